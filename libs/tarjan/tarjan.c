@@ -58,19 +58,6 @@ end0:
     return 0;
 }
 
-// predicate if v is in stack
-static int Stack_elem(Stack * s, size_t v)
-{
-    size_t i = 0;
-
-    for (i = 0; i < s->stack_top; i++) {
-        if (s->values[i] == v)
-            return 1;
-    }
-
-    return 0;
-}
-
 static void Stack_push(Stack * s, size_t v)
 {
     if (s->stack_top < s->max_size) {
@@ -98,16 +85,20 @@ static void Stack_cleanup(Stack * s)
 
 
 typedef struct {
-    int * A; // n times n adjacency matrix
-    size_t n;
+    const TarjanGraph * graph;
 
     size_t index; // current node in algorithm
 
     size_t* vindex; // index per node
     size_t* vlowlink; // lowlink per node
+    char* vonstack; // flag per node: node is on s
+
+    size_t* vedge; // next edge to visit per node
+    Stack * path; // nodes of the depth first search, replaces recursion
 
     Stack * s; // stack of size n
 
+    size_t capacity; // allocated groups in result
     OrderedNodes * result;
 } tarjan_data;
 
@@ -146,21 +137,23 @@ int tarjan_add_node(SizeTArray * c, size_t v)
 }
 
 
-static int tarjan_addto_component(NodeGroup * c, size_t v)
+static int tarjan_addto_result(tarjan_data * data, NodeGroup * c)
 {
-    return tarjan_add_node(&(c->nodes), v);
-}
+    OrderedNodes * result = data->result;
 
-static int tarjan_addto_result(OrderedNodes * result, NodeGroup * c)
-{
-    size_t old_size = result->size;
-    result->size += 1;
-    result->groups = (NodeGroup **)tarjan_realloc(result->groups, result->size * sizeof(*(result->groups)));
+    if (result->size == data->capacity) {
+        size_t capacity = data->capacity ? 2 * data->capacity : 16;
+        NodeGroup ** groups = (NodeGroup **)tarjan_realloc(result->groups, capacity * sizeof(*(result->groups)));
 
-    if (!result->groups)
-        goto end0;
+        if (!groups)
+            goto end0;
 
-    result->groups[result->size - 1] = c;
+        result->groups = groups;
+        data->capacity = capacity;
+    }
+
+    result->groups[result->size] = c;
+    result->size += 1;
 
     // success
     return 1;
@@ -171,9 +164,10 @@ end0:
 }
 
 
-static tarjan_data * tarjan_init(int* A, size_t n)
+static tarjan_data * tarjan_init(const TarjanGraph * graph)
 {
     size_t i;
+    size_t n = graph->n;
 
     tarjan_data * data = 0;
 
@@ -184,9 +178,9 @@ static tarjan_data * tarjan_init(int* A, size_t n)
     if (!data)
         goto end0;
 
-    data->A = A;
-    data->n = n;
+    data->graph = graph;
     data->index = 0;
+    data->capacity = 0;
 
     data->s = Stack_init(n);
     if (!data->s)
@@ -215,10 +209,31 @@ static tarjan_data * tarjan_init(int* A, size_t n)
     for (i = 0; i < n; i++)
         data->vlowlink[i] = SIZE_T_ERROR;
 
+    data->vonstack = (char *) tarjan_malloc(n * sizeof(*(data->vonstack)));
+    if (!data->vonstack)
+        goto end5;
+
+    for (i = 0; i < n; i++)
+        data->vonstack[i] = 0;
+
+    data->vedge = (size_t *) tarjan_malloc(n * sizeof(*(data->vedge)));
+    if (!data->vedge)
+        goto end6;
+
+    data->path = Stack_init(n);
+    if (!data->path)
+        goto end7;
+
     // success
     return data;
 
     // failure
+end7:
+    tarjan_free(data->vedge);
+end6:
+    tarjan_free(data->vonstack);
+end5:
+    tarjan_free(data->vlowlink);
 end4:
     tarjan_free(data->vindex);
 end3:
@@ -231,59 +246,121 @@ end0:
     return 0;
 }
 
-static int tarjan_connect(tarjan_data * data, size_t v)
+static void tarjan_visit(tarjan_data * data, size_t v)
 {
-    size_t w;
-
     data->vindex[v] = data->index;
     data->vlowlink[v] = data->index;
 
     data->index = data->index + 1;
 
     Stack_push(data->s, v);
+    data->vonstack[v] = 1;
 
-    // for all successors of v
-    for (w = 0; w < data->n; w++) {
-        // (v,w) is in the graph
-        if (data->A[v * data->n + w]) {
-            // vindex undefined
-            if (SIZE_T_ERROR == data->vindex[w]) {
-                tarjan_connect(data, w);
-                data->vlowlink[v] = (data->vlowlink[v] < data->vlowlink[w] ? data->vlowlink[v] : data->vlowlink[w]);
-            }
-            // w is on stack
-            // TODO: this can be done in O(1) with flags instead of O(n) as implemented currently
-            else if (Stack_elem(data->s, w)) {
-                data->vlowlink[v] = (data->vlowlink[v] < data->vindex[w] ? data->vlowlink[v] : data->vindex[w]);
-            }
+    data->vedge[v] = data->graph->offsets[v];
+    Stack_push(data->path, v);
+}
+
+static int tarjan_has_edge(const TarjanGraph * graph, size_t v, size_t w)
+{
+    size_t e;
+
+    for (e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+        if (graph->targets[e] == w)
+            return 1;
+    }
+
+    return 0;
+}
+
+// v is the root of a strongly connected component: pop it from s
+static int tarjan_make_component(tarjan_data * data, size_t v)
+{
+    Stack * s = data->s;
+    size_t top = s->stack_top;
+    size_t i;
+
+    // make new component
+    NodeGroup * c = tarjan_init_component();
+    if (!c)
+        goto end0;
+
+    do {
+        top--;
+    } while (s->values[top] != v);
+
+    c->nodes.size = s->stack_top - top;
+    c->nodes.values = (size_t *) tarjan_malloc(c->nodes.size * sizeof(size_t));
+    if (!c->nodes.values)
+        goto end1;
+
+    // same order as popping the nodes one by one
+    for (i = 0; i < c->nodes.size; i++) {
+        size_t w = Stack_pop(s);
+        data->vonstack[w] = 0;
+        c->nodes.values[i] = w;
+    }
+
+    if (!tarjan_addto_result(data, c))
+        goto end2;
+
+    if (1 == c->nodes.size) {
+        if (tarjan_has_edge(data->graph, v, v)) {
+            c->isLoop = 1; // a self-loop
         }
+    } else {
+        c->isLoop = 1;
     }
 
-    if (data->vlowlink[v] == data->vindex[v]) {
-        size_t w = SIZE_T_ERROR;
+    // success
+    return 1;
 
-        // make new component
-        NodeGroup * c = tarjan_init_component();
-        if (!c)
-            goto end0;
+    // failure
+end2:
+    tarjan_free(c->nodes.values);
+end1:
+    tarjan_free(c);
+end0:
+    return 0;
+}
 
-        do {
-            w = Stack_pop(data->s);
+// iterative version of the recursive strongconnect, the call stack is data->path
+static int tarjan_connect(tarjan_data * data, size_t root)
+{
+    const TarjanGraph * graph = data->graph;
+    Stack * path = data->path;
 
-            // add to component
-            tarjan_addto_component(c, w);
+    tarjan_visit(data, root);
 
-        } while(w != v);
+    while (path->stack_top > 0) {
+        size_t v = path->values[path->stack_top - 1];
 
-        tarjan_addto_result(data->result, c);
+        // for all successors of v
+        if (data->vedge[v] < graph->offsets[v + 1]) {
+            size_t w = graph->targets[data->vedge[v]];
+            data->vedge[v]++;
 
-        if (1 == c->nodes.size) {
-            size_t idx = c->nodes.values[0];
-            if (data->A[idx * data->n + idx]) {
-                c->isLoop = 1; // a self-loop
+            // vindex undefined
+            if (SIZE_T_ERROR == data->vindex[w]) {
+                tarjan_visit(data, w);
+            }
+            // w is on stack
+            else if (data->vonstack[w]) {
+                data->vlowlink[v] = (data->vlowlink[v] < data->vindex[w] ? data->vlowlink[v] : data->vindex[w]);
             }
-        } else {
-            c->isLoop = 1;
+            continue;
+        }
+
+        // all successors of v are done
+        Stack_pop(path);
+
+        if (data->vlowlink[v] == data->vindex[v]) {
+            if (!tarjan_make_component(data, v))
+                goto end0;
+        }
+
+        if (path->stack_top > 0) {
+            size_t u = path->values[path->stack_top - 1];
+            data->vlowlink[u] = (data->vlowlink[u] < data->vlowlink[v] ? data->vlowlink[u] : data->vlowlink[v]);
         }
     }
 
@@ -298,9 +375,12 @@ end0:
 static void tarjan_cleanup(tarjan_data* data)
 {
     Stack_cleanup(data->s);
+    Stack_cleanup(data->path);
 
     tarjan_free(data->vindex);
     tarjan_free(data->vlowlink);
+    tarjan_free(data->vonstack);
+    tarjan_free(data->vedge);
 
     tarjan_free(data);
 }
@@ -326,38 +406,253 @@ int tarjan_init_mem(void * (* malloc)(size_t),
     return 0;
 }
 
+/**
+ * Builds the graph with the edges sources[i] -> targets[i]. The successors
+ * of each node keep the order in which their edges are given.
+ **/
+TarjanGraph * tarjan_graph_create(size_t n, const size_t * sources, const size_t * targets, size_t numEdges)
+{
+    size_t i;
+    size_t * next = 0;
+    TarjanGraph * graph = 0;
+
+    if (!tarjan_malloc || !tarjan_free || !tarjan_realloc)
+        goto end0;
+
+    graph = (TarjanGraph *) tarjan_malloc(sizeof(*graph));
+    if (!graph)
+        goto end0;
+
+    graph->n = n;
+    graph->numEdges = numEdges;
+
+    graph->offsets = (size_t *) tarjan_malloc((n + 1) * sizeof(*(graph->offsets)));
+    if (!graph->offsets)
+        goto end1;
+
+    // at least one element, malloc(0) may return NULL
+    graph->targets = (size_t *) tarjan_malloc((numEdges ? numEdges : 1) * sizeof(*(graph->targets)));
+    if (!graph->targets)
+        goto end2;
+
+    next = (size_t *) tarjan_malloc((n + 1) * sizeof(*next));
+    if (!next)
+        goto end3;
+
+    // count the edges per node, then place them (counting sort by source)
+    for (i = 0; i <= n; i++)
+        graph->offsets[i] = 0;
+
+    for (i = 0; i < numEdges; i++) {
+        if (sources[i] >= n || targets[i] >= n)
+            goto end4;
+        graph->offsets[sources[i] + 1]++;
+    }
+
+    for (i = 0; i < n; i++)
+        graph->offsets[i + 1] += graph->offsets[i];
+
+    for (i = 0; i <= n; i++)
+        next[i] = graph->offsets[i];
+
+    for (i = 0; i < numEdges; i++)
+        graph->targets[next[sources[i]]++] = targets[i];
+
+    tarjan_free(next);
+
+    // success
+    return graph;
+
+    // failure
+end4:
+    tarjan_free(next);
+end3:
+    tarjan_free(graph->targets);
+end2:
+    tarjan_free(graph->offsets);
+end1:
+    tarjan_free(graph);
+end0:
+    return 0;
+}
+
+void tarjan_graph_cleanup(TarjanGraph * graph)
+{
+    if (NULL == graph) {
+        return;
+    }
+
+    tarjan_free(graph->offsets);
+    tarjan_free(graph->targets);
+    tarjan_free(graph);
+}
+
+/**
+ * Builds the graph with all edges of graph reversed. The successors of
+ * each node are in ascending order.
+ **/
+TarjanGraph * tarjan_graph_transpose(const TarjanGraph * graph)
+{
+    size_t v, e;
+    size_t * next = 0;
+    TarjanGraph * transposed = 0;
+
+    if (!tarjan_malloc || !tarjan_free || !tarjan_realloc)
+        goto end0;
+
+    transposed = (TarjanGraph *) tarjan_malloc(sizeof(*transposed));
+    if (!transposed)
+        goto end0;
+
+    transposed->n = graph->n;
+    transposed->numEdges = graph->numEdges;
+
+    transposed->offsets = (size_t *) tarjan_malloc((graph->n + 1) * sizeof(*(transposed->offsets)));
+    if (!transposed->offsets)
+        goto end1;
+
+    // at least one element, malloc(0) may return NULL
+    transposed->targets = (size_t *) tarjan_malloc((graph->numEdges ? graph->numEdges : 1) * sizeof(*(transposed->targets)));
+    if (!transposed->targets)
+        goto end2;
+
+    next = (size_t *) tarjan_malloc((graph->n + 1) * sizeof(*next));
+    if (!next)
+        goto end3;
+
+    // count the edges per target, then place them in the order of their sources
+    for (v = 0; v <= graph->n; v++)
+        transposed->offsets[v] = 0;
+
+    for (e = 0; e < graph->numEdges; e++)
+        transposed->offsets[graph->targets[e] + 1]++;
+
+    for (v = 0; v < graph->n; v++)
+        transposed->offsets[v + 1] += transposed->offsets[v];
+
+    for (v = 0; v <= graph->n; v++)
+        next[v] = transposed->offsets[v];
+
+    for (v = 0; v < graph->n; v++) {
+        for (e = graph->offsets[v]; e < graph->offsets[v + 1]; e++)
+            transposed->targets[next[graph->targets[e]]++] = v;
+    }
+
+    tarjan_free(next);
+
+    // success
+    return transposed;
+
+    // failure
+end3:
+    tarjan_free(transposed->targets);
+end2:
+    tarjan_free(transposed->offsets);
+end1:
+    tarjan_free(transposed);
+end0:
+    return 0;
+}
+
 /**
  * See wikipedia (https://en.wikipedia.org/wiki/Tarjan%27s_strongly_connected_components_algorithm) for details
  *
- * A is  the n*n-adjacency matrix of the graph
+ * Runs in O(n + numEdges), the depth first search is done without recursion.
+ * The group of a node comes after the groups of all nodes reachable from it.
  **/
-OrderedNodes* tarjan(int* A, size_t n)
+OrderedNodes * tarjan_graph(const TarjanGraph * graph)
 {
     size_t v;
     OrderedNodes * result = NULL;
-    tarjan_data * data = tarjan_init(A, n);
+    tarjan_data * data = tarjan_init(graph);
 
     if (!data)
         goto end0;
 
-    for (v = 0; v < data->n; v++) {
+    for (v = 0; v < graph->n; v++) {
         if (SIZE_T_ERROR == data->vindex[v]) {
             if (!tarjan_connect(data, v)) {
-                goto end0;
+                goto end1;
             }
         }
     }
 
     result = data->result;
 
+    // shrink to the actual number of groups
+    if (result->size > 0 && result->size < data->capacity) {
+        NodeGroup ** groups = (NodeGroup **) tarjan_realloc(result->groups, result->size * sizeof(*(result->groups)));
+        if (groups) {
+            result->groups = groups;
+        }
+    }
+
     tarjan_cleanup(data);
 
     return result;
 
+end1:
+    tarjan_ordered_nodes_cleanup(data->result);
+    tarjan_cleanup(data);
 end0:
     return 0;
 }
 
+/**
+ * A is  the n*n-adjacency matrix of the graph
+ **/
+OrderedNodes* tarjan(int* A, size_t n)
+{
+    size_t v, w;
+    size_t numEdges = 0;
+    size_t * sources = NULL;
+    size_t * targets = NULL;
+    TarjanGraph * graph = NULL;
+    OrderedNodes * result = NULL;
+
+    if (!tarjan_malloc || !tarjan_free || !tarjan_realloc)
+        goto end0;
+
+    for (v = 0; v < n * n; v++) {
+        if (A[v])
+            numEdges++;
+    }
+
+    sources = (size_t *) tarjan_malloc((numEdges ? numEdges : 1) * sizeof(*sources));
+    if (!sources)
+        goto end0;
+
+    targets = (size_t *) tarjan_malloc((numEdges ? numEdges : 1) * sizeof(*targets));
+    if (!targets)
+        goto end1;
+
+    numEdges = 0;
+    for (v = 0; v < n; v++) {
+        for (w = 0; w < n; w++) {
+            if (A[v * n + w]) {
+                sources[numEdges] = v;
+                targets[numEdges] = w;
+                numEdges++;
+            }
+        }
+    }
+
+    graph = tarjan_graph_create(n, sources, targets, numEdges);
+    if (!graph)
+        goto end2;
+
+    result = tarjan_graph(graph);
+
+    tarjan_graph_cleanup(graph);
+
+end2:
+    tarjan_free(targets);
+end1:
+    tarjan_free(sources);
+end0:
+    return result;
+}
+
 void tarjan_ordered_nodes_cleanup(OrderedNodes * result)
 {
     size_t i = 0;
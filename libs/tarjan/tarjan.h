@@ -37,6 +37,26 @@ typedef struct {
     NodeGroup ** groups;
 } OrderedNodes;
 
+/**
+ * Sparse directed graph in compressed row storage: the successors of
+ * node v are targets[offsets[v]] ... targets[offsets[v + 1] - 1].
+ */
+typedef struct {
+    size_t n; // number of nodes
+    size_t numEdges;
+
+    size_t * offsets; // n + 1 entries
+    size_t * targets; // numEdges entries
+} TarjanGraph;
+
+TarjanGraph * tarjan_graph_create(size_t n, const size_t * sources, const size_t * targets, size_t numEdges);
+
+void tarjan_graph_cleanup(TarjanGraph * graph);
+
+TarjanGraph * tarjan_graph_transpose(const TarjanGraph * graph);
+
+OrderedNodes * tarjan_graph(const TarjanGraph * graph);
+
 OrderedNodes * tarjan(int * A, size_t n);
 
 void tarjan_ordered_nodes_cleanup(OrderedNodes * result);
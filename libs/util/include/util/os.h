@@ -110,6 +110,17 @@ int mcx_os_fclose(FILE * file);
  */
 int mcx_os_fprintf(FILE *stream, const char *format, ...);
 
+/**
+ * Renames the file from to to, replacing to if it exists. On the same
+ * file system the replacement is atomic. Returns 0 on success.
+ */
+int mcx_os_rename(const char * from, const char * to);
+
+/**
+ * Returns the id of the current process.
+ */
+long mcx_os_get_pid(void);
+
 #if defined (OS_WINDOWS)
 char * mcx_os_win_get_last_error();
 #endif // OS_WINDOWS
@@ -193,6 +193,14 @@ FILE * mcx_os_fopen(const char * path, const char * mode) {
     return fopen(path, mode);
 }
 
+int mcx_os_rename(const char * from, const char * to) {
+    return rename(from, to);
+}
+
+long mcx_os_get_pid(void) {
+    return (long) getpid();
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
\ No newline at end of file
@@ -295,6 +295,25 @@ FILE * mcx_os_fopen(const char * path, const char * mode) {
     return f;
 }
 
+int mcx_os_rename(const char * from, const char * to) {
+    wchar_t * wFrom = mcx_string_to_widechar(from);
+    wchar_t * wTo = mcx_string_to_widechar(to);
+    BOOL success = FALSE;
+
+    if (wFrom && wTo) {
+        success = MoveFileExW(wFrom, wTo, MOVEFILE_REPLACE_EXISTING);
+    }
+
+    mcx_free(wFrom);
+    mcx_free(wTo);
+
+    return success ? 0 : -1;
+}
+
+long mcx_os_get_pid(void) {
+    return (long) GetCurrentProcessId();
+}
+
 char * mcx_os_win_get_last_error() {
     wchar_t * wError = NULL;
     char * utf8Error = NULL;
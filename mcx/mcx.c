@@ -11,9 +11,12 @@
 #include "core/Config.h"
 #include "core/Task.h"
 #include "core/Model.h"
+#include "core/ModelCache.h"
 
 #include "reader/Reader.h"
 
+#include "fmu/FmuExtractCache.h"
+
 #include "Memory.h"
 
 #include "util/os.h"
@@ -305,6 +308,7 @@ McxStatus RunMCX(int argc, char *argv[]) {
     InputElement * element = NULL;
 
     Reader * reader = NULL;
+    ModelCache * cache = NULL;
 
     mcx_cpu_time_get(&clock_begin);
     mcx_time_get(&time_begin);
@@ -330,6 +334,19 @@ McxStatus RunMCX(int argc, char *argv[]) {
         goto cleanup;
     }
 
+    cache = (ModelCache *) object_create(ModelCache);
+    if (!cache) {
+        mcx_log(LOG_ERROR, "Could not create model cache");
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+
+    retVal = cache->Load(cache, config);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Reading the model cache failed");
+        goto cleanup;
+    }
+
     reader = (Reader*)object_create(Reader);
     if (!reader) {
         mcx_log(LOG_ERROR, "Could not create input file reader");
@@ -344,6 +361,8 @@ McxStatus RunMCX(int argc, char *argv[]) {
         goto cleanup;
     }
 
+    reader->SetValidated(reader, cache->IsModelValidated(cache));
+
     mcxInput = reader->Read(reader, config->modelFile);
     if (!mcxInput) {
         mcx_log(LOG_ERROR, "Parsing of input file failed");
@@ -352,6 +371,12 @@ McxStatus RunMCX(int argc, char *argv[]) {
     }
     element = (InputElement *) mcxInput;
 
+    retVal = cache->CheckInput(cache, mcxInput->model);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Checking the model cache failed");
+        goto cleanup;
+    }
+
     retVal = config->SetupFromInput(config, mcxInput->config);
     if (RETURN_OK != retVal) {
         mcx_log(LOG_ERROR, "Setting up configuration from input file failed");
@@ -381,6 +406,7 @@ McxStatus RunMCX(int argc, char *argv[]) {
     model->SetConfig(model, config);
     model->SetTask(model, task);
     model->SetComponentFactory(model, factory);
+    model->SetModelCache(model, cache);
 
     mcx_log(LOG_INFO, "******************** Read data: **************************************");
     mcx_log(LOG_INFO, " ");
@@ -514,6 +540,7 @@ McxStatus RunMCX(int argc, char *argv[]) {
 
     object_destroy(task);
     object_destroy(model);
+    object_destroy(cache);
     object_destroy(config);
 
     mcx_cpu_time_get(&clock_cleanup_end);
@@ -548,6 +575,7 @@ cleanup:
 
     if (model) { object_destroy(model); }
     if (task) { object_destroy(task); }
+    if (cache) { object_destroy(cache); }
     if (config) { object_destroy(config); }
 
     if (logInitialized) {
@@ -576,11 +604,14 @@ int main(int argc, char *argv[])
 #endif //ENABLE_MT
 
     InitMemory();
+    FmuExtractCacheInit();
 
     mcx_signal_handler_enable();
     retVal = RunMCX(nArgs, argList);
     mcx_signal_handler_disable();
 
+    FmuExtractCacheCleanup();
+
     if (argList != argv) {
         int i = 0;
         for (i = 0; i < nArgs; i++) {
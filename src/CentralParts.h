@@ -86,6 +86,10 @@ typedef struct {
     int stopIfFirstComponentFinished;
     int aComponentFinished;
     int errorOccurred;
+
+    // input sets of the FMU 2 elements, summed up by their Finish
+    size_t numInputSets;
+    size_t numSkippedInputSets;
 } FinishState;
 
 typedef enum ChannelMode {
@@ -152,6 +156,13 @@ typedef enum StoreLevel {
     STORE_COUPLING = 3,
 } StoreLevel;
 
+typedef enum ResultFilterType {
+    RESULT_FILTER_NONE = 0,
+    RESULT_FILTER_DEADBAND = 1,
+    RESULT_FILTER_SWINGING_DOOR = 2,
+    RESULT_FILTER_MIN_MAX = 3
+} ResultFilterType;
+
 typedef enum {
     NAN_CHECK_NEVER = 0,
     NAN_CHECK_CONNECTED = 1,
@@ -492,6 +492,13 @@ static McxStatus Fmu2Setup(Component * comp) {
         }
     }
 
+    // value references per type for the batched exchange in DoStep
+    retVal = Fmu2CommonStructSetupBatches(&compFmu->fmu2);
+    if (RETURN_OK != retVal) {
+        ComponentLog(comp, LOG_ERROR, "Could not set up variable batches");
+        return RETURN_ERROR;
+    }
+
     return RETURN_OK;
 }
 
@@ -959,7 +966,7 @@ static McxStatus Fmu2DoStep(Component * comp, size_t group, double time, double
     fmi2_status_t status = fmi2_status_ok;
 
     // Set variables
-    retVal = Fmu2SetVariableArray(fmu2, fmu2->in);
+    retVal = Fmu2SetVariableBatch(fmu2, &fmu2->inBatch);
     if (RETURN_OK != retVal) {
         ComponentLog(comp, LOG_ERROR, "Setting inChannels failed");
         return RETURN_ERROR;
@@ -1009,7 +1016,7 @@ static McxStatus Fmu2DoStep(Component * comp, size_t group, double time, double
     compFmu->lastCommunicationTimePoint += deltaTime;
 
     // Get outputs
-    retVal = Fmu2GetVariableArray(fmu2, fmu2->out);
+    retVal = Fmu2GetVariableBatch(fmu2, &fmu2->outBatch);
     if (RETURN_OK != retVal) {
         ComponentLog(comp, LOG_ERROR, "Retrieving outChannels failed");
         return RETURN_ERROR;
@@ -1017,7 +1024,7 @@ static McxStatus Fmu2DoStep(Component * comp, size_t group, double time, double
 
     // local variables
     if (compFmu->localValues) {
-        retVal = Fmu2GetVariableArray(fmu2, fmu2->localValues);
+        retVal = Fmu2GetVariableBatch(fmu2, &fmu2->localBatch);
         if (RETURN_OK != retVal) {
             ComponentLog(comp, LOG_ERROR, "Retrieving local variables failed");
             return RETURN_ERROR;
@@ -1027,6 +1034,19 @@ static McxStatus Fmu2DoStep(Component * comp, size_t group, double time, double
     return RETURN_OK;
 }
 
+static McxStatus Fmu2Finish(Component * comp, FinishState * finishState) {
+    CompFMU * compFmu = (CompFMU *) comp;
+    Fmu2CommonStruct * fmu2 = &compFmu->fmu2;
+
+    ComponentLog(comp, LOG_DEBUG, "Skipped %zu of %zu input sets of unchanged values",
+        fmu2->numSkippedInputSets, fmu2->numInputSets);
+
+    finishState->numInputSets += fmu2->numInputSets;
+    finishState->numSkippedInputSets += fmu2->numSkippedInputSets;
+
+    return RETURN_OK;
+}
+
 static McxStatus Read(Component * comp, ComponentInput * input, const struct Config * const config) {
     CompFMU * compFmu = (CompFMU *) comp;
     InputElement * element = (InputElement *) input;
@@ -1073,6 +1093,7 @@ static McxStatus Read(Component * comp, ComponentInput * input, const struct Con
         comp->DoStep = Fmu2DoStep;
         comp->ExitInitializationMode = Fmu2ExitInitializationMode;
         comp->GetInOutGroupsInitialDependency = Fmu2GetInOutGroupsInitialDependency;
+        comp->Finish = Fmu2Finish;
 
         comp->SetIsPartOfInitCalculation(comp, TRUE);
 
@@ -165,10 +165,10 @@ McxStatus ComponentSetup(Component * comp) {
     McxStatus retVal = RETURN_OK;
 
     // fill structures with data
-    DatabusSetup(comp->data->databus,
-                 DatabusGetInInfo(comp->data->databus),
-                 DatabusGetOutInfo(comp->data->databus),
-                 comp->data->model->config);
+    retVal = DatabusSetup(comp->data->databus,
+                          DatabusGetInInfo(comp->data->databus),
+                          DatabusGetOutInfo(comp->data->databus),
+                          comp->data->model->config);
 
     if (RETURN_OK != retVal) {
         ComponentLog(comp, LOG_ERROR, "Could not setup ports");
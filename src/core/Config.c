@@ -295,6 +295,28 @@ static McxStatus ConfigSetupFromEnvironment(Config * config) {
         }
     }
 
+    {
+        char * numThreads = mcx_os_get_env_var("MC_NUM_THREADS");
+        if (numThreads) {
+            int num = atoi(numThreads);
+            config->numThreadsDefined = TRUE;
+            config->numThreads = (num > 0) ? (size_t) num : 0;
+            mcx_log(LOG_INFO, "Environment variable MC_NUM_THREADS = %zu", config->numThreads);
+            mcx_free(numThreads);
+        }
+    }
+
+    {
+        char * cpuList = mcx_os_get_env_var("MC_CPU_LIST");
+        if (cpuList) {
+            if (config->cpuList) {
+                mcx_free(config->cpuList);
+            }
+            config->cpuList = cpuList;
+            mcx_log(LOG_INFO, "Environment variable MC_CPU_LIST = %s", config->cpuList);
+        }
+    }
+
     {
         char * cosimInitEnabled = NULL;
 
@@ -351,6 +373,99 @@ static McxStatus ConfigSetupFromEnvironment(Config * config) {
         }
     }
 
+    {
+        char * str = mcx_os_get_env_var("MC_MAX_PORT_BUFFER_SIZE");
+        if (str) {
+            long long size = atoll(str);
+            config->maxPortBufferSize = (size > 0) ? (size_t) size : 0;
+            mcx_log(LOG_INFO, "Environment variable MC_MAX_PORT_BUFFER_SIZE = %zu", config->maxPortBufferSize);
+            mcx_free(str);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_RESULT_WRITER_BUFFER_SIZE");
+        if (str) {
+            int size = atoi(str);
+            config->resultWriterBufferSize = (size > 0) ? (size_t) size : 0;
+            mcx_log(LOG_INFO, "Environment variable MC_RESULT_WRITER_BUFFER_SIZE = %zu", config->resultWriterBufferSize);
+            mcx_free(str);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_RESULT_WRITER_FULL");
+        if (str) {
+            if (0 == strcmp(str, "drop")) {
+                config->resultWriterDropRows = TRUE;
+            } else if (0 == strcmp(str, "wait")) {
+                config->resultWriterDropRows = FALSE;
+            } else {
+                mcx_log(LOG_ERROR, "Invalid value \"%s\" for MC_RESULT_WRITER_FULL", str);
+                mcx_free(str);
+                return RETURN_ERROR;
+            }
+            mcx_log(LOG_INFO, "Environment variable MC_RESULT_WRITER_FULL = %s", str);
+            mcx_free(str);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_RESULT_STORAGE_WINDOW");
+        if (str) {
+            int size = atoi(str);
+            config->resultStorageWindow = (size > 0) ? (size_t) size : 0;
+            mcx_log(LOG_INFO, "Environment variable MC_RESULT_STORAGE_WINDOW = %zu", config->resultStorageWindow);
+            mcx_free(str);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_SETUP_THREADS");
+        if (str) {
+            int num = atoi(str);
+            config->numSetupThreads = (num > 0) ? (size_t) num : 0;
+            mcx_log(LOG_INFO, "Environment variable MC_SETUP_THREADS = %zu", config->numSetupThreads);
+            mcx_free(str);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_LOOP_BREAKING_EXACT_SIZE");
+        if (str) {
+            int size = atoi(str);
+            config->loopBreakingExactSize = (size > 0) ? (size_t) size : 0;
+            mcx_log(LOG_INFO, "Environment variable MC_LOOP_BREAKING_EXACT_SIZE = %zu", config->loopBreakingExactSize);
+            mcx_free(str);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_MODEL_CACHE_DIR");
+        if (str) {
+            if (config->modelCacheDir) {
+                mcx_free(config->modelCacheDir);
+            }
+            config->modelCacheDir = mcx_path_get_absolute(str);
+            mcx_free(str);
+            if (!config->modelCacheDir) {
+                return RETURN_ERROR;
+            }
+            mcx_log(LOG_INFO, "Environment variable MC_MODEL_CACHE_DIR = %s", config->modelCacheDir);
+        }
+    }
+
+    {
+        char * str = mcx_os_get_env_var("MC_FMU_SHARED_EXTRACTION");
+        if (str) {
+            if (is_off(str)) {
+                config->fmuSharedExtraction = FALSE;
+            }
+            mcx_log(LOG_INFO, "Environment variable MC_FMU_SHARED_EXTRACTION = %s", str);
+            mcx_free(str);
+        }
+    }
+
     return RETURN_OK;
 }
 
@@ -429,6 +544,12 @@ static void ConfigDestructor(void * self) {
     if (config->executable) {
         mcx_free(config->executable);
     }
+    if (config->cpuList) {
+        mcx_free(config->cpuList);
+    }
+    if (config->modelCacheDir) {
+        mcx_free(config->modelCacheDir);
+    }
 }
 
 static Config * ConfigCreate(Config * config) {
@@ -460,6 +581,13 @@ static Config * ConfigCreate(Config * config) {
     config->sumTimeDefined = FALSE;
     config->sumTime = TRUE;
 
+    config->numThreadsDefined = FALSE;
+    config->numThreads = 0;
+
+    config->cpuList = NULL;
+
+    config->numSetupThreads = 0;
+
     config->writeAllLogFile = FALSE;
 
     config->cosimInitEnabled = FALSE;
@@ -469,6 +597,18 @@ static Config * ConfigCreate(Config * config) {
     config->nanCheck = NAN_CHECK_ALWAYS;
     config->nanCheckNumMessages = MAX_NUM_MSGS;
 
+    config->maxPortBufferSize = 0;
+
+    config->resultWriterBufferSize = 0;
+    config->resultWriterDropRows = FALSE;
+
+    config->resultStorageWindow = 0;
+    config->loopBreakingExactSize = 16;
+
+    config->modelCacheDir = NULL;
+
+    config->fmuSharedExtraction = TRUE;
+
     return config;
 }
 
@@ -59,6 +59,13 @@ struct Config {
     int sumTime;
     int sumTimeDefined;
 
+    size_t numThreads;
+    int numThreadsDefined;
+
+    char * cpuList; // processors for the worker threads, NULL if not defined
+
+    size_t numSetupThreads; // threads reading and setting up model elements, 0: number of processors
+
     int writeAllLogFile;
 
     int cosimInitEnabled;
@@ -67,6 +74,19 @@ struct Config {
 
     NaNCheckLevel nanCheck;
     int nanCheckNumMessages;
+
+    size_t maxPortBufferSize; // maximum size of string and binary port values, 0 if unlimited
+
+    size_t resultWriterBufferSize; // rows buffered per result file for the writer thread, 0 to write synchronously
+    int resultWriterDropRows;      // drop rows instead of waiting if the buffer is full
+
+    size_t resultStorageWindow; // rows of full result storage kept in memory per result file, 0 if unlimited
+
+    size_t loopBreakingExactSize; // max. decoupleable bundles of a loop for the exact loop breaking search
+
+    char * modelCacheDir; // directory of the model build cache, NULL if disabled
+
+    int fmuSharedExtraction; // instances of the same FMU share one extracted directory
 };
 
 void CreateLogHeader(Config * config, LogSeverity sev);
@@ -561,6 +561,13 @@ static void DatabusDataDestructor(DatabusData * data) {
             mcx_free(data->rtfactor);
         }
 
+        ChannelDoubleStoreDestructor(&data->inDoubles);
+        if (data->inDoubleChannels) { mcx_free(data->inDoubleChannels); }
+        if (data->inOtherChannels) { mcx_free(data->inOtherChannels); }
+        ChannelDoubleStoreDestructor(&data->outDoubles);
+        if (data->outDoubleChannels) { mcx_free(data->outDoubleChannels); }
+        if (data->outOtherChannels) { mcx_free(data->outOtherChannels); }
+
         object_destroy(data->inInfo);
         object_destroy(data->outInfo);
         object_destroy(data->localInfo);
@@ -574,6 +581,16 @@ static DatabusData * DatabusDataCreate(DatabusData * data) {
     data->local = NULL;
     data->rtfactor = NULL;
 
+    ChannelDoubleStoreInit(&data->inDoubles);
+    data->inDoubleChannels = NULL;
+    data->numInOthers = 0;
+    data->inOtherChannels = NULL;
+
+    ChannelDoubleStoreInit(&data->outDoubles);
+    data->outDoubleChannels = NULL;
+    data->numOutOthers = 0;
+    data->outOtherChannels = NULL;
+
     data->inInfo = (DatabusInfo *) object_create(DatabusInfo);
     if (!data->inInfo) {
         return NULL;
@@ -601,6 +618,77 @@ OBJECT_CLASS(DatabusData, Object);
 
 
 
+static int ChannelIsDouble(Channel * channel) {
+    ChannelInfo * info = channel->GetInfo(channel);
+
+    return CHANNEL_DOUBLE == info->GetType(info);
+}
+
+static McxStatus DatabusSetupValueStores(Databus * db) {
+    DatabusData * data = db->data;
+    size_t numIn = DatabusInfoGetChannelNum(data->inInfo);
+    size_t numOut = DatabusInfoGetChannelNum(data->outInfo);
+    size_t numInDoubles = 0;
+    size_t numOutDoubles = 0;
+    size_t i = 0;
+
+    for (i = 0; i < numIn; i++) {
+        if (ChannelIsDouble((Channel *) data->in[i])) {
+            numInDoubles++;
+        }
+    }
+    for (i = 0; i < numOut; i++) {
+        if (ChannelIsDouble((Channel *) data->out[i])) {
+            numOutDoubles++;
+        }
+    }
+
+    if (RETURN_OK != ChannelDoubleStoreSetup(&data->inDoubles, numInDoubles)
+        || RETURN_OK != ChannelDoubleStoreSetup(&data->outDoubles, numOutDoubles)) {
+        return RETURN_ERROR;
+    }
+
+    data->inDoubleChannels = (ChannelIn **) mcx_calloc(numInDoubles + 1, sizeof(ChannelIn *));
+    data->inOtherChannels = (ChannelIn **) mcx_calloc(numIn - numInDoubles + 1, sizeof(ChannelIn *));
+    data->outDoubleChannels = (ChannelOut **) mcx_calloc(numOutDoubles + 1, sizeof(ChannelOut *));
+    data->outOtherChannels = (ChannelOut **) mcx_calloc(numOut - numOutDoubles + 1, sizeof(ChannelOut *));
+
+    if (!data->inDoubleChannels || !data->inOtherChannels || !data->outDoubleChannels || !data->outOtherChannels) {
+        mcx_log(LOG_ERROR, "Ports: Memory allocation for port values failed");
+        return RETURN_ERROR;
+    }
+
+    numInDoubles = 0;
+    for (i = 0; i < numIn; i++) {
+        Channel * channel = (Channel *) data->in[i];
+
+        if (ChannelIsDouble(channel)) {
+            if (RETURN_OK != channel->SetValueStore(channel, &data->inDoubles, numInDoubles)) {
+                return RETURN_ERROR;
+            }
+            data->inDoubleChannels[numInDoubles++] = data->in[i];
+        } else {
+            data->inOtherChannels[data->numInOthers++] = data->in[i];
+        }
+    }
+
+    numOutDoubles = 0;
+    for (i = 0; i < numOut; i++) {
+        Channel * channel = (Channel *) data->out[i];
+
+        if (ChannelIsDouble(channel)) {
+            if (RETURN_OK != channel->SetValueStore(channel, &data->outDoubles, numOutDoubles)) {
+                return RETURN_ERROR;
+            }
+            data->outDoubleChannels[numOutDoubles++] = data->out[i];
+        } else {
+            data->outOtherChannels[data->numOutOthers++] = data->out[i];
+        }
+    }
+
+    return RETURN_OK;
+}
+
 McxStatus DatabusSetup(Databus * db, DatabusInfo * in, DatabusInfo * out, Config * config) {
     size_t i = 0;
 
@@ -630,7 +718,7 @@ McxStatus DatabusSetup(Databus * db, DatabusInfo * in, DatabusInfo * out, Config
                 db->data->in = NULL;
                 return RETURN_ERROR;
             }
-            db->data->in[i]->Setup(db->data->in[i], DatabusInfoGetChannel(in, i));
+            db->data->in[i]->Setup(db->data->in[i], DatabusInfoGetChannel(in, i), config);
         }
     } else {
         db->data->in = NULL;
@@ -667,7 +755,8 @@ McxStatus DatabusSetup(Databus * db, DatabusInfo * in, DatabusInfo * out, Config
     } else {
         db->data->out = NULL;
     }
-    return RETURN_OK;
+
+    return DatabusSetupValueStores(db);
 }
 
 
@@ -677,13 +766,18 @@ McxStatus DatabusTriggerOutChannels(Databus *db, TimeInterval * time) {
         return RETURN_ERROR;
     }
     Channel * out = NULL;
-    size_t numOut = DatabusInfoGetChannelNum(DatabusGetOutInfo(db));
     size_t i = 0;
 
     McxStatus retVal = RETURN_OK;
 
-    for (i = 0; i < numOut; i++) {
-        out = (Channel *) db->data->out[i];
+    retVal = ChannelOutUpdateDoubles(db->data->outDoubleChannels, &db->data->outDoubles, time);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Could not update outports");
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < db->data->numOutOthers; i++) {
+        out = (Channel *) db->data->outOtherChannels[i];
         retVal = out->Update(out, time);
         if (RETURN_OK != retVal) {
             ChannelInfo * info = out->GetInfo(out);
@@ -700,13 +794,18 @@ McxStatus DatabusTriggerInConnections(Databus * db, TimeInterval * consumerTime)
         mcx_log(LOG_ERROR, "Ports: Trigger inports: Invalid structure");
         return RETURN_ERROR;
     }
-    size_t numIn = DatabusInfoGetChannelNum(DatabusGetInInfo(db));
     size_t i = 0;
 
     McxStatus retVal = RETURN_OK;
 
-    for (i = 0; i < numIn; i++) {
-        Channel * channel = (Channel *) db->data->in[i];
+    retVal = ChannelInUpdateDoubles(db->data->inDoubleChannels, &db->data->inDoubles, consumerTime);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Could not update inports");
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < db->data->numInOthers; i++) {
+        Channel * channel = (Channel *) db->data->inOtherChannels[i];
         if (channel->IsValid(channel)) {
             retVal = channel->Update(channel, consumerTime);
             if (RETURN_OK != retVal) {
@@ -11,6 +11,8 @@
 #ifndef MCX_CORE_DATABUS_IMPL_H
 #define MCX_CORE_DATABUS_IMPL_H
 
+#include "core/channels/Channel.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -59,6 +61,19 @@ typedef struct DatabusData {
     struct DatabusInfo * outInfo; /**< metadata (size, properties) for \a out */
     struct DatabusInfo * localInfo; /**< metadata (size, properties) for \a local */
     struct DatabusInfo * rtfactorInfo; /**< metadata (size, properties) for \a local */
+
+    /* The values of the CHANNEL_DOUBLE in- and outports are kept in one
+     * contiguous store per direction, so that updates sweep over arrays
+     * instead of channel objects. The other ports are updated one by one. */
+    ChannelDoubleStore inDoubles;           /**< values of the double inports */
+    struct ChannelIn ** inDoubleChannels;   /**< inport of each value in \a inDoubles */
+    size_t numInOthers;
+    struct ChannelIn ** inOtherChannels;    /**< all other inports */
+
+    ChannelDoubleStore outDoubles;          /**< values of the double outports */
+    struct ChannelOut ** outDoubleChannels; /**< outport of each value in \a outDoubles */
+    size_t numOutOthers;
+    struct ChannelOut ** outOtherChannels;  /**< all other outports */
 } DatabusData;
 
 #ifdef __cplusplus
@@ -0,0 +1,539 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "core/FeedbackEdges.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// upper limit for the search tree of the exact search
+#define FEEDBACK_EDGES_MAX_EXPANSIONS 100000
+
+typedef struct FeedbackGraph {
+    size_t numNodes;
+    size_t numEdges;
+    FeedbackEdge * edges;
+
+    // edge indices per node: outEdges[outOffsets[v]] ... outEdges[outOffsets[v + 1] - 1]
+    size_t * outOffsets;
+    size_t * outEdges;
+    size_t * inOffsets;
+    size_t * inEdges;
+
+    char * removed; // per edge
+
+    // depth first search
+    char * state; // per node
+    size_t * cursor; // per node
+    size_t * parentEdge; // per node
+    size_t * stack;
+} FeedbackGraph;
+
+typedef struct FeedbackSearch {
+    char * best;
+    uint64_t bestCost;
+
+    char * keep; // per edge: edge is not removed in this branch
+    size_t expansions;
+} FeedbackSearch;
+
+static void FeedbackGraphCleanup(FeedbackGraph * g) {
+    if (g->outOffsets) { mcx_free(g->outOffsets); }
+    if (g->outEdges) { mcx_free(g->outEdges); }
+    if (g->inOffsets) { mcx_free(g->inOffsets); }
+    if (g->inEdges) { mcx_free(g->inEdges); }
+    if (g->removed) { mcx_free(g->removed); }
+    if (g->state) { mcx_free(g->state); }
+    if (g->cursor) { mcx_free(g->cursor); }
+    if (g->parentEdge) { mcx_free(g->parentEdge); }
+    if (g->stack) { mcx_free(g->stack); }
+}
+
+static McxStatus FeedbackGraphSetup(FeedbackGraph * g, size_t numNodes, FeedbackEdge * edges, size_t numEdges) {
+    size_t i = 0;
+
+    memset(g, 0, sizeof(FeedbackGraph));
+
+    g->numNodes = numNodes;
+    g->numEdges = numEdges;
+    g->edges = edges;
+
+    g->outOffsets = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    g->inOffsets = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    g->outEdges = (size_t *) mcx_calloc(numEdges + 1, sizeof(size_t));
+    g->inEdges = (size_t *) mcx_calloc(numEdges + 1, sizeof(size_t));
+    g->removed = (char *) mcx_calloc(numEdges + 1, sizeof(char));
+    g->state = (char *) mcx_calloc(numNodes + 1, sizeof(char));
+    g->cursor = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    g->parentEdge = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    g->stack = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+
+    if (!g->outOffsets || !g->inOffsets || !g->outEdges || !g->inEdges || !g->removed
+        || !g->state || !g->cursor || !g->parentEdge || !g->stack) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < numEdges; i++) {
+        if (edges[i].from >= numNodes || edges[i].to >= numNodes) {
+            mcx_log(LOG_ERROR, "Model: Loop breaking: Invalid edge %zu -> %zu", edges[i].from, edges[i].to);
+            return RETURN_ERROR;
+        }
+        g->outOffsets[edges[i].from + 1]++;
+        g->inOffsets[edges[i].to + 1]++;
+    }
+
+    for (i = 0; i < numNodes; i++) {
+        g->outOffsets[i + 1] += g->outOffsets[i];
+        g->inOffsets[i + 1] += g->inOffsets[i];
+    }
+
+    // use cursor and parentEdge as insert positions
+    memcpy(g->cursor, g->outOffsets, numNodes * sizeof(size_t));
+    memcpy(g->parentEdge, g->inOffsets, numNodes * sizeof(size_t));
+    for (i = 0; i < numEdges; i++) {
+        g->outEdges[g->cursor[edges[i].from]++] = i;
+        g->inEdges[g->parentEdge[edges[i].to]++] = i;
+    }
+
+    return RETURN_OK;
+}
+
+/**
+ * Searches a cycle over the edges that are not removed. The edge indices of
+ * the cycle are stored in cycle, which needs space for numNodes elements.
+ */
+static int FeedbackGraphFindCycle(FeedbackGraph * g, size_t * cycle, size_t * cycleLen) {
+    size_t root = 0;
+
+    memset(g->state, 0, g->numNodes * sizeof(char));
+
+    for (root = 0; root < g->numNodes; root++) {
+        size_t top = 0;
+
+        if (g->state[root]) {
+            continue;
+        }
+
+        g->state[root] = 1;
+        g->cursor[root] = g->outOffsets[root];
+        g->stack[top++] = root;
+
+        while (top > 0) {
+            size_t v = g->stack[top - 1];
+
+            if (g->cursor[v] < g->outOffsets[v + 1]) {
+                size_t e = g->outEdges[g->cursor[v]++];
+                size_t w = g->edges[e].to;
+
+                if (g->removed[e]) {
+                    continue;
+                }
+
+                if (0 == g->state[w]) {
+                    g->state[w] = 1;
+                    g->cursor[w] = g->outOffsets[w];
+                    g->parentEdge[w] = e;
+                    g->stack[top++] = w;
+                } else if (1 == g->state[w]) {
+                    // w is on the current path: e and the path from w to v form a cycle
+                    size_t n = 0;
+                    size_t x = v;
+
+                    cycle[n++] = e;
+                    while (x != w) {
+                        cycle[n++] = g->parentEdge[x];
+                        x = g->edges[g->parentEdge[x]].from;
+                    }
+
+                    *cycleLen = n;
+                    return TRUE;
+                }
+            } else {
+                g->state[v] = 2;
+                top--;
+            }
+        }
+    }
+
+    *cycleLen = 0;
+    return FALSE;
+}
+
+static int FeedbackGraphReachable(FeedbackGraph * g, size_t from, size_t to) {
+    size_t top = 0;
+
+    memset(g->state, 0, g->numNodes * sizeof(char));
+
+    g->state[from] = 1;
+    g->stack[top++] = from;
+
+    while (top > 0) {
+        size_t v = g->stack[--top];
+        size_t i = 0;
+
+        if (v == to) {
+            return TRUE;
+        }
+
+        for (i = g->outOffsets[v]; i < g->outOffsets[v + 1]; i++) {
+            size_t e = g->outEdges[i];
+            size_t w = g->edges[e].to;
+
+            if (!g->removed[e] && !g->state[w]) {
+                g->state[w] = 1;
+                g->stack[top++] = w;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Greedy ordering in the spirit of Eades, Lin and Smyth: sinks are placed
+ * at the end, sources at the front, otherwise the node with the largest
+ * difference of outgoing and incoming edge weights is placed at the front.
+ * Only nodes without incoming edges that are not removable are placed at
+ * the front, so all these edges point forward. Edges pointing backward
+ * are removed.
+ */
+static McxStatus FeedbackGraphGreedy(FeedbackGraph * g) {
+    size_t numNodes = g->numNodes;
+    size_t numEdges = g->numEdges;
+    FeedbackEdge * edges = g->edges;
+
+    size_t * inDeg = NULL;
+    size_t * outDeg = NULL;
+    size_t * fixedInDeg = NULL;
+    double * weightIn = NULL;
+    double * weightOut = NULL;
+    size_t * pos = NULL;
+    char * placed = NULL;
+
+    double heavy = 1.0;
+    size_t front = 0;
+    size_t back = numNodes;
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_ERROR;
+
+    inDeg = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    outDeg = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    fixedInDeg = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    weightIn = (double *) mcx_calloc(numNodes + 1, sizeof(double));
+    weightOut = (double *) mcx_calloc(numNodes + 1, sizeof(double));
+    pos = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    placed = (char *) mcx_calloc(numNodes + 1, sizeof(char));
+    if (!inDeg || !outDeg || !fixedInDeg || !weightIn || !weightOut || !pos || !placed) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        goto cleanup;
+    }
+
+    // edges that must not be removed weigh more than all others together
+    for (i = 0; i < numEdges; i++) {
+        if (edges[i].removable) {
+            heavy += (double) edges[i].cost;
+        }
+    }
+
+    for (i = 0; i < numEdges; i++) {
+        double weight = edges[i].removable ? (double) edges[i].cost : heavy;
+
+        // self-loops are always removed and do not influence the order
+        if (edges[i].from == edges[i].to) {
+            continue;
+        }
+
+        outDeg[edges[i].from]++;
+        weightOut[edges[i].from] += weight;
+        inDeg[edges[i].to]++;
+        weightIn[edges[i].to] += weight;
+        if (!edges[i].removable) {
+            fixedInDeg[edges[i].to]++;
+        }
+    }
+
+    while (front < back) {
+        size_t v = SIZE_T_ERROR;
+        int atBack = FALSE;
+
+        for (i = 0; i < numNodes; i++) {
+            if (!placed[i] && 0 == outDeg[i]) {
+                v = i;
+                atBack = TRUE;
+                break;
+            }
+        }
+
+        if (SIZE_T_ERROR == v) {
+            for (i = 0; i < numNodes; i++) {
+                if (!placed[i] && 0 == inDeg[i]) {
+                    v = i;
+                    break;
+                }
+            }
+        }
+
+        if (SIZE_T_ERROR == v) {
+            double maxDelta = 0.0;
+
+            for (i = 0; i < numNodes; i++) {
+                if (!placed[i] && 0 == fixedInDeg[i]) {
+                    double delta = weightOut[i] - weightIn[i];
+                    if (SIZE_T_ERROR == v || delta > maxDelta) {
+                        v = i;
+                        maxDelta = delta;
+                    }
+                }
+            }
+        }
+
+        if (SIZE_T_ERROR == v) {
+            mcx_log(LOG_ERROR, "Model: Loop breaking: Connections that must not be decoupled form a loop");
+            goto cleanup;
+        }
+
+        placed[v] = 1;
+        if (atBack) {
+            pos[v] = --back;
+        } else {
+            pos[v] = front++;
+        }
+
+        for (i = g->outOffsets[v]; i < g->outOffsets[v + 1]; i++) {
+            FeedbackEdge * edge = &edges[g->outEdges[i]];
+            if (edge->to != v && !placed[edge->to]) {
+                inDeg[edge->to]--;
+                weightIn[edge->to] -= edge->removable ? (double) edge->cost : heavy;
+                if (!edge->removable) {
+                    fixedInDeg[edge->to]--;
+                }
+            }
+        }
+        for (i = g->inOffsets[v]; i < g->inOffsets[v + 1]; i++) {
+            FeedbackEdge * edge = &edges[g->inEdges[i]];
+            if (edge->from != v && !placed[edge->from]) {
+                outDeg[edge->from]--;
+                weightOut[edge->from] -= edge->removable ? (double) edge->cost : heavy;
+            }
+        }
+    }
+
+    for (i = 0; i < numEdges; i++) {
+        g->removed[i] = pos[edges[i].from] >= pos[edges[i].to];
+    }
+
+    retVal = RETURN_OK;
+
+cleanup:
+    if (inDeg) { mcx_free(inDeg); }
+    if (outDeg) { mcx_free(outDeg); }
+    if (fixedInDeg) { mcx_free(fixedInDeg); }
+    if (weightIn) { mcx_free(weightIn); }
+    if (weightOut) { mcx_free(weightOut); }
+    if (pos) { mcx_free(pos); }
+    if (placed) { mcx_free(placed); }
+
+    return retVal;
+}
+
+static int FeedbackEdgeCompareCostDesc(const void * a, const void * b) {
+    const FeedbackEdge * edgeA = *(const FeedbackEdge * const *) a;
+    const FeedbackEdge * edgeB = *(const FeedbackEdge * const *) b;
+
+    return (edgeA->cost < edgeB->cost) - (edgeA->cost > edgeB->cost);
+}
+
+// puts removed edges back, most expensive first, as long as the graph stays acyclic
+static McxStatus FeedbackGraphMinimize(FeedbackGraph * g) {
+    FeedbackEdge ** candidates = NULL;
+    size_t numCandidates = 0;
+    size_t i = 0;
+
+    candidates = (FeedbackEdge **) mcx_calloc(g->numEdges + 1, sizeof(FeedbackEdge *));
+    if (!candidates) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < g->numEdges; i++) {
+        if (g->removed[i]) {
+            candidates[numCandidates++] = &g->edges[i];
+        }
+    }
+
+    qsort(candidates, numCandidates, sizeof(FeedbackEdge *), FeedbackEdgeCompareCostDesc);
+
+    for (i = 0; i < numCandidates; i++) {
+        FeedbackEdge * edge = candidates[i];
+        size_t e = (size_t) (edge - g->edges);
+
+        if (!FeedbackGraphReachable(g, edge->to, edge->from)) {
+            g->removed[e] = 0;
+        }
+    }
+
+    mcx_free(candidates);
+
+    return RETURN_OK;
+}
+
+// branches over the removable edges of a remaining cycle
+static McxStatus FeedbackGraphSearch(FeedbackGraph * g, FeedbackSearch * search, uint64_t cost) {
+    size_t * cycle = NULL;
+    size_t cycleLen = 0;
+    size_t numKept = 0;
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (search->expansions >= FEEDBACK_EDGES_MAX_EXPANSIONS) {
+        return RETURN_OK;
+    }
+    search->expansions++;
+
+    cycle = (size_t *) mcx_calloc(g->numNodes + 1, sizeof(size_t));
+    if (!cycle) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        return RETURN_ERROR;
+    }
+
+    if (!FeedbackGraphFindCycle(g, cycle, &cycleLen)) {
+        if (cost < search->bestCost) {
+            memcpy(search->best, g->removed, g->numEdges * sizeof(char));
+            search->bestCost = cost;
+        }
+        mcx_free(cycle);
+        return RETURN_OK;
+    }
+
+    for (i = 0; i < cycleLen; i++) {
+        size_t e = cycle[i];
+        FeedbackEdge * edge = &g->edges[e];
+
+        if (!edge->removable || search->keep[e]) {
+            continue;
+        }
+
+        if (cost + edge->cost < search->bestCost) {
+            g->removed[e] = 1;
+            retVal = FeedbackGraphSearch(g, search, cost + edge->cost);
+            g->removed[e] = 0;
+            if (RETURN_OK != retVal) {
+                break;
+            }
+        }
+
+        // the remaining branches keep this edge
+        search->keep[e] = 1;
+        cycle[numKept++] = e;
+    }
+
+    for (i = 0; i < numKept; i++) {
+        search->keep[cycle[i]] = 0;
+    }
+
+    mcx_free(cycle);
+
+    return retVal;
+}
+
+McxStatus FeedbackEdgesSelect(size_t numNodes, FeedbackEdge * edges, size_t numEdges, size_t maxExactEdges) {
+    FeedbackGraph g;
+    FeedbackSearch search;
+    size_t numRemovable = 0;
+    size_t cycleLen = 0;
+    size_t * cycle = NULL;
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_ERROR;
+
+    memset(&search, 0, sizeof(FeedbackSearch));
+
+    if (RETURN_OK != FeedbackGraphSetup(&g, numNodes, edges, numEdges)) {
+        goto cleanup;
+    }
+
+    cycle = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    if (!cycle) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        goto cleanup;
+    }
+
+    // without the removable edges the graph has to be acyclic
+    for (i = 0; i < numEdges; i++) {
+        g.removed[i] = (char) (edges[i].removable ? 1 : 0);
+        if (edges[i].removable) {
+            numRemovable++;
+        }
+    }
+    if (FeedbackGraphFindCycle(&g, cycle, &cycleLen)) {
+        mcx_log(LOG_ERROR, "Model: Loop breaking: Connections that must not be decoupled form a loop");
+        goto cleanup;
+    }
+
+    if (RETURN_OK != FeedbackGraphGreedy(&g)) {
+        goto cleanup;
+    }
+
+    if (RETURN_OK != FeedbackGraphMinimize(&g)) {
+        goto cleanup;
+    }
+
+    if (0 < numRemovable && numRemovable <= maxExactEdges) {
+        search.best = (char *) mcx_calloc(numEdges + 1, sizeof(char));
+        search.keep = (char *) mcx_calloc(numEdges + 1, sizeof(char));
+        if (!search.best || !search.keep) {
+            mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+            goto cleanup;
+        }
+
+        // the greedy solution is the first bound
+        memcpy(search.best, g.removed, numEdges * sizeof(char));
+        for (i = 0; i < numEdges; i++) {
+            if (g.removed[i]) {
+                search.bestCost += edges[i].cost;
+            }
+        }
+
+        memset(g.removed, 0, numEdges * sizeof(char));
+        if (RETURN_OK != FeedbackGraphSearch(&g, &search, 0)) {
+            goto cleanup;
+        }
+        if (search.expansions >= FEEDBACK_EDGES_MAX_EXPANSIONS) {
+            mcx_log(LOG_DEBUG, "Model: Loop breaking: Search limit reached, result may not be minimal");
+        }
+
+        memcpy(g.removed, search.best, numEdges * sizeof(char));
+    }
+
+    for (i = 0; i < numEdges; i++) {
+        edges[i].removed = g.removed[i] ? TRUE : FALSE;
+    }
+
+    retVal = RETURN_OK;
+
+cleanup:
+    if (cycle) { mcx_free(cycle); }
+    if (search.best) { mcx_free(search.best); }
+    if (search.keep) { mcx_free(search.keep); }
+    FeedbackGraphCleanup(&g);
+
+    return retVal;
+}
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
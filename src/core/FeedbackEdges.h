@@ -0,0 +1,48 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_CORE_FEEDBACK_EDGES_H
+#define MCX_CORE_FEEDBACK_EDGES_H
+
+#include "CentralParts.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct FeedbackEdge {
+    size_t from; // node index
+    size_t to;   // node index
+
+    int removable; // edge may be part of the feedback set
+    uint64_t cost; // cost of removing the edge
+
+    int removed; // output: edge is part of the feedback set
+} FeedbackEdge;
+
+/**
+ * Selects a set of edges with small total cost whose removal makes the
+ * graph acyclic and marks them as removed.
+ *
+ * The set is computed with a weighted greedy ordering heuristic and then
+ * reduced to a minimal set. If at most maxExactEdges edges are removable,
+ * a branch and bound search looks for the set with minimum cost.
+ *
+ * Returns RETURN_ERROR if the edges that are not removable form a cycle.
+ */
+McxStatus FeedbackEdgesSelect(size_t numNodes, FeedbackEdge * edges, size_t numEdges, size_t maxExactEdges);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_CORE_FEEDBACK_EDGES_H */
@@ -36,6 +36,10 @@
 #include "util/os.h"
 #include "util/time.h"
 
+#if defined (ENABLE_MT)
+#include "core/WorkerPool.h"
+#endif //ENABLE_MT
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -160,7 +164,7 @@ static McxStatus ModelPreprocessBinaryConnections(Model * model) {
 
     McxStatus retVal = RETURN_OK;
 
-    if (task->stepTypeType != STEP_TYPE_SEQUENTIAL) {
+    if (task->stepTypeType != STEP_TYPE_SEQUENTIAL && task->stepTypeType != STEP_TYPE_SEQUENTIAL_MT) {
         return RETURN_OK;
     }
 
@@ -378,6 +382,14 @@ static McxStatus ModelConnectionsDone(Model * model) {
         model->components,
         RUNTIME_DEPENDENCIES);
 
+    // decouple the loops as in the cached run of this model
+    if (model->cache) {
+        retVal = model->cache->ApplyDecoupling(model->cache, model->connections);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+    }
+
     // Strict Model
     orderedNodes = CreateOrderedNodes(model->subModelGenerator, RUNTIME_DEPENDENCIES, FALSE);
     if (!orderedNodes) {
@@ -396,7 +408,8 @@ static McxStatus ModelConnectionsDone(Model * model) {
     while (OrderedNodesCheckIfLoopsExist(orderedNodes)) {
         i += 1; /* num iterations */
 
-        retVal = OrderedNodesDecoupleConnections(orderedNodes, model->components);
+        retVal = OrderedNodesDecoupleConnections(orderedNodes, model->subModelGenerator->graph, model->components,
+                                                  model->config->loopBreakingExactSize);
         if (retVal != RETURN_OK) {
             mcx_log(LOG_ERROR, "Model: Unable to decouple algebraic loop in iteration %d", i);
             goto cleanup;
@@ -428,6 +441,13 @@ static McxStatus ModelConnectionsDone(Model * model) {
         retVal = model->subModelGenerator->PrintNodeMap(model->subModelGenerator, orderedNodes, RUNTIME_DEPENDENCIES);
     }
 
+    if (model->cache && (i > 0 || !model->cache->IsHit(model->cache))) {
+        retVal = model->cache->Store(model->cache, model->connections);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+    }
+
     model->subModel = model->subModelGenerator->CreateSubModelOfAllNodes(model->subModelGenerator, orderedNodes);
     if (NULL == model->subModel) {
         mcx_log(LOG_ERROR, "Model: Could not create runtime submodel");
@@ -500,6 +520,9 @@ static void ModelDestructor(void * self) {
     }
 
     object_destroy(model->components);
+    if (model->readTimes) {
+        mcx_free(model->readTimes);
+    }
     object_destroy(model->connections);
     object_destroy(model->factory);
 
@@ -510,11 +533,106 @@ static void ModelDestructor(void * self) {
 
 }
 
+/* state of the per-element jobs of the read and setup phases */
+typedef struct ComponentJobs {
+    Model * model;
+    ObjectContainer * inputs;       // read: ComponentInputs
+    ObjectContainer * components;   // setup: elements to set up
+    Component * leaveOutComponent;  // setup: element that is not set up
+
+    Component ** comps;             // read: created elements
+    McxStatus * status;
+    double * times;                 // wall time per element
+} ComponentJobs;
+
+typedef McxStatus (* fComponentJob)(void * ctx, size_t item, size_t worker);
+
+static double SecondsSince(McxTime * start) {
+    McxTime end, diff;
+
+    mcx_time_get(&end);
+    mcx_time_diff(start, &end, &diff);
+
+    return mcx_time_to_seconds(&diff);
+}
+
+/*
+ * Runs job for all elements. The elements are processed by numThreads
+ * threads (0: number of processors) if multi-threading is enabled, the
+ * results are collected in ctx per element so that the caller can report
+ * them in the order of the elements. A sequential run stops at the first
+ * failing element. The status of each element has to be initialized to
+ * RETURN_ERROR, so that elements whose job did not run are not taken as
+ * successful.
+ */
+static McxStatus RunComponentJobs(size_t numItems, fComponentJob job, void * ctx, size_t numThreads) {
+    size_t i = 0;
+
+#if defined (ENABLE_MT)
+    if (0 == numThreads) {
+        numThreads = mcx_thread_get_num_cpus();
+    }
+    if (numThreads > numItems) {
+        numThreads = numItems;
+    }
+
+    if (numThreads > 1) {
+        WorkerPool * pool = (WorkerPool *) object_create(WorkerPool);
+        McxStatus retVal = RETURN_OK;
+
+        if (!pool) {
+            mcx_log(LOG_ERROR, "Model: Could not create worker pool");
+            return RETURN_ERROR;
+        }
+
+        retVal = pool->Setup(pool, numThreads);
+        if (RETURN_OK == retVal) {
+            mcx_log(LOG_DEBUG, "Model: Processing %zu elements on %zu threads", numItems, numThreads);
+            // failures of single jobs are reported per element
+            pool->Run(pool, numItems, job, ctx);
+        } else {
+            mcx_log(LOG_ERROR, "Model: Could not create worker threads");
+        }
+
+        // joins the worker threads
+        object_destroy(pool);
+
+        return retVal;
+    }
+#endif //ENABLE_MT
+
+    for (i = 0; i < numItems; i++) {
+        if (RETURN_ERROR == job(ctx, i, 0)) {
+            break;
+        }
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus ReadComponentJob(void * ctx, size_t item, size_t worker) {
+    ComponentJobs * jobs = (ComponentJobs *) ctx;
+    Model * model = jobs->model;
+    ComponentInput * componentInput = (ComponentInput *) jobs->inputs->At(jobs->inputs, item);
+    McxTime start;
+
+    mcx_time_get(&start);
+
+    jobs->comps[item] = CreateComponentFromComponentInput(model->factory, componentInput, item, model->config);
+    jobs->status[item] = jobs->comps[item] ? RETURN_OK : RETURN_ERROR;
+
+    jobs->times[item] = SecondsSince(&start);
+
+    return jobs->status[item];
+}
+
 static McxStatus ModelReadComponents(void * self, ComponentsInput * input) {
     Model * model = (Model *) self;
 
     ObjectContainer * comps = model->components;
 
+    ComponentJobs jobs;
+
     size_t i = 0;
 
     size_t numComps = input->components->Size(input->components);
@@ -522,37 +640,80 @@ static McxStatus ModelReadComponents(void * self, ComponentsInput * input) {
 
     mcx_log(LOG_INFO, "Reading model elements");
 
-    // loop over all components here
+    memset(&jobs, 0, sizeof(jobs));
+    jobs.model = model;
+    jobs.inputs = input->components;
+    jobs.comps = (Component **) mcx_calloc(numComps + 1, sizeof(Component *));
+    jobs.status = (McxStatus *) mcx_calloc(numComps + 1, sizeof(McxStatus));
+    if (model->readTimes) {
+        mcx_free(model->readTimes);
+    }
+    model->readTimes = (double *) mcx_calloc(numComps + 1, sizeof(double));
+    if (!jobs.comps || !jobs.status || !model->readTimes) {
+        mcx_log(LOG_ERROR, "Model: Memory allocation for elements failed");
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+    jobs.times = model->readTimes;
     for (i = 0; i < numComps; i++) {
-        Component * comp = NULL;
-        ComponentInput * componentInput = (ComponentInput *) input->components->At(input->components, i);
-        InputElement * componentElement = (InputElement *) componentInput;
+        jobs.status[i] = RETURN_ERROR;
+    }
 
-        comp = CreateComponentFromComponentInput(model->factory, componentInput, i, model->config);
-        if (NULL == comp) { // error message in function
-            return RETURN_ERROR;
+    // unpacking and parsing the elements is independent of each other
+    retVal = RunComponentJobs(numComps, ReadComponentJob, &jobs, model->config->numSetupThreads);
+    if (RETURN_ERROR == retVal) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < numComps; i++) {
+        if (RETURN_ERROR == jobs.status[i] || !jobs.comps[i]) {
+            ComponentInput * componentInput = (ComponentInput *) input->components->At(input->components, i);
+            mcx_log(LOG_ERROR, "Model: Reading element %s failed", componentInput->name ? componentInput->name : "");
+            retVal = RETURN_ERROR;
+            goto cleanup;
         }
+    }
+
+    // add the elements in the order of the input
+    for (i = 0; i < numComps; i++) {
+        Component * comp = jobs.comps[i];
+
+        jobs.comps[i] = NULL;
         comp->SetModel(comp, model);
 
         // Finished reading component, add to list
         retVal = comps->PushBack(comps, (Object *) comp);
         if (RETURN_ERROR == retVal) {
             mcx_log(LOG_ERROR, "Model: Adding component to component list failed");
-            return RETURN_ERROR;
+            object_destroy(comp);
+            goto cleanup;
         }
 
         // add the name of the component to the string list
         retVal = comps->SetElementName(comps, i, comp->GetName(comp));
         if (RETURN_ERROR == retVal) {
             mcx_log(LOG_ERROR, "Model: Adding component name to component list failed");
-            return RETURN_ERROR;
+            goto cleanup;
         }
     }
 
     mcx_log(LOG_INFO, "Read %d elements", numComps);
     mcx_log(LOG_INFO, " ");
 
-    return RETURN_OK;
+cleanup:
+    if (jobs.comps) {
+        for (i = 0; i < numComps; i++) {
+            if (jobs.comps[i]) {
+                object_destroy(jobs.comps[i]);
+            }
+        }
+        mcx_free(jobs.comps);
+    }
+    if (jobs.status) {
+        mcx_free(jobs.status);
+    }
+
+    return retVal;
 }
 
 McxStatus ReadConnections(ObjectContainer * connections,
@@ -640,7 +801,7 @@ static McxStatus ModelMakeConnections(Model * model) {
 
     InterExtrapolatingType isInterExtrapolating = INTERPOLATING;
 
-    if (STEP_TYPE_SEQUENTIAL == type) {
+    if (STEP_TYPE_SEQUENTIAL == type || STEP_TYPE_SEQUENTIAL_MT == type) {
         isInterExtrapolating = INTERPOLATING;
     } else {
         isInterExtrapolating = EXTRAPOLATING;
@@ -909,30 +1070,131 @@ static McxStatus SetupOneComponent(Component * comp) {
     return retVal;
 }
 
-McxStatus SetupComponents(ObjectContainer * components, Component * leaveOutComponent) {
+static McxStatus SetupComponentJob(void * ctx, size_t item, size_t worker) {
+    ComponentJobs * jobs = (ComponentJobs *) ctx;
+    Component * comp = (Component *) jobs->components->At(jobs->components, item);
+    McxTime start;
+
+    if (comp == jobs->leaveOutComponent) {
+        jobs->status[item] = RETURN_OK;
+        return RETURN_OK;
+    }
+
+    mcx_time_get(&start);
+
+    jobs->status[item] = SetupOneComponent(comp);
+
+    jobs->times[item] = SecondsSince(&start);
+
+    return jobs->status[item];
+}
+
+McxStatus SetupComponents(ObjectContainer * components, Component * leaveOutComponent, size_t numThreads, double * setupTimes) {
+    ComponentJobs jobs;
+    size_t numComps = components->Size(components);
     size_t i = 0;
     McxStatus retVal = RETURN_OK;
 
-    // loop over all components here
-    for (i = 0; i < components->Size(components); i++) {
-        Component * comp = (Component *) components->At(components, i);
+    memset(&jobs, 0, sizeof(jobs));
+    jobs.components = components;
+    jobs.leaveOutComponent = leaveOutComponent;
+    jobs.status = (McxStatus *) mcx_calloc(numComps + 1, sizeof(McxStatus));
+    jobs.times = setupTimes ? setupTimes : (double *) mcx_calloc(numComps + 1, sizeof(double));
+    if (!jobs.status || !jobs.times) {
+        mcx_log(LOG_ERROR, "Model: Memory allocation for elements failed");
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+    for (i = 0; i < numComps; i++) {
+        jobs.status[i] = RETURN_ERROR;
+    }
 
-        if (comp != leaveOutComponent) {
-            McxStatus status = SetupOneComponent(comp);
+    // instantiating the elements is independent of each other
+    retVal = RunComponentJobs(numComps, SetupComponentJob, &jobs, numThreads);
+    if (RETURN_ERROR == retVal) {
+        goto cleanup;
+    }
 
-            if (RETURN_ERROR == status) {
-                return RETURN_ERROR;
-            } else if (RETURN_WARNING == status) {
-                if (RETURN_ERROR != retVal) {
-                    retVal = status;
-                }
-            }
+    // report in the order of the elements
+    for (i = 0; i < numComps; i++) {
+        if (RETURN_ERROR == jobs.status[i]) {
+            retVal = RETURN_ERROR;
+            break;
+        } else if (RETURN_WARNING == jobs.status[i]) {
+            retVal = RETURN_WARNING;
         }
     }
 
+cleanup:
+    if (jobs.status) {
+        mcx_free(jobs.status);
+    }
+    if (jobs.times && jobs.times != setupTimes) {
+        mcx_free(jobs.times);
+    }
+
     return retVal;
 }
 
+typedef struct ComponentSetupTime {
+    size_t id;
+    double time;
+} ComponentSetupTime;
+
+static int CompareSetupTimes(const void * a, const void * b) {
+    const ComponentSetupTime * first = (const ComponentSetupTime *) a;
+    const ComponentSetupTime * second = (const ComponentSetupTime *) b;
+
+    if (first->time > second->time) {
+        return -1;
+    } else if (first->time < second->time) {
+        return 1;
+    }
+
+    // stable order for equal times
+    return (first->id > second->id) - (first->id < second->id);
+}
+
+#define MAX_NUM_LOGGED_SETUP_TIMES 5
+
+// Logs the wall time of reading and setting up each element and the slowest ones
+static void ModelLogSetupTimes(Model * model, double * setupTimes) {
+    ObjectContainer * comps = model->components;
+    size_t numComps = comps->Size(comps);
+    ComponentSetupTime * times = NULL;
+    size_t i = 0;
+
+    if (0 == numComps) {
+        return;
+    }
+
+    times = (ComponentSetupTime *) mcx_calloc(numComps, sizeof(ComponentSetupTime));
+    if (!times) {
+        return;
+    }
+
+    mcx_log(LOG_DEBUG, "Element setup times (Wall-Time):");
+    for (i = 0; i < numComps; i++) {
+        Component * comp = (Component *) comps->At(comps, i);
+        double readTime = model->readTimes ? model->readTimes[i] : 0.;
+
+        times[i].id = i;
+        times[i].time = readTime + setupTimes[i];
+
+        mcx_log(LOG_DEBUG, "  %s: read %.3fs, setup %.3fs", comp->GetName(comp), readTime, setupTimes[i]);
+    }
+
+    qsort(times, numComps, sizeof(ComponentSetupTime), CompareSetupTimes);
+
+    mcx_log(LOG_INFO, "Slowest elements to set up (Wall-Time):");
+    for (i = 0; i < numComps && i < MAX_NUM_LOGGED_SETUP_TIMES; i++) {
+        Component * comp = (Component *) comps->At(comps, times[i].id);
+        mcx_log(LOG_INFO, "  %s: %.3fs", comp->GetName(comp), times[i].time);
+    }
+
+    mcx_free(times);
+}
+
 McxStatus SetupDatabusComponents(ObjectContainer * components) {
     Component * comp = NULL;
     size_t i = 0;
@@ -966,6 +1228,8 @@ McxStatus SetupDatabusComponents(ObjectContainer * components) {
 static McxStatus ModelSetup(void * self) {
     Model * model = (Model *) self;
 
+    double * setupTimes = NULL;
+
     McxStatus retVal = RETURN_OK;
 
     mcx_log(LOG_DEBUG, "Checking model connections");
@@ -978,13 +1242,24 @@ static McxStatus ModelSetup(void * self) {
 
     mcx_log(LOG_INFO, "Setting up model elements");
 
+    setupTimes = (double *) mcx_calloc(model->components->Size(model->components) + 1, sizeof(double));
+    if (!setupTimes) {
+        mcx_log(LOG_ERROR, "Model: Memory allocation for setup times failed");
+        return RETURN_ERROR;
+    }
+
     retVal = SetupComponents(model->components
                              , NULL
+                             , model->config->numSetupThreads
+                             , setupTimes
         );
     if (RETURN_ERROR == retVal) {
         mcx_log(LOG_ERROR, "Model: Setting up model elements failed");
+        mcx_free(setupTimes);
         return RETURN_ERROR;
     }
+    ModelLogSetupTimes(model, setupTimes);
+    mcx_free(setupTimes);
     mcx_log(LOG_INFO, " ");
 
     mcx_log(LOG_INFO, "Setting up data bus of model elements");
@@ -1447,6 +1722,10 @@ static void ModelSetComponentFactory(Model * model, ComponentFactory * factory)
     model->factory = factory;
 }
 
+static void ModelSetModelCache(Model * model, ModelCache * cache) {
+    model->cache = cache;
+}
+
 static Task * ModelGetTask(Model * model) {
     return model->task;
 }
@@ -1463,13 +1742,16 @@ static Model * ModelCreate(Model * model) {
     model->SetConfig = ModelSetConfig;
     model->SetTask   = ModelSetTask;
     model->SetComponentFactory = ModelSetComponentFactory;
+    model->SetModelCache = ModelSetModelCache;
 
     model->GetTask = ModelGetTask;
 
     // set to default values
     model->components = (ObjectContainer *) object_create(ObjectContainer);
+    model->readTimes = NULL;
     model->connections = (ObjectContainer *) object_create(ObjectContainer);
     model->factory = NULL;
+    model->cache = NULL;
 
     model->config = NULL;
     model->task = NULL;
@@ -17,6 +17,7 @@
 #include "core/Task.h"
 #include "core/Component.h"
 #include "core/SubModel.h"
+#include "core/ModelCache.h"
 #include "reader/model/ModelInput.h"
 #include "components/ComponentFactory.h"
 
@@ -42,6 +43,7 @@ typedef McxStatus (* fModelInitialize)(Model * model);
 typedef void (* fModelSetTask)(Model * model, Task * task);
 typedef void (* fModelSetConfig)(Model * model, Config * config);
 typedef void (* fModelSetComponentFactory)(Model * model, ComponentFactory * factory);
+typedef void (* fModelSetModelCache)(Model * model, ModelCache * cache);
 
 typedef Task * (* fModelGetTask)(Model * model);
 
@@ -58,6 +60,7 @@ struct Model {
     fModelSetConfig SetConfig;
     fModelSetTask   SetTask;
     fModelSetComponentFactory SetComponentFactory;
+    fModelSetModelCache SetModelCache;
     fModelGetTask GetTask;
 
     Config * config;
@@ -66,9 +69,12 @@ struct Model {
     ObjectContainer * connections;
 
     ObjectContainer * components;
+    double * readTimes; // wall time of reading each element in seconds, in order of components
 
     ComponentFactory * factory;
 
+    ModelCache * cache; // not owned, may be NULL
+
     SubModelGenerator * subModelGenerator;
     SubModelGenerator * initialSubModelGenerator;
 
@@ -83,7 +89,7 @@ McxStatus ReadConnections(ObjectContainer * connections,
                           Component * sourceComp,
                           Component * targetComp);
 
-McxStatus SetupComponents(ObjectContainer * components, Component * leaveOutComponent);
+McxStatus SetupComponents(ObjectContainer * components, Component * leaveOutComponent, size_t numThreads, double * setupTimes);
 McxStatus SetupDatabusComponents(ObjectContainer * components);
 
 McxStatus MakeConnections(ObjectContainer * connections, InterExtrapolatingType isInterExtrapolating);
@@ -0,0 +1,516 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "core/ModelCache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/connections/ConnectionInfo.h"
+#include "reader/model/components/specific_data/FmuInput.h"
+#include "util/md5.h"
+#include "util/md5_file.h"
+#include "util/os.h"
+#include "util/paths.h"
+#include "util/string.h"
+#include "version.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define MODEL_CACHE_HEADER "mcx model cache 2"
+#define MODEL_CACHE_EXTENSION ".mcxcache"
+
+// an FMU element of the model
+typedef struct ModelCacheFmu {
+    const char * name;
+    const char * path;
+    char * fingerprint;
+    int ownsFingerprint; // FMUs with the same path share the fingerprint
+} ModelCacheFmu;
+
+static int ModelCacheCompareStrings(const void * a, const void * b) {
+    return strcmp(*(const char * const *) a, *(const char * const *) b);
+}
+
+static int ModelCacheCompareFmuPaths(const void * a, const void * b) {
+    return strcmp((*(const ModelCacheFmu * const *) a)->path, (*(const ModelCacheFmu * const *) b)->path);
+}
+
+// reads one line without the line break, returns FALSE at the end of the file
+static int ModelCacheReadLine(FILE * file, char ** line, size_t * size) {
+    size_t len = 0;
+
+    if (!*line) {
+        *size = 256;
+        *line = (char *) mcx_malloc(*size);
+        if (!*line) {
+            return FALSE;
+        }
+    }
+
+    while (fgets(*line + len, (int) (*size - len), file)) {
+        len += strlen(*line + len);
+        if (len > 0 && '\n' == (*line)[len - 1]) {
+            break;
+        }
+        if (len + 1 == *size) {
+            char * bigger = (char *) mcx_realloc(*line, 2 * *size);
+            if (!bigger) {
+                return FALSE;
+            }
+            *line = bigger;
+            *size = 2 * *size;
+        }
+    }
+
+    if (0 == len) {
+        return FALSE;
+    }
+
+    while (len > 0 && ('\n' == (*line)[len - 1] || '\r' == (*line)[len - 1])) {
+        (*line)[--len] = '\0';
+    }
+
+    return TRUE;
+}
+
+static void ModelCacheClearEntries(ModelCache * cache) {
+    size_t i = 0;
+
+    if (cache->decoupled) {
+        for (i = 0; i < cache->numDecoupled; i++) {
+            mcx_free(cache->decoupled[i]);
+        }
+        mcx_free(cache->decoupled);
+        cache->decoupled = NULL;
+    }
+    cache->numDecoupled = 0;
+
+    if (cache->cachedFmuFingerprint) {
+        mcx_free(cache->cachedFmuFingerprint);
+        cache->cachedFmuFingerprint = NULL;
+    }
+
+    cache->modelValidated = FALSE;
+}
+
+static McxStatus ModelCacheReadFile(ModelCache * cache, FILE * file) {
+    char * line = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+    int lineNr = 0;
+    int complete = FALSE;
+    int stale = FALSE;
+
+    McxStatus retVal = RETURN_OK;
+
+    while (ModelCacheReadLine(file, &line, &size)) {
+        lineNr++;
+
+        if (1 == lineNr) {
+            if (strcmp(line, MODEL_CACHE_HEADER)) {
+                break;
+            }
+        } else if (2 == lineNr) {
+            if (strncmp(line, "model ", 6) || strcmp(line + 6, cache->modelFingerprint)) {
+                break;
+            }
+        } else if (3 == lineNr) {
+            if (strncmp(line, "build ", 6) || strcmp(line + 6, cache->buildFingerprint)) {
+                stale = TRUE;
+                break;
+            }
+        } else if (4 == lineNr) {
+            if (strncmp(line, "fmus ", 5)) {
+                break;
+            }
+            cache->cachedFmuFingerprint = mcx_string_copy(line + 5);
+            if (!cache->cachedFmuFingerprint) {
+                retVal = RETURN_ERROR;
+                break;
+            }
+        } else if (!strncmp(line, "decoupled ", 10)) {
+            if (cache->numDecoupled == capacity) {
+                size_t newCapacity = capacity ? 2 * capacity : 16;
+                char ** decoupled = (char **) mcx_realloc(cache->decoupled, newCapacity * sizeof(char *));
+                if (!decoupled) {
+                    retVal = RETURN_ERROR;
+                    break;
+                }
+                cache->decoupled = decoupled;
+                capacity = newCapacity;
+            }
+            cache->decoupled[cache->numDecoupled] = mcx_string_copy(line + 10);
+            if (!cache->decoupled[cache->numDecoupled]) {
+                retVal = RETURN_ERROR;
+                break;
+            }
+            cache->numDecoupled++;
+        } else if (!strcmp(line, "end")) {
+            complete = TRUE;
+            break;
+        } else {
+            break;
+        }
+    }
+
+    if (line) {
+        mcx_free(line);
+    }
+
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Model cache: Not enough memory to read %s", cache->path);
+        ModelCacheClearEntries(cache);
+        return RETURN_ERROR;
+    }
+
+    if (stale) {
+        mcx_log(LOG_INFO, "Model cache: Ignoring %s of another mcx build or configuration", cache->path);
+        ModelCacheClearEntries(cache);
+        return RETURN_OK;
+    }
+
+    if (!complete) {
+        mcx_log(LOG_WARNING, "Model cache: Ignoring invalid cache file %s", cache->path);
+        ModelCacheClearEntries(cache);
+        return RETURN_OK;
+    }
+
+    if (cache->numDecoupled > 0) {
+        qsort(cache->decoupled, cache->numDecoupled, sizeof(char *), ModelCacheCompareStrings);
+    }
+    cache->modelValidated = TRUE;
+
+    return RETURN_OK;
+}
+
+static McxStatus ModelCacheLoad(ModelCache * cache, Config * config) {
+    char sizeString[32];
+    char * fileName = NULL;
+    FILE * file = NULL;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (!config->modelCacheDir) {
+        return RETURN_OK;
+    }
+
+    cache->modelFingerprint = mcx_md5_file_fingerprint(config->modelFile);
+    if (!cache->modelFingerprint) {
+        mcx_log(LOG_WARNING, "Model cache: Could not read %s, caching disabled", config->modelFile);
+        return RETURN_OK;
+    }
+
+    // the schema and the loop breaking depend on the build and on the configuration
+    snprintf(sizeString, sizeof(sizeString), "%zu", config->loopBreakingExactSize);
+    cache->buildFingerprint = mcx_string_merge(3, __mcx_git_repository_id__, " loop-breaking-exact-size ", sizeString);
+    if (!cache->buildFingerprint) {
+        return RETURN_ERROR;
+    }
+
+    if (!mcx_os_path_exists(config->modelCacheDir)) {
+        if (RETURN_OK != mcx_os_mkdir_recursive(config->modelCacheDir)) {
+            mcx_log(LOG_WARNING, "Model cache: Could not create %s, caching disabled", config->modelCacheDir);
+            return RETURN_OK;
+        }
+    }
+
+    fileName = mcx_string_merge(2, cache->modelFingerprint, MODEL_CACHE_EXTENSION);
+    if (!fileName) {
+        return RETURN_ERROR;
+    }
+
+    cache->path = mcx_path_join(config->modelCacheDir, fileName);
+    mcx_free(fileName);
+    if (!cache->path) {
+        return RETURN_ERROR;
+    }
+
+    file = mcx_os_fopen(cache->path, "r");
+    if (!file) {
+        mcx_log(LOG_DEBUG, "Model cache: No cache file %s", cache->path);
+        return RETURN_OK;
+    }
+
+    retVal = ModelCacheReadFile(cache, file);
+    mcx_os_fclose(file);
+
+    if (cache->modelValidated) {
+        mcx_log(LOG_INFO, "Model cache: Using %s", cache->path);
+    }
+
+    return retVal;
+}
+
+// computes the fingerprint of each FMU, FMUs with the same path are read once
+static McxStatus ModelCacheFingerprintFmus(ModelCacheFmu * fmus, size_t numFmus) {
+    ModelCacheFmu ** sorted = NULL;
+    size_t i = 0;
+
+    if (0 == numFmus) {
+        return RETURN_OK;
+    }
+
+    sorted = (ModelCacheFmu **) mcx_calloc(numFmus, sizeof(ModelCacheFmu *));
+    if (!sorted) {
+        return RETURN_ERROR;
+    }
+    for (i = 0; i < numFmus; i++) {
+        sorted[i] = &fmus[i];
+    }
+    qsort(sorted, numFmus, sizeof(ModelCacheFmu *), ModelCacheCompareFmuPaths);
+
+    for (i = 0; i < numFmus; i++) {
+        if (i > 0 && !strcmp(sorted[i]->path, sorted[i - 1]->path)) {
+            sorted[i]->fingerprint = sorted[i - 1]->fingerprint;
+        } else {
+            sorted[i]->fingerprint = mcx_md5_file_fingerprint(sorted[i]->path);
+            sorted[i]->ownsFingerprint = TRUE;
+        }
+    }
+
+    mcx_free(sorted);
+
+    return RETURN_OK;
+}
+
+static McxStatus ModelCacheCheckInput(ModelCache * cache, ModelInput * input) {
+    ObjectContainer * components = input->components->components;
+    ModelCacheFmu * fmus = NULL;
+    size_t numFmus = 0;
+    MD5_CTX context;
+    unsigned char digest[16];
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (!cache->path) {
+        return RETURN_OK;
+    }
+
+    fmus = (ModelCacheFmu *) mcx_calloc(components->Size(components) + 1, sizeof(ModelCacheFmu));
+    if (!fmus) {
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < components->Size(components); i++) {
+        ComponentInput * component = (ComponentInput *) components->At(components, i);
+        FmuInput * fmuInput = NULL;
+
+        if (!object_same_type(ComponentTypeFmu, component->type)) {
+            continue;
+        }
+
+        fmuInput = (FmuInput *) component;
+        if (!fmuInput->fmuFile) {
+            mcx_log(LOG_DEBUG, "Model cache: Could not read FMU of %s", component->name);
+            goto cleanup;
+        }
+
+        fmus[numFmus].name = component->name;
+        fmus[numFmus].path = fmuInput->fmuFile;
+        numFmus++;
+    }
+
+    retVal = ModelCacheFingerprintFmus(fmus, numFmus);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+
+    mcx_md5_init(&context);
+
+    for (i = 0; i < numFmus; i++) {
+        if (!fmus[i].fingerprint) {
+            mcx_log(LOG_DEBUG, "Model cache: Could not read FMU of %s", fmus[i].name);
+            goto cleanup;
+        }
+
+        mcx_md5_update(&context, fmus[i].name, (unsigned long) strlen(fmus[i].name) + 1);
+        mcx_md5_update(&context, fmus[i].fingerprint, (unsigned long) strlen(fmus[i].fingerprint) + 1);
+    }
+
+    mcx_md5_final(digest, &context);
+
+    cache->fmuFingerprint = (char *) mcx_calloc(16 * 2 + 1, sizeof(char));
+    if (!cache->fmuFingerprint) {
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+    for (i = 0; i < 16; i++) {
+        snprintf(cache->fmuFingerprint + 2 * i, 3, "%02x", digest[i]);
+    }
+
+    cache->hit = cache->modelValidated
+        && cache->cachedFmuFingerprint
+        && !strcmp(cache->cachedFmuFingerprint, cache->fmuFingerprint);
+
+    if (cache->modelValidated && !cache->hit) {
+        mcx_log(LOG_INFO, "Model cache: FMUs changed, model build results are not reused");
+    }
+
+cleanup:
+    for (i = 0; i < numFmus; i++) {
+        if (fmus[i].ownsFingerprint && fmus[i].fingerprint) {
+            mcx_free(fmus[i].fingerprint);
+        }
+    }
+    mcx_free(fmus);
+
+    return retVal;
+}
+
+static int ModelCacheIsEnabled(ModelCache * cache) {
+    return NULL != cache->path;
+}
+
+static int ModelCacheIsModelValidated(ModelCache * cache) {
+    return cache->modelValidated;
+}
+
+static int ModelCacheIsHit(ModelCache * cache) {
+    return cache->hit;
+}
+
+static McxStatus ModelCacheApplyDecoupling(ModelCache * cache, ObjectContainer * connections) {
+    size_t numApplied = 0;
+    size_t i = 0;
+
+    if (!cache->hit || 0 == cache->numDecoupled) {
+        return RETURN_OK;
+    }
+
+    for (i = 0; i < connections->Size(connections); i++) {
+        ConnectionInfo * info = (ConnectionInfo *) connections->At(connections, i);
+        char * connStr = NULL;
+
+        if (info->IsDecoupled(info) || DECOUPLE_NEVER == info->GetDecoupleType(info)) {
+            continue;
+        }
+
+        connStr = info->ConnectionString(info);
+        if (!connStr) {
+            continue;
+        }
+
+        if (bsearch(&connStr, cache->decoupled, cache->numDecoupled, sizeof(char *), ModelCacheCompareStrings)) {
+            mcx_log(LOG_INFO, "Decoupling connection %s (cached)", connStr);
+            info->SetDecoupled(info);
+            numApplied++;
+        }
+
+        mcx_free(connStr);
+    }
+
+    mcx_log(LOG_INFO, "Model cache: Decoupled %zu connections", numApplied);
+
+    return RETURN_OK;
+}
+
+static McxStatus ModelCacheStore(ModelCache * cache, ObjectContainer * connections) {
+    char pidString[32];
+    char * tmpPath = NULL;
+    FILE * file = NULL;
+    int failed = FALSE;
+    size_t i = 0;
+
+    if (!cache->path || !cache->fmuFingerprint) {
+        return RETURN_OK;
+    }
+
+    // unique name, concurrent runs of the same model replace the file atomically
+    snprintf(pidString, sizeof(pidString), ".%ld.tmp", mcx_os_get_pid());
+    tmpPath = mcx_string_merge(2, cache->path, pidString);
+    if (!tmpPath) {
+        return RETURN_ERROR;
+    }
+
+    file = mcx_os_fopen(tmpPath, "w");
+    if (!file) {
+        mcx_log(LOG_WARNING, "Model cache: Could not write %s", tmpPath);
+        mcx_free(tmpPath);
+        return RETURN_OK;
+    }
+
+    failed |= fprintf(file, "%s\nmodel %s\nbuild %s\nfmus %s\n", MODEL_CACHE_HEADER,
+                      cache->modelFingerprint, cache->buildFingerprint, cache->fmuFingerprint) < 0;
+
+    for (i = 0; i < connections->Size(connections) && !failed; i++) {
+        ConnectionInfo * info = (ConnectionInfo *) connections->At(connections, i);
+        char * connStr = NULL;
+
+        if (!info->IsDecoupled(info)) {
+            continue;
+        }
+
+        connStr = info->ConnectionString(info);
+        if (connStr && !strchr(connStr, '\n')) {
+            failed |= fprintf(file, "decoupled %s\n", connStr) < 0;
+        }
+        if (connStr) {
+            mcx_free(connStr);
+        }
+    }
+
+    failed |= fprintf(file, "end\n") < 0;
+    failed |= 0 != mcx_os_fclose(file);
+
+    if (failed || 0 != mcx_os_rename(tmpPath, cache->path)) {
+        mcx_log(LOG_WARNING, "Model cache: Could not write %s", cache->path);
+        remove(tmpPath);
+    } else {
+        mcx_log(LOG_DEBUG, "Model cache: Wrote %s", cache->path);
+    }
+
+    mcx_free(tmpPath);
+
+    return RETURN_OK;
+}
+
+static void ModelCacheDestructor(ModelCache * cache) {
+    ModelCacheClearEntries(cache);
+
+    if (cache->path) { mcx_free(cache->path); }
+    if (cache->modelFingerprint) { mcx_free(cache->modelFingerprint); }
+    if (cache->buildFingerprint) { mcx_free(cache->buildFingerprint); }
+    if (cache->fmuFingerprint) { mcx_free(cache->fmuFingerprint); }
+}
+
+static ModelCache * ModelCacheCreate(ModelCache * cache) {
+    cache->Load = ModelCacheLoad;
+    cache->CheckInput = ModelCacheCheckInput;
+    cache->IsEnabled = ModelCacheIsEnabled;
+    cache->IsModelValidated = ModelCacheIsModelValidated;
+    cache->IsHit = ModelCacheIsHit;
+    cache->ApplyDecoupling = ModelCacheApplyDecoupling;
+    cache->Store = ModelCacheStore;
+
+    cache->path = NULL;
+
+    cache->modelFingerprint = NULL;
+    cache->buildFingerprint = NULL;
+    cache->fmuFingerprint = NULL;
+
+    cache->modelValidated = FALSE;
+    cache->hit = FALSE;
+
+    cache->cachedFmuFingerprint = NULL;
+    cache->decoupled = NULL;
+    cache->numDecoupled = 0;
+
+    return cache;
+}
+
+OBJECT_CLASS(ModelCache, Object);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
@@ -0,0 +1,79 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_CORE_MODEL_CACHE_H
+#define MCX_CORE_MODEL_CACHE_H
+
+#include "CentralParts.h"
+#include "core/Config.h"
+#include "objects/ObjectContainer.h"
+#include "reader/model/ModelInput.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Remembers results of the model build for later runs of the same model.
+ *
+ * The cache file in the directory MC_MODEL_CACHE_DIR is named after the md5
+ * of the model file and records the mcx build, the configuration the loop
+ * breaking depends on and the md5 of all FMUs of the model. If the model
+ * file and the build match, its schema validation is skipped. If the FMUs match
+ * too, the connections decoupled by loop breaking are decoupled right away.
+ */
+typedef struct ModelCache ModelCache;
+
+typedef McxStatus (* fModelCacheLoad)(ModelCache * cache, Config * config);
+typedef McxStatus (* fModelCacheCheckInput)(ModelCache * cache, ModelInput * input);
+typedef int (* fModelCacheGetFlag)(ModelCache * cache);
+typedef McxStatus (* fModelCacheApplyDecoupling)(ModelCache * cache, ObjectContainer * connections);
+typedef McxStatus (* fModelCacheStore)(ModelCache * cache, ObjectContainer * connections);
+
+extern const struct ObjectClass _ModelCache;
+
+struct ModelCache {
+    Object _; // base class
+
+    // reads the cache file of the model file if caching is enabled
+    fModelCacheLoad Load;
+
+    // compares the FMUs of input with the cache file
+    fModelCacheCheckInput CheckInput;
+
+    fModelCacheGetFlag IsEnabled;
+    fModelCacheGetFlag IsModelValidated; // cache file belongs to the model file
+    fModelCacheGetFlag IsHit; // cache file belongs to the model file and its FMUs
+
+    // decouples the connections (ConnectionInfo) decoupled in the cached run
+    fModelCacheApplyDecoupling ApplyDecoupling;
+
+    // writes the cache file with the decoupled connections (ConnectionInfo)
+    fModelCacheStore Store;
+
+    char * path; // cache file, NULL if caching is disabled
+
+    char * modelFingerprint;
+    char * buildFingerprint; // mcx build and configuration
+    char * fmuFingerprint; // NULL if the FMUs could not be read
+
+    int modelValidated;
+    int hit;
+
+    char * cachedFmuFingerprint;
+    char ** decoupled; // sorted connection strings
+    size_t numDecoupled;
+};
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_CORE_MODEL_CACHE_H */
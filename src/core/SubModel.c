@@ -9,9 +9,12 @@
  ********************************************************************************/
 
 #include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 #include "CentralParts.h"
 #include "core/SubModel.h"
+#include "core/FeedbackEdges.h"
 #include "core/Component.h"
 #include "core/connections/Connection.h"
 #include "core/Databus.h"
@@ -156,22 +159,6 @@ static McxStatus SubModelGeneratorSetComponents(SubModelGenerator * subModelGene
     return RETURN_OK;
 }
 
-static size_t SubModelGeneratorGetNodeID(SubModelGenerator * subModelGenerator, Component * comp, size_t group) {
-    ObjectContainer * nodes = subModelGenerator->nodeMap;
-
-    size_t i;
-
-    for (i = 0; i < nodes->Size(nodes); i++) {
-        CompAndGroup * compAndGroup = (CompAndGroup *) nodes->At(nodes, i);
-
-        if (compAndGroup->comp == comp && compAndGroup->group == group) {
-            return i;
-        }
-    }
-
-    return SIZE_T_ERROR;
-}
-
 static CompAndGroup * SubModelGeneratorGetCompAndGroup(SubModelGenerator * subModelGenerator, size_t nodeID) {
     ObjectContainer * nodes = subModelGenerator->nodeMap;
 
@@ -394,129 +381,262 @@ static int SubModelIsElement(SubModel * subModel, const Component * comp) {
 }
 
 // only need to consider DECOUPLE_IFNEEDED since DECOUPLE_ALWAYS is handled at connection->Setup()
-McxStatus OrderedNodesDecoupleConnections(OrderedNodes * orderedNodes, ObjectContainer * comps) {
-    size_t i; size_t k;
+// connections from one element to another, decoupled together
+typedef struct LoopBundle {
+    Component * fromComp;
+    Component * toComp;
+    ObjectContainer * connections;
+} LoopBundle;
+
+static void LoopBundleEvaluate(LoopBundle * bundle, FeedbackEdge * edge, int * priority) {
+    Component * fromComp = bundle->fromComp;
+    Component * toComp = bundle->toComp;
+    ObjectContainer * connections = bundle->connections;
+    size_t numCoupled = 0;
+    size_t k = 0;
+
+    edge->removable = TRUE;
+    *priority = -1;
+
+    // check if all connections are decoupleable and get priority
+    for (k = 0; k < connections->Size(connections); k++) {
+        Connection * conn = (Connection *) connections->At(connections, k);
+        ConnectionInfo * info = conn->GetInfo(conn);
+
+        if (info->IsDecoupled(info)) {
+            continue;
+        }
 
-    size_t numNodes = 0;
-    size_t numGroups = orderedNodes->size;
-    NodeGroup * group = NULL;
+        numCoupled++;
 
-    for (i = 0; i < numGroups; i++) {
-        group = orderedNodes->groups[i];
-        numNodes += group->nodes.size;
+        if (fromComp->GetSequenceNumber(fromComp) > toComp->GetSequenceNumber(toComp)) {
+            *priority = INT_MAX; // ordering by components takes priority
+            break;
+        } else if (info->GetDecoupleType(info) == DECOUPLE_IFNEEDED) {
+            if (info->GetDecouplePriority(info) > *priority) {
+                *priority = info->GetDecouplePriority(info);
+            }
+        } else if (info->GetDecoupleType(info) == DECOUPLE_NEVER) {
+            // if a connection in this bundle set to never decouple, discard this bundle
+            edge->removable = FALSE;
+        }
     }
 
-    if (comps->Size(comps) != numNodes) {
-        mcx_log(LOG_ERROR, "Model: Calculated %d nodes, expected %d", numNodes, comps->Size(comps));
+    if (0 == numCoupled) {
+        edge->removable = FALSE;
+    }
+
+    // cost without priorities, see OrderedNodesDecoupleLoop
+    edge->cost = numCoupled;
+}
+
+static McxStatus LoopBundleDecouple(LoopBundle * bundle) {
+    ObjectContainer * connections = bundle->connections;
+    size_t k = 0;
+
+    if (0 == connections->Size(connections)) {
+        mcx_log(LOG_ERROR, "Model: No connection from %s to %s", bundle->fromComp->GetName(bundle->fromComp), bundle->toComp->GetName(bundle->toComp));
         return RETURN_ERROR;
     }
 
-    // get edges to decouple
-    for (i = 0; i < numGroups; i++) {
-        group = orderedNodes->groups[i];
-        if (group->isLoop) {
-            size_t decoupleFrom = SIZE_T_ERROR, decoupleTo = SIZE_T_ERROR;
-            int decouplePriority = -1;
-            size_t ii = 0, jj = 0;
-
-            for (ii = 0; ii < group->nodes.size && decouplePriority < INT_MAX; ii++) {
-                for (jj = 0; jj < group->nodes.size && decouplePriority < INT_MAX; jj++) {
-                    int localDecouplePriority = -1;
-                    ObjectContainer * connections = NULL;
-                    Component * fromComp = (Component *) comps->At(comps, group->nodes.values[ii]);
-                    Component * toComp = (Component *) comps->At(comps, group->nodes.values[jj]);
-
-                    // consistency check
-                    if (fromComp->GetID(fromComp) != group->nodes.values[ii] || toComp->GetID(toComp) != group->nodes.values[jj]) {
-                        mcx_log(LOG_ERROR, "Model: Elements need to be ordered by ID");
-                        return RETURN_ERROR;
-                    }
+    // set all connections decoupled
+    for (k = 0; k < connections->Size(connections); k++) {
+        Connection * conn = (Connection *) connections->At(connections, k);
+        ConnectionInfo * info = conn->GetInfo(conn);
 
-                    connections = fromComp->GetConnections(fromComp, toComp);
-                    if (!connections) {
-                        mcx_log(LOG_ERROR, "Model: Could not get connections from %s to %s", fromComp->GetName(fromComp), toComp->GetName(toComp));
-                        return RETURN_ERROR;
-                    } else if (0 == connections->Size(connections)) {
-                        mcx_log(LOG_DEBUG, "no connection %s -> %s", fromComp->GetName(fromComp), toComp->GetName(toComp));
-                    }
+        char * connStr = info->ConnectionString(info);
+        mcx_log(LOG_INFO, "Decoupling connection %s", connStr);
+        mcx_free(connStr);
 
-                    // check if all connections are decoupleable and get priority
-                    for (k = 0; k < connections->Size(connections); k++) {
-                        Connection * conn = (Connection *) connections->At(connections, k);
-                        ConnectionInfo    * info = conn->GetInfo(conn);
+        info->SetDecoupled(info);
+    }
 
-                        if (info->IsDecoupled(info)) {
-                            continue;
-                        }
+    return RETURN_OK;
+}
 
-                        if (fromComp->GetSequenceNumber(fromComp) > toComp->GetSequenceNumber(toComp)) {
-                            localDecouplePriority = INT_MAX; // ordering by components takes priority
-                            break;
-                        } else if (info->GetDecoupleType(info) == DECOUPLE_IFNEEDED) {
-                            if (info->GetDecouplePriority(info) > localDecouplePriority) {
-                                localDecouplePriority = info->GetDecouplePriority(info);
-                            }
-                        } else if (info->GetDecoupleType(info) == DECOUPLE_NEVER) {
-                            // if a connection in this bundle set to never decouple, discard this bundle
-                            localDecouplePriority = -1;
-                            break;
-                        }
-                    }
+/**
+ * Decouples a small set of connection bundles so that no loop remains in
+ * the group. The cost of decoupling a bundle is its number of connections,
+ * weighted so that bundles with a higher decouple priority are cheaper.
+ * Bundles against the trigger sequence cost nothing.
+ */
+static McxStatus OrderedNodesDecoupleLoop(NodeGroup * group, TarjanGraph * graph, ObjectContainer * comps, size_t * localIndex, size_t maxExactEdges) {
+    size_t numNodes = group->nodes.size;
+    size_t numEdges = 0;
+    size_t numDecoupled = 0;
+    size_t i = 0;
+    size_t e = 0;
 
-                    if (localDecouplePriority > decouplePriority) {
-                        decoupleFrom = ii; decoupleTo = jj;
-                        decouplePriority = localDecouplePriority;
-                    } else {
-                        // not highest priority
-                    }
+    FeedbackEdge * edges = NULL;
+    LoopBundle * bundles = NULL;
+    int * priorities = NULL;
+    size_t * lastFrom = NULL; // per node: 1 + source of the last edge to the node
+    int maxPriority = 0;
 
-                    object_destroy(connections);
-                }
+    McxStatus retVal = RETURN_ERROR;
+
+    for (i = 0; i < numNodes; i++) {
+        localIndex[group->nodes.values[i]] = i;
+    }
+
+    // graph edges within the group, there is at most one edge per pair of nodes
+    for (i = 0; i < numNodes; i++) {
+        size_t node = group->nodes.values[i];
+        numEdges += graph->offsets[node + 1] - graph->offsets[node];
+    }
+
+    edges = (FeedbackEdge *) mcx_calloc(numEdges + 1, sizeof(FeedbackEdge));
+    bundles = (LoopBundle *) mcx_calloc(numEdges + 1, sizeof(LoopBundle));
+    priorities = (int *) mcx_calloc(numEdges + 1, sizeof(int));
+    lastFrom = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    if (!edges || !bundles || !priorities || !lastFrom) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        goto cleanup;
+    }
+
+    numEdges = 0;
+    for (i = 0; i < numNodes; i++) {
+        size_t node = group->nodes.values[i];
+
+        for (e = graph->offsets[node]; e < graph->offsets[node + 1]; e++) {
+            size_t target = graph->targets[e];
+
+            if (SIZE_T_ERROR == localIndex[target] || i + 1 == lastFrom[localIndex[target]]) {
+                continue;
             }
+            lastFrom[localIndex[target]] = i + 1;
 
-            // decouple connection with highest priority
-            if (decoupleFrom != SIZE_T_ERROR && decoupleTo != SIZE_T_ERROR) {
-                ObjectContainer * connections = NULL;
-                Component * fromComp = (Component *) comps->At(comps, group->nodes.values[decoupleFrom]);
-                Component * toComp = (Component *) comps->At(comps, group->nodes.values[decoupleTo]);
+            bundles[numEdges].fromComp = (Component *) comps->At(comps, node);
+            bundles[numEdges].toComp = (Component *) comps->At(comps, target);
 
-                // consistency check
-                if (fromComp->GetID(fromComp) != group->nodes.values[decoupleFrom] || toComp->GetID(toComp) != group->nodes.values[decoupleTo]) {
-                    mcx_log(LOG_ERROR, "Model: Elements need to be ordered by ID");
-                    return RETURN_ERROR;
-                }
+            // consistency check
+            if (bundles[numEdges].fromComp->GetID(bundles[numEdges].fromComp) != node
+                || bundles[numEdges].toComp->GetID(bundles[numEdges].toComp) != target) {
+                mcx_log(LOG_ERROR, "Model: Elements need to be ordered by ID");
+                goto cleanup;
+            }
 
-                connections = fromComp->GetConnections(fromComp, toComp);
-                if (!connections) {
-                    mcx_log(LOG_ERROR, "Model: Could not get connections from %s to %s", fromComp->GetName(fromComp), toComp->GetName(toComp));
-                    return RETURN_ERROR;
-                }
-                if (0 == connections->Size(connections)) {
-                    mcx_log(LOG_ERROR, "Model: No connection from %s to %s", fromComp->GetName(fromComp), toComp->GetName(toComp));
-                    return RETURN_ERROR;
-                }
+            bundles[numEdges].connections = bundles[numEdges].fromComp->GetConnections(bundles[numEdges].fromComp, bundles[numEdges].toComp);
+            if (!bundles[numEdges].connections) {
+                mcx_log(LOG_ERROR, "Model: Could not get connections from %s to %s",
+                    bundles[numEdges].fromComp->GetName(bundles[numEdges].fromComp),
+                    bundles[numEdges].toComp->GetName(bundles[numEdges].toComp));
+                goto cleanup;
+            }
 
-                // set all connections decoupled
-                for (k = 0; k < connections->Size(connections); k++) {
-                    Connection * conn = (Connection *) connections->At(connections, k);
-                    ConnectionInfo * info = conn->GetInfo(conn);
+            edges[numEdges].from = i;
+            edges[numEdges].to = localIndex[target];
 
-                    char * connStr = info->ConnectionString(info);
-                    mcx_log(LOG_INFO, "Decoupling connection %s", connStr);
-                    mcx_free(connStr);
+            LoopBundleEvaluate(&bundles[numEdges], &edges[numEdges], &priorities[numEdges]);
 
-                    info->SetDecoupled(info);
-                }
+            if (edges[numEdges].removable && INT_MAX != priorities[numEdges] && priorities[numEdges] > maxPriority) {
+                maxPriority = priorities[numEdges];
+            }
 
-                object_destroy(connections);
-            } else {
-                mcx_log(LOG_ERROR, "Model: No connection can be decoupled");
-                // in this group, no bundle can be decoupled
-                return RETURN_ERROR;
+            numEdges++;
+        }
+    }
+
+    for (e = 0; e < numEdges; e++) {
+        if (INT_MAX == priorities[e]) {
+            edges[e].cost = 0;
+        } else if (priorities[e] >= 0) {
+            edges[e].cost *= (uint64_t) (maxPriority - priorities[e]) + 1;
+        } else {
+            edges[e].cost *= (uint64_t) maxPriority + 1;
+        }
+    }
+
+    if (RETURN_OK != FeedbackEdgesSelect(numNodes, edges, numEdges, maxExactEdges)) {
+        mcx_log(LOG_ERROR, "Model: No connection can be decoupled");
+        goto cleanup;
+    }
+
+    for (e = 0; e < numEdges; e++) {
+        if (edges[e].removed) {
+            if (RETURN_OK != LoopBundleDecouple(&bundles[e])) {
+                goto cleanup;
             }
+            numDecoupled++;
         }
     }
-    return RETURN_OK;
+
+    if (0 == numDecoupled) {
+        mcx_log(LOG_ERROR, "Model: No connection can be decoupled");
+        goto cleanup;
+    }
+
+    retVal = RETURN_OK;
+
+cleanup:
+    for (i = 0; i < numNodes; i++) {
+        localIndex[group->nodes.values[i]] = SIZE_T_ERROR;
+    }
+
+    if (bundles) {
+        for (e = 0; e < numEdges; e++) {
+            if (bundles[e].connections) {
+                object_destroy(bundles[e].connections);
+            }
+        }
+        mcx_free(bundles);
+    }
+    if (edges) {
+        mcx_free(edges);
+    }
+    if (priorities) {
+        mcx_free(priorities);
+    }
+    if (lastFrom) {
+        mcx_free(lastFrom);
+    }
+
+    return retVal;
+}
+
+McxStatus OrderedNodesDecoupleConnections(OrderedNodes * orderedNodes, TarjanGraph * graph, ObjectContainer * comps, size_t maxExactEdges) {
+    size_t i;
+
+    size_t numNodes = 0;
+    size_t numGroups = orderedNodes->size;
+    NodeGroup * group = NULL;
+    size_t * localIndex = NULL;
+
+    McxStatus retVal = RETURN_OK;
+
+    for (i = 0; i < numGroups; i++) {
+        group = orderedNodes->groups[i];
+        numNodes += group->nodes.size;
+    }
+
+    if (comps->Size(comps) != numNodes || !graph || graph->n != numNodes) {
+        mcx_log(LOG_ERROR, "Model: Calculated %d nodes, expected %d", numNodes, comps->Size(comps));
+        return RETURN_ERROR;
+    }
+
+    localIndex = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    if (!localIndex) {
+        mcx_log(LOG_ERROR, "Model: Not enough memory for loop breaking");
+        return RETURN_ERROR;
+    }
+    for (i = 0; i < numNodes; i++) {
+        localIndex[i] = SIZE_T_ERROR;
+    }
+
+    // break all loops at once
+    for (i = 0; i < numGroups; i++) {
+        group = orderedNodes->groups[i];
+        if (group->isLoop) {
+            retVal = OrderedNodesDecoupleLoop(group, graph, comps, localIndex, maxExactEdges);
+            if (RETURN_OK != retVal) {
+                break;
+            }
+        }
+    }
+
+    mcx_free(localIndex);
+
+    return retVal;
 }
 
 static void SubModelGeneratorDestructor(SubModelGenerator * subModelGenerator) {
@@ -535,8 +655,8 @@ static void SubModelGeneratorDestructor(SubModelGenerator * subModelGenerator) {
         object_destroy(subModelGenerator->componentsList);
     }
 
-    if (NULL != subModelGenerator->deps) {
-        DependenciesDestroy(subModelGenerator->deps);
+    if (NULL != subModelGenerator->graph) {
+        tarjan_graph_cleanup(subModelGenerator->graph);
     }
 }
 
@@ -559,7 +679,7 @@ static SubModelGenerator * SubModelGeneratorCreate(SubModelGenerator * subModel)
         return NULL;
     }
 
-    subModel->deps = NULL;
+    subModel->graph = NULL;
 
     return subModel;
 }
@@ -618,14 +738,115 @@ static size_t GetNodeID(ObjectContainer * comps, size_t compId) {
     return SIZE_T_ERROR;
 }
 
-static struct Dependencies * SubModelGeneratorCreateDependencyMatrix(SubModelGenerator * subModelGenerator, DependencyType depType) {
+// range of nodes of one component in the node map
+typedef struct {
+    Component * comp;
+    size_t firstNode;
+    size_t numNodes;
+} NodeMapEntry;
+
+static int NodeMapEntryCompare(const void * a, const void * b) {
+    uintptr_t compA = (uintptr_t) ((const NodeMapEntry *) a)->comp;
+    uintptr_t compB = (uintptr_t) ((const NodeMapEntry *) b)->comp;
+
+    return (compA > compB) - (compA < compB);
+}
+
+// the nodes of each component are consecutive in the node map (see
+// SubModelGeneratorFillNodeMap), the table is sorted by component
+static NodeMapEntry * SubModelGeneratorCreateNodeTable(SubModelGenerator * subModelGenerator, size_t * numEntries) {
+    ObjectContainer * nodes = subModelGenerator->nodeMap;
+    size_t numNodes = nodes->Size(nodes);
+    NodeMapEntry * entries = NULL;
+    size_t num = 0;
+    size_t i = 0;
+
+    entries = (NodeMapEntry *) mcx_calloc(numNodes + 1, sizeof(NodeMapEntry));
+    if (!entries) {
+        return NULL;
+    }
+
+    for (i = 0; i < numNodes; i++) {
+        CompAndGroup * compAndGroup = (CompAndGroup *) nodes->At(nodes, i);
+
+        if (0 == num || entries[num - 1].comp != compAndGroup->comp) {
+            entries[num].comp = compAndGroup->comp;
+            entries[num].firstNode = i;
+            entries[num].numNodes = 0;
+            num++;
+        }
+        entries[num - 1].numNodes++;
+    }
+
+    qsort(entries, num, sizeof(NodeMapEntry), NodeMapEntryCompare);
+
+    *numEntries = num;
+
+    return entries;
+}
+
+static size_t SubModelGeneratorGetNodeID(NodeMapEntry * entries, size_t numEntries, Component * comp, size_t group) {
+    NodeMapEntry key;
+    NodeMapEntry * entry = NULL;
+
+    key.comp = comp;
+    entry = (NodeMapEntry *) bsearch(&key, entries, numEntries, sizeof(NodeMapEntry), NodeMapEntryCompare);
+
+    if (!entry || group >= entry->numNodes) {
+        return SIZE_T_ERROR;
+    }
+
+    return entry->firstNode + group;
+}
+
+typedef struct {
+    size_t num;
+    size_t capacity;
+
+    size_t * sources;
+    size_t * targets;
+} DependencyEdges;
+
+static McxStatus DependencyEdgesAdd(DependencyEdges * edges, size_t source, size_t target) {
+    if (edges->num == edges->capacity) {
+        size_t capacity = edges->capacity ? 2 * edges->capacity : 64;
+        size_t * sources = NULL;
+        size_t * targets = NULL;
+
+        sources = (size_t *) mcx_realloc(edges->sources, capacity * sizeof(size_t));
+        if (!sources) {
+            return RETURN_ERROR;
+        }
+        edges->sources = sources;
+
+        targets = (size_t *) mcx_realloc(edges->targets, capacity * sizeof(size_t));
+        if (!targets) {
+            return RETURN_ERROR;
+        }
+        edges->targets = targets;
+
+        edges->capacity = capacity;
+    }
+
+    edges->sources[edges->num] = source;
+    edges->targets[edges->num] = target;
+    edges->num++;
+
+    return RETURN_OK;
+}
+
+// graph with an edge from each node to the nodes that depend on it
+static TarjanGraph * SubModelGeneratorCreateDependencyGraph(SubModelGenerator * subModelGenerator, DependencyType depType) {
     size_t numNodes = subModelGenerator->nodeMap->Size(subModelGenerator->nodeMap);
     McxStatus retVal = RETURN_OK;
     size_t targetNode;
 
-    // init dependency matrix
-    struct Dependencies * A = DependenciesCreate(numNodes, numNodes);
-    if (!A) {
+    TarjanGraph * graph = NULL;
+    DependencyEdges edges = { 0, 0, NULL, NULL };
+
+    size_t numEntries = 0;
+    NodeMapEntry * entries = SubModelGeneratorCreateNodeTable(subModelGenerator, &numEntries);
+    if (!entries) {
         return NULL;
     }
 
@@ -654,9 +875,9 @@ static struct Dependencies * SubModelGeneratorCreateDependencyMatrix(SubModelGen
             Dependency dependency = DEP_INDEPENDENT;
             retVal = GetDependency(targetCompDependency, targetInChannelID, targetGroup, &dependency);
             if (RETURN_ERROR == retVal) {
-                mcx_log(LOG_ERROR, "GetDependency failed in SubModelGeneratorCreateDependencyMatrix");
-                mcx_free(A);
-                return NULL;
+                mcx_log(LOG_ERROR, "GetDependency failed in SubModelGeneratorCreateDependencyGraph");
+                DependenciesDestroy(targetCompDependency);
+                goto cleanup;
             }
 
             if (INITIAL_DEPENDENCIES == depType) {
@@ -698,7 +919,7 @@ static struct Dependencies * SubModelGeneratorCreateDependencyMatrix(SubModelGen
                         sourceOutGroup = sourceComp->GetOutGroup(sourceComp, info->GetSourceChannelID(info));
                     }
 
-                    sourceNode = SubModelGeneratorGetNodeID(subModelGenerator, sourceComp, sourceOutGroup);
+                    sourceNode = SubModelGeneratorGetNodeID(entries, numEntries, sourceComp, sourceOutGroup);
 
                     if (SIZE_T_ERROR == sourceNode) {
                         // source is not part of this submodel
@@ -718,11 +939,11 @@ static struct Dependencies * SubModelGeneratorCreateDependencyMatrix(SubModelGen
                             }
                         }
                     }
-                    retVal = SetDependency(A, sourceNode, targetNode, DEP_DEPENDENT);
+                    retVal = DependencyEdgesAdd(&edges, sourceNode, targetNode);
                     if (RETURN_ERROR == retVal) {
-                        mcx_log(LOG_ERROR, "SetDependency failed in SubModelGeneratorCreateDependencyMatrix");
-                        mcx_free(A);
-                        return NULL;
+                        mcx_log(LOG_ERROR, "Adding a dependency failed in SubModelGeneratorCreateDependencyGraph");
+                        DependenciesDestroy(targetCompDependency);
+                        goto cleanup;
                     }
 
                     if (0 == numOutChannels && (INITIAL_DEPENDENCIES == depType) ) {
@@ -742,7 +963,18 @@ static struct Dependencies * SubModelGeneratorCreateDependencyMatrix(SubModelGen
         }
     }
 
-    return A;
+    graph = tarjan_graph_create(numNodes, edges.sources, edges.targets, edges.num);
+
+cleanup:
+    if (edges.sources) {
+        mcx_free(edges.sources);
+    }
+    if (edges.targets) {
+        mcx_free(edges.targets);
+    }
+    mcx_free(entries);
+
+    return graph;
 }
 
 OrderedNodes * CreateOrderedNodes(SubModelGenerator * subModelGenerator, DependencyType depType, int cutNodes) {
@@ -750,26 +982,35 @@ OrderedNodes * CreateOrderedNodes(SubModelGenerator * subModelGenerator, Depende
     OrderedNodes * orderedNodes = NULL;
     McxStatus retVal = RETURN_OK;
     int statusFlag = 0;
-    struct Dependencies * A = NULL;
+    TarjanGraph * graph = NULL;
+    TarjanGraph * dependencies = NULL;
 
     size_t numAllNodes = nodes->Size(nodes);
     if (numAllNodes <= 0) {
         mcx_log(LOG_WARNING, "Model: No outports in elements");
     }
 
-    A = SubModelGeneratorCreateDependencyMatrix(subModelGenerator, depType);
-    if (!A) {
-        mcx_log(LOG_ERROR, "Model: Could not object_create dependency matrix");
+    graph = SubModelGeneratorCreateDependencyGraph(subModelGenerator, depType);
+    if (!graph) {
+        mcx_log(LOG_ERROR, "Model: Could not create dependency graph");
         return NULL;
     }
 
-    if (subModelGenerator->deps) {
-        DependenciesDestroy(subModelGenerator->deps);
+    if (subModelGenerator->graph) {
+        tarjan_graph_cleanup(subModelGenerator->graph);
     }
 
-    subModelGenerator->deps = A;
+    subModelGenerator->graph = graph;
+
+    // each node points to the nodes it depends on, so that these come first
+    dependencies = tarjan_graph_transpose(graph);
+    if (!dependencies) {
+        mcx_log(LOG_ERROR, "Model: Could not create dependency graph");
+        return NULL;
+    }
 
-    orderedNodes = tarjan((int *) GetDependencyMatrix(A), (int) numAllNodes);
+    orderedNodes = tarjan_graph(dependencies);
+    tarjan_graph_cleanup(dependencies);
 
     if (!orderedNodes) {
         mcx_log(LOG_ERROR, "Model: Tarjan Error");
@@ -92,14 +92,14 @@ struct SubModelGenerator {
 
     ObjectContainer * componentsList; // contains Component
 
-    struct Dependencies * deps;
+    TarjanGraph * graph; // dependencies of the last CreateOrderedNodes, edges from source to target
 };
 
 ObjectContainer * GetEvaluationListOfAllNodes(SubModelGenerator * subModelGenerator);
 
 OrderedNodes * CreateOrderedNodes(SubModelGenerator * subModelGenerator, DependencyType depType, int cutNodes);
 int OrderedNodesCheckIfLoopsExist(OrderedNodes * nodes);
-McxStatus OrderedNodesDecoupleConnections(OrderedNodes * nodes, ObjectContainer * components);
+McxStatus OrderedNodesDecoupleConnections(OrderedNodes * nodes, TarjanGraph * graph, ObjectContainer * components, size_t maxExactEdges);
 
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
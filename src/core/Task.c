@@ -14,12 +14,14 @@
 #include "steptypes/StepTypeParallelST.h"
 #include "steptypes/StepTypeParallelMT.h"
 #include "steptypes/StepTypeSequential.h"
+#include "steptypes/StepTypeSequentialMT.h"
 #include "core/Databus.h"
 #include "core/channels/Channel.h"
 
 #include "util/compare.h"
 #include "util/signals.h"
 #include "util/os.h"
+#include "util/string.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -122,8 +124,17 @@ static McxStatus TaskInitialize(Task * task, Model * model) {
 
     task->storage->StoreModelOut(task->storage, model->subModel, stepParams->time, STORE_SYNCHRONIZATION);
     task->storage->StoreModelLocal(task->storage, model->subModel, stepParams->time, STORE_SYNCHRONIZATION);
+    retVal = task->storage->Synchronized(task->storage, stepParams->time);
+    if (RETURN_ERROR == retVal) {
+        mcx_log(LOG_ERROR, "Synchronization of result storage failed during initialization");
+        return RETURN_ERROR;
+    }
 
-    task->stepType->Configure(task->stepType, stepParams, subModel);
+    retVal = task->stepType->Configure(task->stepType, stepParams, subModel);
+    if (RETURN_ERROR == retVal) {
+        mcx_log(LOG_ERROR, "Configuration of coupling method failed");
+        return RETURN_ERROR;
+    }
 
     return RETURN_OK;
 }
@@ -155,15 +166,23 @@ static McxStatus TaskRun(Task * task, Model * model) {
         stepParams->numSteps++;
         stepParams->time = stepParams->timeEndStep;    // advance time
 
+        status = task->storage->Synchronized(task->storage, stepParams->time);
     }
 
     task->finishState.aComponentFinished = stepParams->aComponentFinished;
     task->finishState.errorOccurred = status == RETURN_ERROR;
+    task->finishState.numInputSets = 0;
+    task->finishState.numSkippedInputSets = 0;
     retVal = task->stepType->Finish(task->stepType, stepParams, subModel, &task->finishState);
     if (RETURN_ERROR == retVal) {
         status = RETURN_ERROR;
     }
 
+    if (task->finishState.numInputSets > 0) {
+        mcx_log(LOG_INFO, "Skipped %zu of %zu input sets of unchanged values of FMU elements",
+                task->finishState.numSkippedInputSets, task->finishState.numInputSets);
+    }
+
     retVal = task->storage->Finished(task->storage);
     if (RETURN_ERROR == retVal) {
         status = RETURN_ERROR;
@@ -226,6 +245,26 @@ static McxStatus TaskRead(Task * task, TaskInput * taskInput) {
         mcx_log(LOG_DEBUG, "  Using summation for time calculation");
     }
 
+    task->params->numThreads = taskInput->numThreads.defined ? taskInput->numThreads.value : 0;
+    if (task->config && task->config->numThreadsDefined) {
+        task->params->numThreads = task->config->numThreads;
+    }
+
+    if (task->config && task->config->cpuList) {
+        task->params->cpuList = mcx_string_copy(task->config->cpuList);
+    } else if (taskInput->cpuList) {
+        task->params->cpuList = mcx_string_copy(taskInput->cpuList);
+    }
+
+    // pinned workers keep their elements by default
+    if (taskInput->scheduler.defined) {
+        task->params->scheduler = taskInput->scheduler.value;
+    } else if (task->params->cpuList) {
+        task->params->scheduler = STEP_TYPE_SCHEDULER_STATIC;
+    } else {
+        task->params->scheduler = STEP_TYPE_SCHEDULER_SHARED_QUEUE;
+    }
+
     task->stepTypeType = taskInput->stepType;
     switch(task->stepTypeType) {
     case STEP_TYPE_PARALLEL_ST:
@@ -233,10 +272,34 @@ static McxStatus TaskRead(Task * task, TaskInput * taskInput) {
         break;
     case STEP_TYPE_PARALLEL_MT:
         mcx_log(LOG_INFO, "  Type: Parallel (one time step) Co-simulation");
+        if (task->params->numThreads > 0) {
+            mcx_log(LOG_INFO, "  Worker threads: %zu", task->params->numThreads);
+        } else {
+            mcx_log(LOG_INFO, "  Worker threads: number of processors");
+        }
+        if (task->params->cpuList) {
+            mcx_log(LOG_INFO, "  Worker processors: %s", task->params->cpuList);
+        }
+        if (task->params->scheduler == STEP_TYPE_SCHEDULER_WORK_STEALING) {
+            mcx_log(LOG_INFO, "  Scheduler: work stealing");
+        } else if (task->params->scheduler == STEP_TYPE_SCHEDULER_STATIC) {
+            mcx_log(LOG_INFO, "  Scheduler: static");
+        }
         break;
     case STEP_TYPE_SEQUENTIAL:
         mcx_log(LOG_INFO, "  Type: Sequential Co-simulation");
         break;
+    case STEP_TYPE_SEQUENTIAL_MT:
+        mcx_log(LOG_INFO, "  Type: Sequential (multithreaded) Co-simulation");
+        if (task->params->numThreads > 0) {
+            mcx_log(LOG_INFO, "  Worker threads: %zu", task->params->numThreads);
+        } else {
+            mcx_log(LOG_INFO, "  Worker threads: number of processors");
+        }
+        if (task->params->cpuList) {
+            mcx_log(LOG_INFO, "  Worker processors: %s", task->params->cpuList);
+        }
+        break;
     default:
         /* this should not happen */
         mcx_log(LOG_ERROR, "Invalid coupling method");
@@ -291,10 +354,16 @@ static McxStatus TaskSetup(Task * task, Model * model) {
     case STEP_TYPE_PARALLEL_MT:
         task->stepType = (StepType *) object_create(StepTypeParallelMT);
         break;
+    case STEP_TYPE_SEQUENTIAL_MT:
+        task->stepType = (StepType *) object_create(StepTypeSequentialMT);
+        break;
 #else //not ENABLE_MT
     case STEP_TYPE_PARALLEL_MT:
         task->stepType = (StepType *) object_create(StepTypeParallelST);
         break;
+    case STEP_TYPE_SEQUENTIAL_MT:
+        task->stepType = (StepType *) object_create(StepTypeSequential);
+        break;
 #endif //not ENABLE_MT
     default:
         mcx_log(LOG_ERROR, "Invalid coupling method");
@@ -380,6 +449,8 @@ static Task * TaskCreate(Task * task) {
     task->finishState.aComponentFinished = FALSE;
     task->finishState.stopIfFirstComponentFinished = FALSE;
     task->finishState.errorOccurred = FALSE;
+    task->finishState.numInputSets = 0;
+    task->finishState.numSkippedInputSets = 0;
 
     return task;
 }
@@ -0,0 +1,592 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#include "core/WorkerPool.h"
+#include "util/stdlib.h"
+#include "util/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// number of polls before a waiting thread goes to sleep
+#define WORKER_POOL_SPIN_COUNT 4000
+
+// weight of the latest measurement in the smoothed job costs
+#define WORKER_POOL_COST_SMOOTHING 0.25
+
+static int WorkerPoolSpinWhileEquals(McxAtomic * atomic, int32_t value) {
+    size_t i = 0;
+
+    for (i = 0; i < WORKER_POOL_SPIN_COUNT; i++) {
+        if (mcx_atomic_load(atomic) != value) {
+            return TRUE;
+        }
+        mcx_cpu_relax();
+    }
+
+    return FALSE;
+}
+
+static void WorkerPoolExecute(WorkerPool * pool, size_t item, size_t worker) {
+    WorkerPoolWorker * w = &pool->workers[worker];
+    McxTime start, end, diff;
+    double time = 0.;
+
+    mcx_time_get(&start);
+    if (RETURN_ERROR == pool->job(pool->ctx, item, worker)) {
+        mcx_atomic_fetch_add(&pool->numFailed, 1);
+    }
+    mcx_time_get(&end);
+
+    mcx_time_diff(&start, &end, &diff);
+    time = mcx_time_to_seconds(&diff);
+
+    // each item is executed by exactly one worker per run
+    if (0. == pool->itemCosts[item]) {
+        pool->itemCosts[item] = time;
+    } else {
+        pool->itemCosts[item] += WORKER_POOL_COST_SMOOTHING * (time - pool->itemCosts[item]);
+    }
+
+    w->busyTime += time;
+    w->numJobs++;
+}
+
+static void WorkerPoolProcessSharedQueue(WorkerPool * pool, size_t worker) {
+    size_t numItems = pool->numItems;
+
+    while (1) {
+        size_t item = (size_t) mcx_atomic_fetch_add(&pool->nextItem, 1);
+
+        if (item >= numItems) {
+            break;
+        }
+
+        WorkerPoolExecute(pool, item, worker);
+    }
+}
+
+static int WorkerPoolClaim(WorkerPool * pool, size_t pos) {
+    return 0 == mcx_atomic_fetch_add(&pool->claimed[pos], 1);
+}
+
+static void WorkerPoolProcessOwnAndSteal(WorkerPool * pool, size_t worker) {
+    WorkerPoolWorker * own = &pool->workers[worker];
+    size_t i = 0;
+
+    // own items, longest first
+    while (1) {
+        int32_t pos = mcx_atomic_fetch_add(&own->head, 1);
+
+        if (pos >= (int32_t) own->end) {
+            break;
+        }
+
+        if (WorkerPoolClaim(pool, (size_t) pos)) {
+            WorkerPoolExecute(pool, pool->schedule[pos], worker);
+        }
+    }
+
+    // steal the shortest items from the back of the other workers
+    for (i = 1; i < pool->numWorkers; i++) {
+        WorkerPoolWorker * victim = &pool->workers[(worker + i) % pool->numWorkers];
+
+        while (1) {
+            int32_t pos = mcx_atomic_fetch_add(&victim->tail, -1) - 1;
+
+            if (pos < (int32_t) victim->begin) {
+                break;
+            }
+
+            if (WorkerPoolClaim(pool, (size_t) pos)) {
+                WorkerPoolExecute(pool, pool->schedule[pos], worker);
+                own->numStolen++;
+            }
+        }
+    }
+}
+
+static void WorkerPoolProcessStatic(WorkerPool * pool, size_t worker) {
+    size_t item = 0;
+
+    for (item = worker; item < pool->numItems; item += pool->numWorkers) {
+        WorkerPoolExecute(pool, item, worker);
+    }
+}
+
+static void WorkerPoolProcessItems(WorkerPool * pool, size_t worker) {
+    switch (pool->scheduling) {
+    case WORKER_POOL_WORK_STEALING:
+        WorkerPoolProcessOwnAndSteal(pool, worker);
+        break;
+    case WORKER_POOL_STATIC:
+        WorkerPoolProcessStatic(pool, worker);
+        break;
+    default:
+        WorkerPoolProcessSharedQueue(pool, worker);
+        break;
+    }
+}
+
+static void WorkerPoolPin(WorkerPool * pool, size_t worker) {
+    WorkerPoolWorker * w = &pool->workers[worker];
+    size_t cpu = 0;
+
+    if (0 == pool->numCpus) {
+        return;
+    }
+
+    cpu = pool->cpus[worker % pool->numCpus];
+    if (mcx_thread_set_affinity(cpu)) {
+        mcx_log(LOG_WARNING, "Worker pool: Could not pin worker %zu to CPU %zu", worker, cpu);
+        return;
+    }
+
+    w->pinned = TRUE;
+    w->cpu = cpu;
+    w->numaNode = mcx_cpu_get_numa_node(cpu);
+}
+
+static McxThreadReturn WorkerPoolThread(void * param) {
+    WorkerPoolThreadArg * arg = (WorkerPoolThreadArg *) param;
+    WorkerPool * pool = arg->pool;
+
+    int32_t generation = arg->generation;
+
+    // Setup returns once all workers are placed
+    WorkerPoolPin(pool, arg->worker);
+    mcx_atomic_fetch_add(&pool->numStarted, 1);
+    mcx_atomic_wake_all(&pool->numStarted);
+
+    while (1) {
+        // wait for the next run
+        if (!WorkerPoolSpinWhileEquals(&pool->generation, generation)) {
+            mcx_atomic_fetch_add(&pool->numSleepingWorkers, 1);
+            while (mcx_atomic_load(&pool->generation) == generation) {
+                mcx_atomic_wait(&pool->generation, generation);
+            }
+            mcx_atomic_fetch_add(&pool->numSleepingWorkers, -1);
+        }
+        generation = mcx_atomic_load(&pool->generation);
+
+        if (pool->finished) {
+            break;
+        }
+
+        WorkerPoolProcessItems(pool, arg->worker);
+
+        // the last worker to finish releases the caller
+        if (1 == mcx_atomic_fetch_add(&pool->pending, -1)) {
+            if (mcx_atomic_load(&pool->callerSleeping)) {
+                mcx_atomic_wake_all(&pool->pending);
+            }
+        }
+    }
+
+    mcx_thread_exit(0);
+
+    return 0;
+}
+
+static void WorkerPoolStartGeneration(WorkerPool * pool) {
+    mcx_atomic_fetch_add(&pool->generation, 1);
+    if (mcx_atomic_load(&pool->numSleepingWorkers) > 0) {
+        mcx_atomic_wake_all(&pool->generation);
+    }
+}
+
+static McxStatus WorkerPoolSetup(WorkerPool * pool, size_t numWorkers) {
+    size_t i = 0;
+
+    if (pool->workers) {
+        mcx_log(LOG_ERROR, "Worker pool: Already set up");
+        return RETURN_ERROR;
+    }
+
+    if (0 == numWorkers) {
+        numWorkers = 1;
+    }
+
+    pool->workers = (WorkerPoolWorker *) mcx_calloc(numWorkers, sizeof(WorkerPoolWorker));
+    if (!pool->workers) {
+        mcx_log(LOG_ERROR, "Worker pool: Memory allocation for workers failed");
+        return RETURN_ERROR;
+    }
+    for (i = 0; i < numWorkers; i++) {
+        pool->workers[i].pinned = FALSE;
+        pool->workers[i].numaNode = -1;
+    }
+
+    // the calling thread is worker 0
+    if (numWorkers > 1) {
+        pool->threads = (McxThread *) mcx_calloc(numWorkers - 1, sizeof(McxThread));
+        pool->args = (WorkerPoolThreadArg *) mcx_calloc(numWorkers - 1, sizeof(WorkerPoolThreadArg));
+        if (!pool->threads || !pool->args) {
+            mcx_log(LOG_ERROR, "Worker pool: Memory allocation for thread handles failed");
+            return RETURN_ERROR;
+        }
+    }
+
+    for (i = 1; i < numWorkers; i++) {
+        WorkerPoolThreadArg * arg = &pool->args[i - 1];
+
+        arg->pool = pool;
+        arg->worker = i;
+        arg->generation = mcx_atomic_load(&pool->generation);
+
+        if (mcx_thread_create(&pool->threads[i - 1], (McxThreadStartRoutine) WorkerPoolThread, arg)) {
+            mcx_log(LOG_ERROR, "Worker pool: Could not create thread");
+            return RETURN_ERROR;
+        }
+
+        pool->numWorkers = i + 1;
+    }
+
+    pool->numWorkers = numWorkers;
+
+    WorkerPoolPin(pool, 0);
+    while (1) {
+        int32_t numStarted = mcx_atomic_load(&pool->numStarted);
+
+        if ((size_t) numStarted == numWorkers - 1) {
+            break;
+        }
+        mcx_atomic_wait(&pool->numStarted, numStarted);
+    }
+
+    return RETURN_OK;
+}
+
+static void WorkerPoolSetScheduling(WorkerPool * pool, WorkerPoolScheduling scheduling) {
+    pool->scheduling = scheduling;
+}
+
+static McxStatus WorkerPoolSetAffinity(WorkerPool * pool, const char * cpuList) {
+    if (pool->workers) {
+        mcx_log(LOG_ERROR, "Worker pool: Affinity has to be set before the workers are created");
+        return RETURN_ERROR;
+    }
+
+    if (pool->cpus) {
+        mcx_free(pool->cpus);
+        pool->cpus = NULL;
+        pool->numCpus = 0;
+    }
+
+    if (!cpuList) {
+        return RETURN_OK;
+    }
+
+    if (mcx_cpu_list_parse(cpuList, &pool->cpus, &pool->numCpus)) {
+        mcx_log(LOG_ERROR, "Worker pool: Invalid processor list \"%s\"", cpuList);
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus WorkerPoolReserve(WorkerPool * pool, size_t numItems) {
+    size_t i = 0;
+
+    if (numItems <= pool->capacity) {
+        return RETURN_OK;
+    }
+
+    pool->itemCosts = (double *) mcx_realloc(pool->itemCosts, numItems * sizeof(double));
+    pool->order = (size_t *) mcx_realloc(pool->order, numItems * sizeof(size_t));
+    pool->owners = (size_t *) mcx_realloc(pool->owners, numItems * sizeof(size_t));
+    pool->schedule = (size_t *) mcx_realloc(pool->schedule, numItems * sizeof(size_t));
+    pool->claimed = (McxAtomic *) mcx_realloc((void *) pool->claimed, numItems * sizeof(McxAtomic));
+    if (!pool->itemCosts || !pool->order || !pool->owners || !pool->schedule || !pool->claimed) {
+        mcx_log(LOG_ERROR, "Worker pool: Memory allocation for %zu items failed", numItems);
+        return RETURN_ERROR;
+    }
+
+    for (i = pool->capacity; i < numItems; i++) {
+        pool->itemCosts[i] = 0.;
+    }
+    pool->capacity = numItems;
+
+    return RETURN_OK;
+}
+
+static int WorkerPoolCompareCosts(const void * left, const void * right, void * arg) {
+    const double * costs = (const double *) arg;
+    double l = costs[*(const size_t *) left];
+    double r = costs[*(const size_t *) right];
+
+    if (l > r) {
+        return -1;
+    } else if (l < r) {
+        return 1;
+    }
+
+    // keep the natural order for equal costs
+    return (*(const size_t *) left > *(const size_t *) right) - (*(const size_t *) left < *(const size_t *) right);
+}
+
+/*
+ * Longest processing time first: items sorted by descending cost are
+ * assigned to the worker with the smallest load so far. Each worker gets
+ * a contiguous segment of the schedule, again sorted by descending cost,
+ * so that thieves take the cheapest items from its back.
+ */
+static void WorkerPoolSchedule(WorkerPool * pool, size_t numItems) {
+    size_t numWorkers = pool->numWorkers;
+    size_t i = 0;
+    size_t w = 0;
+    size_t begin = 0;
+
+    for (i = 0; i < numItems; i++) {
+        pool->order[i] = i;
+        mcx_atomic_store(&pool->claimed[i], 0);
+    }
+    mcx_sort(pool->order, numItems, sizeof(size_t), WorkerPoolCompareCosts, pool->itemCosts);
+
+    // end is used to count the items of each worker
+    for (w = 0; w < numWorkers; w++) {
+        pool->workers[w].load = 0.;
+        pool->workers[w].end = 0;
+    }
+
+    for (i = 0; i < numItems; i++) {
+        size_t best = 0;
+
+        for (w = 1; w < numWorkers; w++) {
+            if (pool->workers[w].load < pool->workers[best].load
+                || (pool->workers[w].load == pool->workers[best].load && pool->workers[w].end < pool->workers[best].end)) {
+                best = w;
+            }
+        }
+
+        pool->owners[i] = best;
+        pool->workers[best].load += pool->itemCosts[pool->order[i]];
+        pool->workers[best].end++;
+    }
+
+    for (w = 0; w < numWorkers; w++) {
+        WorkerPoolWorker * worker = &pool->workers[w];
+        size_t count = worker->end;
+
+        worker->begin = begin;
+        worker->end = begin;
+        begin += count;
+    }
+
+    for (i = 0; i < numItems; i++) {
+        WorkerPoolWorker * worker = &pool->workers[pool->owners[i]];
+        pool->schedule[worker->end++] = pool->order[i];
+    }
+
+    for (w = 0; w < numWorkers; w++) {
+        WorkerPoolWorker * worker = &pool->workers[w];
+
+        mcx_atomic_store(&worker->head, (int32_t) worker->begin);
+        mcx_atomic_store(&worker->tail, (int32_t) worker->end);
+    }
+}
+
+static McxStatus WorkerPoolRun(WorkerPool * pool, size_t numItems, fWorkerPoolJob job, void * ctx) {
+    McxTime start, end, diff;
+    int32_t pending = 0;
+    size_t i = 0;
+
+    if (RETURN_OK != WorkerPoolReserve(pool, numItems)) {
+        return RETURN_ERROR;
+    }
+
+    mcx_time_get(&start);
+
+    // right now, only this thread is touching the pool
+    pool->job = job;
+    pool->ctx = ctx;
+    pool->numItems = numItems;
+
+    if (WORKER_POOL_WORK_STEALING == pool->scheduling) {
+        WorkerPoolSchedule(pool, numItems);
+    }
+
+    mcx_atomic_store(&pool->nextItem, 0);
+    mcx_atomic_store(&pool->numFailed, 0);
+    mcx_atomic_store(&pool->pending, (int32_t) (pool->numWorkers - 1));
+
+    WorkerPoolStartGeneration(pool);
+
+    WorkerPoolProcessItems(pool, 0);
+
+    // wait until all background workers are done with this run
+    for (i = 0; i < WORKER_POOL_SPIN_COUNT && 0 != mcx_atomic_load(&pool->pending); i++) {
+        mcx_cpu_relax();
+    }
+    if (0 != mcx_atomic_load(&pool->pending)) {
+        mcx_atomic_store(&pool->callerSleeping, TRUE);
+        while (0 != (pending = mcx_atomic_load(&pool->pending))) {
+            mcx_atomic_wait(&pool->pending, pending);
+        }
+        mcx_atomic_store(&pool->callerSleeping, FALSE);
+    }
+
+    mcx_time_get(&end);
+    mcx_time_diff(&start, &end, &diff);
+    pool->runTime += mcx_time_to_seconds(&diff);
+    pool->numRuns++;
+
+    return mcx_atomic_load(&pool->numFailed) > 0 ? RETURN_ERROR : RETURN_OK;
+}
+
+static size_t WorkerPoolGetNumWorkers(const WorkerPool * pool) {
+    return pool->numWorkers;
+}
+
+static const char * WorkerPoolSchedulingName(WorkerPoolScheduling scheduling) {
+    switch (scheduling) {
+    case WORKER_POOL_WORK_STEALING:
+        return "work stealing";
+    case WORKER_POOL_STATIC:
+        return "static";
+    default:
+        return "shared queue";
+    }
+}
+
+static void WorkerPoolLogStatistics(const WorkerPool * pool) {
+    size_t i = 0;
+
+    if (!pool->workers || 0 == pool->numRuns) {
+        return;
+    }
+
+    mcx_log(LOG_INFO, "Worker pool: %zu runs on %zu workers (%s), %.3f s wall time",
+            pool->numRuns, pool->numWorkers, WorkerPoolSchedulingName(pool->scheduling), pool->runTime);
+    for (i = 0; i < pool->numWorkers; i++) {
+        const WorkerPoolWorker * worker = &pool->workers[i];
+
+        mcx_log(LOG_INFO, "Worker pool: Worker %zu: %zu jobs (%zu stolen), busy %.3f s, utilisation %.1f %%",
+                i, worker->numJobs, worker->numStolen, worker->busyTime,
+                pool->runTime > 0. ? 100. * worker->busyTime / pool->runTime : 0.);
+    }
+}
+
+static void WorkerPoolLogPlacement(const WorkerPool * pool) {
+    size_t i = 0;
+
+    if (!pool->workers) {
+        return;
+    }
+
+    for (i = 0; i < pool->numWorkers; i++) {
+        const WorkerPoolWorker * worker = &pool->workers[i];
+
+        if (!worker->pinned) {
+            mcx_log(LOG_INFO, "Worker pool: Worker %zu: not pinned", i);
+        } else if (worker->numaNode < 0) {
+            mcx_log(LOG_INFO, "Worker pool: Worker %zu: CPU %zu", i, worker->cpu);
+        } else {
+            mcx_log(LOG_INFO, "Worker pool: Worker %zu: CPU %zu, NUMA node %d", i, worker->cpu, worker->numaNode);
+        }
+    }
+}
+
+static void WorkerPoolDestructor(WorkerPool * pool) {
+    if (pool->threads) {
+        size_t i = 0;
+
+        pool->finished = TRUE;
+        WorkerPoolStartGeneration(pool);
+        mcx_atomic_wake_all(&pool->generation);
+
+        for (i = 0; i + 1 < pool->numWorkers; i++) {
+            long ret;
+            mcx_thread_join(pool->threads[i], &ret);
+        }
+
+        mcx_free(pool->threads);
+        pool->threads = NULL;
+    }
+
+    if (pool->args) {
+        mcx_free(pool->args);
+        pool->args = NULL;
+    }
+
+    if (pool->workers) {
+        mcx_free(pool->workers);
+        pool->workers = NULL;
+    }
+
+    if (pool->cpus) {
+        mcx_free(pool->cpus);
+        pool->cpus = NULL;
+    }
+
+    mcx_free(pool->itemCosts);
+    mcx_free(pool->order);
+    mcx_free(pool->owners);
+    mcx_free(pool->schedule);
+    mcx_free((void *) pool->claimed);
+}
+
+static WorkerPool * WorkerPoolCreate(WorkerPool * pool) {
+    pool->Setup = WorkerPoolSetup;
+    pool->SetScheduling = WorkerPoolSetScheduling;
+    pool->SetAffinity = WorkerPoolSetAffinity;
+    pool->Run = WorkerPoolRun;
+    pool->GetNumWorkers = WorkerPoolGetNumWorkers;
+    pool->LogStatistics = WorkerPoolLogStatistics;
+    pool->LogPlacement = WorkerPoolLogPlacement;
+
+    pool->numWorkers = 1;
+    pool->threads = NULL;
+    pool->args = NULL;
+    pool->workers = NULL;
+
+    pool->scheduling = WORKER_POOL_SHARED_QUEUE;
+
+    pool->cpus = NULL;
+    pool->numCpus = 0;
+
+    pool->job = NULL;
+    pool->ctx = NULL;
+    pool->numItems = 0;
+    pool->finished = FALSE;
+
+    pool->capacity = 0;
+    pool->itemCosts = NULL;
+    pool->order = NULL;
+    pool->owners = NULL;
+    pool->schedule = NULL;
+    pool->claimed = NULL;
+
+    pool->runTime = 0.;
+    pool->numRuns = 0;
+
+    mcx_atomic_store(&pool->generation, 0);
+    mcx_atomic_store(&pool->nextItem, 0);
+    mcx_atomic_store(&pool->pending, 0);
+    mcx_atomic_store(&pool->numFailed, 0);
+    mcx_atomic_store(&pool->numSleepingWorkers, 0);
+    mcx_atomic_store(&pool->callerSleeping, FALSE);
+    mcx_atomic_store(&pool->numStarted, 0);
+
+    return pool;
+}
+
+OBJECT_CLASS(WorkerPool, Object);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //ENABLE_MT
@@ -0,0 +1,150 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_CORE_WORKER_POOL_H
+#define MCX_CORE_WORKER_POOL_H
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#include "util/atomic.h"
+#include "util/threads.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct WorkerPool WorkerPool;
+typedef struct WorkerPoolThreadArg WorkerPoolThreadArg;
+typedef struct WorkerPoolWorker WorkerPoolWorker;
+
+typedef enum WorkerPoolScheduling {
+    WORKER_POOL_SHARED_QUEUE,   // items are pulled from a shared index
+    WORKER_POOL_WORK_STEALING,  // cost-based packing with work stealing
+    WORKER_POOL_STATIC,         // worker w executes items w, w + numWorkers, ...
+} WorkerPoolScheduling;
+
+/**
+ * Work function executed by the pool for each item index of a run. The
+ * worker index is in [0, numWorkers), where worker 0 is the thread that
+ * called Run.
+ */
+typedef McxStatus (* fWorkerPoolJob)(void * ctx, size_t item, size_t worker);
+
+typedef McxStatus (* fWorkerPoolSetup)(WorkerPool * pool, size_t numWorkers);
+typedef void (* fWorkerPoolSetScheduling)(WorkerPool * pool, WorkerPoolScheduling scheduling);
+typedef McxStatus (* fWorkerPoolSetAffinity)(WorkerPool * pool, const char * cpuList);
+typedef McxStatus (* fWorkerPoolRun)(WorkerPool * pool, size_t numItems, fWorkerPoolJob job, void * ctx);
+typedef size_t (* fWorkerPoolGetNumWorkers)(const WorkerPool * pool);
+typedef void (* fWorkerPoolLogStatistics)(const WorkerPool * pool);
+typedef void (* fWorkerPoolLogPlacement)(const WorkerPool * pool);
+
+struct WorkerPoolThreadArg {
+    WorkerPool * pool;
+    size_t worker;
+
+    // generation at thread creation, the thread waits for the next one
+    int32_t generation;
+};
+
+/* per-worker schedule and statistics */
+struct WorkerPoolWorker {
+    // work stealing: items [begin, end) of pool->schedule are owned by the worker
+    size_t begin;
+    size_t end;
+    McxAtomic head;                // next position taken by the owner
+    McxAtomic tail;                // one past the next position taken by thieves
+    double load;                   // estimated cost of the owned items
+
+    // placement, cpu is only valid if pinned
+    int pinned;
+    size_t cpu;
+    int numaNode;                  // -1 if unknown
+
+    double busyTime;               // wall time spent in jobs
+    size_t numJobs;                // executed jobs
+    size_t numStolen;              // executed jobs owned by other workers
+};
+
+extern const struct ObjectClass _WorkerPool;
+
+/**
+ * Fixed-size pool of worker threads. The threads are created once in
+ * Setup and wait for the next run by spinning shortly on a generation
+ * counter before sleeping on it (futex / WaitOnAddress).
+ *
+ * By default, items of a run are pulled from a shared atomic index. With
+ * work stealing enabled, the items are packed longest-first onto the
+ * workers based on the job times measured in the previous runs, and
+ * workers that run out of items steal from the back of the others. Static
+ * scheduling always executes an item on the same worker, so with pinned
+ * workers an item also stays on the same processor. Memory the item
+ * allocated before (e.g. during model setup) is not moved to the node of
+ * that processor.
+ */
+struct WorkerPool {
+    Object _; // super class first
+
+    fWorkerPoolSetup Setup;
+    fWorkerPoolSetScheduling SetScheduling;
+    fWorkerPoolSetAffinity SetAffinity;
+    fWorkerPoolRun Run;
+    fWorkerPoolGetNumWorkers GetNumWorkers;
+    fWorkerPoolLogStatistics LogStatistics;
+    fWorkerPoolLogPlacement LogPlacement;
+
+    // number of workers including the thread calling Run
+    size_t numWorkers;
+
+    McxThread * threads;           // numWorkers - 1 background threads
+    WorkerPoolThreadArg * args;
+    WorkerPoolWorker * workers;    // numWorkers
+
+    WorkerPoolScheduling scheduling;
+
+    // processors the workers are pinned to (worker i to cpus[i % numCpus]), set before Setup
+    size_t * cpus;
+    size_t numCpus;
+
+    // current run, published before generation is incremented
+    fWorkerPoolJob job;
+    void * ctx;
+    size_t numItems;
+    int finished;
+
+    // per-item data, capacity items long
+    size_t capacity;
+    double * itemCosts;            // smoothed job wall time
+    size_t * order;                // item indices sorted by descending cost
+    size_t * owners;               // owning worker per position in order
+    size_t * schedule;             // item indices grouped by owning worker
+    McxAtomic * claimed;           // work stealing: item was taken by a worker
+
+    McxAtomic generation;          // incremented to start a run
+    McxAtomic nextItem;            // shared queue of item indices
+    McxAtomic pending;             // background workers still busy in this run
+    McxAtomic numFailed;           // jobs that returned RETURN_ERROR
+
+    McxAtomic numSleepingWorkers;  // background workers blocked on generation
+    McxAtomic callerSleeping;      // calling thread blocked on pending
+    McxAtomic numStarted;          // background workers that are placed and running
+
+    double runTime;                // wall time of all runs
+    size_t numRuns;
+};
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //ENABLE_MT
+
+#endif /* MCX_CORE_WORKER_POOL_H */
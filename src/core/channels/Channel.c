@@ -34,6 +34,7 @@ static ChannelData * ChannelDataCreate(ChannelData * data) {
     data->isDefinedDuringInit = FALSE;
     data->internalValue = NULL;
     ChannelValueInit(&data->value, CHANNEL_UNKNOWN);
+    data->store = NULL;
 
     return data;
 }
@@ -70,6 +71,80 @@ static McxStatus ChannelSetup(Channel * channel, ChannelInfo * info) {
     return RETURN_OK;
 }
 
+static McxStatus ChannelSetValueStore(Channel * channel, ChannelDoubleStore * store, size_t idx) {
+    if (CHANNEL_DOUBLE == ChannelValueType(&channel->data->value)) {
+        store->values[idx] = channel->data->value.value.d;
+    }
+    channel->data->store = store;
+    channel->data->storeIdx = idx;
+
+    return RETURN_OK;
+}
+
+static double * ChannelGetStoreValue(Channel * channel) {
+    return &channel->data->store->values[channel->data->storeIdx];
+}
+
+// scale, offset and limits of the compiled conversions of a channel
+typedef struct ChannelDoubleConversion {
+    double scale;
+    double offset;
+    double min;
+    double max;
+} ChannelDoubleConversion;
+
+static void ChannelDoubleConversionInit(ChannelDoubleConversion * conversion) {
+    conversion->scale = 1.0;
+    conversion->offset = -0.0; // x + -0.0 == x for all x, including -0.0
+    conversion->min = -INFINITY;
+    conversion->max = INFINITY;
+}
+
+static McxStatus ChannelDoubleConversionAddLinear(ChannelDoubleConversion * conversion, LinearConversion * linear, ChannelInfo * info) {
+    if (CHANNEL_DOUBLE != linear->type) {
+        mcx_log(LOG_ERROR, "Port %s: Linear conversion of type %s cannot be applied to a port of type %s",
+            info->GetLogName(info), ChannelTypeToString(linear->type), ChannelTypeToString(CHANNEL_DOUBLE));
+        return RETURN_ERROR;
+    }
+
+    if (linear->factor) {
+        conversion->scale *= linear->factor->value.d;
+        conversion->offset *= linear->factor->value.d;
+    }
+    if (linear->offset) {
+        conversion->offset += linear->offset->value.d;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelDoubleConversionAddRange(ChannelDoubleConversion * conversion, RangeConversion * range, ChannelInfo * info) {
+    if (CHANNEL_DOUBLE != range->type) {
+        mcx_log(LOG_ERROR, "Port %s: Range conversion of type %s cannot be applied to a port of type %s",
+            info->GetLogName(info), ChannelTypeToString(range->type), ChannelTypeToString(CHANNEL_DOUBLE));
+        return RETURN_ERROR;
+    }
+
+    if (range->min) {
+        conversion->min = range->min->value.d;
+    }
+    if (range->max) {
+        conversion->max = range->max->value.d;
+    }
+
+    return RETURN_OK;
+}
+
+static void ChannelDoubleConversionStore(ChannelDoubleConversion * conversion, Channel * channel) {
+    ChannelDoubleStore * store = channel->data->store;
+    size_t idx = channel->data->storeIdx;
+
+    store->scales[idx] = conversion->scale;
+    store->offsets[idx] = conversion->offset;
+    store->mins[idx] = conversion->min;
+    store->maxs[idx] = conversion->max;
+}
+
 static void ChannelDestructor(Channel * channel) {
     object_destroy(channel->data);
 }
@@ -84,6 +159,7 @@ static Channel * ChannelCreate(Channel * channel) {
     channel->Setup = ChannelSetup;
     channel->IsDefinedDuringInit = ChannelIsDefinedDuringInit;
     channel->SetDefinedDuringInit = ChannelSetDefinedDuringInit;
+    channel->SetValueStore = ChannelSetValueStore;
 
     // virtual functions
     channel->GetValueReference = NULL;
@@ -96,6 +172,60 @@ static Channel * ChannelCreate(Channel * channel) {
 }
 
 
+// ----------------------------------------------------------------------
+// ChannelDoubleStore
+
+void ChannelDoubleStoreInit(ChannelDoubleStore * store) {
+    store->num = 0;
+
+    store->values = NULL;
+    store->scales = NULL;
+    store->offsets = NULL;
+    store->mins = NULL;
+    store->maxs = NULL;
+}
+
+McxStatus ChannelDoubleStoreSetup(ChannelDoubleStore * store, size_t num) {
+    size_t i = 0;
+
+    ChannelDoubleStoreDestructor(store);
+
+    store->values = (double *) mcx_calloc(num + 1, sizeof(double));
+    store->scales = (double *) mcx_calloc(num + 1, sizeof(double));
+    store->offsets = (double *) mcx_calloc(num + 1, sizeof(double));
+    store->mins = (double *) mcx_calloc(num + 1, sizeof(double));
+    store->maxs = (double *) mcx_calloc(num + 1, sizeof(double));
+
+    if (!store->values || !store->scales || !store->offsets || !store->mins || !store->maxs) {
+        mcx_log(LOG_ERROR, "Ports: Memory allocation for port values failed");
+        ChannelDoubleStoreDestructor(store);
+        return RETURN_ERROR;
+    }
+
+    store->num = num;
+
+    // identity until the channels are bound
+    for (i = 0; i < num; i++) {
+        store->scales[i] = 1.0;
+        store->offsets[i] = -0.0;
+        store->mins[i] = -INFINITY;
+        store->maxs[i] = INFINITY;
+    }
+
+    return RETURN_OK;
+}
+
+void ChannelDoubleStoreDestructor(ChannelDoubleStore * store) {
+    if (store->values) { mcx_free(store->values); }
+    if (store->scales) { mcx_free(store->scales); }
+    if (store->offsets) { mcx_free(store->offsets); }
+    if (store->mins) { mcx_free(store->mins); }
+    if (store->maxs) { mcx_free(store->maxs); }
+
+    ChannelDoubleStoreInit(store);
+}
+
+
 // ----------------------------------------------------------------------
 // ChannelIn
 
@@ -114,6 +244,15 @@ static ChannelInData * ChannelInDataCreate(ChannelInData * data) {
 
     data->isDiscrete = FALSE;
 
+    data->isChanged = TRUE;
+    data->hasValue = FALSE;
+
+    data->valueCapacity = 0;
+    data->referenceBuffer = NULL;
+    data->referenceCapacity = 0;
+
+    data->maxBufferSize = 0;
+
     return data;
 }
 
@@ -185,9 +324,109 @@ static const void * ChannelInGetValueReference(Channel * channel) {
         return NULL;
     }
 
+    if (channel->data->store) {
+        return ChannelGetStoreValue(channel);
+    }
+
     return ChannelValueReference(&channel->data->value);
 }
 
+static McxStatus ChannelInUpdateDouble(ChannelIn * in, TimeInterval * time);
+
+/*
+ * Makes sure that *buffer holds at least size bytes. Buffers only grow, the
+ * previous content is not kept. A capacity of 0 means that the size of
+ * *buffer is unknown.
+ */
+static McxStatus ChannelInReserveBuffer(ChannelIn * in, char ** buffer, size_t * capacity, size_t size) {
+    size_t newCapacity = 0;
+
+    if (size <= * capacity) {
+        return RETURN_OK;
+    }
+
+    if (in->data->maxBufferSize && size > in->data->maxBufferSize) {
+        ChannelInfo * info = ((Channel *) in)->GetInfo((Channel *) in);
+        mcx_log(LOG_ERROR, "Port %s: Update inport: Value of %zu bytes exceeds the maximum size of %zu bytes",
+            info->GetLogName(info), size, in->data->maxBufferSize);
+        return RETURN_ERROR;
+    }
+
+    // grow geometrically to amortize values of slowly increasing size
+    newCapacity = 2 * (* capacity);
+    if (newCapacity < size) {
+        newCapacity = size;
+    }
+    if (in->data->maxBufferSize && newCapacity > in->data->maxBufferSize) {
+        newCapacity = in->data->maxBufferSize;
+    }
+
+    if (* buffer) {
+        mcx_free(* buffer);
+    }
+    * capacity = 0;
+
+    * buffer = (char *) mcx_malloc(newCapacity);
+    if (!* buffer) {
+        ChannelInfo * info = ((Channel *) in)->GetInfo((Channel *) in);
+        mcx_log(LOG_ERROR, "Port %s: Update inport: Memory allocation of %zu bytes failed", info->GetLogName(info), newCapacity);
+        return RETURN_ERROR;
+    }
+    * capacity = newCapacity;
+
+    return RETURN_OK;
+}
+
+// copies the string or binary value of the connection into the channel value
+static McxStatus ChannelInCopyConnectionValue(ChannelIn * in, Connection * conn) {
+    ChannelValue * val = &((Channel *) in)->data->value;
+    const void * reference = conn->GetValueReference(conn);
+
+    if (CHANNEL_STRING == val->type) {
+        const char * str = reference ? * (const char * const *) reference : NULL;
+        size_t size = 0;
+
+        if (!str) {
+            ChannelValueDestructor(val);
+            in->data->valueCapacity = 0;
+            return RETURN_OK;
+        }
+
+        size = strlen(str) + 1;
+        if (RETURN_OK != ChannelInReserveBuffer(in, &val->value.s, &in->data->valueCapacity, size)) {
+            return RETURN_ERROR;
+        }
+        memcpy(val->value.s, str, size);
+    } else {
+        const binary_string * bin = (const binary_string *) reference;
+
+        if (!bin || !bin->data) {
+            BinaryStringDestructor(&val->value.b);
+            return RETURN_OK;
+        }
+
+        // binary values are shared with the connection instead of copied
+        BinaryStringSet(&val->value.b, bin);
+        if (!val->value.b.data) {
+            return RETURN_ERROR;
+        }
+    }
+
+    return RETURN_OK;
+}
+
+/*
+ * Returns the capacity of the buffer of the component reference. It is
+ * unknown if the component replaced the buffer that was written last.
+ */
+static size_t * ChannelInGetReferenceCapacity(ChannelIn * in, char * buffer) {
+    if (buffer != in->data->referenceBuffer) {
+        in->data->referenceCapacity = 0;
+    }
+
+    return &in->data->referenceCapacity;
+}
+
 static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
     ChannelIn * in = (ChannelIn *) channel;
     ChannelInfo * info = channel->GetInfo(channel);
@@ -195,6 +434,10 @@ static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
 
     McxStatus retVal = RETURN_OK;
 
+    if (channel->data->store) {
+        return ChannelInUpdateDouble(in, time);
+    }
+
     /* if no connection is present we have nothing to update*/
     if (conn) {
         ConnectionInfo * connInfo = NULL;
@@ -202,12 +445,22 @@ static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
 
         connInfo = conn->GetInfo(conn);
 
-        ChannelValueDestructor(val);
-        ChannelValueInit(val, connInfo->GetType(connInfo));
+        if (ChannelValueType(val) != connInfo->GetType(connInfo)) {
+            ChannelValueDestructor(val);
+            ChannelValueInit(val, connInfo->GetType(connInfo));
+            in->data->valueCapacity = 0;
+        }
 
         /* Update the connection for the current time */
         conn->UpdateToOutput(conn, time);
-        ChannelValueSetFromReference(val, conn->GetValueReference(conn));
+        if (CHANNEL_STRING == ChannelValueType(val) || CHANNEL_BINARY == ChannelValueType(val)) {
+            retVal = ChannelInCopyConnectionValue(in, conn);
+            if (RETURN_OK != retVal) {
+                return RETURN_ERROR;
+            }
+        } else {
+            ChannelValueSetFromReference(val, conn->GetValueReference(conn));
+        }
 
         //type
         if (in->data->typeConversion) {
@@ -272,25 +525,38 @@ static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
             MCX_DEBUG_LOG("[%f] CH IN  (%s) (%f, %f)", time->startTime, info->GetLogName(info), time->startTime, * (double *) channel->GetValueReference(channel));
         }
 #endif // MCX_DEBUG
-        * (double *) in->data->reference = * (double *) channel->GetValueReference(channel);
+        // bitwise, so that NaN payloads and signed zeros count as changes
+        if (memcmp(in->data->reference, channel->GetValueReference(channel), sizeof(double))) {
+            * (double *) in->data->reference = * (double *) channel->GetValueReference(channel);
+            in->data->isChanged = TRUE;
+        }
         break;
     case CHANNEL_INTEGER:
-        * (int *) in->data->reference = * (int *) channel->GetValueReference(channel);
-        break;
     case CHANNEL_BOOL:
-        * (int *) in->data->reference = * (int *) channel->GetValueReference(channel);
+        if (* (int *) in->data->reference != * (int *) channel->GetValueReference(channel)) {
+            * (int *) in->data->reference = * (int *) channel->GetValueReference(channel);
+            in->data->isChanged = TRUE;
+        }
         break;
     case CHANNEL_STRING:
     {
         const void * reference = channel->GetValueReference(channel);
 
         if (NULL != reference && NULL != * (const char * *) reference ) {
-            if (* (char * *) in->data->reference) {
-                mcx_free(* (char * *) in->data->reference);
+            if (* (char * *) in->data->reference && !strcmp(* (char * *) in->data->reference, * (const char **) reference)) {
+                break;
             }
-            * (char * *) in->data->reference = (char *) mcx_calloc(strlen(* (const char **) reference) + 1, sizeof(char));
-            if (* (char * *) in->data->reference) {
-                strncpy(* (char * *) in->data->reference, * (const char **)reference, strlen(* (const char **)reference) + 1);
+            in->data->isChanged = TRUE;
+            {
+                char ** target = (char * *) in->data->reference;
+                size_t size = strlen(* (const char **) reference) + 1;
+
+                retVal = ChannelInReserveBuffer(in, target, ChannelInGetReferenceCapacity(in, * target), size);
+                in->data->referenceBuffer = * target;
+                if (RETURN_OK != retVal) {
+                    return RETURN_ERROR;
+                }
+                memcpy(* target, * (const char **) reference, size);
             }
         }
         break;
@@ -300,13 +566,17 @@ static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
         const void * reference = channel->GetValueReference(channel);
 
         if (NULL != reference && NULL != ((const binary_string *) reference)->data) {
-            if (((binary_string *) in->data->reference)->data) {
-                mcx_free(((binary_string *) in->data->reference)->data);
+            binary_string * target = (binary_string *) in->data->reference;
+            const binary_string * source = (const binary_string *) reference;
+
+            if (source->payload && source->payload == target->payload) {
+                break;
             }
-            ((binary_string *) in->data->reference)->len = ((const binary_string *) reference)->len;
-            ((binary_string *) in->data->reference)->data = (char *) mcx_malloc(((binary_string *) in->data->reference)->len);
-            if (((binary_string *) in->data->reference)->data) {
-                memcpy(((binary_string *) in->data->reference)->data, ((const binary_string *) reference)->data, ((binary_string *) in->data->reference)->len);
+            in->data->isChanged = TRUE;
+
+            BinaryStringSet(target, source);
+            if (!target->data) {
+                return RETURN_ERROR;
             }
         }
         break;
@@ -316,6 +586,7 @@ static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
         const void * reference = channel->GetValueReference(channel);
 
         if (NULL != reference && NULL != ((binary_string *) reference)->data) {
+            in->data->isChanged = TRUE;
             ((binary_string *) in->data->reference)->len = ((binary_string *) reference)->len;
             ((binary_string *) in->data->reference)->data = ((binary_string *) reference)->data;
         }
@@ -328,6 +599,177 @@ static McxStatus ChannelInUpdate(Channel * channel, TimeInterval * time) {
     return RETURN_OK;
 }
 
+static McxStatus ChannelInConvertTypeToDouble(ChannelIn * in, Connection * conn, double * value) {
+    Channel * channel = (Channel *) in;
+    ChannelInfo * info = channel->GetInfo(channel);
+    ConnectionInfo * connInfo = conn->GetInfo(conn);
+    Conversion * conversion = (Conversion *) in->data->typeConversion;
+    const void * reference = conn->GetValueReference(conn);
+
+    ChannelValue val;
+    McxStatus retVal = RETURN_OK;
+
+    in->data->hasValue = NULL != reference;
+    if (!reference) {
+        return RETURN_OK;
+    }
+
+    ChannelValueInit(&val, connInfo->GetType(connInfo));
+    ChannelValueSetFromReference(&val, reference);
+
+    retVal = conversion->convert(conversion, &val);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Port %s: Update inport: Could not execute type conversion", info->GetLogName(info));
+        ChannelValueDestructor(&val);
+        return RETURN_ERROR;
+    }
+
+    * value = val.value.d;
+    ChannelValueDestructor(&val);
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelInFetchDouble(ChannelIn * in, TimeInterval * time, double * value) {
+    Connection * conn = in->data->connection;
+
+    if (conn) {
+        conn->UpdateToOutput(conn, time);
+        if (in->data->typeConversion) {
+            return ChannelInConvertTypeToDouble(in, conn, value);
+        } else {
+            const double * reference = (const double *) conn->GetValueReference(conn);
+
+            in->data->hasValue = NULL != reference;
+            if (reference) {
+                * value = * reference;
+            }
+        }
+    } else {
+        // unconnected channels start from their default value
+        * value = ((Channel *) in)->data->value.value.d;
+        in->data->hasValue = TRUE;
+    }
+
+    return RETURN_OK;
+}
+
+static void ChannelInConvertDoubles(double * values,
+                                    const double * scales,
+                                    const double * offsets,
+                                    const double * mins,
+                                    const double * maxs,
+                                    size_t num) {
+    size_t i = 0;
+
+    // branch free, so that the compiler can vectorize it
+    for (i = 0; i < num; i++) {
+        double value = scales[i] * values[i] + offsets[i];
+
+        value = value <= mins[i] ? mins[i] : value;
+        values[i] = value >= maxs[i] ? maxs[i] : value;
+    }
+}
+
+static void ChannelInWriteDouble(ChannelIn * in, double value, TimeInterval * time) {
+    Channel * channel = (Channel *) in;
+    double * reference = (double *) in->data->reference;
+
+    if (!reference || !in->data->hasValue || !channel->IsValid(channel)) {
+        return;
+    }
+
+#ifdef MCX_DEBUG
+    if (time->startTime < MCX_DEBUG_LOG_TIME) {
+        ChannelInfo * info = channel->GetInfo(channel);
+        MCX_DEBUG_LOG("[%f] CH IN  (%s) (%f, %f)", time->startTime, info->GetLogName(info), time->startTime, value);
+    }
+#endif // MCX_DEBUG
+
+    // bitwise, so that NaN payloads and signed zeros count as changes
+    if (memcmp(reference, &value, sizeof(double))) {
+        * reference = value;
+        in->data->isChanged = TRUE;
+    }
+}
+
+static McxStatus ChannelInUpdateDouble(ChannelIn * in, TimeInterval * time) {
+    Channel * channel = (Channel *) in;
+    ChannelDoubleStore * store = channel->data->store;
+    size_t idx = channel->data->storeIdx;
+
+    if (RETURN_OK != ChannelInFetchDouble(in, time, &store->values[idx])) {
+        return RETURN_ERROR;
+    }
+
+    ChannelInConvertDoubles(&store->values[idx], &store->scales[idx], &store->offsets[idx],
+                            &store->mins[idx], &store->maxs[idx], 1);
+
+    ChannelInWriteDouble(in, store->values[idx], time);
+
+    return RETURN_OK;
+}
+
+McxStatus ChannelInUpdateDoubles(ChannelIn ** ins, ChannelDoubleStore * store, TimeInterval * time) {
+    size_t i = 0;
+
+    for (i = 0; i < store->num; i++) {
+        if (RETURN_OK != ChannelInFetchDouble(ins[i], time, &store->values[i])) {
+            return RETURN_ERROR;
+        }
+    }
+
+    ChannelInConvertDoubles(store->values, store->scales, store->offsets, store->mins, store->maxs, store->num);
+
+    for (i = 0; i < store->num; i++) {
+        ChannelInWriteDouble(ins[i], store->values[i], time);
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelInCompileConversions(ChannelIn * in) {
+    Channel * channel = (Channel *) in;
+    ChannelInfo * info = channel->GetInfo(channel);
+    ChannelDoubleConversion conversion;
+
+    if (!channel->data->store) {
+        return RETURN_OK;
+    }
+
+    ChannelDoubleConversionInit(&conversion);
+
+    if (in->data->unitConversion) {
+        UnitConversion * unit = in->data->unitConversion;
+
+        // (x + source.offset) * source.factor / target.factor - target.offset
+        conversion.scale = unit->source.factor / unit->target.factor;
+        conversion.offset = unit->source.offset * conversion.scale - unit->target.offset;
+    }
+
+    if (in->data->linearConversion) {
+        if (RETURN_OK != ChannelDoubleConversionAddLinear(&conversion, in->data->linearConversion, info)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    if (in->data->rangeConversion) {
+        if (RETURN_OK != ChannelDoubleConversionAddRange(&conversion, in->data->rangeConversion, info)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    ChannelDoubleConversionStore(&conversion, channel);
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelInSetValueStore(Channel * channel, ChannelDoubleStore * store, size_t idx) {
+    ChannelSetValueStore(channel, store, idx);
+
+    return ChannelInCompileConversions((ChannelIn *) channel);
+}
+
 static int ChannelInIsValid(Channel * channel) {
 
     if (channel->IsConnected(channel)) {
@@ -349,6 +791,14 @@ static int ChannelInIsDiscrete(ChannelIn * in) {
     return in->data->isDiscrete;
 }
 
+static int ChannelInIsChanged(ChannelIn * in) {
+    return in->data->isChanged;
+}
+
+static void ChannelInResetChanged(ChannelIn * in) {
+    in->data->isChanged = FALSE;
+}
+
 static int ChannelInIsConnected(Channel * channel) {
     if (channel->data->info && channel->data->info->connected) {
         return TRUE;
@@ -418,11 +868,10 @@ static McxStatus ChannelInSetConnection(ChannelIn * in, Connection * connection,
         }
     }
 
-    return RETURN_OK;
-
+    return ChannelInCompileConversions(in);
 }
 
-static McxStatus ChannelInSetup(ChannelIn * in, ChannelInfo * info) {
+static McxStatus ChannelInSetup(ChannelIn * in, ChannelInfo * info, Config * config) {
     Channel * channel = (Channel *) in;
     McxStatus retVal;
 
@@ -442,6 +891,10 @@ static McxStatus ChannelInSetup(ChannelIn * in, ChannelInfo * info) {
         channel->data->internalValue = ChannelValueReference(&channel->data->value);
     }
 
+    if (config) {
+        in->data->maxBufferSize = config->maxPortBufferSize;
+    }
+
     // unit conversion is setup when a connection is set
 
     // min/max conversions are only used for double types
@@ -499,6 +952,7 @@ static ChannelIn * ChannelInCreate(ChannelIn * in) {
     channel->IsValid           = ChannelInIsValid;
     channel->Update            = ChannelInUpdate;
     channel->IsConnected       = ChannelInIsConnected;
+    channel->SetValueStore     = ChannelInSetValueStore;
 
     in->Setup        = ChannelInSetup;
     in->SetReference = ChannelInSetReference;
@@ -511,6 +965,9 @@ static ChannelIn * ChannelInCreate(ChannelIn * in) {
     in->IsDiscrete = ChannelInIsDiscrete;
     in->SetDiscrete = ChannelInSetDiscrete;
 
+    in->IsChanged = ChannelInIsChanged;
+    in->ResetChanged = ChannelInResetChanged;
+
     return in;
 }
 
@@ -639,6 +1096,10 @@ static const void * ChannelOutGetValueReference(Channel * channel) {
         return NULL;
     }
 
+    if (channel->data->store) {
+        return ChannelGetStoreValue(channel);
+    }
+
     return ChannelValueReference(&channel->data->value);
 }
 
@@ -749,6 +1210,8 @@ static void WarnAboutNaN(LogSeverity level, ChannelInfo * info, TimeInterval * t
     }
 }
 
+static McxStatus ChannelOutUpdateDouble(ChannelOut * out, TimeInterval * time);
+
 static McxStatus ChannelOutUpdate(Channel * channel, TimeInterval * time) {
     ChannelOut * out = (ChannelOut *)channel;
     ChannelInfo * info = ((Channel *)out)->GetInfo((Channel *)out);
@@ -757,6 +1220,10 @@ static McxStatus ChannelOutUpdate(Channel * channel, TimeInterval * time) {
 
     McxStatus retVal = RETURN_OK;
 
+    if (channel->data->store) {
+        return ChannelOutUpdateDouble(out, time);
+    }
+
     time->endTime = time->startTime;
     {
         size_t j = 0;
@@ -864,6 +1331,154 @@ static McxStatus ChannelOutUpdate(Channel * channel, TimeInterval * time) {
     return RETURN_OK;
 }
 
+static void ChannelOutFetchDouble(ChannelOut * out, TimeInterval * time, double * value) {
+    Channel * channel = (Channel *) out;
+
+    if (out->data->valueFunction) {
+        proc * p = (proc *) out->data->valueFunction;
+        * value = p->fn(time, p->env);
+    } else if (channel->data->internalValue) {
+        * value = * (const double *) channel->data->internalValue;
+    }
+}
+
+static void ChannelOutConvertDoubles(double * values,
+                                     const double * scales,
+                                     const double * offsets,
+                                     const double * mins,
+                                     const double * maxs,
+                                     size_t num) {
+    size_t i = 0;
+
+    // branch free, so that the compiler can vectorize it
+    for (i = 0; i < num; i++) {
+        double value = values[i];
+
+        value = value <= mins[i] ? mins[i] : value;
+        value = value >= maxs[i] ? maxs[i] : value;
+        values[i] = scales[i] * value + offsets[i];
+    }
+}
+
+static void ChannelOutNotifyConnections(ChannelOut * out, double value, TimeInterval * time) {
+    Channel * channel = (Channel *) out;
+    ObjectContainer * conns = out->data->connections;
+    size_t i = 0;
+
+#ifdef MCX_DEBUG
+    if (time->startTime < MCX_DEBUG_LOG_TIME) {
+        ChannelInfo * info = channel->GetInfo(channel);
+        MCX_DEBUG_LOG("[%f] CH OUT (%s) (%f, %f)", time->startTime, info->GetLogName(info), time->startTime, value);
+    }
+#endif // MCX_DEBUG
+
+    for (i = 0; i < conns->Size(conns); i++) {
+        Connection * connection = (Connection *) conns->At(conns, i);
+        channel->SetDefinedDuringInit(channel);
+        connection->UpdateFromInput(connection, time);
+    }
+}
+
+static McxStatus ChannelOutCheckNaN(ChannelOut * out, double value, TimeInterval * time) {
+    ChannelInfo * info = ((Channel *) out)->GetInfo((Channel *) out);
+    ObjectContainer * conns = out->data->connections;
+
+    if (!isnan(value)) {
+        return RETURN_OK;
+    }
+
+    switch (out->data->nanCheck) {
+    case NAN_CHECK_ALWAYS:
+        mcx_log(LOG_ERROR, "Outport %s at time %f is not a number (NaN)",
+               info->GetName(info), time->startTime);
+        return RETURN_ERROR;
+
+    case NAN_CHECK_CONNECTED:
+        if (conns->Size(conns) > 0) {
+            mcx_log(LOG_ERROR, "Outport %s at time %f is not a number (NaN)",
+                   info->GetName(info), time->startTime);
+            return RETURN_ERROR;
+        } else {
+            WarnAboutNaN(LOG_WARNING, info, time, &out->data->countNaNCheckWarning, &out->data->maxNumNaNCheckWarning);
+            break;
+        }
+
+    case NAN_CHECK_NEVER:
+        WarnAboutNaN((conns->Size(conns) > 0) ? LOG_ERROR : LOG_WARNING,
+                     info, time, &out->data->countNaNCheckWarning, &out->data->maxNumNaNCheckWarning);
+        break;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelOutUpdateDouble(ChannelOut * out, TimeInterval * time) {
+    Channel * channel = (Channel *) out;
+    ChannelDoubleStore * store = channel->data->store;
+    size_t idx = channel->data->storeIdx;
+
+    time->endTime = time->startTime;
+
+    ChannelOutFetchDouble(out, time, &store->values[idx]);
+
+    ChannelOutConvertDoubles(&store->values[idx], &store->scales[idx], &store->offsets[idx],
+                             &store->mins[idx], &store->maxs[idx], 1);
+
+    ChannelOutNotifyConnections(out, store->values[idx], time);
+
+    return ChannelOutCheckNaN(out, store->values[idx], time);
+}
+
+McxStatus ChannelOutUpdateDoubles(ChannelOut ** outs, ChannelDoubleStore * store, TimeInterval * time) {
+    size_t i = 0;
+
+    time->endTime = time->startTime;
+
+    for (i = 0; i < store->num; i++) {
+        ChannelOutFetchDouble(outs[i], time, &store->values[i]);
+    }
+
+    ChannelOutConvertDoubles(store->values, store->scales, store->offsets, store->mins, store->maxs, store->num);
+
+    for (i = 0; i < store->num; i++) {
+        ChannelOutNotifyConnections(outs[i], store->values[i], time);
+    }
+
+    for (i = 0; i < store->num; i++) {
+        if (RETURN_OK != ChannelOutCheckNaN(outs[i], store->values[i], time)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelOutSetValueStore(Channel * channel, ChannelDoubleStore * store, size_t idx) {
+    ChannelOut * out = (ChannelOut *) channel;
+    ChannelInfo * info = channel->GetInfo(channel);
+    ChannelDoubleConversion conversion;
+
+    ChannelSetValueStore(channel, store, idx);
+
+    ChannelDoubleConversionInit(&conversion);
+
+    if (out->data->rangeConversion && out->data->rangeConversionIsActive) {
+        if (RETURN_OK != ChannelDoubleConversionAddRange(&conversion, out->data->rangeConversion, info)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    if (out->data->linearConversion) {
+        if (RETURN_OK != ChannelDoubleConversionAddLinear(&conversion, out->data->linearConversion, info)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    ChannelDoubleConversionStore(&conversion, channel);
+
+    return RETURN_OK;
+}
+
 static void ChannelOutDestructor(ChannelOut * out) {
     object_destroy(out->data);
 }
@@ -881,6 +1496,7 @@ static ChannelOut * ChannelOutCreate(ChannelOut * out) {
     channel->IsValid           = ChannelOutIsValid;
     channel->Update            = ChannelOutUpdate;
     channel->IsConnected       = ChannelOutIsConnected;
+    channel->SetValueStore     = ChannelOutSetValueStore;
 
     out->Setup                = ChannelOutSetup;
     out->RegisterConnection   = ChannelOutRegisterConnection;
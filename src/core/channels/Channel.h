@@ -48,6 +48,30 @@ typedef McxStatus (* fChannelSetup)(Channel * channel, struct ChannelInfo * info
 
 typedef McxStatus (* fChannelUpdate)(Channel * channel, TimeInterval * time);
 
+/**
+ * Values of CHANNEL_DOUBLE channels in one contiguous array, together with
+ * the conversions of each channel compiled into an affine transform and a
+ * clamp, so that all channels can be converted in one loop:
+ *
+ *   in:  value = clamp(scale * value + offset, min, max)
+ *   out: value = scale * clamp(value, min, max) + offset
+ */
+typedef struct ChannelDoubleStore {
+    size_t num;
+
+    double * values;
+    double * scales;
+    double * offsets;
+    double * mins;
+    double * maxs;
+} ChannelDoubleStore;
+
+void ChannelDoubleStoreInit(ChannelDoubleStore * store);
+McxStatus ChannelDoubleStoreSetup(ChannelDoubleStore * store, size_t num);
+void ChannelDoubleStoreDestructor(ChannelDoubleStore * store);
+
+typedef McxStatus (* fChannelSetValueStore)(Channel * channel, ChannelDoubleStore * store, size_t idx);
+
 extern const struct ObjectClass _Channel;
 
 struct Channel {
@@ -99,6 +123,15 @@ struct Channel {
      */
     fChannelSetup Setup;
 
+    /**
+     * Virtual method.
+     *
+     * Moves the value and the compiled conversions of a CHANNEL_DOUBLE
+     * channel into slot idx of a store owned by the databus.
+     * GetValueReference() returns the slot afterwards.
+     */
+    fChannelSetValueStore SetValueStore;
+
     struct ChannelData * data;
 };
 
@@ -107,7 +140,7 @@ struct Channel {
 
 typedef struct ChannelIn ChannelIn;
 
-typedef McxStatus (* fChannelInSetup)(ChannelIn * in, struct ChannelInfo * info);
+typedef McxStatus (* fChannelInSetup)(ChannelIn * in, struct ChannelInfo * info, struct Config * config);
 
 typedef McxStatus  (* fChannelInSetReference) (ChannelIn   * in,
                                                void        * reference,
@@ -125,6 +158,9 @@ typedef McxStatus (* fChannelInSetConnection)(ChannelIn * in,
 typedef int (*fChannelInIsDiscrete)(ChannelIn * in);
 typedef void (*fChannelInSetDiscrete)(ChannelIn * in);
 
+typedef int (*fChannelInIsChanged)(ChannelIn * in);
+typedef void (*fChannelInResetChanged)(ChannelIn * in);
+
 extern const struct ObjectClass _ChannelIn;
 
 struct ChannelIn {
@@ -142,6 +178,10 @@ struct ChannelIn {
      * Sets the reference inside the component to which the value of the in
      * channel is written on every channel in Update(). Only one reference can be
      * registered and subsequent calls will fail.
+     *
+     * String buffers in the reference are reused by Update(), the component
+     * may read them but must not shrink them. Binary values are shared with
+     * the connection and must not be modified.
      */
     fChannelInSetReference SetReference;
 
@@ -168,6 +208,18 @@ struct ChannelIn {
     */
     fChannelInSetDiscrete SetDiscrete;
 
+    /**
+     * Returns true if Update() wrote a value into the component reference
+     * that differs from the previously written one since the last call of
+     * ResetChanged(). Initially true.
+     */
+    fChannelInIsChanged IsChanged;
+
+    /**
+     * Marks the current value as consumed by the component.
+     */
+    fChannelInResetChanged ResetChanged;
+
     struct ChannelInData * data;
 };
 
@@ -277,6 +329,23 @@ struct ChannelLocal {
     struct ChannelLocalData * data;
 };
 
+// ----------------------------------------------------------------------
+// Dense updates of CHANNEL_DOUBLE channels
+
+/**
+ * Updates the in channels ins[0..store->num) that are bound to the slots of
+ * store. The connection values are fetched first, then the conversions of
+ * all channels are applied in one loop over the store and finally the values
+ * are written to the component references.
+ */
+McxStatus ChannelInUpdateDoubles(ChannelIn ** ins, ChannelDoubleStore * store, TimeInterval * time);
+
+/**
+ * Updates the out channels outs[0..store->num) that are bound to the slots
+ * of store, notifies their connections and checks for NaN values.
+ */
+McxStatus ChannelOutUpdateDoubles(ChannelOut ** outs, ChannelDoubleStore * store, TimeInterval * time);
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
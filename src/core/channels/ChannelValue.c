@@ -10,11 +10,104 @@
 
 #include "core/channels/ChannelValue.h"
 #include "util/stdlib.h"
+#include "util/format.h"
+
+#if defined (ENABLE_MT)
+#include "util/atomic.h"
+#endif // ENABLE_MT
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+struct BinaryPayload {
+#if defined (ENABLE_MT)
+    McxAtomic refCount; // payloads are shared between the threads of parallel step types
+#else
+    int32_t refCount;
+#endif // ENABLE_MT
+    size_t capacity;
+    char data[1];
+};
+
+static BinaryPayload * BinaryPayloadCreate(size_t capacity) {
+    BinaryPayload * payload = (BinaryPayload *) mcx_malloc(sizeof(BinaryPayload) + capacity);
+
+    if (!payload) {
+        return NULL;
+    }
+    payload->refCount = 1;
+    payload->capacity = capacity;
+
+    return payload;
+}
+
+static void BinaryPayloadRetain(BinaryPayload * payload) {
+#if defined (ENABLE_MT)
+    mcx_atomic_fetch_add(&payload->refCount, 1);
+#else
+    payload->refCount++;
+#endif // ENABLE_MT
+}
+
+static void BinaryPayloadRelease(BinaryPayload * payload) {
+#if defined (ENABLE_MT)
+    if (1 == mcx_atomic_fetch_add(&payload->refCount, -1)) {
+#else
+    if (0 == --payload->refCount) {
+#endif // ENABLE_MT
+        mcx_free(payload);
+    }
+}
+
+// only the single holder of a payload may write to it
+static int BinaryPayloadIsUnique(BinaryPayload * payload) {
+#if defined (ENABLE_MT)
+    return 1 == mcx_atomic_load(&payload->refCount);
+#else
+    return 1 == payload->refCount;
+#endif // ENABLE_MT
+}
+
+void BinaryStringDestructor(binary_string * binary) {
+    if (binary->payload) {
+        BinaryPayloadRelease(binary->payload);
+        binary->payload = NULL;
+    } else if (binary->data) {
+        mcx_free(binary->data);
+    }
+    binary->data = NULL;
+    binary->len = 0;
+}
+
+void BinaryStringSet(binary_string * target, const binary_string * source) {
+    if (source->payload) {
+        if (source->payload != target->payload) {
+            BinaryPayloadRetain(source->payload);
+            BinaryStringDestructor(target);
+            target->payload = source->payload;
+        }
+        target->data = source->data;
+        target->len = source->len;
+        return;
+    }
+
+    // publish a new payload, the current one can be overwritten if nobody else references it
+    if (!target->payload || !BinaryPayloadIsUnique(target->payload) || target->payload->capacity < source->len) {
+        BinaryPayload * payload = BinaryPayloadCreate(source->len);
+
+        BinaryStringDestructor(target);
+        if (!payload) {
+            mcx_log(LOG_ERROR, "Port value: Memory allocation of binary value of %zu bytes failed", source->len);
+            return;
+        }
+        target->payload = payload;
+    }
+    memcpy(target->payload->data, source->data, source->len);
+    target->data = target->payload->data;
+    target->len = source->len;
+}
+
 void ChannelValueInit(ChannelValue * value, ChannelType type) {
     value->type = type;
     ChannelValueDataInit(&value->value, type);
@@ -27,10 +120,7 @@ void ChannelValueDataDestructor(ChannelValueData * data, ChannelType type) {
             data->s = NULL;
         }
     } else if (type == CHANNEL_BINARY) {
-        if (data->b.data) {
-            mcx_free(data->b.data);
-            data->b.data = NULL;
-        }
+        BinaryStringDestructor(&data->b);
     } else if (type == CHANNEL_BINARY_REFERENCE) {
         // do not free references to binary, they are not owned by the ChannelValueData
     }
@@ -54,12 +144,12 @@ char * ChannelValueToString(ChannelValue * value) {
 
     switch (value->type) {
     case CHANNEL_DOUBLE:
-        length = 1 /* sign */ + 1 /* pre decimal place */ + 1 /* dot */ + precision + digits_of_exp + 1 /* string termination */;
+        length = 1 /* sign */ + 1 /* pre decimal place */ + 1 /* dot */ + precision + 1 /* E */ + digits_of_exp + 1 /* string termination */;
         buffer = (char *) mcx_malloc(sizeof(char) * length);
         if (!buffer) {
             return NULL;
         }
-        sprintf(buffer, "%*.*E", (unsigned) precision, (unsigned) precision, value->value.d);
+        mcx_format_double_exp(value->value.d, (unsigned) precision, buffer, length);
         break;
     case CHANNEL_INTEGER:
         length = 1 /* sign */ + mcx_digits10(abs(value->value.i)) + 1 /* string termination*/;
@@ -123,16 +213,15 @@ McxStatus ChannelValueDataToStringBuffer(ChannelValueData * value, ChannelType t
     size_t length = 0;
     const size_t precision = 13;
     const uint32_t digits_of_exp = 4; // = (mcx_digits10(DBL_MAX_10_EXP) + 1 /* sign */
-    const char * doubleFmt = "%*.*E";
 
     switch (type) {
     case CHANNEL_DOUBLE:
-        length = 1 /* sign */ + 1 /* pre decimal place */ + 1 /* dot */ + precision + digits_of_exp + 1 /* string termination */;
+        length = 1 /* sign */ + 1 /* pre decimal place */ + 1 /* dot */ + precision + 1 /* E */ + digits_of_exp + 1 /* string termination */;
         if (len < length) {
             mcx_log(LOG_ERROR, "Port value to string: buffer too short. Needed: %d, given: %d", length, len);
             return RETURN_ERROR;
         }
-        sprintf(buffer, doubleFmt, (unsigned)precision, (unsigned)precision, value->d);
+        mcx_format_double_exp(value->d, (unsigned) precision, buffer, len);
         break;
     case CHANNEL_INTEGER:
         length = 1 /* sign */ + mcx_digits10(abs(value->i)) + 1 /* string termination*/;
@@ -226,6 +315,7 @@ void ChannelValueDataInit(ChannelValueData * data, ChannelType type) {
         case CHANNEL_BINARY_REFERENCE:
             data->b.len = 0;
             data->b.data = NULL;
+            data->b.payload = NULL;
             break;
         case CHANNEL_UNKNOWN:
         default:
@@ -259,14 +349,7 @@ void ChannelValueDataSetFromReference(ChannelValueData * data, ChannelType type,
         break;
     case CHANNEL_BINARY:
         if (NULL != reference && NULL != ((binary_string *) reference)->data) {
-            if (data->b.data) {
-                mcx_free(data->b.data);
-            }
-            data->b.len = ((binary_string *) reference)->len;
-            data->b.data = (char *) mcx_calloc(data->b.len, 1);
-            if (data->b.data) {
-                memcpy(data->b.data, ((binary_string *) reference)->data, data->b.len);
-            }
+            BinaryStringSet(&data->b, (const binary_string *) reference);
         }
         break;
     case CHANNEL_BINARY_REFERENCE:
@@ -323,16 +406,10 @@ void ChannelValueSetToReference(ChannelValue * value, void * reference) {
         }
         break;
     case CHANNEL_BINARY:
-        if (NULL != reference && NULL != ((binary_string *) reference)->data) {
-            mcx_free(((binary_string *) reference)->data);
-            ((binary_string *) reference)->data = NULL;
-        }
         if (value->value.b.data) {
-            ((binary_string *) reference)->len = value->value.b.len;
-            ((binary_string *) reference)->data = (char *) mcx_calloc(value->value.b.len, 1);
-            if (((binary_string *) reference)->data) {
-                memcpy(((binary_string *) reference)->data, value->value.b.data, value->value.b.len);
-            }
+            BinaryStringSet((binary_string *) reference, &value->value.b);
+        } else {
+            BinaryStringDestructor((binary_string *) reference);
         }
         break;
     case CHANNEL_BINARY_REFERENCE:
@@ -27,9 +27,17 @@ typedef struct {
     void * env;
 } proc;
 
+/*
+ * Immutable, reference counted buffer of a binary value. It is created once
+ * by the producer of a value and shared by all ports, connections and
+ * filters the value is forwarded to.
+ */
+typedef struct BinaryPayload BinaryPayload;
+
 typedef struct {
     size_t len;
     char * data;
+    BinaryPayload * payload; // owner of data if it is shared, NULL otherwise
 } binary_string;
 
 // possible types of values that can be put on channels
@@ -74,6 +82,14 @@ void ChannelValueSetToReference(ChannelValue * value, void * reference);
 
 McxStatus ChannelValueSet(ChannelValue * value, const ChannelValue * source);
 
+/*
+ * Sets target to the binary value of source. A shared source is referenced,
+ * any other source is copied into a new shared buffer. The previous value of
+ * target is released.
+ */
+void BinaryStringSet(binary_string * target, const binary_string * source);
+void BinaryStringDestructor(binary_string * binary);
+
 size_t ChannelValueTypeSize(ChannelType type);
 
 ChannelValue ** ArrayToChannelValueArray(void * values, size_t num, ChannelType type);
@@ -38,6 +38,11 @@ typedef struct ChannelData {
     const void * internalValue;
     ChannelValue value;
 
+    // slot in the double store of the databus, NULL if the value is kept in
+    // value. For in channels, value keeps the unconverted value then.
+    ChannelDoubleStore * store;
+    size_t storeIdx;
+
 } ChannelData;
 
 // ----------------------------------------------------------------------
@@ -63,6 +68,22 @@ typedef struct ChannelInData {
     int isDiscrete;
 
     void * reference;
+
+    // value in reference differs from the one consumed by the component
+    int isChanged;
+
+    // the last update got a value from the connection, otherwise the port keeps its value
+    int hasValue;
+
+    // ----------------------------------------------------------------------
+    // Buffers of string values, binary values are shared
+
+    // the buffers only grow, so that updates copy in place
+    size_t valueCapacity;       // of the value of the channel
+    char * referenceBuffer;     // last buffer written to reference
+    size_t referenceCapacity;
+
+    size_t maxBufferSize;       // 0 if unlimited
 } ChannelInData;
 
 // ----------------------------------------------------------------------
@@ -0,0 +1,28 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_FMU_FMU_EXTRACT_CACHE_H
+#define MCX_FMU_FMU_EXTRACT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// Process-wide registry of FMU fingerprints and shared extraction
+// directories (see common_fmu.c). Init has to be called before the first
+// FMU is read, Cleanup after the last FMU has been destroyed.
+void FmuExtractCacheInit(void);
+void FmuExtractCacheCleanup(void);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_FMU_FMU_EXTRACT_CACHE_H */
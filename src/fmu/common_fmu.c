@@ -15,9 +15,13 @@
 #include "util/paths.h"
 #include "util/string.h"
 #include "util/os.h"
+#include "util/mutex.h"
 
 #include "reader/model/components/specific_data/FmuInput.h"
 
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -87,20 +91,407 @@ jm_callbacks * JMGetCallbacks(void) {
 }
 
 
-static char * GetExtractPath(char * tempDir, const char * name, char * pathToFmu) {
+/* Extraction cache
+ *
+ * All instances of one FMU file share a single md5 fingerprint and, unless
+ * the FMU can only be instantiated once per process, a single extracted
+ * directory <tempDir>/fmu_<md5>. The FMU is unpacked into a private temporary
+ * directory first and installed with an atomic rename, so concurrent runs
+ * using the same temp dir never see a partial extraction. Directories in a
+ * persistent temp dir are reused by later runs.
+ */
+typedef struct FmuExtractEntry {
+    char * fmuFile;    // absolute path of the FMU file
+    char * tempDir;    // directory of the shared extraction
+    char * md5;        // fingerprint of the FMU file, NULL if it could not be computed
+    char * path;       // shared extraction directory, NULL if not installed
+
+    fmi_version_enu_t version;
+    int onlyOncePerProcess;
+
+    int isLocal;       // path is removed together with the last user
+    int hashed;
+    int installed;     // install was attempted
+
+    size_t numUsers;
+    size_t numShared;
+
+#if defined (ENABLE_MT)
+    McxMutex lock;
+#endif // ENABLE_MT
+} FmuExtractEntry;
+
+static FmuExtractEntry ** extractEntries = NULL;
+static size_t numExtractEntries = 0;
+static size_t numTempExtractions = 0; // unique suffix of temporary extraction directories
+
+#if defined (ENABLE_MT)
+static McxMutex extractEntriesLock;
+
+// fmilib unzips with the working directory of the process set to the target
+// directory, so at most one FMU may be unpacked at a time
+static McxMutex unpackLock;
+#endif // ENABLE_MT
+
+static fmi_version_enu_t FmuUnpack(FmuCommon * fmu, const char * path) {
+    fmi_version_enu_t version = fmi_version_unknown_enu;
+
+#if defined (ENABLE_MT)
+    mcx_mutex_lock(&unpackLock);
+#endif // ENABLE_MT
+
+    version = fmi_import_get_fmi_version(fmu->context, fmu->fmuFile, path);
+
+#if defined (ENABLE_MT)
+    mcx_mutex_unlock(&unpackLock);
+#endif // ENABLE_MT
+
+    return version;
+}
+
+static void FmuExtractEntryDestroy(FmuExtractEntry * entry) {
+    if (entry->fmuFile) { mcx_free(entry->fmuFile); }
+    if (entry->tempDir) { mcx_free(entry->tempDir); }
+    if (entry->md5) { mcx_free(entry->md5); }
+    if (entry->path) { mcx_free(entry->path); }
+#if defined (ENABLE_MT)
+    mcx_mutex_destroy(&entry->lock);
+#endif // ENABLE_MT
+    mcx_free(entry);
+}
+
+void FmuExtractCacheInit(void) {
+#if defined (ENABLE_MT)
+    mcx_mutex_create(&extractEntriesLock);
+    mcx_mutex_create(&unpackLock);
+#endif // ENABLE_MT
+}
+
+void FmuExtractCacheCleanup(void) {
+    size_t i = 0;
+
+    // entries are normally released by their last FMU instance
+    for (i = 0; i < numExtractEntries; i++) {
+        FmuExtractEntryDestroy(extractEntries[i]);
+    }
+    if (extractEntries) {
+        mcx_free(extractEntries);
+        extractEntries = NULL;
+    }
+    numExtractEntries = 0;
+
+#if defined (ENABLE_MT)
+    mcx_mutex_destroy(&extractEntriesLock);
+    mcx_mutex_destroy(&unpackLock);
+#endif // ENABLE_MT
+}
+
+static FmuExtractEntry * FmuExtractCacheAcquire(const char * fmuFile, const char * tempDir, int isLocal) {
+    FmuExtractEntry * entry = NULL;
+    size_t i = 0;
+
+#if defined (ENABLE_MT)
+    mcx_mutex_lock(&extractEntriesLock);
+#endif // ENABLE_MT
+
+    for (i = 0; i < numExtractEntries; i++) {
+        if (!strcmp(extractEntries[i]->fmuFile, fmuFile) && !strcmp(extractEntries[i]->tempDir, tempDir)) {
+            entry = extractEntries[i];
+            break;
+        }
+    }
+
+    if (!entry) {
+        FmuExtractEntry ** entries = (FmuExtractEntry **) mcx_realloc(extractEntries, (numExtractEntries + 1) * sizeof(FmuExtractEntry *));
+        if (entries) {
+            extractEntries = entries;
+            entry = (FmuExtractEntry *) mcx_calloc(1, sizeof(FmuExtractEntry));
+        }
+        if (entry) {
+            entry->fmuFile = mcx_string_copy(fmuFile);
+            entry->tempDir = mcx_string_copy(tempDir);
+            entry->version = fmi_version_unknown_enu;
+            entry->isLocal = isLocal;
+#if defined (ENABLE_MT)
+            mcx_mutex_create(&entry->lock);
+#endif // ENABLE_MT
+            if (!entry->fmuFile || !entry->tempDir) {
+                FmuExtractEntryDestroy(entry);
+                entry = NULL;
+            } else {
+                extractEntries[numExtractEntries++] = entry;
+            }
+        }
+    }
+
+    if (entry) {
+        entry->numUsers++;
+    }
+
+#if defined (ENABLE_MT)
+    mcx_mutex_unlock(&extractEntriesLock);
+#endif // ENABLE_MT
+
+    return entry;
+}
+
+static void FmuExtractCacheRelease(FmuExtractEntry * entry) {
+    size_t i = 0;
+
+#if defined (ENABLE_MT)
+    mcx_mutex_lock(&extractEntriesLock);
+#endif // ENABLE_MT
+
+    entry->numUsers--;
+    if (0 == entry->numUsers) {
+        for (i = 0; i < numExtractEntries; i++) {
+            if (extractEntries[i] == entry) {
+                extractEntries[i] = extractEntries[numExtractEntries - 1];
+                numExtractEntries--;
+                break;
+            }
+        }
+    } else {
+        entry = NULL;
+    }
+
+#if defined (ENABLE_MT)
+    mcx_mutex_unlock(&extractEntriesLock);
+#endif // ENABLE_MT
+
+    if (entry) {
+        if (entry->isLocal && entry->path) {
+            mcx_os_remove_dir_tree(entry->path);
+        }
+        FmuExtractEntryDestroy(entry);
+    }
+}
+
+// Returns the fingerprint of the FMU, computed once per entry
+static const char * FmuExtractEntryGetMD5(FmuExtractEntry * entry) {
+#if defined (ENABLE_MT)
+    mcx_mutex_lock(&entry->lock);
+#endif // ENABLE_MT
+
+    if (!entry->hashed) {
+        entry->md5 = mcx_md5_file_fingerprint(entry->fmuFile);
+        entry->hashed = TRUE;
+    }
+
+#if defined (ENABLE_MT)
+    mcx_mutex_unlock(&entry->lock);
+#endif // ENABLE_MT
+
+    return entry->md5;
+}
+
+static int XmlIsTrue(xmlNodePtr node, const char * name) {
+    xmlChar * value = xmlGetProp(node, (const xmlChar *) name);
+    int isTrue = FALSE;
+
+    if (value) {
+        isTrue = !strcmp((const char *) value, "true");
+        xmlFree(value);
+    }
+
+    return isTrue;
+}
+
+// FMI 2: <CoSimulation>, <ModelExchange>
+// FMI 1: <Implementation><CoSimulation_StandAlone|CoSimulation_Tool><Capabilities>
+static int XmlOnlyOncePerProcess(xmlNodePtr node, int depth) {
+    static const char * names[] = {
+        "CoSimulation", "ModelExchange", "Implementation", "CoSimulation_StandAlone", "CoSimulation_Tool", "Capabilities", NULL
+    };
+    xmlNodePtr child = NULL;
+    size_t i = 0;
+
+    if (XmlIsTrue(node, "canBeInstantiatedOnlyOncePerProcess")) {
+        return TRUE;
+    }
+    if (0 == depth) {
+        return FALSE;
+    }
+
+    for (child = node->children; child; child = child->next) {
+        if (XML_ELEMENT_NODE != child->type) {
+            continue;
+        }
+        for (i = 0; names[i]; i++) {
+            if (!strcmp((const char *) child->name, names[i])) {
+                if (XmlOnlyOncePerProcess(child, depth - 1)) {
+                    return TRUE;
+                }
+                break;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+static McxStatus FmuReadExtractInfo(const char * path, fmi_version_enu_t * version, int * onlyOncePerProcess) {
+    const char * pathList[2] = {path, "modelDescription.xml"};
+    char * fileName = NULL;
+    xmlDocPtr doc = NULL;
+    xmlNodePtr root = NULL;
+    xmlChar * fmiVersion = NULL;
+
+    mcx_path_merge(pathList, 2, &fileName);
+    if (!fileName) {
+        return RETURN_ERROR;
+    }
+
+    doc = xmlReadFile(fileName, NULL, XML_PARSE_NONET);
+    mcx_free(fileName);
+    if (!doc) {
+        return RETURN_ERROR;
+    }
+
+    root = xmlDocGetRootElement(doc);
+    if (root) {
+        fmiVersion = xmlGetProp(root, (const xmlChar *) "fmiVersion");
+    }
+    if (!fmiVersion) {
+        *version = fmi_version_unknown_enu;
+    } else if (!strcmp((const char *) fmiVersion, "1.0")) {
+        *version = fmi_version_1_enu;
+    } else if (!strncmp((const char *) fmiVersion, "2.", 2)) {
+        *version = fmi_version_2_0_enu;
+    } else {
+        *version = fmi_version_unsupported_enu;
+    }
+    if (fmiVersion) { xmlFree(fmiVersion); }
+
+    *onlyOncePerProcess = root ? XmlOnlyOncePerProcess(root, 3) : FALSE;
+
+    xmlFreeDoc(doc);
+
+    return RETURN_OK;
+}
+
+// Installs <tempDir>/fmu_<md5> or picks up an existing one. Expects entry->lock to be held.
+static McxStatus FmuExtractEntryInstall(FmuExtractEntry * entry, FmuCommon * fmu) {
+    const char * pathList[2] = {entry->tempDir, NULL};
+    char * subDir = NULL;
+    char * path = NULL;
+    char * tmpPath = NULL;
+    McxStatus retVal = RETURN_OK;
+
+    subDir = (char *) mcx_calloc(strlen("fmu_") + strlen(entry->md5) + 1, sizeof(char));
+    if (!subDir) {
+        return RETURN_ERROR;
+    }
+    sprintf(subDir, "fmu_%s", entry->md5);
+    pathList[1] = subDir;
+    mcx_path_merge(pathList, 2, &path);
+    mcx_free(subDir);
+    if (!path) {
+        return RETURN_ERROR;
+    }
+
+    if (!mcx_os_path_exists(path)) {
+        size_t id = 0;
+
+#if defined (ENABLE_MT)
+        mcx_mutex_lock(&extractEntriesLock);
+#endif // ENABLE_MT
+        id = numTempExtractions++;
+#if defined (ENABLE_MT)
+        mcx_mutex_unlock(&extractEntriesLock);
+#endif // ENABLE_MT
+
+        tmpPath = (char *) mcx_calloc(strlen(path) + 64, sizeof(char));
+        if (!tmpPath) {
+            mcx_free(path);
+            return RETURN_ERROR;
+        }
+        sprintf(tmpPath, "%s.%ld_%zu.tmp", path, mcx_os_get_pid(), id);
+
+        retVal = mcx_os_mkdir_recursive(tmpPath);
+        if (RETURN_OK == retVal) {
+            mcx_log(LOG_DEBUG, "%s: Unpacking %s to %s", fmu->instanceName, fmu->fmuFile, path);
+            if (fmi_version_unknown_enu == FmuUnpack(fmu, tmpPath)) {
+                retVal = RETURN_ERROR;
+            }
+        }
+        if (RETURN_OK == retVal && 0 != mcx_os_rename(tmpPath, path)) {
+            // another process installed the same FMU in the meantime
+            mcx_log(LOG_DEBUG, "%s: %s is already installed", fmu->instanceName, path);
+        }
+        if (mcx_os_path_exists(tmpPath)) {
+            mcx_os_remove_dir_tree(tmpPath);
+        }
+        mcx_free(tmpPath);
+    } else {
+        mcx_log(LOG_DEBUG, "%s: Reusing extracted FMU %s", fmu->instanceName, path);
+    }
+
+    if (RETURN_OK == retVal) {
+        retVal = FmuReadExtractInfo(path, &entry->version, &entry->onlyOncePerProcess);
+    }
+    if (RETURN_OK == retVal
+        && fmi_version_1_enu != entry->version
+        && fmi_version_2_0_enu != entry->version) {
+        retVal = RETURN_ERROR;
+    }
+
+    if (RETURN_OK == retVal) {
+        entry->path = path;
+    } else {
+        mcx_log(LOG_DEBUG, "%s: Could not install shared extraction %s", fmu->instanceName, path);
+        mcx_free(path);
+    }
+
+    return retVal;
+}
+
+// Lets the FMU use the shared extraction, returns TRUE if it does
+static int FmuExtractEntryShare(FmuExtractEntry * entry, FmuCommon * fmu) {
+    int isShared = FALSE;
+
+#if defined (ENABLE_MT)
+    mcx_mutex_lock(&entry->lock);
+#endif // ENABLE_MT
+
+    if (!entry->installed) {
+        FmuExtractEntryInstall(entry, fmu);
+        entry->installed = TRUE;
+    }
+
+    // FMUs that can only be instantiated once need a private copy of their binaries
+    if (entry->path && (!entry->onlyOncePerProcess || 0 == entry->numShared)) {
+        char * path = mcx_string_copy(entry->path);
+        if (path) {
+            mcx_free(fmu->path);
+            fmu->path = path;
+            fmu->version = entry->version;
+            entry->numShared++;
+            isShared = TRUE;
+        }
+    }
+
+#if defined (ENABLE_MT)
+    mcx_mutex_unlock(&entry->lock);
+#endif // ENABLE_MT
+
+    return isShared;
+}
+
+static char * GetExtractPath(char * tempDir, const char * name, const char * md5String) {
     char * extractPath = NULL;
-    char * md5String = mcx_md5_file_fingerprint(pathToFmu);
     char * subDir = NULL;
 
     const char * pathList[2] = {tempDir, subDir};
 
     if (NULL == md5String) {
-        const char defaultMD5[] = "0000";
-        md5String = (char *) mcx_calloc(strlen(defaultMD5) + 1, sizeof(char));
-        strcpy(md5String, defaultMD5);
+        md5String = "0000";
     }
 
     subDir = (char *) mcx_calloc(strlen(name)+strlen(md5String)+2, sizeof(char));
+    if (NULL == subDir) {
+        return NULL;
+    }
 
     sprintf(subDir, "%s_%s", name, md5String);
 
@@ -108,12 +499,7 @@ static char * GetExtractPath(char * tempDir, const char * name, char * pathToFmu
 
     mcx_path_merge(pathList, 2, &extractPath);
 
-    if (NULL != md5String) {
-        mcx_free(md5String);
-    }
-    if (NULL != subDir) {
-        mcx_free(subDir);
-    }
+    mcx_free(subDir);
 
     return extractPath;
 }
@@ -123,6 +509,7 @@ McxStatus CreateFmuExtractPath(FmuCommon * fmu, const char * name, const Config
     char * tempDir = NULL;
     char * encodedName = NULL;
     char * localName = NULL;
+    char * fmuFile = NULL;
 
     if (NULL == config) {
         mcx_log(LOG_ERROR, "FMU: The config is not set correctly");
@@ -136,6 +523,23 @@ McxStatus CreateFmuExtractPath(FmuCommon * fmu, const char * name, const Config
         fmu->isLocal = TRUE;
     }
 
+    // fmilibrary does not normalize paths when joining them so they might get too long.
+    // With mcx_path_get_absolute we normalize the path before.
+    fmuFile = mcx_path_get_absolute(fmu->fmuFile);
+    if (!fmuFile) {
+        mcx_log(LOG_ERROR, "%s: could not get absolute path of %s", name, fmu->fmuFile);
+        return RETURN_ERROR;
+    }
+    mcx_free(fmu->fmuFile);
+    fmu->fmuFile = fmuFile;
+
+    fmu->extractEntry = FmuExtractCacheAcquire(fmu->fmuFile, tempDir, fmu->isLocal);
+    if (!fmu->extractEntry) {
+        mcx_log(LOG_ERROR, "%s: could not register %s", name, fmu->fmuFile);
+        return RETURN_ERROR;
+    }
+    fmu->shareExtraction = config->fmuSharedExtraction;
+
     // encode " " and "_" with escape char "_" for (OM)FMUs who cannot decode "%20"
     encodedName = mcx_string_encode_filename(name);
     if (encodedName) {
@@ -143,7 +547,7 @@ McxStatus CreateFmuExtractPath(FmuCommon * fmu, const char * name, const Config
         mcx_free(encodedName);
     }
     if (localName) {
-        fmu->path = GetExtractPath(tempDir, localName, fmu->fmuFile);
+        fmu->path = GetExtractPath(tempDir, localName, FmuExtractEntryGetMD5(fmu->extractEntry));
         mcx_free(localName);
     } else {
         mcx_log(LOG_ERROR, "%s: could not encode name", name);
@@ -172,6 +576,9 @@ void FmuCommonInit(FmuCommon * fmu) {
     fmu->path = NULL;
     fmu->instanceName = NULL;
     fmu->isLocal = 0;
+    fmu->extractEntry = NULL;
+    fmu->shareExtraction = FALSE;
+    fmu->isShared = FALSE;
 }
 
 McxStatus FmuCommonRead(FmuCommon * common, FmuInput * input) {
@@ -187,12 +594,14 @@ void FmuCommonDestructor(FmuCommon * fmu) {
         fmi_import_free_context(fmu->context);
     }
     if (fmu->path) {
-        if (fmu->isLocal
-            ) {
+        if (fmu->isLocal && !fmu->isShared) {
             McxStatus retVal = mcx_os_remove_dir_tree(fmu->path);
         }
         mcx_free(fmu->path);
     }
+    if (fmu->extractEntry) {
+        FmuExtractCacheRelease(fmu->extractEntry);
+    }
 
     if (fmu->instanceName) {
         mcx_free(fmu->instanceName);
@@ -259,18 +668,20 @@ McxStatus FmuOpen(FmuCommon * fmu, const struct Config * const config) {
 
     fmu->context = fmi_import_allocate_context(&fmu->callbacks);
 
+    if (fmu->shareExtraction && fmu->extractEntry && FmuExtractEntryGetMD5(fmu->extractEntry)) {
+        fmu->isShared = FmuExtractEntryShare(fmu->extractEntry, fmu);
+        if (fmu->isShared) {
+            mcx_log(LOG_DEBUG, "%s: Using extracted FMU %s", fmu->instanceName, fmu->path);
+            return RETURN_OK;
+        }
+    }
+
     {
         retVal = mcx_os_mkdir_recursive(fmu->path);
 
         if (RETURN_OK == retVal) {
-            // fmilibrary does not normalize paths when joining them so they might get too long.
-            // With mcx_path_get_absolute we normalize the path before.
-            char * fmuFile = mcx_path_get_absolute(fmu->fmuFile);
-            mcx_free(fmu->fmuFile);
-            fmu->fmuFile = fmuFile;
-
             mcx_log(LOG_DEBUG, "%s: Unpacking %s to %s", fmu->instanceName, fmu->fmuFile, fmu->path);
-            fmu->version = fmi_import_get_fmi_version(fmu->context, fmu->fmuFile, fmu->path);
+            fmu->version = FmuUnpack(fmu, fmu->path);
         }
         else {
             mcx_log(LOG_ERROR, "%s: Cannot create %s to unpack %s", fmu->instanceName, fmu->path, fmu->fmuFile);
@@ -14,6 +14,7 @@
 #include "CentralParts.h"
 #include "reader/model/components/specific_data/FmuInput.h"
 #include "core/Config.h"
+#include "fmu/FmuExtractCache.h"
 
 #include "fmilib.h"
 
@@ -39,6 +40,10 @@ typedef struct FmuCommon {
     char * path;
 
     int isLocal;
+
+    struct FmuExtractEntry * extractEntry; // process-wide extraction cache entry of fmuFile
+    int shareExtraction;
+    int isShared; // path is the shared extraction of fmuFile
 } FmuCommon;
 
 
@@ -76,6 +76,13 @@ McxStatus Fmu2CommonStructInit(Fmu2CommonStruct * fmu) {
     fmu->numLogCategories = 0;
     fmu->logCategories = NULL;
 
+    Fmu2VariableBatchInit(&fmu->inBatch);
+    Fmu2VariableBatchInit(&fmu->outBatch);
+    Fmu2VariableBatchInit(&fmu->localBatch);
+
+    fmu->numInputSets = 0;
+    fmu->numSkippedInputSets = 0;
+
     return RETURN_OK;
 }
 
@@ -202,8 +209,26 @@ McxStatus Fmu2CommonStructSetup(FmuCommon * common, Fmu2CommonStruct * fmu2, fmi
     return retVal;
 }
 
+McxStatus Fmu2CommonStructSetupBatches(Fmu2CommonStruct * fmu) {
+    if (RETURN_OK != Fmu2VariableBatchSetup(&fmu->inBatch, fmu->in)) {
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != Fmu2VariableBatchSetup(&fmu->outBatch, fmu->out)) {
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != Fmu2VariableBatchSetup(&fmu->localBatch, fmu->localValues)) {
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
 void Fmu2CommonStructDestructor(Fmu2CommonStruct * fmu) {
     size_t i = 0;
+
+    Fmu2VariableBatchDestructor(&fmu->inBatch);
+    Fmu2VariableBatchDestructor(&fmu->outBatch);
+    Fmu2VariableBatchDestructor(&fmu->localBatch);
     if (fmu->in) {
         fmu->in->DestroyObjects(fmu->in);
         object_destroy(fmu->in);
@@ -760,8 +785,9 @@ McxStatus Fmu2GetVariable(Fmu2CommonStruct * fmu, Fmu2Value * fmuVal) {
 
         status = fmi2_import_get_integer(fmu->fmiImport, vrs, 3, vs);
 
-    binary.len = vs[2];
-    binary.data = (char *) ((((long long)vs[1] & 0xffffffff) << 32) | (vs[0] & 0xffffffff));
+        binary.len = vs[2];
+        binary.data = (char *) ((((long long)vs[1] & 0xffffffff) << 32) | (vs[0] & 0xffffffff));
+        binary.payload = NULL; // owned by the FMU, published as a new payload
 
         ChannelValueSetFromReference(chVal, &binary);
 
@@ -808,6 +834,351 @@ McxStatus Fmu2GetVariableArray(Fmu2CommonStruct * fmu, ObjectContainer * vals) {
     return RETURN_OK;
 }
 
+static Fmu2BatchType Fmu2BatchTypeOfValue(Fmu2Value * fmuVal) {
+    if (FMU2_VALUE_SCALAR != fmuVal->data->type) {
+        return FMU2_BATCH_OTHER;
+    }
+
+    switch (ChannelValueType(&fmuVal->val)) {
+    case CHANNEL_DOUBLE:
+        return FMU2_BATCH_REAL;
+    case CHANNEL_INTEGER:
+        return FMU2_BATCH_INTEGER;
+    case CHANNEL_BOOL:
+        return FMU2_BATCH_BOOLEAN;
+    case CHANNEL_STRING:
+        return FMU2_BATCH_STRING;
+    default:
+        return FMU2_BATCH_OTHER;
+    }
+}
+
+static size_t Fmu2BatchTypeSize(Fmu2BatchType type) {
+    switch (type) {
+    case FMU2_BATCH_REAL:
+        return sizeof(fmi2_real_t);
+    case FMU2_BATCH_INTEGER:
+        return sizeof(fmi2_integer_t);
+    case FMU2_BATCH_BOOLEAN:
+        return sizeof(fmi2_boolean_t);
+    case FMU2_BATCH_STRING:
+        return sizeof(fmi2_string_t);
+    default:
+        return 0;
+    }
+}
+
+void Fmu2VariableBatchInit(Fmu2VariableBatch * batch) {
+    size_t i = 0;
+
+    for (i = 0; i < FMU2_BATCH_NUM_TYPES; i++) {
+        batch->types[i].num = 0;
+        batch->types[i].vals = NULL;
+        batch->types[i].vrs = NULL;
+        batch->types[i].values = NULL;
+        batch->types[i].changedVrs = NULL;
+    }
+
+    batch->allDefined = FALSE;
+}
+
+McxStatus Fmu2VariableBatchSetup(Fmu2VariableBatch * batch, ObjectContainer * vals) {
+    size_t numVals = vals->Size(vals);
+    size_t i = 0;
+
+    Fmu2VariableBatchDestructor(batch);
+
+    for (i = 0; i < FMU2_BATCH_NUM_TYPES; i++) {
+        Fmu2TypedBatch * typed = &batch->types[i];
+
+        // allocate for the worst case, a batch is built only once
+        typed->vals = (Fmu2Value **) mcx_calloc(numVals + 1, sizeof(Fmu2Value *));
+        typed->vrs = (fmi2_value_reference_t *) mcx_calloc(numVals + 1, sizeof(fmi2_value_reference_t));
+        if (FMU2_BATCH_OTHER != i) {
+            typed->values = mcx_calloc(numVals + 1, Fmu2BatchTypeSize((Fmu2BatchType) i));
+            typed->changedVrs = (fmi2_value_reference_t *) mcx_calloc(numVals + 1, sizeof(fmi2_value_reference_t));
+        }
+        if (!typed->vals || !typed->vrs || (FMU2_BATCH_OTHER != i && (!typed->values || !typed->changedVrs))) {
+            mcx_log(LOG_ERROR, "FMU: Memory allocation for variable batch failed");
+            return RETURN_ERROR;
+        }
+    }
+
+    for (i = 0; i < numVals; i++) {
+        Fmu2Value * fmuVal = (Fmu2Value *) vals->At(vals, i);
+        Fmu2TypedBatch * typed = &batch->types[Fmu2BatchTypeOfValue(fmuVal)];
+
+        typed->vals[typed->num] = fmuVal;
+        if (FMU2_VALUE_SCALAR == fmuVal->data->type) {
+            typed->vrs[typed->num] = fmuVal->data->vr.scalar;
+        }
+        typed->num++;
+    }
+
+    batch->allDefined = FALSE;
+
+    return RETURN_OK;
+}
+
+void Fmu2VariableBatchDestructor(Fmu2VariableBatch * batch) {
+    size_t i = 0;
+
+    for (i = 0; i < FMU2_BATCH_NUM_TYPES; i++) {
+        Fmu2TypedBatch * typed = &batch->types[i];
+
+        if (typed->vals) { mcx_free(typed->vals); }
+        if (typed->vrs) { mcx_free(typed->vrs); }
+        if (typed->values) { mcx_free(typed->values); }
+        if (typed->changedVrs) { mcx_free(typed->changedVrs); }
+    }
+
+    Fmu2VariableBatchInit(batch);
+}
+
+static int Fmu2VariableBatchAllDefined(Fmu2VariableBatch * batch) {
+    size_t i = 0;
+    size_t j = 0;
+
+    // channels never become undefined again
+    if (batch->allDefined) {
+        return TRUE;
+    }
+
+    for (i = 0; i < FMU2_BATCH_NUM_TYPES; i++) {
+        Fmu2TypedBatch * typed = &batch->types[i];
+
+        for (j = 0; j < typed->num; j++) {
+            Channel * channel = typed->vals[j]->channel;
+
+            if (channel && FALSE == channel->IsDefinedDuringInit(channel)) {
+                return FALSE;
+            }
+        }
+    }
+
+    batch->allDefined = TRUE;
+
+    return TRUE;
+}
+
+static int Fmu2InputIsChanged(Fmu2Value * fmuVal) {
+    ChannelIn * in = (ChannelIn *) fmuVal->channel;
+
+    // inputs without channel are always sent
+    return NULL == in || in->IsChanged(in);
+}
+
+static void Fmu2InputResetChanged(Fmu2Value * fmuVal) {
+    ChannelIn * in = (ChannelIn *) fmuVal->channel;
+
+    if (in) {
+        in->ResetChanged(in);
+    }
+}
+
+static McxStatus Fmu2SetTypedValues(Fmu2CommonStruct * fmu, Fmu2TypedBatch * typed, Fmu2BatchType type) {
+    fmi2_status_t status = fmi2_status_ok;
+    size_t numChanged = 0;
+    size_t i = 0;
+
+    if (0 == typed->num) {
+        return RETURN_OK;
+    }
+
+    for (i = 0; i < typed->num; i++) {
+        ChannelValue * chVal = &typed->vals[i]->val;
+
+        if (!Fmu2InputIsChanged(typed->vals[i])) {
+            continue;
+        }
+
+        switch (type) {
+        case FMU2_BATCH_REAL:
+            ((fmi2_real_t *) typed->values)[numChanged] = chVal->value.d;
+            break;
+        case FMU2_BATCH_INTEGER:
+            ((fmi2_integer_t *) typed->values)[numChanged] = chVal->value.i;
+            break;
+        case FMU2_BATCH_BOOLEAN:
+            ((fmi2_boolean_t *) typed->values)[numChanged] = chVal->value.i;
+            break;
+        case FMU2_BATCH_STRING:
+            ((fmi2_string_t *) typed->values)[numChanged] = chVal->value.s;
+            break;
+        default:
+            break;
+        }
+        typed->changedVrs[numChanged] = typed->vrs[i];
+        numChanged++;
+    }
+
+    fmu->numInputSets += typed->num;
+    fmu->numSkippedInputSets += typed->num - numChanged;
+
+    if (0 == numChanged) {
+        return RETURN_OK;
+    }
+
+    switch (type) {
+    case FMU2_BATCH_REAL:
+        status = fmi2_import_set_real(fmu->fmiImport, typed->changedVrs, numChanged, (const fmi2_real_t *) typed->values);
+        break;
+    case FMU2_BATCH_INTEGER:
+        status = fmi2_import_set_integer(fmu->fmiImport, typed->changedVrs, numChanged, (const fmi2_integer_t *) typed->values);
+        break;
+    case FMU2_BATCH_BOOLEAN:
+        status = fmi2_import_set_boolean(fmu->fmiImport, typed->changedVrs, numChanged, (const fmi2_boolean_t *) typed->values);
+        break;
+    case FMU2_BATCH_STRING:
+        status = fmi2_import_set_string(fmu->fmiImport, typed->changedVrs, numChanged, (const fmi2_string_t *) typed->values);
+        break;
+    default:
+        break;
+    }
+
+    if (fmi2_status_ok != status) {
+        // set the variables one by one to report the failing ones
+        for (i = 0; i < typed->num; i++) {
+            if (!Fmu2InputIsChanged(typed->vals[i])) {
+                continue;
+            }
+            if (RETURN_ERROR == Fmu2SetVariable(fmu, typed->vals[i])) {
+                return RETURN_ERROR;
+            }
+        }
+    }
+
+    for (i = 0; i < typed->num; i++) {
+        Fmu2InputResetChanged(typed->vals[i]);
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus Fmu2GetTypedValues(Fmu2CommonStruct * fmu, Fmu2TypedBatch * typed, Fmu2BatchType type) {
+    fmi2_status_t status = fmi2_status_ok;
+    size_t i = 0;
+
+    if (0 == typed->num) {
+        return RETURN_OK;
+    }
+
+    switch (type) {
+    case FMU2_BATCH_REAL:
+        status = fmi2_import_get_real(fmu->fmiImport, typed->vrs, typed->num, (fmi2_real_t *) typed->values);
+        break;
+    case FMU2_BATCH_INTEGER:
+        status = fmi2_import_get_integer(fmu->fmiImport, typed->vrs, typed->num, (fmi2_integer_t *) typed->values);
+        break;
+    case FMU2_BATCH_BOOLEAN:
+        status = fmi2_import_get_boolean(fmu->fmiImport, typed->vrs, typed->num, (fmi2_boolean_t *) typed->values);
+        break;
+    case FMU2_BATCH_STRING:
+        status = fmi2_import_get_string(fmu->fmiImport, typed->vrs, typed->num, (fmi2_string_t *) typed->values);
+        break;
+    default:
+        break;
+    }
+
+    if (fmi2_status_ok != status) {
+        // get the variables one by one to report the failing ones
+        for (i = 0; i < typed->num; i++) {
+            if (RETURN_ERROR == Fmu2GetVariable(fmu, typed->vals[i])) {
+                mcx_log(LOG_ERROR, "FMU: Getting of variable array failed at element %zu", i);
+                return RETURN_ERROR;
+            }
+        }
+
+        return RETURN_OK;
+    }
+
+    for (i = 0; i < typed->num; i++) {
+        ChannelValue * chVal = &typed->vals[i]->val;
+
+        switch (type) {
+        case FMU2_BATCH_REAL:
+            chVal->value.d = ((fmi2_real_t *) typed->values)[i];
+            break;
+        case FMU2_BATCH_INTEGER:
+            chVal->value.i = ((fmi2_integer_t *) typed->values)[i];
+            break;
+        case FMU2_BATCH_BOOLEAN:
+            chVal->value.i = ((fmi2_boolean_t *) typed->values)[i];
+            break;
+        case FMU2_BATCH_STRING:
+            // copies the string owned by the FMU
+            ChannelValueSetFromReference(chVal, &((fmi2_string_t *) typed->values)[i]);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return RETURN_OK;
+}
+
+McxStatus Fmu2SetVariableBatch(Fmu2CommonStruct * fmu, Fmu2VariableBatch * batch) {
+    Fmu2TypedBatch * others = &batch->types[FMU2_BATCH_OTHER];
+    size_t i = 0;
+
+    // undefined inputs must not be set, which is only checked on the slow
+    // path. It sends all inputs and keeps them marked as changed, so that the
+    // first batched set sends all of them again.
+    if (!Fmu2VariableBatchAllDefined(batch)) {
+        for (i = 0; i < FMU2_BATCH_NUM_TYPES; i++) {
+            size_t j = 0;
+
+            for (j = 0; j < batch->types[i].num; j++) {
+                if (RETURN_ERROR == Fmu2SetVariable(fmu, batch->types[i].vals[j])) {
+                    return RETURN_ERROR;
+                }
+            }
+        }
+
+        return RETURN_OK;
+    }
+
+    for (i = 0; i < FMU2_BATCH_OTHER; i++) {
+        if (RETURN_ERROR == Fmu2SetTypedValues(fmu, &batch->types[i], (Fmu2BatchType) i)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    for (i = 0; i < others->num; i++) {
+        fmu->numInputSets++;
+        if (!Fmu2InputIsChanged(others->vals[i])) {
+            fmu->numSkippedInputSets++;
+            continue;
+        }
+        if (RETURN_ERROR == Fmu2SetVariable(fmu, others->vals[i])) {
+            return RETURN_ERROR;
+        }
+        Fmu2InputResetChanged(others->vals[i]);
+    }
+
+    return RETURN_OK;
+}
+
+McxStatus Fmu2GetVariableBatch(Fmu2CommonStruct * fmu, Fmu2VariableBatch * batch) {
+    Fmu2TypedBatch * others = &batch->types[FMU2_BATCH_OTHER];
+    size_t i = 0;
+
+    for (i = 0; i < FMU2_BATCH_OTHER; i++) {
+        if (RETURN_ERROR == Fmu2GetTypedValues(fmu, &batch->types[i], (Fmu2BatchType) i)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    for (i = 0; i < others->num; i++) {
+        if (RETURN_ERROR == Fmu2GetVariable(fmu, others->vals[i])) {
+            mcx_log(LOG_ERROR, "FMU: Getting of variable array failed at element %zu", i);
+            return RETURN_ERROR;
+        }
+    }
+
+    return RETURN_OK;
+}
+
 int fmi2FilterLocalVariables(fmi2_import_variable_t *vl, void *data) {
     fmi2_causality_enu_t causality = fmi2_import_get_causality(vl);
     if (fmi2_causality_enu_local == causality) {
@@ -40,6 +40,44 @@ McxStatus Fmu2GetVariable(Fmu2CommonStruct * fmu, Fmu2Value * fmuVal);
 
 McxStatus Fmi2RegisterLocalChannelsAtDatabus(ObjectContainer * vals, const char * compName, Databus * db);
 
+typedef enum Fmu2BatchType {
+    FMU2_BATCH_REAL,
+    FMU2_BATCH_INTEGER,
+    FMU2_BATCH_BOOLEAN,
+    FMU2_BATCH_STRING,
+    FMU2_BATCH_OTHER,       // binary values, always exchanged one by one
+    FMU2_BATCH_NUM_TYPES
+} Fmu2BatchType;
+
+typedef struct Fmu2TypedBatch {
+    size_t num;
+    Fmu2Value ** vals;
+    fmi2_value_reference_t * vrs;
+    void * values;          // fmi2_real_t, fmi2_integer_t, fmi2_boolean_t or fmi2_string_t
+
+    // value references of the changed inputs, compacted on every set
+    fmi2_value_reference_t * changedVrs;
+} Fmu2TypedBatch;
+
+/*
+ * Value references and value buffers of a list of Fmu2Values grouped by
+ * type, so that each type can be exchanged with a single FMI call.
+ */
+typedef struct Fmu2VariableBatch {
+    Fmu2TypedBatch types[FMU2_BATCH_NUM_TYPES];
+
+    // inputs: all channels have a value, so no variable has to be skipped
+    int allDefined;
+} Fmu2VariableBatch;
+
+void Fmu2VariableBatchInit(Fmu2VariableBatch * batch);
+McxStatus Fmu2VariableBatchSetup(Fmu2VariableBatch * batch, ObjectContainer * vals);
+void Fmu2VariableBatchDestructor(Fmu2VariableBatch * batch);
+
+// sets the inputs of the batch whose channel value changed since the last set
+McxStatus Fmu2SetVariableBatch(Fmu2CommonStruct * fmu, Fmu2VariableBatch * batch);
+McxStatus Fmu2GetVariableBatch(Fmu2CommonStruct * fmu, Fmu2VariableBatch * batch);
+
 struct Fmu2CommonStruct {
     fmi2_import_t * fmiImport;
     fmi2_boolean_t isLogging;
@@ -55,6 +93,15 @@ struct Fmu2CommonStruct {
     ObjectContainer * localValues;
     ObjectContainer * tunableParams;
 
+    // batched exchange of in, out and localValues during DoStep
+    Fmu2VariableBatch inBatch;
+    Fmu2VariableBatch outBatch;
+    Fmu2VariableBatch localBatch;
+
+    // inputs whose value did not change since the last set are not sent
+    size_t numInputSets;
+    size_t numSkippedInputSets;
+
     size_t numLogCategories;
     fmi2_string_t * logCategories;
 
@@ -63,6 +110,7 @@ struct Fmu2CommonStruct {
 McxStatus Fmu2CommonStructInit(Fmu2CommonStruct * fmu);
 McxStatus Fmu2CommonStructRead(FmuCommon * common, Fmu2CommonStruct * fmu2, fmi2_type_t fmu_type, FmuInput * input);
 McxStatus Fmu2CommonStructSetup(FmuCommon * common, Fmu2CommonStruct * fmu2, fmi2_type_t fmu_type);
+McxStatus Fmu2CommonStructSetupBatches(Fmu2CommonStruct * fmu);
 void Fmu2CommonStructDestructor(Fmu2CommonStruct * fmu);
 
 int Fmu2ValueIsContainedInObjectContainerPred(Object * obj, void * ctx);
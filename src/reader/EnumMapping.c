@@ -28,6 +28,21 @@ MapStringInt storeLevelMapping[] = {
 
 MapStringInt backendTypeMapping[] = {
     {"csv", BACKEND_CSV},
+    {"binary", BACKEND_BINARY},
+    {"stream", BACKEND_STREAM},
+    {NULL, 0}
+};
+
+MapStringInt resultFilterTypeMapping[] = {
+    {"deadband", RESULT_FILTER_DEADBAND},
+    {"swingingDoor", RESULT_FILTER_SWINGING_DOOR},
+    {"minMax", RESULT_FILTER_MIN_MAX},
+    {NULL, 0}
+};
+
+MapStringInt compressionTypeMapping[] = {
+    {"none", COMPRESSION_NONE},
+    {"gzip", COMPRESSION_GZIP},
     {NULL, 0}
 };
 
@@ -42,6 +57,14 @@ MapStringInt stepTypeMapping[] = {
     {"parallel_single_thread",    STEP_TYPE_PARALLEL_ST},
     {"parallel_one_step_size",    STEP_TYPE_PARALLEL_MT},
     {"parallel_sync_all",         STEP_TYPE_PARALLEL_MT},
+    {"sequential_multithreaded",  STEP_TYPE_SEQUENTIAL_MT},
+    {NULL, 0}
+};
+
+MapStringInt schedulerMapping[] = {
+    {"shared_queue",  STEP_TYPE_SCHEDULER_SHARED_QUEUE},
+    {"work_stealing", STEP_TYPE_SCHEDULER_WORK_STEALING},
+    {"static",        STEP_TYPE_SCHEDULER_STATIC},
     {NULL, 0}
 };
 
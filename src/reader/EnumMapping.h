@@ -20,8 +20,11 @@ extern "C" {
 
 extern MapStringInt storeLevelMapping[];
 extern MapStringInt backendTypeMapping[];
+extern MapStringInt compressionTypeMapping[];
+extern MapStringInt resultFilterTypeMapping[];
 extern MapStringInt endTypeMapping[];
 extern MapStringInt stepTypeMapping[];
+extern MapStringInt schedulerMapping[];
 
 extern MapStringInt interExtrapolationIntervalMapping[];
 extern MapStringInt interExtrapolationOrderMapping[];
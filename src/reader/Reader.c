@@ -97,13 +97,17 @@ static InputRoot * ReadMcxExe(Reader * reader, const char * file) {
 
     switch (reader->format_) {
         case FILE_FORMAT_SSD:
-            return SSDReadMcx(file, reader->GetSSDComponents_(reader));
+            return SSDReadMcx(file, reader->GetSSDComponents_(reader), reader->validated_);
         default:
             mcx_log(LOG_ERROR, "Unknown input file format");
             return NULL;
     }
 }
 
+static void ReaderSetValidated(Reader * reader, int validated) {
+    reader->validated_ = validated;
+}
+
 static SSDComponentSpecificDataDefinition ** ReaderGetSSDComponents(Reader * reader) {
     return ssdMcxExeComponents;
 }
@@ -114,10 +118,12 @@ static void ReaderDestructor(Reader * reader) {
 static Reader * ReaderCreate(Reader * reader) {
     reader->reader_initialised_ = FALSE;
     reader->format_ = FILE_FORMAT_UNKNOWN;
+    reader->validated_ = FALSE;
 
     reader->Setup = ReaderSetup;
     reader->Cleanup = ReaderCleanup;
     reader->Read = ReadMcxExe;
+    reader->SetValidated = ReaderSetValidated;
 
     reader->GetSSDComponents_ = ReaderGetSSDComponents;
 
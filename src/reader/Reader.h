@@ -36,6 +36,7 @@ typedef struct Reader Reader;
 typedef McxStatus (*fReaderSetup)(Reader * reader, const char * modelFile, Config * config);
 typedef void (*fReaderCleanup)(Reader * reader);
 typedef InputRoot * (*fReaderRead)(Reader * reader, const char * file);
+typedef void (*fReaderSetValidated)(Reader * reader, int validated);
 
 typedef SSDComponentSpecificDataDefinition ** (*fReaderGetSSDComponents)(Reader * reader);
 
@@ -45,11 +46,13 @@ struct Reader {
     fReaderSetup Setup;
     fReaderCleanup Cleanup;
     fReaderRead Read;
+    fReaderSetValidated SetValidated;
 
     fReaderGetSSDComponents GetSSDComponents_;
 
     int reader_initialised_;
     FileFormat format_;
+    int validated_; // input file is known to be valid
 };
 
 #ifdef __cplusplus
@@ -57,10 +57,29 @@ static McxStatus CopyFrom(ComponentResultsInput * self, ComponentResultsInput *
     self->stepTime = src->stepTime;
     self->stepCount = src->stepCount;
 
+    for (i = 0; i < src->filters->Size(src->filters); i++) {
+        InputElement * srcFilter = (InputElement *) src->filters->At(src->filters, i);
+        InputElement * filter = srcFilter->Clone(srcFilter);
+
+        if (!filter) {
+            return RETURN_ERROR;
+        }
+
+        retVal = self->filters->PushBack(self->filters, (Object *) filter);
+        if (retVal == RETURN_ERROR) {
+            object_destroy(filter);
+            return RETURN_ERROR;
+        }
+    }
+
     return RETURN_OK;
 }
 
 static void ComponentResultsInputDestructor(ComponentResultsInput * input) {
+    if (input->filters) {
+        input->filters->DestroyObjects(input->filters);
+        object_destroy(input->filters);
+    }
 }
 
 static ComponentResultsInput * ComponentResultsInputCreate(ComponentResultsInput * input) {
@@ -74,6 +93,11 @@ static ComponentResultsInput * ComponentResultsInputCreate(ComponentResultsInput
     OPTIONAL_UNSET(input->stepTime);
     OPTIONAL_UNSET(input->stepCount);
 
+    input->filters = (ObjectContainer *) object_create(ObjectContainer);
+    if (!input->filters) {
+        return NULL;
+    }
+
     inputElement->Clone = Clone;
     input->CopyFrom = CopyFrom;
 
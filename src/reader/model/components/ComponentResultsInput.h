@@ -12,6 +12,7 @@
 #define MCX_READER_MODEL_COMPONENTS_COMPONENT_RESULTS_INPUT_H
 
 #include "reader/core/InputElement.h"
+#include "reader/model/components/ResultFilterInput.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +36,8 @@ struct ComponentResultsInput {
     OPTIONAL_VALUE(double) stepTime;
     OPTIONAL_VALUE(size_t) stepCount;
 
+    ObjectContainer * filters; // of ResultFilterInput
+
     fComponentResultsInputCopyFrom CopyFrom;
 };
 
@@ -0,0 +1,92 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "reader/model/components/ResultFilterInput.h"
+
+#include "util/string.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+static InputElement * Clone(InputElement * self) {
+    ResultFilterInput * clone = (ResultFilterInput *)object_create(ResultFilterInput);
+    McxStatus retVal = RETURN_ERROR;
+
+    if (!clone) {
+        return NULL;
+    }
+
+    retVal = clone->CopyFrom(clone, (ResultFilterInput *) self);
+
+    // cleanup:
+    if (retVal == RETURN_ERROR) {
+        object_destroy(clone);
+        return NULL;
+    }
+
+    return (InputElement *) clone;
+}
+
+static McxStatus CopyFrom(ResultFilterInput * self, ResultFilterInput * src) {
+    InputElement * base = (InputElement *)self;
+    McxStatus retVal = RETURN_OK;
+
+    if (!self || !src) {
+        mcx_log(LOG_ERROR, "ResultFilterInput: Invalid copy arguments");
+        return RETURN_ERROR;
+    }
+
+    // copy base class first
+    retVal = base->CopyFrom(base, (InputElement *)src);
+    if (retVal == RETURN_ERROR) {
+        return RETURN_ERROR;
+    }
+
+    // copy src members
+    self->type = src->type;
+
+    self->port = mcx_string_copy(src->port);
+    if (!self->port && src->port) {
+        return RETURN_ERROR;
+    }
+
+    self->threshold = src->threshold;
+    self->window = src->window;
+
+    return RETURN_OK;
+}
+
+static void ResultFilterInputDestructor(ResultFilterInput * input) {
+    if (input->port) {
+        mcx_free(input->port);
+    }
+}
+
+static ResultFilterInput * ResultFilterInputCreate(ResultFilterInput * input) {
+    InputElement * inputElement = (InputElement *)input;
+
+    input->type = RESULT_FILTER_NONE;
+    input->port = NULL;
+
+    OPTIONAL_UNSET(input->threshold);
+    OPTIONAL_UNSET(input->window);
+
+    inputElement->Clone = Clone;
+    input->CopyFrom = CopyFrom;
+
+    return input;
+}
+
+OBJECT_CLASS(ResultFilterInput, InputElement);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
@@ -0,0 +1,42 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_READER_MODEL_COMPONENTS_RESULT_FILTER_INPUT_H
+#define MCX_READER_MODEL_COMPONENTS_RESULT_FILTER_INPUT_H
+
+#include "reader/core/InputElement.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct ResultFilterInput ResultFilterInput;
+
+typedef McxStatus (*fResultFilterInputCopyFrom)(ResultFilterInput * self, ResultFilterInput * src);
+
+extern const ObjectClass _ResultFilterInput;
+
+struct ResultFilterInput {
+    InputElement _;
+
+    ResultFilterType type;
+    char * port; // NULL if the filter applies to all numeric ports
+
+    OPTIONAL_VALUE(double) threshold;
+    OPTIONAL_VALUE(size_t) window;
+
+    fResultFilterInputCopyFrom CopyFrom;
+};
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //  MCX_READER_MODEL_COMPONENTS_RESULT_FILTER_INPUT_H
@@ -44,9 +44,68 @@ SSDComponentSpecificDataDefinition * ssdMcxExeComponents[] = {
     NULL
 };
 
+static ResultFilterInput * SSDReadResultFilter(xmlNodePtr filterNode) {
+    ResultFilterInput * filterInput = (ResultFilterInput *) object_create(ResultFilterInput);
+    InputElement * element = (InputElement *) filterInput;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (!filterInput) {
+        return NULL;
+    }
+
+    element->type = INPUT_SSD;
+    element->context = (void *) filterNode;
+
+    retVal = xml_attr_enum(filterNode, "type", resultFilterTypeMapping, (int *) &filterInput->type, SSD_MANDATORY);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_attr_string(filterNode, "port", &filterInput->port, SSD_OPTIONAL);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_opt_attr_double(filterNode, "threshold", &filterInput->threshold);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_opt_attr_size_t(filterNode, "window", &filterInput->window);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    switch (filterInput->type) {
+    case RESULT_FILTER_DEADBAND:
+    case RESULT_FILTER_SWINGING_DOOR:
+        if (!filterInput->threshold.defined || filterInput->threshold.value < 0.0) {
+            retVal = xml_error_generic(filterNode, "Filter needs a non-negative threshold");
+        }
+        break;
+    case RESULT_FILTER_MIN_MAX:
+        if (!filterInput->window.defined || filterInput->window.value < 1) {
+            retVal = xml_error_generic(filterNode, "Filter needs a window of at least 1");
+        }
+        break;
+    default:
+        break;
+    }
+
+cleanup:
+    if (retVal == RETURN_ERROR) {
+        object_destroy(filterInput);
+        return NULL;
+    }
+
+    return filterInput;
+}
+
 static ComponentResultsInput * SSDReadComponentResults(xmlNodePtr annotationNode) {
     ComponentResultsInput * resultsInput = (ComponentResultsInput *) object_create(ComponentResultsInput);
     InputElement * element = (InputElement *) resultsInput;
+    size_t i = 0;
 
     McxStatus retVal = RETURN_OK;
 
@@ -99,6 +158,22 @@ static ComponentResultsInput * SSDReadComponentResults(xmlNodePtr annotationNode
         if (retVal == RETURN_ERROR) {
             goto cleanup;
         }
+
+        for (i = 0; i < xml_num_children(resultsNode); i++) {
+            xmlNodePtr filterNode = xml_child_by_index(resultsNode, i);
+            ResultFilterInput * filterInput = SSDReadResultFilter(filterNode);
+
+            if (!filterInput) {
+                retVal = RETURN_ERROR;
+                goto cleanup;
+            }
+
+            retVal = resultsInput->filters->PushBack(resultsInput->filters, (Object *) filterInput);
+            if (retVal == RETURN_ERROR) {
+                object_destroy(filterInput);
+                goto cleanup;
+            }
+        }
     }
 
 cleanup:
@@ -37,6 +37,7 @@ McxStatus SSDReaderInit(const char * file) {
 
 
 void SSDReaderCleanup() {
+    xml_set_validated_doc(NULL);
     xml_cleanup_parsed_schemas();
     xml_cleanup_path_resolution_configuration();
 
@@ -47,7 +48,7 @@ void SSDReaderCleanup() {
 }
 
 
-InputRoot * SSDReadMcx(const char * file, SSDComponentSpecificDataDefinition * components[]) {
+InputRoot * SSDReadMcx(const char * file, SSDComponentSpecificDataDefinition * components[], int validated) {
     InputRoot * input = (InputRoot *) object_create(InputRoot);
     InputElement * element = (InputElement *) input;
     ObjectContainer * units = NULL;
@@ -71,6 +72,12 @@ InputRoot * SSDReadMcx(const char * file, SSDComponentSpecificDataDefinition * c
         goto cleanup;
     }
 
+    if (validated) {
+        // file is unchanged since an earlier run validated it
+        mcx_log(LOG_INFO, "Skipping schema validation of %s", file);
+        xml_set_validated_doc(_doc);
+    }
+
     retVal = xml_validate_doc(_doc, "SystemStructureDescription.xsd");
     if (retVal == RETURN_ERROR) {
         goto cleanup;
@@ -24,7 +24,7 @@ extern "C" {
 McxStatus SSDReaderInit(const char * file);
 void SSDReaderCleanup();
 
-InputRoot * SSDReadMcx(const char * file, SSDComponentSpecificDataDefinition * components[]);
+InputRoot * SSDReadMcx(const char * file, SSDComponentSpecificDataDefinition * components[], int validated);
 
 
 #ifdef __cplusplus
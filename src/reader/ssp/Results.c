@@ -14,6 +14,7 @@
 #include "reader/EnumMapping.h"
 #include "reader/task/BackendInput.h"
 #include "reader/task/BackendsInput.h"
+#include "reader/task/StreamChannelInput.h"
 
 
 #ifdef __cplusplus
@@ -21,9 +22,42 @@ extern "C" {
 #endif /* __cplusplus */
 
 
+static StreamChannelInput * SSDReadStreamChannel(xmlNodePtr channelNode) {
+    StreamChannelInput * channelInput = (StreamChannelInput *) object_create(StreamChannelInput);
+    InputElement * element = (InputElement *) channelInput;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (!channelInput) {
+        return NULL;
+    }
+
+    element->type = INPUT_SSD;
+    element->context = (void *) channelNode;
+
+    retVal = xml_attr_string(channelNode, "element", &channelInput->element, SSD_MANDATORY);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_attr_string(channelNode, "port", &channelInput->port, SSD_OPTIONAL);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (retVal == RETURN_ERROR) {
+        object_destroy(channelInput);
+        return NULL;
+    }
+
+    return channelInput;
+}
+
 static BackendInput * SSDReadBackend(xmlNodePtr backendNode) {
     BackendInput * backendInput = (BackendInput*)object_create(BackendInput);
     InputElement * element = (InputElement *)backendInput;
+    size_t i = 0;
 
     McxStatus retVal = RETURN_OK;
 
@@ -50,6 +84,57 @@ static BackendInput * SSDReadBackend(xmlNodePtr backendNode) {
         goto cleanup;
     }
 
+    retVal = xml_opt_attr_enum(backendNode, "compression", compressionTypeMapping, &backendInput->compression);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_opt_attr_bool(backendNode, "mapped", &backendInput->mapped);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_opt_attr_double(backendNode, "syncInterval", &backendInput->syncInterval);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    if (backendInput->syncInterval.defined && backendInput->syncInterval.value < 0.0) {
+        retVal = xml_error_generic(backendNode, "syncInterval must not be negative");
+        goto cleanup;
+    }
+
+    retVal = xml_opt_attr_int(backendNode, "tcpPort", &backendInput->tcpPort);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    retVal = xml_opt_attr_size_t(backendNode, "queueSize", &backendInput->queueSize);
+    if (retVal == RETURN_ERROR) {
+        goto cleanup;
+    }
+
+    if (backendInput->queueSize.defined && backendInput->queueSize.value < 1) {
+        retVal = xml_error_generic(backendNode, "queueSize must be at least 1");
+        goto cleanup;
+    }
+
+    for (i = 0; i < xml_num_children(backendNode); i++) {
+        xmlNodePtr channelNode = xml_child_by_index(backendNode, i);
+        StreamChannelInput * channel = SSDReadStreamChannel(channelNode);
+
+        if (!channel) {
+            retVal = RETURN_ERROR;
+            goto cleanup;
+        }
+
+        retVal = backendInput->channels->PushBack(backendInput->channels, (Object *) channel);
+        if (retVal == RETURN_ERROR) {
+            object_destroy(channel);
+            goto cleanup;
+        }
+    }
+
 cleanup:
     if (retVal == RETURN_ERROR) {
         object_destroy(backendInput);
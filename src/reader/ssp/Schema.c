@@ -61,6 +61,9 @@ static SchemaLookup _schemaLookup[] = {
 };
 
 
+static xmlDocPtr _validatedDoc = NULL;
+
+
 static CatalogueEntry _schemaCatalogue[] = {
     {"com.avl.model.connect.ssp.task", taskSchemaStr, NULL, NULL},
     {"com.avl.model.connect.ssp.results", resultsSchemaStr, NULL, NULL},
@@ -246,6 +249,11 @@ void xml_cleanup_parsed_schemas() {
 }
 
 
+void xml_set_validated_doc(xmlDocPtr doc) {
+    _validatedDoc = doc;
+}
+
+
 McxStatus xml_validate_node(xmlNodePtr node, const char * schema_id) {
     CatalogueEntry * schema;
     int ret_val = 0;
@@ -260,6 +268,10 @@ McxStatus xml_validate_node(xmlNodePtr node, const char * schema_id) {
         return RETURN_ERROR;
     }
 
+    if (_validatedDoc && node->doc == _validatedDoc) {
+        return RETURN_OK;
+    }
+
     schema = get_schema_by_id(schema_id);
     if (!schema) {
         mcx_log(LOG_ERROR, "Unknown schema id: %s", schema_id);
@@ -296,6 +308,10 @@ McxStatus xml_validate_doc(xmlDocPtr doc, const char * schema_id) {
         return RETURN_ERROR;
     }
 
+    if (_validatedDoc && doc == _validatedDoc) {
+        return RETURN_OK;
+    }
+
     schema = get_schema_by_id(schema_id);
     if (!schema) {
         mcx_log(LOG_ERROR, "Unknown schema id: %s", schema_id);
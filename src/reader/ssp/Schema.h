@@ -26,6 +26,9 @@ McxStatus xml_validate_doc(xmlDocPtr doc, const char * schema_id);
 
 void xml_cleanup_parsed_schemas();
 
+// skips the validation of doc and its nodes, doc is known to be valid
+void xml_set_validated_doc(xmlDocPtr doc);
+
 
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
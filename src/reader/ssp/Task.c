@@ -118,6 +118,21 @@ TaskInput * SSDReadTask(xmlNodePtr defaultExperimentNode) {
             if (retVal == RETURN_ERROR) {
                 goto cleanup;
             }
+
+            retVal = xml_opt_attr_size_t(taskNode, "numThreads", &taskInput->numThreads);
+            if (retVal == RETURN_ERROR) {
+                goto cleanup;
+            }
+
+            retVal = xml_opt_attr_enum(taskNode, "scheduler", schedulerMapping, (OPTIONAL_VALUE(int) *) &taskInput->scheduler);
+            if (retVal == RETURN_ERROR) {
+                goto cleanup;
+            }
+
+            retVal = xml_attr_string(taskNode, "cpuList", &taskInput->cpuList, SSD_OPTIONAL);
+            if (retVal == RETURN_ERROR) {
+                goto cleanup;
+            }
         }
     }
 
@@ -15,12 +15,27 @@ extern "C" {
 #endif /* __cplusplus */
 
 static void BackendInputDestructor(BackendInput * input) {
+    if (input->channels) {
+        input->channels->DestroyObjects(input->channels);
+        object_destroy(input->channels);
+    }
 }
 
 static BackendInput * BackendInputCreate(BackendInput * input) {
     input->type = BACKEND_CSV;
 
     OPTIONAL_UNSET(input->storeAtRuntime);
+    OPTIONAL_UNSET(input->compression);
+    OPTIONAL_UNSET(input->mapped);
+    OPTIONAL_UNSET(input->syncInterval);
+
+    OPTIONAL_UNSET(input->tcpPort);
+    OPTIONAL_UNSET(input->queueSize);
+
+    input->channels = (ObjectContainer *) object_create(ObjectContainer);
+    if (!input->channels) {
+        return NULL;
+    }
 
     return input;
 }
@@ -13,6 +13,7 @@
 
 #include "storage/Backends.h"
 
+#include "objects/ObjectContainer.h"
 #include "reader/core/InputElement.h"
 
 #ifdef __cplusplus
@@ -26,6 +27,14 @@ typedef struct BackendInput {
 
     BackendType type;
     OPTIONAL_VALUE(int) storeAtRuntime;
+    OPTIONAL_VALUE(int) compression; // CompressionType
+    OPTIONAL_VALUE(int) mapped;
+    OPTIONAL_VALUE(double) syncInterval; // in seconds
+
+    // stream backend
+    OPTIONAL_VALUE(int) tcpPort;
+    OPTIONAL_VALUE(size_t) queueSize;
+    ObjectContainer * channels; // of StreamChannelInput, empty for all ports
 } BackendInput;
 
 #ifdef __cplusplus
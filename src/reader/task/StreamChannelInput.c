@@ -0,0 +1,37 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "reader/task/StreamChannelInput.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+static void StreamChannelInputDestructor(StreamChannelInput * input) {
+    if (input->element) {
+        mcx_free(input->element);
+    }
+    if (input->port) {
+        mcx_free(input->port);
+    }
+}
+
+static StreamChannelInput * StreamChannelInputCreate(StreamChannelInput * input) {
+    input->element = NULL;
+    input->port = NULL;
+
+    return input;
+}
+
+OBJECT_CLASS(StreamChannelInput, InputElement);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
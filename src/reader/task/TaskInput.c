@@ -15,6 +15,7 @@ extern "C" {
 #endif /* __cplusplus */
 
 static void TaskInputDestructor(TaskInput * input) {
+    if (input->cpuList) { mcx_free(input->cpuList); }
     if (input->results) { object_destroy(input->results); }
 }
 
@@ -32,6 +33,10 @@ static TaskInput * TaskInputCreate(TaskInput * input) {
 
     OPTIONAL_UNSET(input->timingOutput);
 
+    OPTIONAL_UNSET(input->numThreads);
+    OPTIONAL_UNSET(input->scheduler);
+    input->cpuList = NULL;
+
     input->stepType = STEP_TYPE_UNDEFINED;
 
     input->results = NULL;
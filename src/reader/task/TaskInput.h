@@ -26,6 +26,7 @@ typedef enum TaskEndType {
 } TaskEndType;
 
 MAKE_OPTIONAL_TYPE(TaskEndType);
+MAKE_OPTIONAL_TYPE(StepTypeScheduler);
 
 extern const ObjectClass _TaskInput;
 
@@ -45,6 +46,10 @@ typedef struct TaskInput {
 
     OPTIONAL_VALUE(TaskEndType) endType;        // task stop condition
 
+    OPTIONAL_VALUE(size_t) numThreads;          // number of worker threads for multi-threaded step types
+    OPTIONAL_VALUE(StepTypeScheduler) scheduler; // distribution of elements onto the worker threads
+    char * cpuList;                             // processors the worker threads are pinned to
+
     StepTypeType stepType;                      // step type used for the task
 
     ResultsInput * results;
@@ -237,6 +237,27 @@ McxStatus CompEnterCouplingStepMode(Component * comp, void * param) {
 }
 
 
+McxStatus CompDoStepAndEnterCommunicationPoint(CompAndGroup * compGroup, void * param) {
+    StepTypeParams * params = (StepTypeParams *) param;
+
+    McxStatus retVal = RETURN_OK;
+
+    TimeInterval interval = {params->timeEndStep, params->timeEndStep};
+
+    retVal = ComponentDoCommunicationStep(compGroup->comp, compGroup->group, params);
+    if (RETURN_ERROR == retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Element DoStep failed");
+        return RETURN_ERROR;
+    }
+
+    retVal = ComponentEnterCommunicationPoint(compGroup->comp, &interval);
+    if (RETURN_ERROR == retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Element EnterCommunicationPoint failed");
+        return RETURN_ERROR;
+    }
+    return RETURN_OK;
+}
+
 McxStatus CompEnterCommunicationPoint(CompAndGroup * compGroup, void * param) {
     const StepTypeParams * params = (const StepTypeParams *) param;
 
@@ -306,6 +327,9 @@ OBJECT_CLASS(StepType, Object);
 // Step Type Params
 
 static void StepTypeParamsDestructor(StepTypeParams * params) {
+    if (params->cpuList) {
+        mcx_free(params->cpuList);
+    }
 
 }
 
@@ -317,6 +341,9 @@ static StepTypeParams * StepTypeParamsCreate(StepTypeParams * params) {
     params->numSteps = 0;
     params->aComponentFinished = FALSE;
     params->sumTime = FALSE;
+    params->numThreads = 0;
+    params->scheduler = STEP_TYPE_SCHEDULER_SHARED_QUEUE;
+    params->cpuList = NULL;
 
     return params;
 }
@@ -29,8 +29,15 @@ typedef enum StepTypeType {
     STEP_TYPE_SEQUENTIAL = 1,       /* "sequential" */
     STEP_TYPE_PARALLEL_ST = 2,      /* "parallel_singlethreaded" */
     STEP_TYPE_PARALLEL_MT = 3,      /* "parallel_multithreaded" */
+    STEP_TYPE_SEQUENTIAL_MT = 4,    /* "sequential_multithreaded" */
 } StepTypeType;
 
+typedef enum StepTypeScheduler {
+    STEP_TYPE_SCHEDULER_SHARED_QUEUE = 0,   /* "shared_queue" */
+    STEP_TYPE_SCHEDULER_WORK_STEALING = 1,  /* "work_stealing" */
+    STEP_TYPE_SCHEDULER_STATIC = 2,         /* "static" */
+} StepTypeScheduler;
+
 
 typedef McxStatus (* fStepTypeDoStep)(StepType * stepType, StepTypeParams * params, SubModel * subModel);
 typedef McxStatus (* fStepTypeFinish)(StepType * stepType, StepTypeParams * params, SubModel * subModel, FinishState * finishState);
@@ -51,6 +58,10 @@ struct StepTypeParams {
     int aComponentFinished;
 
     int sumTime; // if true then time = \sum_{numSteps} timeStepSize, else time = numSteps * timeStepSize
+
+    size_t numThreads; // number of worker threads of multi-threaded step types, 0: number of processors
+    StepTypeScheduler scheduler; // distribution of the elements onto the worker threads
+    char * cpuList; // processors the worker threads are pinned to, e.g. "0-3,8", NULL: not pinned
 };
 
 /* shared functionality between step types */
@@ -58,6 +69,7 @@ McxStatus ComponentDoCommunicationStep(Component * comp, size_t group, StepTypeP
 McxStatus CompEnterCouplingStepMode(Component * comp, void * param);
 McxStatus CompEnterCommunicationPoint(CompAndGroup * compGroup, void * param);
 McxStatus CompDoStep(CompAndGroup * compGroup, void * param);
+McxStatus CompDoStepAndEnterCommunicationPoint(CompAndGroup * compGroup, void * param);
 
 McxStatus StepTypeFinish(StepType * stepType, StepTypeParams * params, SubModel * subModel, FinishState * finishState);
 
@@ -19,144 +19,35 @@
 #include "storage/ComponentStorage.h"
 #include "storage/ResultsStorage.h"
 #include "util/threads.h"
-#include "util/events.h"
-#include "util/mutex.h"
+#include "util/string.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
-// ----------------------------------------------------------------------
-// DoStepThreadCounter
+static McxStatus ParallelMTCompDoStep(void * ctx, size_t item, size_t worker) {
+    StepTypeParallelMT * parallelMTType = (StepTypeParallelMT *) ctx;
+    ObjectContainer * eval = parallelMTType->subModel->evaluationList;
+    CompAndGroup * compAndGroup = (CompAndGroup *) eval->At(eval, item);
 
-static void DoStepThreadCounterSetup(DoStepThreadCounter * counter, size_t count) {
-    counter->count = count;
-}
-
-static void DoStepThreadCounterDecrease(DoStepThreadCounter * counter) {
-    mcx_mutex_lock(&counter->mutex);
-    if (counter->count > 0) {
-        counter->count--;
-        if (0 == counter->count) {
-            mcx_event_set(&counter->isDoneEvent);
-        }
-    }
-    mcx_mutex_unlock(&counter->mutex);
-}
-
-static void DoStepThreadCounterWait(DoStepThreadCounter * counter) {
-    mcx_event_wait(&counter->isDoneEvent);
-}
-
-static void DoStepThreadCounterDestructor(DoStepThreadCounter * counter) {
-    mcx_event_destroy(&counter->isDoneEvent);
-    mcx_mutex_destroy(&counter->mutex);
-}
-
-static DoStepThreadCounter * DoStepThreadCounterCreate(DoStepThreadCounter * counter) {
-    int status;
-
-    counter->Setup = DoStepThreadCounterSetup;
-    counter->Decrease = DoStepThreadCounterDecrease;
-    counter->Wait = DoStepThreadCounterWait;
-
-    mcx_mutex_create(&counter->mutex);
-    counter->count = 0;
-    status = mcx_event_create(&counter->isDoneEvent);
-    if (status) {
-        mcx_log(LOG_ERROR, "Simulation: Failed to create DoStep done event");
-        return NULL;
-    }
-    return counter;
-}
-
-OBJECT_CLASS(DoStepThreadCounter, Object);
-
-// ----------------------------------------------------------------------
-// DoStepThreadArg
-
-static void DoStepThreadArgSetup(DoStepThreadArg * arg, Component * comp, size_t group, StepTypeParams * params) {
-    arg->comp = comp;
-    arg->group = group;
-    arg->params = params;
-}
-
-static void DoStepThreadArgSetCounter(DoStepThreadArg * arg, DoStepThreadCounter * counter) {
-    if (arg->threadCounter) {
-        object_destroy(arg->threadCounter);
-    }
-    arg->threadCounter = (DoStepThreadCounter *) object_strong_reference(counter);
-}
-
-static void DoStepThreadArgStartThread(DoStepThreadArg * arg) {
-    mcx_event_set(&arg->startDoStepEvent);
-}
-
-static void DoStepThreadArgDestructor(DoStepThreadArg * arg) {
-    object_destroy(arg->threadCounter);
-}
-
-static DoStepThreadArg * DoStepThreadArgCreate(DoStepThreadArg * arg) {
-    int status;
-
-    arg->Setup = DoStepThreadArgSetup;
-    arg->SetCounter = DoStepThreadArgSetCounter;
-    arg->StartThread = DoStepThreadArgStartThread;
-
-    arg->comp = NULL;
-    arg->group = 0;
-    arg->params = NULL;
-    arg->status = RETURN_OK;
-    arg->finished = FALSE;
-    status = mcx_event_create(&arg->startDoStepEvent);
-    if (status) {
-        mcx_log(LOG_ERROR, "Simulation: Failed to create DoStep start event");
-        return NULL;
-    }
-    arg->threadCounter = NULL;
-
-    return arg;
-}
-
-OBJECT_CLASS(DoStepThreadArg, Object);
-
-
-static McxThreadReturn ParallelMTCompDoStepWrapper(void * arg) {
-    DoStepThreadArg * threadArg = (DoStepThreadArg *) arg;
-    StepTypeParams * params = (StepTypeParams *) threadArg->params;
-    DoStepThreadCounter * counter = (DoStepThreadCounter *) threadArg->threadCounter;
-
-    while (1) {
-        mcx_event_wait(&threadArg->startDoStepEvent);
-
-        if (threadArg->finished) {
-            break;
-        }
-
-        threadArg->status = ComponentDoCommunicationStep(threadArg->comp, threadArg->group, params);
-        if (RETURN_ERROR == threadArg->status) {
-            mcx_log(LOG_ERROR, "Simulation: Element DoStep failed");
-            // multithreaded error handling via threadArg->status
-        }
+    McxStatus retVal = RETURN_OK;
 
-        counter->Decrease(counter);
+    retVal = ComponentDoCommunicationStep(compAndGroup->comp, compAndGroup->group, parallelMTType->params);
+    if (RETURN_ERROR == retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Element DoStep failed");
+        return RETURN_ERROR;
     }
 
-    mcx_thread_exit(0);
-
-    return 0;
+    return RETURN_OK;
 }
 
 static McxStatus ParallelMTDoStep(StepType * stepType, StepTypeParams * params, SubModel * subModel) {
     StepTypeParallelMT * parallelMTType = (StepTypeParallelMT *) stepType;
+    WorkerPool * pool = parallelMTType->pool;
 
-    DoStepThreadCounter * counter = parallelMTType->counter;
-
-    ObjectContainer * args = parallelMTType->args;
     ObjectContainer * eval = subModel->evaluationList;
 
     McxStatus retVal = RETURN_OK;
-    size_t i = 0;
 
     retVal = subModel->LoopComponents(subModel, CompEnterCouplingStepMode, (void *) params);
     if (RETURN_OK != retVal) {
@@ -170,24 +61,15 @@ static McxStatus ParallelMTDoStep(StepType * stepType, StepTypeParams * params,
         return RETURN_ERROR;
     }
 
-    // right now, only this thread is running, so no mutex is needed
-    counter->Setup(counter, eval->Size(eval));
-
-    for (i = 0; i < eval->Size(eval); i++) {
-        DoStepThreadArg * arg = (DoStepThreadArg *) args->At(args, i);
-        arg->StartThread(arg);
-    }
-    // now all component->DoSteps are running
-
-    counter->Wait(counter);
+    // right now, only this thread is running, so no synchronization is needed
+    parallelMTType->subModel = subModel;
+    parallelMTType->params = params;
 
-    /* check for errors during DoSteps */
-    for (i = 0; i < eval->Size(eval); i++) {
-        DoStepThreadArg * arg = (DoStepThreadArg *) args->At(args, i);
-        if (RETURN_OK != arg->status) {
-            mcx_log(LOG_ERROR, "Simulation: Synchronization DoStep from %fs to %fs failed", params->time, params->timeEndStep);
-            return RETURN_ERROR;
-        }
+    // returns when all component->DoSteps are done
+    retVal = pool->Run(pool, eval->Size(eval), ParallelMTCompDoStep, parallelMTType);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Synchronization DoStep from %fs to %fs failed", params->time, params->timeEndStep);
+        return RETURN_ERROR;
     }
 
     retVal = subModel->LoopEvaluationList(subModel, CompEnterCommunicationPoint, (void *) params);
@@ -199,111 +81,130 @@ static McxStatus ParallelMTDoStep(StepType * stepType, StepTypeParams * params,
     return RETURN_OK;
 }
 
+// static scheduling runs item i on worker i % numWorkers
+static void ParallelMTLogStaticPlacement(WorkerPool * pool, ObjectContainer * eval) {
+    size_t numWorkers = pool->GetNumWorkers(pool);
+    size_t w = 0;
+
+    for (w = 0; w < numWorkers; w++) {
+        char * names = NULL;
+        size_t num = 0;
+        size_t i = 0;
+
+        for (i = w; i < eval->Size(eval); i += numWorkers) {
+            CompAndGroup * compAndGroup = (CompAndGroup *) eval->At(eval, i);
+            Component * comp = compAndGroup->comp;
+            char * merged = NULL;
+
+            if (names) {
+                merged = mcx_string_merge(3, names, ", ", comp->GetName(comp));
+                mcx_free(names);
+            } else {
+                merged = mcx_string_copy(comp->GetName(comp));
+            }
+            names = merged;
+            num++;
+        }
+
+        mcx_log(LOG_INFO, "Simulation: Worker %zu runs %zu elements: %s", w, num, names ? names : "");
+
+        if (names) {
+            mcx_free(names);
+        }
+    }
+}
+
 static McxStatus ParallelMTConfigure(StepType * stepType, StepTypeParams * params, SubModel * subModel) {
     StepTypeParallelMT * parallelMTType = (StepTypeParallelMT *) stepType;
+    WorkerPool * pool = parallelMTType->pool;
 
-    DoStepThreadCounter * counter = parallelMTType->counter;
-
-    ObjectContainer * args = parallelMTType->args;
     ObjectContainer * eval = subModel->evaluationList;
 
+    size_t numWorkers = params->numThreads;
+
     McxStatus retVal = RETURN_OK;
-    size_t i = 0;
 
-    parallelMTType->threads
-        = (McxThread *) mcx_malloc(eval->Size(eval) * sizeof(McxThread));
-    if (!parallelMTType->threads) {
-        mcx_log(LOG_ERROR, "Simulation: Memory allocation for thread handles failed");
+    if (0 == numWorkers) {
+        numWorkers = mcx_thread_get_num_cpus();
+    }
+    // more workers than evaluation list entries would only spin
+    if (numWorkers > eval->Size(eval)) {
+        numWorkers = eval->Size(eval);
+    }
+
+    retVal = pool->SetAffinity(pool, params->cpuList);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Could not set processors of worker threads");
         return RETURN_ERROR;
     }
 
-    // TODO: this should be done with subModel->LoopEvaluationList
-    for (i = 0; i < eval->Size(eval); i++) {
-        CompAndGroup * compAndGroup = (CompAndGroup *) eval->At(eval, i);
-        DoStepThreadArg * arg = (DoStepThreadArg *) object_create(DoStepThreadArg);
-        if (!arg) {
-            mcx_log(LOG_ERROR, "Simulation: Could not create thread argument");
-            return RETURN_ERROR;
-        }
+    retVal = pool->Setup(pool, numWorkers);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Could not create worker threads");
+        return RETURN_ERROR;
+    }
 
-        arg->Setup(arg,
-                   compAndGroup->comp,
-                   compAndGroup->group,
-                   params);
+    switch (params->scheduler) {
+    case STEP_TYPE_SCHEDULER_WORK_STEALING:
+        // pack elements longest-first based on their measured step times
+        pool->SetScheduling(pool, WORKER_POOL_WORK_STEALING);
+        break;
+    case STEP_TYPE_SCHEDULER_STATIC:
+        // each element always runs on the same worker
+        pool->SetScheduling(pool, WORKER_POOL_STATIC);
+        break;
+    default:
+        pool->SetScheduling(pool, WORKER_POOL_SHARED_QUEUE);
+        break;
+    }
 
-        arg->SetCounter(arg, counter);
+    mcx_log(LOG_DEBUG, "Simulation: Using %zu worker threads for %zu elements", pool->GetNumWorkers(pool), eval->Size(eval));
 
-        args->PushBack(args, (Object *) arg);
+    if (params->cpuList) {
+        pool->LogPlacement(pool);
     }
-
-    parallelMTType->numThreads = eval->Size(eval);
-    for (i = 0; i < eval->Size(eval); i++) {
-        DoStepThreadArg * arg = (DoStepThreadArg *) args->At(args, i);
-        McxThread thread;
-        int statusFlag = mcx_thread_create(&thread,
-            (McxThreadStartRoutine) ParallelMTCompDoStepWrapper,
-            arg);
-        if (statusFlag) {
-            mcx_log(LOG_ERROR, "Simulation: Could not create thread");
-            return RETURN_ERROR;
-        }
-        parallelMTType->threads[i] = thread;
+    if (STEP_TYPE_SCHEDULER_STATIC == params->scheduler) {
+        ParallelMTLogStaticPlacement(pool, eval);
     }
 
     return RETURN_OK;
 }
 
+static McxStatus ParallelMTFinish(StepType * stepType, StepTypeParams * params, SubModel * subModel, FinishState * finishState) {
+    StepTypeParallelMT * parallelMTType = (StepTypeParallelMT *) stepType;
+    WorkerPool * pool = parallelMTType->pool;
 
-static void StepTypeParallelMTDestructor(StepTypeParallelMT * parallelMTType) {
-    if (parallelMTType->args) {
-        ObjectContainer * args = parallelMTType->args;
-        size_t i = 0;
-
-        for (i = 0; i < args->Size(args); i++) {
-            DoStepThreadArg * arg = (DoStepThreadArg *) args->At(args, i);
-
-            long ret;
-
-            arg->finished = TRUE;
-            arg->StartThread(arg);
-
-            mcx_thread_join(parallelMTType->threads[i], &ret);
+    McxStatus retVal = StepTypeFinish(stepType, params, subModel, finishState);
 
-            object_destroy(arg);
-        }
+    pool->LogStatistics(pool);
 
-        object_destroy(parallelMTType->args);
+    return retVal;
+}
 
-        mcx_free(parallelMTType->threads);
-        parallelMTType->threads = NULL;
-    }
 
-    if (parallelMTType->counter) {
-        object_destroy(parallelMTType->counter);
-    }
+static void StepTypeParallelMTDestructor(StepTypeParallelMT * parallelMTType) {
+    // joins the worker threads
+    object_destroy(parallelMTType->pool);
 }
 
 
 static StepTypeParallelMT * StepTypeParallelMTCreate(StepTypeParallelMT * parallelMTType) {
     StepType * type = (StepType *) parallelMTType;
-    int statusFlag = 0;
 
     type->type = STEP_TYPE_PARALLEL_MT;
 
     type->Configure = ParallelMTConfigure;
     type->DoStep = ParallelMTDoStep;
+    type->Finish = ParallelMTFinish;
 
-    // counter
-    parallelMTType->counter = (DoStepThreadCounter *) object_create(DoStepThreadCounter);
-    if (!parallelMTType->counter) {
-        mcx_log(LOG_ERROR, "Simulation: Could not create thread counter");
+    parallelMTType->pool = (WorkerPool *) object_create(WorkerPool);
+    if (!parallelMTType->pool) {
+        mcx_log(LOG_ERROR, "Simulation: Could not create worker pool");
         return NULL;
     }
 
-    // dynamic data
-    parallelMTType->args = (ObjectContainer *) object_create(ObjectContainer);
-    parallelMTType->threads = NULL;
-    parallelMTType->numThreads = 0;
+    parallelMTType->subModel = NULL;
+    parallelMTType->params = NULL;
 
     return parallelMTType;
 }
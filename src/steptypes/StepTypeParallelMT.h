@@ -16,81 +16,23 @@
 #if defined (ENABLE_MT)
 
 #include "steptypes/StepType.h"
-#include "util/threads.h"
-#include "util/events.h"
-#include "util/mutex.h"
+#include "core/WorkerPool.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
-typedef struct DoStepThreadCounter DoStepThreadCounter;
-typedef struct DoStepThreadArg DoStepThreadArg;
-
-typedef void (* fDoStepThreadCounterSetup)(DoStepThreadCounter * counter, size_t count);
-typedef void (* fDoStepThreadCounterDecrease)(DoStepThreadCounter * counter);
-typedef void (* fDoStepThreadCounterWait)(DoStepThreadCounter * counter);
-
-extern const struct ObjectClass _DoStepThreadCounter;
-
-typedef struct DoStepThreadCounter {
-    Object _;
-
-    fDoStepThreadCounterSetup Setup;
-    fDoStepThreadCounterDecrease Decrease;
-    fDoStepThreadCounterWait Wait;
-
-    McxMutex mutex;
-    McxEvent isDoneEvent;
-
-    // Is initialized to the number of components.
-    // Whenever a component finishes its DoStep, count is decremented.
-    // When count == 0, isDoneEvent is signaled.
-    size_t count;
-} DoStepThreadCounter;
-
-
-typedef void (* fDoStepThreadArgSetup)(DoStepThreadArg * arg, Component * comp, size_t group, StepTypeParams * params);
-typedef void (* fDoStepThreadArgSetCounter)(DoStepThreadArg * arg, DoStepThreadCounter * counter);
-typedef void (* fDoStepThreadArgStartThread)(DoStepThreadArg * arg);
-
-extern const struct ObjectClass _DoStepThreadArg;
-
-typedef struct DoStepThreadArg {
-    Object _;
-
-    fDoStepThreadArgSetup Setup;
-    fDoStepThreadArgSetCounter SetCounter;
-    fDoStepThreadArgStartThread StartThread;
-
-    // Data needed for ComponentDoCommStep
-    struct Component * comp;
-    size_t group;
-    StepTypeParams * params;
-
-    // last status value
-    McxStatus status;
-
-    // flag if thread should stop
-    int finished;
-
-    // Event for when to start the DoStep calculation
-    McxEvent startDoStepEvent;
-
-    // Signal when last thread is done
-    DoStepThreadCounter * threadCounter;
-} DoStepThreadArg;
-
-
 extern const struct ObjectClass _StepTypeParallelMT;
 
 typedef struct StepTypeParallelMT {
     StepType _;
 
-    DoStepThreadCounter * counter;
-    ObjectContainer * args; /* of DoStepThreadArg */
-    size_t numThreads;
-    McxThread * threads;
+    // persistent workers executing the evaluation list entries
+    WorkerPool * pool;
+
+    // data of the current DoStep, read by the workers
+    SubModel * subModel;
+    StepTypeParams * params;
 } StepTypeParallelMT;
 
 #ifdef __cplusplus
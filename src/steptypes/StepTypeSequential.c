@@ -20,28 +20,6 @@ extern "C" {
 #endif /* __cplusplus */
 
 
-static McxStatus CompDoStepAndEnterCommunicationPoint(CompAndGroup * compGroup, void * param) {
-    StepTypeParams * params = (StepTypeParams *) param;
-    Component * comp = compGroup->comp;
-
-    McxStatus retVal = RETURN_OK;
-
-    TimeInterval interval = {params->timeEndStep, params->timeEndStep};
-
-    retVal = ComponentDoCommunicationStep(compGroup->comp, compGroup->group, params);
-    if (RETURN_ERROR == retVal) {
-        mcx_log(LOG_ERROR, "Simulation: Element DoStep failed");
-        return RETURN_ERROR;
-    }
-
-    retVal = ComponentEnterCommunicationPoint(compGroup->comp, &interval);
-    if (RETURN_ERROR == retVal) {
-        mcx_log(LOG_ERROR, "Simulation: Element EnterCommunicationPoint failed");
-        return RETURN_ERROR;
-    }
-    return RETURN_OK;
-}
-
 McxStatus CompPreDoUpdateState(Component * comp, void * param) {
     const StepTypeParams * params = (const StepTypeParams *) param;
     McxStatus retVal = RETURN_OK;
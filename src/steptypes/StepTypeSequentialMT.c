@@ -0,0 +1,537 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#include "steptypes/StepTypeSequentialMT.h"
+#include "core/Component.h"
+#include "core/SubModel.h"
+#include "core/connections/ConnectionInfo.h"
+#include "util/threads.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// number of polls before a worker waiting for a ready node goes to sleep
+#define SEQUENTIAL_MT_SPIN_COUNT 4000
+
+static void SequentialMTPushReadyNode(StepTypeSequentialMT * sequentialMTType, size_t node) {
+    int32_t slot = mcx_atomic_fetch_add(&sequentialMTType->readyTail, 1);
+
+    mcx_atomic_store(&sequentialMTType->readyNodes[slot], (int32_t) node);
+    if (mcx_atomic_load(&sequentialMTType->numWaiting) > 0) {
+        mcx_atomic_wake_all(&sequentialMTType->readyNodes[slot]);
+    }
+}
+
+static size_t SequentialMTWaitForReadyNode(StepTypeSequentialMT * sequentialMTType, size_t slot) {
+    McxAtomic * readyNode = &sequentialMTType->readyNodes[slot];
+    int32_t node = -1;
+    size_t i = 0;
+
+    for (i = 0; i < SEQUENTIAL_MT_SPIN_COUNT; i++) {
+        node = mcx_atomic_load(readyNode);
+        if (node >= 0) {
+            return (size_t) node;
+        }
+        mcx_cpu_relax();
+    }
+
+    mcx_atomic_fetch_add(&sequentialMTType->numWaiting, 1);
+    while ((node = mcx_atomic_load(readyNode)) < 0) {
+        mcx_atomic_wait(readyNode, node);
+    }
+    mcx_atomic_fetch_add(&sequentialMTType->numWaiting, -1);
+
+    return (size_t) node;
+}
+
+/*
+ * Executed once per worker: takes the queue slots in order and runs the
+ * node in it as soon as it is filled. Slots are only taken while nodes are
+ * left, and every node is pushed once all of its predecessors are done, so
+ * a taken slot is always filled eventually.
+ */
+static McxStatus SequentialMTProcessNodes(void * ctx, size_t item, size_t worker) {
+    StepTypeSequentialMT * sequentialMTType = (StepTypeSequentialMT *) ctx;
+    ObjectContainer * eval = sequentialMTType->subModel->evaluationList;
+
+    while (1) {
+        size_t slot = (size_t) mcx_atomic_fetch_add(&sequentialMTType->readyHead, 1);
+        size_t node = 0;
+        size_t i = 0;
+
+        if (slot >= sequentialMTType->numNodes) {
+            break;
+        }
+
+        node = SequentialMTWaitForReadyNode(sequentialMTType, slot);
+
+        // after an error, the remaining nodes are only released to let the workers finish
+        if (0 == mcx_atomic_load(&sequentialMTType->numFailed)) {
+            CompAndGroup * compAndGroup = (CompAndGroup *) eval->At(eval, node);
+
+            if (RETURN_ERROR == CompDoStepAndEnterCommunicationPoint(compAndGroup, sequentialMTType->params)) {
+                mcx_atomic_fetch_add(&sequentialMTType->numFailed, 1);
+            }
+        }
+
+        for (i = sequentialMTType->successorsStart[node]; i < sequentialMTType->successorsStart[node + 1]; i++) {
+            size_t successor = sequentialMTType->successors[i];
+
+            if (1 == mcx_atomic_fetch_add(&sequentialMTType->remainingPredecessors[successor], -1)) {
+                SequentialMTPushReadyNode(sequentialMTType, successor);
+            }
+        }
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus SequentialMTDoStep(StepType * stepType, StepTypeParams * params, SubModel * subModel) {
+    StepTypeSequentialMT * sequentialMTType = (StepTypeSequentialMT *) stepType;
+    WorkerPool * pool = sequentialMTType->pool;
+
+    McxStatus retVal = RETURN_OK;
+    size_t i = 0;
+
+    retVal = subModel->LoopComponents(subModel, CompEnterCouplingStepMode, (void *) params);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Enter coupling step mode of elements failed");
+        return RETURN_ERROR;
+    }
+
+    // pre do update: parts of do-step that must not be multi-threaded
+    retVal = subModel->LoopComponents(subModel, CompPreDoUpdateState, (void *) params);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Pre do update of elements failed");
+        return RETURN_ERROR;
+    }
+
+    // right now, only this thread is running, so no synchronization is needed
+    sequentialMTType->subModel = subModel;
+    sequentialMTType->params = params;
+
+    mcx_atomic_store(&sequentialMTType->readyHead, 0);
+    mcx_atomic_store(&sequentialMTType->readyTail, 0);
+    mcx_atomic_store(&sequentialMTType->numFailed, 0);
+    for (i = 0; i < sequentialMTType->numNodes; i++) {
+        mcx_atomic_store(&sequentialMTType->remainingPredecessors[i], (int32_t) sequentialMTType->numPredecessors[i]);
+        mcx_atomic_store(&sequentialMTType->readyNodes[i], -1);
+    }
+    for (i = 0; i < sequentialMTType->numNodes; i++) {
+        if (0 == sequentialMTType->numPredecessors[i]) {
+            SequentialMTPushReadyNode(sequentialMTType, i);
+        }
+    }
+
+    // returns when all nodes are done
+    retVal = pool->Run(pool, pool->GetNumWorkers(pool), SequentialMTProcessNodes, sequentialMTType);
+    if (RETURN_OK != retVal || mcx_atomic_load(&sequentialMTType->numFailed) > 0) {
+        mcx_log(LOG_ERROR, "Simulation: Do step of elements failed");
+        return RETURN_ERROR;
+    }
+
+    retVal = subModel->LoopComponents(subModel, CompPostDoUpdateState, (void *) params);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Post do update of elements failed");
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+// position of an element in the submodel, the table is sorted by element
+typedef struct {
+    const Component * comp;
+    size_t idx;
+} SequentialMTCompEntry;
+
+static int SequentialMTCompEntryCompare(const void * a, const void * b) {
+    uintptr_t compA = (uintptr_t) ((const SequentialMTCompEntry *) a)->comp;
+    uintptr_t compB = (uintptr_t) ((const SequentialMTCompEntry *) b)->comp;
+
+    return (compA > compB) - (compA < compB);
+}
+
+static int SequentialMTCompareSizes(const void * a, const void * b) {
+    size_t sizeA = * (const size_t *) a;
+    size_t sizeB = * (const size_t *) b;
+
+    return (sizeA > sizeB) - (sizeA < sizeB);
+}
+
+static size_t SequentialMTGetComponentIndex(SequentialMTCompEntry * entries, size_t numEntries, const Component * comp) {
+    SequentialMTCompEntry key;
+    SequentialMTCompEntry * entry = NULL;
+
+    key.comp = comp;
+    entry = (SequentialMTCompEntry *) bsearch(&key, entries, numEntries, sizeof(SequentialMTCompEntry), SequentialMTCompEntryCompare);
+
+    return entry ? entry->idx : SIZE_T_ERROR;
+}
+
+/*
+ * Element graph: the elements that exchange data with each element over a
+ * connection, regardless of direction and of whether the connection is
+ * decoupled (their relative order in the evaluation list determines which
+ * values are read and must be kept), and the evaluation list entries of
+ * each element. Both in CSR format.
+ */
+typedef struct {
+    size_t * neighborsStart;    // numComps + 1 offsets into neighbors
+    size_t * neighbors;         // sorted and unique per element
+    size_t * nodesStart;        // numComps + 1 offsets into nodes
+    size_t * nodes;             // ascending per element
+} SequentialMTCoupling;
+
+static void SequentialMTCouplingDestroy(SequentialMTCoupling * coupling) {
+    if (coupling->neighborsStart) { mcx_free(coupling->neighborsStart); }
+    if (coupling->neighbors) { mcx_free(coupling->neighbors); }
+    if (coupling->nodesStart) { mcx_free(coupling->nodesStart); }
+    if (coupling->nodes) { mcx_free(coupling->nodes); }
+}
+
+static McxStatus SequentialMTCouplingSetup(SequentialMTCoupling * coupling, ObjectContainer * comps, ObjectContainer * eval) {
+    size_t numComps = comps->Size(comps);
+    size_t numNodes = eval->Size(eval);
+    SequentialMTCompEntry * entries = NULL;
+    size_t * compOfNode = NULL;
+    size_t * fill = NULL;
+    size_t numEdges = 0;
+    size_t pass = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    coupling->neighborsStart = (size_t *) mcx_calloc(numComps + 1, sizeof(size_t));
+    coupling->nodesStart = (size_t *) mcx_calloc(numComps + 1, sizeof(size_t));
+    coupling->nodes = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    entries = (SequentialMTCompEntry *) mcx_calloc(numComps + 1, sizeof(SequentialMTCompEntry));
+    compOfNode = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    fill = (size_t *) mcx_calloc(numComps + 1, sizeof(size_t));
+    if (!coupling->neighborsStart || !coupling->nodesStart || !coupling->nodes || !entries || !compOfNode || !fill) {
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+
+    for (i = 0; i < numComps; i++) {
+        entries[i].comp = (const Component *) comps->At(comps, i);
+        entries[i].idx = i;
+    }
+    qsort(entries, numComps, sizeof(SequentialMTCompEntry), SequentialMTCompEntryCompare);
+
+    // entries of each element
+    for (i = 0; i < numNodes; i++) {
+        CompAndGroup * compAndGroup = (CompAndGroup *) eval->At(eval, i);
+        size_t comp = SequentialMTGetComponentIndex(entries, numComps, compAndGroup->comp);
+
+        if (SIZE_T_ERROR == comp) {
+            mcx_log(LOG_ERROR, "Simulation: Element %s is not part of the submodel", compAndGroup->comp->GetName(compAndGroup->comp));
+            retVal = RETURN_ERROR;
+            goto cleanup;
+        }
+        compOfNode[i] = comp;
+        coupling->nodesStart[comp + 1]++;
+    }
+    for (i = 0; i < numComps; i++) {
+        coupling->nodesStart[i + 1] += coupling->nodesStart[i];
+        fill[i] = coupling->nodesStart[i];
+    }
+    for (i = 0; i < numNodes; i++) {
+        coupling->nodes[fill[compOfNode[i]]++] = i;
+    }
+
+    // neighbors from the inport connections, counted in the first pass and filled in the second
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < numComps; i++) {
+            Component * comp = (Component *) comps->At(comps, i);
+
+            for (j = 0; j < comp->GetNumInChannels(comp); j++) {
+                ConnectionInfo * info = GetInConnectionInfo(comp, j);
+                size_t source = SIZE_T_ERROR;
+
+                if (!info) {
+                    continue;
+                }
+
+                source = SequentialMTGetComponentIndex(entries, numComps, info->GetSourceComponent(info));
+                if (SIZE_T_ERROR == source || source == i) {
+                    continue;
+                }
+
+                if (0 == pass) {
+                    coupling->neighborsStart[i + 1]++;
+                    coupling->neighborsStart[source + 1]++;
+                } else {
+                    coupling->neighbors[fill[i]++] = source;
+                    coupling->neighbors[fill[source]++] = i;
+                }
+            }
+        }
+
+        if (0 == pass) {
+            for (i = 0; i < numComps; i++) {
+                coupling->neighborsStart[i + 1] += coupling->neighborsStart[i];
+                fill[i] = coupling->neighborsStart[i];
+            }
+            numEdges = coupling->neighborsStart[numComps];
+            coupling->neighbors = (size_t *) mcx_calloc(numEdges + 1, sizeof(size_t));
+            if (!coupling->neighbors) {
+                retVal = RETURN_ERROR;
+                goto cleanup;
+            }
+        }
+    }
+
+    // elements are often connected by several ports
+    numEdges = 0;
+    for (i = 0; i < numComps; i++) {
+        size_t start = coupling->neighborsStart[i];
+        size_t end = coupling->neighborsStart[i + 1];
+
+        qsort(coupling->neighbors + start, end - start, sizeof(size_t), SequentialMTCompareSizes);
+
+        coupling->neighborsStart[i] = numEdges;
+        for (j = start; j < end; j++) {
+            if (j == start || coupling->neighbors[j] != coupling->neighbors[j - 1]) {
+                coupling->neighbors[numEdges++] = coupling->neighbors[j];
+            }
+        }
+    }
+    coupling->neighborsStart[numComps] = numEdges;
+
+cleanup:
+    if (entries) {
+        mcx_free(entries);
+    }
+    if (compOfNode) {
+        mcx_free(compOfNode);
+    }
+    if (fill) {
+        mcx_free(fill);
+    }
+
+    return retVal;
+}
+
+// adds the entries of element comp after node to successors (if not NULL), returns their number
+static size_t SequentialMTAddLaterNodes(SequentialMTCoupling * coupling, size_t comp, size_t node, size_t * successors) {
+    size_t num = 0;
+    size_t i = 0;
+
+    for (i = coupling->nodesStart[comp]; i < coupling->nodesStart[comp + 1]; i++) {
+        if (coupling->nodes[i] > node) {
+            if (successors) {
+                successors[num] = coupling->nodes[i];
+            }
+            num++;
+        }
+    }
+
+    return num;
+}
+
+// adds the successors of node of element comp to successors (if not NULL), returns their number
+static size_t SequentialMTAddSuccessors(SequentialMTCoupling * coupling, size_t comp, size_t node, size_t * successors) {
+    size_t num = 0;
+    size_t i = 0;
+
+    // the evaluation list is in dependency order, so every edge points to a later entry
+    num += SequentialMTAddLaterNodes(coupling, comp, node, successors);
+    for (i = coupling->neighborsStart[comp]; i < coupling->neighborsStart[comp + 1]; i++) {
+        num += SequentialMTAddLaterNodes(coupling, coupling->neighbors[i], node, successors ? successors + num : NULL);
+    }
+
+    return num;
+}
+
+static McxStatus SequentialMTCreateGraph(StepTypeSequentialMT * sequentialMTType, SubModel * subModel) {
+    ObjectContainer * eval = subModel->evaluationList;
+    ObjectContainer * comps = subModel->components;
+
+    SequentialMTCoupling coupling = { NULL, NULL, NULL, NULL };
+    size_t numNodes = eval->Size(eval);
+    size_t numComps = comps->Size(comps);
+    size_t numEdges = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    sequentialMTType->numNodes = numNodes;
+    sequentialMTType->numPredecessors = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    sequentialMTType->successorsStart = (size_t *) mcx_calloc(numNodes + 1, sizeof(size_t));
+    sequentialMTType->remainingPredecessors = (McxAtomic *) mcx_calloc(numNodes + 1, sizeof(McxAtomic));
+    sequentialMTType->readyNodes = (McxAtomic *) mcx_calloc(numNodes + 1, sizeof(McxAtomic));
+    if (!sequentialMTType->numPredecessors || !sequentialMTType->successorsStart
+        || !sequentialMTType->remainingPredecessors || !sequentialMTType->readyNodes) {
+        mcx_log(LOG_ERROR, "Simulation: Memory allocation for the element graph failed");
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+
+    retVal = SequentialMTCouplingSetup(&coupling, comps, eval);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Could not collect the connections of the elements");
+        goto cleanup;
+    }
+
+    for (i = 0; i < numComps; i++) {
+        for (j = coupling.nodesStart[i]; j < coupling.nodesStart[i + 1]; j++) {
+            size_t node = coupling.nodes[j];
+
+            sequentialMTType->successorsStart[node + 1] = SequentialMTAddSuccessors(&coupling, i, node, NULL);
+        }
+    }
+    for (i = 0; i < numNodes; i++) {
+        sequentialMTType->successorsStart[i + 1] += sequentialMTType->successorsStart[i];
+    }
+    numEdges = sequentialMTType->successorsStart[numNodes];
+
+    sequentialMTType->successors = (size_t *) mcx_calloc(numEdges + 1, sizeof(size_t));
+    if (!sequentialMTType->successors) {
+        mcx_log(LOG_ERROR, "Simulation: Memory allocation for the element graph failed");
+        retVal = RETURN_ERROR;
+        goto cleanup;
+    }
+
+    for (i = 0; i < numComps; i++) {
+        for (j = coupling.nodesStart[i]; j < coupling.nodesStart[i + 1]; j++) {
+            size_t node = coupling.nodes[j];
+            size_t start = sequentialMTType->successorsStart[node];
+            size_t num = SequentialMTAddSuccessors(&coupling, i, node, sequentialMTType->successors + start);
+            size_t k = 0;
+
+            // successors in evaluation order, so that earlier entries are released first
+            qsort(sequentialMTType->successors + start, num, sizeof(size_t), SequentialMTCompareSizes);
+            for (k = 0; k < num; k++) {
+                sequentialMTType->numPredecessors[sequentialMTType->successors[start + k]]++;
+            }
+        }
+    }
+
+    mcx_log(LOG_DEBUG, "Simulation: Element graph with %zu nodes and %zu ordering constraints", numNodes, numEdges);
+
+cleanup:
+    SequentialMTCouplingDestroy(&coupling);
+
+    return retVal;
+}
+
+static McxStatus SequentialMTConfigure(StepType * stepType, StepTypeParams * params, SubModel * subModel) {
+    StepTypeSequentialMT * sequentialMTType = (StepTypeSequentialMT *) stepType;
+    WorkerPool * pool = sequentialMTType->pool;
+
+    size_t numWorkers = params->numThreads;
+
+    McxStatus retVal = RETURN_OK;
+
+    retVal = SequentialMTCreateGraph(sequentialMTType, subModel);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Could not create element graph");
+        return RETURN_ERROR;
+    }
+
+    if (0 == numWorkers) {
+        numWorkers = mcx_thread_get_num_cpus();
+    }
+    // more workers than evaluation list entries would only spin
+    if (numWorkers > sequentialMTType->numNodes) {
+        numWorkers = sequentialMTType->numNodes;
+    }
+
+    retVal = pool->SetAffinity(pool, params->cpuList);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Could not set processors of worker threads");
+        return RETURN_ERROR;
+    }
+
+    retVal = pool->Setup(pool, numWorkers);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Simulation: Could not create worker threads");
+        return RETURN_ERROR;
+    }
+
+    mcx_log(LOG_DEBUG, "Simulation: Using %zu worker threads for %zu elements", pool->GetNumWorkers(pool), sequentialMTType->numNodes);
+
+    if (params->cpuList) {
+        pool->LogPlacement(pool);
+    }
+
+    return RETURN_OK;
+}
+
+
+static void StepTypeSequentialMTDestructor(StepTypeSequentialMT * sequentialMTType) {
+    // joins the worker threads
+    object_destroy(sequentialMTType->pool);
+
+    if (sequentialMTType->numPredecessors) {
+        mcx_free(sequentialMTType->numPredecessors);
+    }
+    if (sequentialMTType->successorsStart) {
+        mcx_free(sequentialMTType->successorsStart);
+    }
+    if (sequentialMTType->successors) {
+        mcx_free(sequentialMTType->successors);
+    }
+    if (sequentialMTType->remainingPredecessors) {
+        mcx_free((void *) sequentialMTType->remainingPredecessors);
+    }
+    if (sequentialMTType->readyNodes) {
+        mcx_free((void *) sequentialMTType->readyNodes);
+    }
+}
+
+
+static StepTypeSequentialMT * StepTypeSequentialMTCreate(StepTypeSequentialMT * sequentialMTType) {
+    StepType * type = (StepType *) sequentialMTType;
+
+    type->type = STEP_TYPE_SEQUENTIAL_MT;
+
+    type->Configure = SequentialMTConfigure;
+    type->DoStep = SequentialMTDoStep;
+
+    sequentialMTType->pool = (WorkerPool *) object_create(WorkerPool);
+    if (!sequentialMTType->pool) {
+        mcx_log(LOG_ERROR, "Simulation: Could not create worker pool");
+        return NULL;
+    }
+
+    sequentialMTType->numNodes = 0;
+    sequentialMTType->numPredecessors = NULL;
+    sequentialMTType->successorsStart = NULL;
+    sequentialMTType->successors = NULL;
+
+    sequentialMTType->remainingPredecessors = NULL;
+    sequentialMTType->readyNodes = NULL;
+    mcx_atomic_store(&sequentialMTType->readyHead, 0);
+    mcx_atomic_store(&sequentialMTType->readyTail, 0);
+    mcx_atomic_store(&sequentialMTType->numWaiting, 0);
+    mcx_atomic_store(&sequentialMTType->numFailed, 0);
+
+    sequentialMTType->subModel = NULL;
+    sequentialMTType->params = NULL;
+
+    return sequentialMTType;
+}
+
+OBJECT_CLASS(StepTypeSequentialMT, StepType);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //ENABLE_MT
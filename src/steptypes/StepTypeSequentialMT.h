@@ -0,0 +1,64 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_STEPTYPES_STEP_TYPE_SEQUENTIAL_MT_H
+#define MCX_STEPTYPES_STEP_TYPE_SEQUENTIAL_MT_H
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#include "steptypes/StepType.h"
+#include "core/WorkerPool.h"
+#include "util/atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+extern const struct ObjectClass _StepTypeSequentialMT;
+
+/*
+ * Sequential (Gauss-Seidel) coupling executed as a task graph: evaluation
+ * list entries that are connected to each other or belong to the same
+ * element keep the order computed by tarjan(), all others run in parallel.
+ */
+typedef struct StepTypeSequentialMT {
+    StepType _;
+
+    // persistent workers executing the evaluation list entries
+    WorkerPool * pool;
+
+    // ordering constraints between evaluation list entries, successors in CSR format
+    size_t numNodes;
+    size_t * numPredecessors;
+    size_t * successorsStart;       // numNodes + 1 offsets into successors
+    size_t * successors;
+
+    // state of the current DoStep
+    McxAtomic * remainingPredecessors;
+    McxAtomic * readyNodes;         // queue of nodes whose predecessors are done, -1: not yet filled
+    McxAtomic readyHead;            // next queue slot taken by a worker
+    McxAtomic readyTail;            // next queue slot filled by a finished node
+    McxAtomic numWaiting;           // workers sleeping on an empty queue slot
+    McxAtomic numFailed;
+
+    // data of the current DoStep, read by the workers
+    SubModel * subModel;
+    StepTypeParams * params;
+} StepTypeSequentialMT;
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //ENABLE_MT
+
+#endif /* MCX_STEPTYPES_STEP_TYPE_SEQUENTIAL_MT_H */
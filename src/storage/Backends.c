@@ -18,11 +18,26 @@ const char * GetBackendTypeString(BackendType type) {
     switch (type) {
         case BACKEND_CSV:
             return "csv";
+        case BACKEND_BINARY:
+            return "binary";
+        case BACKEND_STREAM:
+            return "stream";
     }
 
     return "unknown";
 }
 
+const char * GetCompressionFileSuffix(CompressionType type) {
+    switch (type) {
+        case COMPRESSION_GZIP:
+            return ".gz";
+        case COMPRESSION_NONE:
+            return "";
+    }
+
+    return "";
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
\ No newline at end of file
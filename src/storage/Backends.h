@@ -19,11 +19,21 @@ extern "C" {
 
 typedef enum BackendType {
     BACKEND_CSV = 0,
+    BACKEND_BINARY = 1,
+    BACKEND_STREAM = 2,
     BACKEND_NUM
 } BackendType;
 
+typedef enum CompressionType {
+    COMPRESSION_NONE = 0,
+    COMPRESSION_GZIP = 1
+} CompressionType;
+
 const char * GetBackendTypeString(BackendType type);
 
+/* suffix that is appended to the names of result files written with the given compression */
+const char * GetCompressionFileSuffix(CompressionType type);
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -14,6 +14,10 @@
 #include "core/channels/ChannelInfo.h"
 #include "storage/ChannelStorage.h"
 
+#include "util/file.h"
+#include "util/os.h"
+#include "util/string.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -21,8 +25,19 @@ extern "C" {
 // ----------------------------------------------------------------------
 // Channel Storage
 
-static McxStatus ChannelStorageStoreFull(ChannelStorage * channelStore, double time);
-static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, double time);
+static McxStatus ChannelStorageStoreFull(ChannelStorage * channelStore, double time, ChannelValue * values);
+static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, double time, ChannelValue * values);
+#if defined (ENABLE_MT)
+static McxStatus ChannelStorageStoreRing(ChannelStorage * channelStore, double time, ChannelValue * values);
+#endif // ENABLE_MT
+
+// reference to the value of column col of the row that is stored
+static const void * ChannelStorageRowReference(Channel * channel, ChannelValue * values, size_t col) {
+    if (values) {
+        return ChannelValueReference(&values[col]);
+    }
+    return channel->GetValueReference(channel);
+}
 
 static size_t ChannelStorageGetChannelNum(ChannelStorage * channelStore) {
     ObjectContainer * channels = channelStore->channels;
@@ -35,7 +50,7 @@ static McxStatus ChannelStorageRegisterChannelInternal(ChannelStorage * channelS
     ChannelInfo *info = NULL;
 
     /* if values have already been written, do not allow registering additional channels */
-    if (channelStore->values) {
+    if (channelStore->values || channelStore->columnTypes) {
         info = channel->GetInfo(channel);
         mcx_log(LOG_ERROR, "Results: Register port %s: Cannot register ports to storage after values have been stored", info->GetLogName(info));
         return RETURN_ERROR;
@@ -164,38 +179,420 @@ static McxStatus ChannelStorageSetValueFromReferenceAt(ChannelStorage * channelS
     return RETURN_OK;
 }
 
-static McxStatus ChannelStorageStoreFull(ChannelStorage * channelStore, double time) {
+#define CHANNEL_STORAGE_CHUNK_ROWS 1024
+#define CHANNEL_STORAGE_ARENA_BLOCK_SIZE (64 * 1024)
+
+struct ChannelStorageArenaBlock {
+    ChannelStorageArenaBlock * next;
+    size_t lastChunk; /* newest chunk with data in this block */
+    size_t size;
+    size_t used;
+    char data[1];
+};
+
+/* strings and binaries in chunks */
+typedef struct StoredBlob {
+    char * data;
+    size_t len;
+} StoredBlob;
+
+static void ChannelStorageAddMemory(ChannelStorage * channelStore, size_t size) {
+    channelStore->memoryUsed += size;
+    if (channelStore->memoryUsed > channelStore->memoryPeak) {
+        channelStore->memoryPeak = channelStore->memoryUsed;
+    }
+}
+
+static void ChannelStorageRemoveMemory(ChannelStorage * channelStore, size_t size) {
+    channelStore->memoryUsed -= size;
+}
+
+static size_t ChannelStorageColumnSize(ChannelType type) {
+    switch (type) {
+    case CHANNEL_DOUBLE:
+        return CHANNEL_STORAGE_CHUNK_ROWS * sizeof(double);
+    case CHANNEL_INTEGER:
+        return CHANNEL_STORAGE_CHUNK_ROWS * sizeof(int);
+    case CHANNEL_BOOL:
+        return CHANNEL_STORAGE_CHUNK_ROWS / 8;
+    case CHANNEL_STRING:
+        return CHANNEL_STORAGE_CHUNK_ROWS * sizeof(char *);
+    case CHANNEL_BINARY:
+    case CHANNEL_BINARY_REFERENCE:
+        return CHANNEL_STORAGE_CHUNK_ROWS * sizeof(StoredBlob);
+    default:
+        return 0;
+    }
+}
+
+static McxStatus ChannelStorageSetupColumns(ChannelStorage * channelStore) {
+    ObjectContainer * channels = channelStore->channels;
+    size_t colNum = channels->Size(channels);
+    size_t col = 0;
+    size_t offset = 0;
+
+    channelStore->columnTypes = (ChannelType *) mcx_calloc(colNum, sizeof(ChannelType));
+    channelStore->columnOffsets = (size_t *) mcx_calloc(colNum, sizeof(size_t));
+    if (!channelStore->columnTypes || !channelStore->columnOffsets) {
+        mcx_log(LOG_ERROR, "Results: Store ports: No memory for port columns");
+        return RETURN_ERROR;
+    }
+
+    for (col = 0; col < colNum; col++) {
+        ChannelInfo * info = channelStore->GetChannelInfo(channelStore, col);
+
+        channelStore->columnTypes[col] = info->GetType(info);
+        channelStore->columnOffsets[col] = offset;
+        // keep every column 8-byte aligned
+        offset += (ChannelStorageColumnSize(channelStore->columnTypes[col]) + 7) & ~((size_t) 7);
+    }
+    channelStore->chunkSize = offset;
+
+    ChannelStorageAddMemory(channelStore, colNum * (sizeof(ChannelType) + sizeof(size_t)));
+
+    return RETURN_OK;
+}
+
+static char * ChannelStorageArenaCopy(ChannelStorage * channelStore, size_t chunk, const char * data, size_t len) {
+    ChannelStorageArenaBlock * block = channelStore->arenaLast;
+    char * copy = NULL;
+
+    if (!block || block->size - block->used < len) {
+        size_t size = len > CHANNEL_STORAGE_ARENA_BLOCK_SIZE ? len : CHANNEL_STORAGE_ARENA_BLOCK_SIZE;
+
+        block = (ChannelStorageArenaBlock *) mcx_malloc(sizeof(ChannelStorageArenaBlock) + size);
+        if (!block) {
+            return NULL;
+        }
+        block->next = NULL;
+        block->size = size;
+        block->used = 0;
+        if (channelStore->arenaLast) {
+            channelStore->arenaLast->next = block;
+        } else {
+            channelStore->arena = block;
+        }
+        channelStore->arenaLast = block;
+
+        ChannelStorageAddMemory(channelStore, sizeof(ChannelStorageArenaBlock) + size);
+    }
+
+    copy = block->data + block->used;
+    memcpy(copy, data, len);
+    block->used += len;
+    block->lastChunk = chunk;
+
+    return copy;
+}
+
+/* frees all arena blocks that only hold data of chunks before chunk */
+static void ChannelStorageArenaRelease(ChannelStorage * channelStore, size_t chunk) {
+    while (channelStore->arena && channelStore->arena->lastChunk < chunk) {
+        ChannelStorageArenaBlock * block = channelStore->arena;
+
+        channelStore->arena = block->next;
+        if (channelStore->arenaLast == block) {
+            channelStore->arenaLast = NULL;
+        }
+        ChannelStorageRemoveMemory(channelStore, sizeof(ChannelStorageArenaBlock) + block->size);
+        mcx_free(block);
+    }
+}
+
+static McxStatus ChannelStorageSetChunkValue(ChannelStorage * channelStore, size_t row, size_t col, const void * reference) {
+    char * column = channelStore->chunks[row / CHANNEL_STORAGE_CHUNK_ROWS] + channelStore->columnOffsets[col];
+    size_t idx = row % CHANNEL_STORAGE_CHUNK_ROWS;
+
+    switch (channelStore->columnTypes[col]) {
+    case CHANNEL_DOUBLE:
+        ((double *) column)[idx] = reference ? * (const double *) reference : 0.0;
+        break;
+    case CHANNEL_INTEGER:
+        ((int *) column)[idx] = reference ? * (const int *) reference : 0;
+        break;
+    case CHANNEL_BOOL: {
+        unsigned char mask = (unsigned char) (1u << (idx % 8));
+
+        if (reference && * (const int *) reference) {
+            ((unsigned char *) column)[idx / 8] |= mask;
+        } else {
+            ((unsigned char *) column)[idx / 8] &= (unsigned char) ~mask;
+        }
+        break;
+    }
+    case CHANNEL_STRING: {
+        const char * str = reference ? * (const char * const *) reference : NULL;
+        char * copy = NULL;
+
+        if (str) {
+            copy = ChannelStorageArenaCopy(channelStore, row / CHANNEL_STORAGE_CHUNK_ROWS, str, strlen(str) + 1);
+            if (!copy) {
+                mcx_log(LOG_ERROR, "Results: Store ports: No memory for string value");
+                return RETURN_ERROR;
+            }
+        }
+        ((char **) column)[idx] = copy;
+        break;
+    }
+    case CHANNEL_BINARY:
+    case CHANNEL_BINARY_REFERENCE: {
+        const binary_string * binary = (const binary_string *) reference;
+        StoredBlob * blob = &((StoredBlob *) column)[idx];
+
+        blob->data = NULL;
+        blob->len = 0;
+        if (binary && binary->data) {
+            blob->data = ChannelStorageArenaCopy(channelStore, row / CHANNEL_STORAGE_CHUNK_ROWS, binary->data, binary->len);
+            if (!blob->data && binary->len > 0) {
+                mcx_log(LOG_ERROR, "Results: Store ports: No memory for binary value");
+                return RETURN_ERROR;
+            }
+            blob->len = binary->len;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelStorageWriteSpill(ChannelStorage * channelStore, const void * data, size_t size) {
+    if (size > 0 && 1 != fwrite(data, size, 1, channelStore->spillFile)) {
+        mcx_log(LOG_ERROR, "Results: Could not write to storage file \"%s\"", channelStore->spillFileName);
+        return RETURN_ERROR;
+    }
+    return RETURN_OK;
+}
+
+/* Moves the oldest chunk in memory to the spill file. The fixed-size
+ * columns are written as they are, followed by the lengths and contents
+ * of the strings (including termination, 0 for NULL) and binaries. */
+static McxStatus ChannelStorageSpillChunk(ChannelStorage * channelStore) {
+    ObjectContainer * channels = channelStore->channels;
+    size_t colNum = channels->Size(channels);
+    size_t chunkIdx = channelStore->numSpilledChunks;
+    char * chunk = channelStore->chunks[chunkIdx];
+    int64_t * offsets = NULL;
+    int64_t size = (int64_t) channelStore->chunkSize;
+    size_t col = 0, idx = 0;
+
+    offsets = (int64_t *) mcx_realloc(channelStore->spillOffsets, (chunkIdx + 2) * sizeof(int64_t));
+    if (!offsets) {
+        mcx_log(LOG_ERROR, "Results: Store ports: No memory for storage file offsets");
+        return RETURN_ERROR;
+    }
+    channelStore->spillOffsets = offsets;
+
+    if (mcx_file_seek(channelStore->spillFile, offsets[chunkIdx])) {
+        mcx_log(LOG_ERROR, "Results: Could not seek in storage file \"%s\"", channelStore->spillFileName);
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != ChannelStorageWriteSpill(channelStore, chunk, channelStore->chunkSize)) {
+        return RETURN_ERROR;
+    }
+
+    for (col = 0; col < colNum; col++) {
+        const char * column = chunk + channelStore->columnOffsets[col];
+        ChannelType type = channelStore->columnTypes[col];
+
+        if (CHANNEL_STRING != type && CHANNEL_BINARY != type && CHANNEL_BINARY_REFERENCE != type) {
+            continue;
+        }
+
+        for (idx = 0; idx < CHANNEL_STORAGE_CHUNK_ROWS; idx++) {
+            const char * data = NULL;
+            uint64_t len = 0;
+
+            if (CHANNEL_STRING == type) {
+                data = ((char * const *) column)[idx];
+                len = data ? strlen(data) + 1 : 0;
+            } else {
+                data = ((const StoredBlob *) column)[idx].data;
+                len = data ? ((const StoredBlob *) column)[idx].len : 0;
+            }
+
+            if (RETURN_OK != ChannelStorageWriteSpill(channelStore, &len, sizeof(len))
+                || RETURN_OK != ChannelStorageWriteSpill(channelStore, data, (size_t) len)) {
+                return RETURN_ERROR;
+            }
+            size += sizeof(len) + len;
+        }
+    }
+
+    offsets[chunkIdx + 1] = offsets[chunkIdx] + size;
+
+    mcx_free(chunk);
+    channelStore->chunks[chunkIdx] = NULL;
+    ChannelStorageRemoveMemory(channelStore, channelStore->chunkSize);
+    channelStore->numSpilledChunks++;
+
+    ChannelStorageArenaRelease(channelStore, channelStore->numSpilledChunks);
+
+    return RETURN_OK;
+}
+
+/* reads a spilled chunk into the spill buffer and returns it */
+static const char * ChannelStorageLoadChunk(ChannelStorage * channelStore, size_t chunkIdx) {
+    ObjectContainer * channels = channelStore->channels;
+    size_t colNum = channels->Size(channels);
+    size_t size = 0;
+    size_t pos = channelStore->chunkSize;
+    size_t col = 0, idx = 0;
+    char * buffer = NULL;
+
+    if (chunkIdx == channelStore->spillLoadedChunk) {
+        return channelStore->spillBuffer;
+    }
+    if (!channelStore->spillFile) {
+        mcx_log(LOG_ERROR, "Results: Rows of storage file \"%s\" are not available anymore", channelStore->spillFileName);
+        return NULL;
+    }
+
+    size = (size_t) (channelStore->spillOffsets[chunkIdx + 1] - channelStore->spillOffsets[chunkIdx]);
+    if (size > channelStore->spillBufferSize) {
+        buffer = (char *) mcx_realloc(channelStore->spillBuffer, size);
+        if (!buffer) {
+            mcx_log(LOG_ERROR, "Results: No memory to read storage file \"%s\"", channelStore->spillFileName);
+            return NULL;
+        }
+        ChannelStorageAddMemory(channelStore, size - channelStore->spillBufferSize);
+        channelStore->spillBuffer = buffer;
+        channelStore->spillBufferSize = size;
+    }
+    buffer = channelStore->spillBuffer;
+    channelStore->spillLoadedChunk = (size_t) -1;
+
+    if (mcx_file_seek(channelStore->spillFile, channelStore->spillOffsets[chunkIdx])
+        || 1 != fread(buffer, size, 1, channelStore->spillFile)) {
+        mcx_log(LOG_ERROR, "Results: Could not read storage file \"%s\"", channelStore->spillFileName);
+        return NULL;
+    }
+
+    // let the string and binary columns point to the contents behind the fixed-size columns
+    for (col = 0; col < colNum; col++) {
+        char * column = buffer + channelStore->columnOffsets[col];
+        ChannelType type = channelStore->columnTypes[col];
+
+        if (CHANNEL_STRING != type && CHANNEL_BINARY != type && CHANNEL_BINARY_REFERENCE != type) {
+            continue;
+        }
+
+        for (idx = 0; idx < CHANNEL_STORAGE_CHUNK_ROWS; idx++) {
+            uint64_t len = 0;
+            char * data = NULL;
+
+            memcpy(&len, buffer + pos, sizeof(len));
+            pos += sizeof(len);
+            data = len ? buffer + pos : NULL;
+            pos += (size_t) len;
+
+            if (CHANNEL_STRING == type) {
+                ((char **) column)[idx] = data;
+            } else {
+                ((StoredBlob *) column)[idx].data = data;
+                ((StoredBlob *) column)[idx].len = (size_t) len;
+            }
+        }
+    }
+
+    channelStore->spillLoadedChunk = chunkIdx;
+
+    return buffer;
+}
+
+static ChannelValue ChannelStorageGetChunkValue(ChannelStorage * channelStore, size_t row, size_t col) {
+    const char * chunk = channelStore->chunks[row / CHANNEL_STORAGE_CHUNK_ROWS];
+    const char * column = NULL;
+    size_t idx = row % CHANNEL_STORAGE_CHUNK_ROWS;
+    ChannelValue value;
+
+    ChannelValueInit(&value, channelStore->columnTypes[col]);
+
+    if (!chunk) {
+        chunk = ChannelStorageLoadChunk(channelStore, row / CHANNEL_STORAGE_CHUNK_ROWS);
+        if (!chunk) {
+            return value;
+        }
+    }
+    column = chunk + channelStore->columnOffsets[col];
+
+    // string and binary values point into the arena and must not be destroyed
+    switch (channelStore->columnTypes[col]) {
+    case CHANNEL_DOUBLE:
+        value.value.d = ((const double *) column)[idx];
+        break;
+    case CHANNEL_INTEGER:
+        value.value.i = ((const int *) column)[idx];
+        break;
+    case CHANNEL_BOOL:
+        value.value.i = (((const unsigned char *) column)[idx / 8] >> (idx % 8)) & 1;
+        break;
+    case CHANNEL_STRING:
+        value.value.s = ((char * const *) column)[idx];
+        break;
+    case CHANNEL_BINARY:
+    case CHANNEL_BINARY_REFERENCE:
+        value.value.b.data = ((const StoredBlob *) column)[idx].data;
+        value.value.b.len = ((const StoredBlob *) column)[idx].len;
+        value.value.b.payload = NULL;
+        break;
+    default:
+        break;
+    }
+
+    return value;
+}
+
+static McxStatus ChannelStorageStoreFull(ChannelStorage * channelStore, double time, ChannelValue * values) {
     ObjectContainer * channels = channelStore->channels;
+    size_t row = channelStore->numValues;
     size_t i = 0;
     McxStatus retVal;
 
-    /* first store: allocate memory */
-    if (channelStore->numValuesAllocated == 0) {
-        size_t newSize = 0;
-        channelStore->numValuesAllocated = 1;
-        newSize = channelStore->numValuesAllocated * channels->Size(channels) * sizeof(ChannelValue);
-
-        channelStore->values = (ChannelValue *) mcx_realloc(channelStore->values, newSize);
-        if (!channelStore->values) {
-            mcx_log(LOG_DEBUG, "Results: Store ports: No memory for port values");
+    /* first store: set up the column layout */
+    if (!channelStore->columnTypes) {
+        retVal = ChannelStorageSetupColumns(channelStore);
+        if (RETURN_OK != retVal) {
             return RETURN_ERROR;
         }
     }
 
-    if (channelStore->numValues + 1 > channelStore->numValuesAllocated) {
-        size_t newSize = 0;
-        channelStore->numValuesAllocated *= 2;
-        newSize = channelStore->numValuesAllocated * channels->Size(channels) * sizeof(ChannelValue);
+    /* start a new chunk */
+    if (row / CHANNEL_STORAGE_CHUNK_ROWS >= channelStore->numChunks) {
+        char * chunk = NULL;
 
-        channelStore->values = (ChannelValue *) mcx_realloc(channelStore->values, newSize);
-        if (!channelStore->values) {
-            mcx_log(LOG_DEBUG, "Results: Store ports: No memory for port values");
+        if (channelStore->numChunks == channelStore->numChunksAllocated) {
+            size_t newNum = channelStore->numChunksAllocated ? 2 * channelStore->numChunksAllocated : 16;
+            char ** chunks = (char **) mcx_realloc(channelStore->chunks, newNum * sizeof(char *));
+            if (!chunks) {
+                mcx_log(LOG_ERROR, "Results: Store ports: No memory for port values");
+                return RETURN_ERROR;
+            }
+            ChannelStorageAddMemory(channelStore, (newNum - channelStore->numChunksAllocated) * sizeof(char *));
+            channelStore->chunks = chunks;
+            channelStore->numChunksAllocated = newNum;
+        }
+
+        chunk = (char *) mcx_calloc(1, channelStore->chunkSize);
+        if (!chunk) {
+            mcx_log(LOG_ERROR, "Results: Store ports: No memory for port values");
             return RETURN_ERROR;
         }
+        ChannelStorageAddMemory(channelStore, channelStore->chunkSize);
+        channelStore->chunks[channelStore->numChunks++] = chunk;
+
+        if (channelStore->spillFile && channelStore->numChunks - channelStore->numSpilledChunks > channelStore->spillWindow) {
+            retVal = ChannelStorageSpillChunk(channelStore);
+            if (RETURN_OK != retVal) {
+                return RETURN_ERROR;
+            }
+        }
     }
 
     /* set time */
-    retVal = ChannelStorageSetValueFromReferenceAt(channelStore, channelStore->numValues, 0, &time);
+    retVal = ChannelStorageSetChunkValue(channelStore, row, 0, &time);
     if (RETURN_OK != retVal) {
         mcx_log(LOG_ERROR, "Results: Store ports: Could not set time %f", time);
         return RETURN_ERROR;
@@ -204,9 +601,8 @@ static McxStatus ChannelStorageStoreFull(ChannelStorage * channelStore, double t
     /* set channels */
     for (i = 1; i < channels->Size(channels); i++) {
         Channel * channel = (Channel *) channels->At(channels, i);
-        retVal = ChannelStorageSetValueFromReferenceAt(channelStore,
-            channelStore->numValues, i, channel->GetValueReference(channel));
-        if (RETURN_OK != retVal) { /* error msg in ChannelStorageSetValueFromReferenceAt */
+        retVal = ChannelStorageSetChunkValue(channelStore, row, i, ChannelStorageRowReference(channel, values, i));
+        if (RETURN_OK != retVal) { /* error msg in ChannelStorageSetChunkValue */
             ChannelInfo *info = channel->GetInfo(channel);
             mcx_log(LOG_DEBUG, "Results: Error in store port %s", info->GetLogName(info));
             return RETURN_ERROR;
@@ -214,11 +610,12 @@ static McxStatus ChannelStorageStoreFull(ChannelStorage * channelStore, double t
     }
     //    ChannelStoragePrint(channelStore);
     channelStore->numValues += 1;
+    channelStore->numValuesAllocated = channelStore->numChunks * CHANNEL_STORAGE_CHUNK_ROWS;
 
     return RETURN_OK;
 }
 
-static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, double time) {
+static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, double time, ChannelValue * values) {
     ObjectContainer * channels = channelStore->channels;
     size_t i = 0;
     McxStatus retVal;
@@ -233,6 +630,7 @@ static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, doubl
             mcx_log(LOG_DEBUG, "Results: Store ports: No memory for port values");
             return RETURN_ERROR;
         }
+        ChannelStorageAddMemory(channelStore, newSize);
     }
 
     /* no incrementing numValues, thus no reallocating */
@@ -247,7 +645,7 @@ static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, doubl
     /* set channels */
     for (i = 1; i < channels->Size(channels); i++) {
         Channel * channel = (Channel *) channels->At(channels, i);
-        retVal = ChannelStorageSetValueFromReferenceAt(channelStore, 0, i, channel->GetValueReference(channel));
+        retVal = ChannelStorageSetValueFromReferenceAt(channelStore, 0, i, ChannelStorageRowReference(channel, values, i));
         if (RETURN_OK != retVal) { /* error msg in ChannelStorageSetValueFromReferenceAt */
             ChannelInfo *info = channel->GetInfo(channel);
             mcx_log(LOG_DEBUG, "Results: Error in store port %s", info->GetLogName(info));
@@ -264,6 +662,9 @@ static McxStatus ChannelStorageStoreNonFull(ChannelStorage * channelStore, doubl
 // TODO: save number of columns
 static ChannelValue ChannelStorageGetValueAt(ChannelStorage * channelStore, size_t row, size_t col) {
     size_t colNum = channelStore->channels->Size(channelStore->channels);
+    if (channelStore->chunks) {
+        return ChannelStorageGetChunkValue(channelStore, row, col);
+    }
     return channelStore->values[row * colNum + col];
 }
 
@@ -283,6 +684,148 @@ static ChannelInfo * ChannelStorageGetChannelInfo(ChannelStorage * channelStore,
     }
 }
 
+static McxStatus ChannelStorageSetupSpill(ChannelStorage * channelStore, const char * fileName, size_t numRows) {
+    if (!channelStore->fullStorage) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: Storage file can only be used with full storage");
+        return RETURN_ERROR;
+    }
+    if (channelStore->columnTypes) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: Storage file has to be set up before values are stored");
+        return RETURN_ERROR;
+    }
+
+    channelStore->spillOffsets = (int64_t *) mcx_calloc(1, sizeof(int64_t));
+    channelStore->spillFileName = mcx_string_copy(fileName);
+    if (!channelStore->spillOffsets || !channelStore->spillFileName) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: No memory for storage file");
+        return RETURN_ERROR;
+    }
+
+    channelStore->spillFile = mcx_os_fopen(fileName, "w+b");
+    if (!channelStore->spillFile) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: Could not create storage file \"%s\"", fileName);
+        return RETURN_ERROR;
+    }
+
+    channelStore->spillWindow = (numRows + CHANNEL_STORAGE_CHUNK_ROWS - 1) / CHANNEL_STORAGE_CHUNK_ROWS;
+    if (channelStore->spillWindow == 0) {
+        channelStore->spillWindow = 1;
+    }
+
+    return RETURN_OK;
+}
+
+static void ChannelStorageRemoveSpill(ChannelStorage * channelStore) {
+    if (channelStore->spillFile) {
+        mcx_os_fclose(channelStore->spillFile);
+        channelStore->spillFile = NULL;
+        if (remove(channelStore->spillFileName)) {
+            mcx_log(LOG_DEBUG, "Results: Could not remove storage file \"%s\"", channelStore->spillFileName);
+        }
+    }
+}
+
+#if defined (ENABLE_MT)
+static McxStatus ChannelStorageSetupRing(ChannelStorage * channelStore, size_t numRows, int dropIfFull) {
+    ObjectContainer * channels = channelStore->channels;
+    size_t colNum = channels->Size(channels);
+    size_t ringSize = 1;
+    size_t row = 0, col = 0;
+
+    if (channelStore->fullStorage) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: Ring buffer cannot be used with full storage");
+        return RETURN_ERROR;
+    }
+    if (channelStore->values) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: Ring buffer has to be set up before values are stored");
+        return RETURN_ERROR;
+    }
+
+    while (ringSize < numRows) {
+        ringSize *= 2;
+    }
+
+    channelStore->values = (ChannelValue *) mcx_calloc(ringSize * colNum, sizeof(ChannelValue));
+    if (!channelStore->values) {
+        mcx_log(LOG_ERROR, "Results: Setup port storage: No memory for %zu buffered rows", ringSize);
+        return RETURN_ERROR;
+    }
+    ChannelStorageAddMemory(channelStore, ringSize * colNum * sizeof(ChannelValue));
+    for (row = 0; row < ringSize; row++) {
+        for (col = 0; col < colNum; col++) {
+            ChannelInfo * info = channelStore->GetChannelInfo(channelStore, col);
+            ChannelValueInit(&channelStore->values[row * colNum + col], info->GetType(info));
+        }
+    }
+    channelStore->numValues = ringSize;
+    channelStore->numValuesAllocated = ringSize;
+
+    channelStore->ringSize = ringSize;
+    channelStore->dropIfFull = dropIfFull;
+    channelStore->Store = ChannelStorageStoreRing;
+
+    return RETURN_OK;
+}
+
+static McxStatus ChannelStorageStoreRing(ChannelStorage * channelStore, double time, ChannelValue * values) {
+    ObjectContainer * channels = channelStore->channels;
+    uint32_t head = (uint32_t) mcx_atomic_load(&channelStore->ringHead);
+    uint32_t tail = (uint32_t) mcx_atomic_load(&channelStore->ringTail);
+    size_t row = 0;
+    size_t i = 0;
+    McxStatus retVal;
+
+    channelStore->ringRowPending = FALSE;
+
+    if (head - tail >= channelStore->ringSize) {
+        if (channelStore->dropIfFull) {
+            channelStore->numDroppedRows++;
+            return RETURN_OK;
+        }
+
+        // back-pressure: wait until the writer has written the oldest row
+        mcx_atomic_store(&channelStore->ringWaiting, TRUE);
+        while (head - (tail = (uint32_t) mcx_atomic_load(&channelStore->ringTail)) >= channelStore->ringSize) {
+            mcx_atomic_wait(&channelStore->ringTail, (int32_t) tail);
+        }
+        mcx_atomic_store(&channelStore->ringWaiting, FALSE);
+    }
+
+    row = head & (channelStore->ringSize - 1);
+
+    /* set time */
+    retVal = ChannelStorageSetValueFromReferenceAt(channelStore, row, 0, &time);
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Results: Store ports: Could not set time %f", time);
+        return RETURN_ERROR;
+    }
+
+    /* set channels */
+    for (i = 1; i < channels->Size(channels); i++) {
+        Channel * channel = (Channel *) channels->At(channels, i);
+        retVal = ChannelStorageSetValueFromReferenceAt(channelStore, row, i, ChannelStorageRowReference(channel, values, i));
+        if (RETURN_OK != retVal) { /* error msg in ChannelStorageSetValueFromReferenceAt */
+            ChannelInfo *info = channel->GetInfo(channel);
+            mcx_log(LOG_DEBUG, "Results: Error in store port %s", info->GetLogName(info));
+            return RETURN_ERROR;
+        }
+    }
+    channelStore->ringRowPending = TRUE;
+
+    return RETURN_OK;
+}
+
+static int ChannelStoragePublishRow(ChannelStorage * channelStore) {
+    if (!channelStore->ringRowPending) {
+        return FALSE;
+    }
+    channelStore->ringRowPending = FALSE;
+    mcx_atomic_fetch_add(&channelStore->ringHead, 1);
+
+    return TRUE;
+}
+#endif // ENABLE_MT
+
 static void ChannelStorageDestructor(ChannelStorage * channelStore) {
     if (channelStore) {
         ObjectContainer * channels = channelStore->channels;
@@ -300,6 +843,44 @@ static void ChannelStorageDestructor(ChannelStorage * channelStore) {
             channelStore->values = NULL;
         }
 
+        if (channelStore->chunks) {
+            size_t i = 0;
+            for (i = 0; i < channelStore->numChunks; i++) {
+                if (channelStore->chunks[i]) {
+                    mcx_free(channelStore->chunks[i]);
+                }
+            }
+            mcx_free(channelStore->chunks);
+            channelStore->chunks = NULL;
+        }
+        while (channelStore->arena) {
+            ChannelStorageArenaBlock * next = channelStore->arena->next;
+            mcx_free(channelStore->arena);
+            channelStore->arena = next;
+        }
+        if (channelStore->columnTypes) {
+            mcx_free(channelStore->columnTypes);
+            channelStore->columnTypes = NULL;
+        }
+        if (channelStore->columnOffsets) {
+            mcx_free(channelStore->columnOffsets);
+            channelStore->columnOffsets = NULL;
+        }
+
+        ChannelStorageRemoveSpill(channelStore);
+        if (channelStore->spillFileName) {
+            mcx_free(channelStore->spillFileName);
+            channelStore->spillFileName = NULL;
+        }
+        if (channelStore->spillOffsets) {
+            mcx_free(channelStore->spillOffsets);
+            channelStore->spillOffsets = NULL;
+        }
+        if (channelStore->spillBuffer) {
+            mcx_free(channelStore->spillBuffer);
+            channelStore->spillBuffer = NULL;
+        }
+
         if (channels) {
             size_t i = 0;
             if (channels->Size(channels) > 0) {
@@ -327,6 +908,12 @@ static ChannelStorage * ChannelStorageCreate(ChannelStorage * channelStore) {
 
     channelStore->Length = ChannelStorageLength;
     channelStore->GetChannelInfo = ChannelStorageGetChannelInfo;
+    channelStore->SetupSpill = ChannelStorageSetupSpill;
+    channelStore->RemoveSpill = ChannelStorageRemoveSpill;
+#if defined (ENABLE_MT)
+    channelStore->SetupRing = ChannelStorageSetupRing;
+    channelStore->PublishRow = ChannelStoragePublishRow;
+#endif // ENABLE_MT
 
     channelStore->channels = (ObjectContainer *) object_create(ObjectContainer);
     if (!channelStore->channels) {
@@ -337,12 +924,43 @@ static ChannelStorage * ChannelStorageCreate(ChannelStorage * channelStore) {
     channelStore->numValuesAllocated = 0;
     channelStore->values    = NULL;
 
+    channelStore->chunks = NULL;
+    channelStore->numChunks = 0;
+    channelStore->numChunksAllocated = 0;
+    channelStore->columnTypes = NULL;
+    channelStore->columnOffsets = NULL;
+    channelStore->chunkSize = 0;
+    channelStore->arena = NULL;
+    channelStore->arenaLast = NULL;
+
+    channelStore->spillFile = NULL;
+    channelStore->spillFileName = NULL;
+    channelStore->spillWindow = 0;
+    channelStore->numSpilledChunks = 0;
+    channelStore->spillOffsets = NULL;
+    channelStore->spillBuffer = NULL;
+    channelStore->spillBufferSize = 0;
+    channelStore->spillLoadedChunk = (size_t) -1;
+
+    channelStore->memoryUsed = 0;
+    channelStore->memoryPeak = 0;
+
     channelStore->lastStored = -1.0;
 
     channelStore->fullStorage = TRUE;
 
     channelStore->storeCallNum = 0;
 
+#if defined (ENABLE_MT)
+    channelStore->ringSize = 0;
+    channelStore->dropIfFull = FALSE;
+    mcx_atomic_store(&channelStore->ringHead, 0);
+    mcx_atomic_store(&channelStore->ringTail, 0);
+    mcx_atomic_store(&channelStore->ringWaiting, FALSE);
+    channelStore->ringRowPending = FALSE;
+    channelStore->numDroppedRows = 0;
+#endif // ENABLE_MT
+
     return channelStore;
 }
 
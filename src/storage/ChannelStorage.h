@@ -11,23 +11,32 @@
 #ifndef MCX_STORAGE_CHANNELSTORAGE_H
 #define MCX_STORAGE_CHANNELSTORAGE_H
 
+#include "util/atomic.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 typedef struct ChannelStorage ChannelStorage;
 typedef struct ComponentStorage ComponentStorage;
+typedef struct ChannelStorageArenaBlock ChannelStorageArenaBlock;
 
 struct ChannelInfo;
 
 typedef McxStatus (* fChannelStorageSetup)(ChannelStorage * channelStore, int fullStorage);
 typedef McxStatus (* fChannelStorageRegisterChannel)(ChannelStorage * channelStore,
                                                      Channel * channel);
-typedef McxStatus (* fChannelStorageStore)(ChannelStorage * channelStore, double time);
+typedef McxStatus (* fChannelStorageStore)(ChannelStorage * channelStore, double time, ChannelValue * values);
 typedef size_t (* fChannelStorageGetChannelNum)(ChannelStorage * channelStore);
 typedef ChannelValue (* fChannelStorageGetValueAt)(ChannelStorage * channelStore, size_t row, size_t col);
 typedef size_t (* fChannelStorageLength)(ChannelStorage * channelStore);
 typedef struct ChannelInfo * (* fChannelStorageGetChannelInfo)(ChannelStorage * channelStore, size_t idx);
+typedef McxStatus (* fChannelStorageSetupSpill)(ChannelStorage * channelStore, const char * fileName, size_t numRows);
+typedef void (* fChannelStorageRemoveSpill)(ChannelStorage * channelStore);
+#if defined (ENABLE_MT)
+typedef McxStatus (* fChannelStorageSetupRing)(ChannelStorage * channelStore, size_t numRows, int dropIfFull);
+typedef int (* fChannelStoragePublishRow)(ChannelStorage * channelStore);
+#endif // ENABLE_MT
 
 extern const struct ObjectClass _ChannelStorage;
 
@@ -36,6 +45,12 @@ typedef struct ChannelStorage {
 
     fChannelStorageSetup Setup;
     fChannelStorageRegisterChannel RegisterChannel;
+
+    /**
+     * Stores a row for time. The values of the row are taken from values
+     * (one per channel, the first is ignored) or, if values is NULL, from the
+     * channels.
+     */
     fChannelStorageStore Store;
 
     fChannelStorageGetChannelNum GetChannelNum;
@@ -45,18 +60,83 @@ typedef struct ChannelStorage {
 
     fChannelStorageGetChannelInfo GetChannelInfo;
 
+    /**
+     * Keeps at most numRows rows of full storage in memory. Older rows are
+     * moved to the file fileName and read back when they are accessed.
+     */
+    fChannelStorageSetupSpill SetupSpill;
+
+    /**
+     * Closes and deletes the file of SetupSpill. The rows in the file
+     * cannot be accessed afterwards.
+     */
+    fChannelStorageRemoveSpill RemoveSpill;
+
+#if defined (ENABLE_MT)
+    /**
+     * Stores the rows in a ring buffer that is emptied by the result writer
+     * thread instead of overwriting a single row. If the ring is full, Store
+     * either waits for the writer or drops the row.
+     */
+    fChannelStorageSetupRing SetupRing;
+
+    /**
+     * Makes the row of the last Store visible to the result writer. Returns
+     * FALSE if there was no row to publish because it was dropped.
+     */
+    fChannelStoragePublishRow PublishRow;
+#endif // ENABLE_MT
+
     ObjectContainer * channels; /* of Channel */
 
     // the vector of values
     size_t numValues; /* number of rows used*/
     size_t numValuesAllocated; /* number of rows allocated */
-    ChannelValue * values; /* of size numValuesAllocated * descriptions->Size() */
+    ChannelValue * values; /* of size numValuesAllocated * descriptions->Size(), not used for full storage */
+
+    /* full storage: rows are kept in chunks of CHANNEL_STORAGE_CHUNK_ROWS rows,
+     * each chunk holds one packed column per channel. Strings and binaries
+     * are copied into the arena. Chunks and arena blocks never move. */
+    char ** chunks;
+    size_t numChunks;
+    size_t numChunksAllocated;
+    ChannelType * columnTypes;
+    size_t * columnOffsets; /* byte offset of each column within a chunk */
+    size_t chunkSize;
+    ChannelStorageArenaBlock * arena;     /* oldest block */
+    ChannelStorageArenaBlock * arenaLast; /* block that is filled */
+
+    /* full storage with a memory window: chunks [0, numSpilledChunks)
+     * are moved to spillFile, the chunk at spillOffsets[i] is loaded
+     * into spillBuffer when it is accessed */
+    FILE * spillFile;
+    char * spillFileName;
+    size_t spillWindow; /* number of chunks kept in memory */
+    size_t numSpilledChunks;
+    int64_t * spillOffsets; /* of size numSpilledChunks + 1 */
+    char * spillBuffer;
+    size_t spillBufferSize;
+    size_t spillLoadedChunk; /* chunk in spillBuffer, (size_t) -1 if none */
+
+    size_t memoryUsed; /* bytes allocated for stored values */
+    size_t memoryPeak;
 
     double lastStored;
 
     int fullStorage;
 
     size_t storeCallNum;
+
+#if defined (ENABLE_MT)
+    // ring buffer of rows, the row of position p is stored in p % ringSize
+    size_t ringSize;         // power of 2, 0 if the ring is not used
+    int dropIfFull;
+    McxAtomic ringHead;      // positions published by the simulation
+    McxAtomic ringTail;      // positions written by the result writer
+    McxAtomic ringWaiting;   // simulation waits for ringTail to advance
+    int ringRowPending;      // row stored at ringHead but not yet published
+    size_t numDroppedRows;
+#endif // ENABLE_MT
 } ChannelStorage;
 
 #ifdef __cplusplus
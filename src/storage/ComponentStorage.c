@@ -13,6 +13,7 @@
 #include "storage/ResultsStorage.h"
 #include "storage/ChannelStorage.h"
 #include "storage/ComponentStorage.h"
+#include "storage/ResultFilter.h"
 
 #include "util/compare.h"
 
@@ -24,6 +25,8 @@ extern "C" {
 // Component Storage
 
 static McxStatus ComponentStorageRead(ComponentStorage * compStore, ComponentResultsInput * input) {
+    size_t i = 0;
+
     compStore->storeLevel = input->resultLevel.defined ? input->resultLevel.value : STORE_NONE;
     compStore->hasOwnStoreLevel = input->resultLevel.defined;
 
@@ -43,6 +46,17 @@ static McxStatus ComponentStorageRead(ComponentStorage * compStore, ComponentRes
         return RETURN_ERROR;
     }
 
+    for (i = 0; i < input->filters->Size(input->filters); i++) {
+        InputElement * filterInput = (InputElement *) input->filters->At(input->filters, i);
+        InputElement * filter = filterInput->Clone(filterInput);
+
+        if (!filter || RETURN_OK != compStore->filterInputs->PushBack(compStore->filterInputs, (Object *) filter)) {
+            mcx_log(LOG_ERROR, "Results: Read element storage: Could not read result filters");
+            object_destroy(filter);
+            return RETURN_ERROR;
+        }
+    }
+
     return RETURN_OK;
 }
 
@@ -60,9 +74,31 @@ static McxStatus ComponentStorageRegisterChannel(ComponentStorage * compStore, C
     return RETURN_OK;
 }
 
+// stores a row in the port storage chType, values is NULL for the current values of the ports
+static McxStatus ComponentStorageStoreRow(ComponentStorage * compStore, ChannelStoreType chType, double time, ChannelValue * values) {
+    ChannelStorage * channels = compStore->channels[chType];
+    McxStatus retVal;
+
+    retVal = channels->Store(channels, time, values);
+    if (RETURN_ERROR == retVal) {
+        ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not store ports for time %.17g s", time);
+        return RETURN_ERROR;
+    }
+
+    retVal = compStore->storage->SetStored(compStore->storage, compStore, chType, time);
+    if (RETURN_OK != retVal) {
+        ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not store data for time %.17g s", time);
+        return RETURN_ERROR;
+    }
+    channels->lastStored = time;
+
+    return RETURN_OK;
+}
+
 static McxStatus ComponentStorageStoreChannels(ComponentStorage * compStore, ChannelStoreType chType, double time, StoreLevel level) {
     ChannelStorage *channels = NULL;
-    McxStatus retVal;
+    ResultFilter * filter = NULL;
+    double lastStored = 0.0;
 
     if (compStore->storage) {
         if (!compStore->storage->active) {
@@ -85,6 +121,24 @@ static McxStatus ComponentStorageStoreChannels(ComponentStorage * compStore, Cha
         return RETURN_OK;
     }
 
+    if (compStore->filterInputs->Size(compStore->filterInputs) > 0) {
+        filter = compStore->filters[chType];
+        if (!filter) {
+            filter = (ResultFilter *) object_create(ResultFilter);
+            if (!filter) {
+                ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not create result filter");
+                return RETURN_ERROR;
+            }
+            compStore->filters[chType] = filter;
+            if (RETURN_OK != filter->Setup(filter, compStore, chType, compStore->filterInputs, ComponentStorageStoreRow)) {
+                return RETURN_ERROR;
+            }
+        }
+    }
+
+    // the filter may not store every row that passes
+    lastStored = filter && filter->previous.valid ? filter->previous.time : channels->lastStored;
+
     /* ignore values before start time and after end time */
     if (compStore->startTimeDefined) {
         if (double_lt(time, compStore->startTime)) {
@@ -99,8 +153,8 @@ static McxStatus ComponentStorageStoreChannels(ComponentStorage * compStore, Cha
 
     /* check if at least stepTime between stores (and this is not the first store)*/
     if (compStore->stepTimeDefined) {
-        if (double_geq(channels->lastStored, compStore->startTime)
-            && double_gt(channels->lastStored + compStore->stepTime, time)) {
+        if (double_geq(lastStored, compStore->startTime)
+            && double_gt(lastStored + compStore->stepTime, time)) {
                 return RETURN_OK;
         }
     }
@@ -113,26 +167,17 @@ static McxStatus ComponentStorageStoreChannels(ComponentStorage * compStore, Cha
         }
     }
 
-    if (double_lt(time, channels->lastStored)) {
+    if (double_lt(time, lastStored)) {
         ComponentLog(compStore->comp, LOG_ERROR,
-            "Results: Setting result for previous time (%.17g s < %.17g s), ignoring value", time, channels->lastStored);
+            "Results: Setting result for previous time (%.17g s < %.17g s), ignoring value", time, lastStored);
         return RETURN_ERROR;
     }
 
-    retVal = channels->Store(channels, time);
-    if (RETURN_ERROR == retVal) {
-        ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not store ports for time %.17g s", time);
-        return RETURN_ERROR;
+    if (filter) {
+        return filter->Store(filter, time);
     }
 
-    retVal = compStore->storage->SetStored(compStore->storage, compStore, chType, time);
-    if (RETURN_OK != retVal) {
-        ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not store data for time %.17g s", time);
-        return RETURN_ERROR;
-    }
-    channels->lastStored = time;
-
-    return RETURN_OK;
+    return ComponentStorageStoreRow(compStore, chType, time, NULL);
 }
 
 static void ComponentStorageDisableStorage(ComponentStorage * compStore) {
@@ -201,6 +246,17 @@ static McxStatus ComponentStorageSetup(ComponentStorage * compStore, ResultsStor
 }
 
 static McxStatus ComponentStorageFinished(ComponentStorage * compStore) {
+    size_t i = 0;
+
+    /* store the rows held back by the filters */
+    for (i = 0; i < CHANNEL_STORE_NUM; i++) {
+        ResultFilter * filter = compStore->filters[i];
+        if (filter && RETURN_OK != filter->Finish(filter)) {
+            ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not store the last filtered row");
+            return RETURN_ERROR;
+        }
+    }
+
     /* flush not yet written but complete rows */
     return compStore->storage->SetFinished(compStore->storage, compStore);
 }
@@ -209,9 +265,14 @@ static void ComponentStorageDestructor(ComponentStorage * compStore) {
     size_t i = 0;
 
     for (i = 0; i < CHANNEL_STORE_NUM; i++) {
+        object_destroy(compStore->filters[i]);
         object_destroy(compStore->channels[i]);
     }
 
+    if (compStore->filterInputs) {
+        compStore->filterInputs->DestroyObjects(compStore->filterInputs);
+        object_destroy(compStore->filterInputs);
+    }
 }
 
 static ComponentStorage * ComponentStorageCreate(ComponentStorage * compStore) {
@@ -231,8 +292,16 @@ static ComponentStorage * ComponentStorageCreate(ComponentStorage * compStore) {
         if (!compStore->channels[i]) {
             return NULL;
         }
+        compStore->filters[i] = NULL;
     }
 
+    compStore->filterInputs = (ObjectContainer *) object_create(ObjectContainer);
+    if (!compStore->filterInputs) {
+        return NULL;
+    }
+
+    compStore->idx = (size_t) -1;
+
     compStore->hasOwnStoreLevel = 0;
     compStore->storeLevel = STORE_NONE;
 
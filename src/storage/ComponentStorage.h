@@ -24,6 +24,7 @@ typedef struct ComponentStorage ComponentStorage;
 
 typedef struct ChannelStorage ChannelStorage;
 typedef struct Component Component;
+typedef struct ResultFilter ResultFilter;
 
 typedef enum StoreLevel StoreLevel;
 
@@ -55,6 +56,7 @@ struct ComponentStorage {
     fComponentStorageSetup Setup;
 
     ResultsStorage * storage;
+    size_t idx; /* index in storage->componentStorage, assigned by ResultsStorage::RegisterComponent */
 
     ChannelStorage * channels[CHANNEL_STORE_NUM];
 
@@ -74,6 +76,10 @@ struct ComponentStorage {
 
     double timeOffset;
 
+    /* per port filters, applied to the rows that pass the range and increments */
+    ObjectContainer * filterInputs; /* of ResultFilterInput */
+    ResultFilter * filters[CHANNEL_STORE_NUM]; /* created at the first store if there are filterInputs */
+
     const Component * comp; ///< pointer to the component that should be actually stored, to retrieve e.g. comp-name, channel-infos, ...
 };
 
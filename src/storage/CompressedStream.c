@@ -0,0 +1,417 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_STORAGE)
+
+#include "storage/CompressedStream.h"
+
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// size of the output buffer of deflate
+#define COMPRESSED_OUT_SIZE (64 * 1024)
+
+static int StreamFailed(CompressedStream * stream) {
+#if defined (ENABLE_MT)
+    return mcx_atomic_load(&stream->failed);
+#else
+    return stream->failed;
+#endif // ENABLE_MT
+}
+
+static void StreamSetFailed(CompressedStream * stream) {
+#if defined (ENABLE_MT)
+    mcx_atomic_store(&stream->failed, TRUE);
+#else
+    stream->failed = TRUE;
+#endif // ENABLE_MT
+}
+
+// deflates the data of block into the file of its stream, runs in the compressor thread if there is one
+static void CompressBlock(CompressedBlock * block) {
+    CompressedStream * stream = block->stream;
+    z_stream * zstream = &stream->zstream;
+    int ret = Z_OK;
+
+    if (StreamFailed(stream)) {
+        block->size = 0;
+        return;
+    }
+
+    zstream->next_in = (Bytef *) block->data;
+    zstream->avail_in = (uInt) block->size;
+
+    do {
+        size_t size = 0;
+
+        zstream->next_out = (Bytef *) stream->out;
+        zstream->avail_out = COMPRESSED_OUT_SIZE;
+
+        ret = deflate(zstream, block->flush);
+        if (Z_STREAM_ERROR == ret) {
+            mcx_log(LOG_ERROR, "Results: Could not compress results of file \"%s\"", stream->name);
+            StreamSetFailed(stream);
+            break;
+        }
+
+        size = COMPRESSED_OUT_SIZE - zstream->avail_out;
+        if (size > 0 && 1 != fwrite(stream->out, size, 1, stream->fp)) {
+            if (ENOSPC == errno) {
+                mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\": No space left on device", stream->name);
+            } else {
+                mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\"", stream->name);
+            }
+            StreamSetFailed(stream);
+            break;
+        }
+        // deflate fills the whole output buffer as long as there is pending output
+    } while (0 == zstream->avail_out || (Z_FINISH == block->flush && Z_STREAM_END != ret));
+
+    block->size = 0;
+}
+
+// ----------------------------------------------------------------------
+// Storage Compressor
+
+#if defined (ENABLE_MT)
+static CompressedBlock * CompressorPop(StorageCompressor * compressor) {
+    CompressedBlock * block = NULL;
+
+    mcx_mutex_lock(&compressor->queueLock);
+    block = compressor->first;
+    if (block) {
+        compressor->first = block->next;
+        if (!compressor->first) {
+            compressor->last = NULL;
+        }
+        block->next = NULL;
+    }
+    mcx_mutex_unlock(&compressor->queueLock);
+
+    return block;
+}
+
+static void CompressorPush(StorageCompressor * compressor, CompressedBlock * block) {
+    mcx_atomic_store(&block->busy, TRUE);
+
+    mcx_mutex_lock(&compressor->queueLock);
+    block->next = NULL;
+    if (compressor->last) {
+        compressor->last->next = block;
+    } else {
+        compressor->first = block;
+    }
+    compressor->last = block;
+    mcx_mutex_unlock(&compressor->queueLock);
+
+    mcx_atomic_fetch_add(&compressor->signal, 1);
+    mcx_atomic_wake_all(&compressor->signal);
+}
+
+static McxThreadReturn CompressorThread(void * param) {
+    StorageCompressor * compressor = (StorageCompressor *) param;
+
+    while (1) {
+        int32_t signal = mcx_atomic_load(&compressor->signal);
+        int stop = mcx_atomic_load(&compressor->stop);
+        CompressedBlock * block = CompressorPop(compressor);
+
+        if (block) {
+            CompressBlock(block);
+            mcx_atomic_store(&block->busy, FALSE);
+            mcx_atomic_wake_all(&block->busy);
+            continue;
+        }
+
+        // blocks queued before the stop request have been compressed
+        if (stop) {
+            break;
+        }
+        mcx_atomic_wait(&compressor->signal, signal);
+    }
+
+    return 0;
+}
+
+static McxStatus CompressorStart(StorageCompressor * compressor) {
+    if (compressor->running) {
+        return RETURN_OK;
+    }
+
+    mcx_atomic_store(&compressor->stop, FALSE);
+    if (mcx_thread_create(&compressor->thread, (McxThreadStartRoutine) CompressorThread, compressor)) {
+        mcx_log(LOG_ERROR, "Results: Could not create result compressor thread");
+        return RETURN_ERROR;
+    }
+    compressor->running = TRUE;
+
+    return RETURN_OK;
+}
+
+static McxStatus CompressorStop(StorageCompressor * compressor) {
+    long ret = 0;
+
+    if (!compressor->running) {
+        return RETURN_OK;
+    }
+
+    mcx_atomic_store(&compressor->stop, TRUE);
+    mcx_atomic_fetch_add(&compressor->signal, 1);
+    mcx_atomic_wake_all(&compressor->signal);
+    mcx_thread_join(compressor->thread, &ret);
+    compressor->running = FALSE;
+
+    return RETURN_OK;
+}
+
+static void StorageCompressorDestructor(StorageCompressor * compressor) {
+    CompressorStop(compressor);
+    mcx_mutex_destroy(&compressor->queueLock);
+}
+
+static StorageCompressor * StorageCompressorCreate(StorageCompressor * compressor) {
+    compressor->Start = CompressorStart;
+    compressor->Stop = CompressorStop;
+
+    compressor->running = FALSE;
+    mcx_mutex_create(&compressor->queueLock);
+    compressor->first = NULL;
+    compressor->last = NULL;
+
+    mcx_atomic_store(&compressor->signal, 0);
+    mcx_atomic_store(&compressor->stop, FALSE);
+
+    return compressor;
+}
+
+OBJECT_CLASS(StorageCompressor, Object);
+
+static void WaitForBlock(CompressedBlock * block) {
+    while (mcx_atomic_load(&block->busy)) {
+        mcx_atomic_wait(&block->busy, TRUE);
+    }
+}
+#endif // ENABLE_MT
+
+// ----------------------------------------------------------------------
+// Compressed Stream
+
+// hands the current block over to the compressor and continues with the other block
+static McxStatus StreamSubmit(CompressedStream * stream, int flush) {
+    CompressedBlock * block = &stream->blocks[stream->current];
+
+    block->flush = flush;
+
+#if defined (ENABLE_MT)
+    if (stream->compressor && stream->compressor->running) {
+        CompressorPush(stream->compressor, block);
+
+        stream->current = 1 - stream->current;
+        // back pressure: wait until the compressor is done with the block that is filled next
+        WaitForBlock(&stream->blocks[stream->current]);
+    } else {
+        CompressBlock(block);
+    }
+#else
+    CompressBlock(block);
+#endif // ENABLE_MT
+
+    return StreamFailed(stream) ? RETURN_ERROR : RETURN_OK;
+}
+
+static void StreamWaitIdle(CompressedStream * stream) {
+#if defined (ENABLE_MT)
+    WaitForBlock(&stream->blocks[0]);
+    WaitForBlock(&stream->blocks[1]);
+#endif // ENABLE_MT
+}
+
+static McxStatus StreamOpen(CompressedStream * stream, FILE * fp, const char * name, CompressionType type, StorageCompressor * compressor) {
+    size_t i = 0;
+    int ret = Z_OK;
+
+    if (stream->zstreamInitialized) {
+        mcx_log(LOG_ERROR, "Results: Compressed stream of \"%s\" is already open", stream->name);
+        return RETURN_ERROR;
+    }
+
+    if (COMPRESSION_GZIP != type) {
+        mcx_log(LOG_ERROR, "Results: Unsupported compression of result file \"%s\"", name);
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < 2; i++) {
+        stream->blocks[i].data = (char *) mcx_malloc(COMPRESSED_BLOCK_SIZE);
+        if (!stream->blocks[i].data) {
+            mcx_log(LOG_ERROR, "Results: Memory allocation for compression of \"%s\" failed", name);
+            return RETURN_ERROR;
+        }
+        stream->blocks[i].size = 0;
+        stream->blocks[i].stream = stream;
+    }
+    stream->out = (char *) mcx_malloc(COMPRESSED_OUT_SIZE);
+    if (!stream->out) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for compression of \"%s\" failed", name);
+        return RETURN_ERROR;
+    }
+
+    stream->zstream.zalloc = Z_NULL;
+    stream->zstream.zfree = Z_NULL;
+    stream->zstream.opaque = Z_NULL;
+
+    // 16 added to the window bits selects the gzip format
+    ret = deflateInit2(&stream->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    if (Z_OK != ret) {
+        mcx_log(LOG_ERROR, "Results: Could not initialize compression of \"%s\"", name);
+        return RETURN_ERROR;
+    }
+    stream->zstreamInitialized = TRUE;
+
+    stream->fp = fp;
+    stream->name = name;
+    stream->type = type;
+    stream->current = 0;
+    stream->compressor = compressor;
+
+    return RETURN_OK;
+}
+
+static McxStatus StreamWrite(CompressedStream * stream, const void * data, size_t size) {
+    const char * bytes = (const char *) data;
+
+    if (!stream->zstreamInitialized) {
+        mcx_log(LOG_ERROR, "Results: Compressed stream is not open");
+        return RETURN_ERROR;
+    }
+
+    while (size > 0) {
+        CompressedBlock * block = &stream->blocks[stream->current];
+        size_t len = COMPRESSED_BLOCK_SIZE - block->size;
+
+        if (len > size) {
+            len = size;
+        }
+        memcpy(block->data + block->size, bytes, len);
+        block->size += len;
+        bytes += len;
+        size -= len;
+
+        if (COMPRESSED_BLOCK_SIZE == block->size) {
+            if (RETURN_OK != StreamSubmit(stream, Z_NO_FLUSH)) {
+                return RETURN_ERROR;
+            }
+        }
+    }
+
+    return StreamFailed(stream) ? RETURN_ERROR : RETURN_OK;
+}
+
+static McxStatus StreamFlush(CompressedStream * stream) {
+    McxStatus retVal = RETURN_OK;
+
+    if (!stream->zstreamInitialized) {
+        return RETURN_OK;
+    }
+
+    retVal = StreamSubmit(stream, Z_SYNC_FLUSH);
+    StreamWaitIdle(stream);
+
+    if (RETURN_OK != retVal || StreamFailed(stream)) {
+        return RETURN_ERROR;
+    }
+
+    if (fflush(stream->fp)) {
+        mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\"", stream->name);
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus StreamClose(CompressedStream * stream) {
+    if (!stream->zstreamInitialized) {
+        return RETURN_OK;
+    }
+
+    StreamSubmit(stream, Z_FINISH);
+    StreamWaitIdle(stream);
+
+    deflateEnd(&stream->zstream);
+    stream->zstreamInitialized = FALSE;
+
+    return StreamFailed(stream) ? RETURN_ERROR : RETURN_OK;
+}
+
+static void CompressedStreamDestructor(CompressedStream * stream) {
+    size_t i = 0;
+
+    StreamWaitIdle(stream);
+
+    if (stream->zstreamInitialized) {
+        deflateEnd(&stream->zstream);
+    }
+    for (i = 0; i < 2; i++) {
+        if (stream->blocks[i].data) {
+            mcx_free(stream->blocks[i].data);
+        }
+    }
+    if (stream->out) {
+        mcx_free(stream->out);
+    }
+}
+
+static CompressedStream * CompressedStreamCreate(CompressedStream * stream) {
+    size_t i = 0;
+
+    stream->Open = StreamOpen;
+    stream->Write = StreamWrite;
+    stream->Flush = StreamFlush;
+    stream->Close = StreamClose;
+
+    stream->fp = NULL;
+    stream->name = NULL;
+    stream->type = COMPRESSION_NONE;
+    stream->zstreamInitialized = FALSE;
+
+    for (i = 0; i < 2; i++) {
+        stream->blocks[i].data = NULL;
+        stream->blocks[i].size = 0;
+        stream->blocks[i].flush = Z_NO_FLUSH;
+        stream->blocks[i].stream = stream;
+#if defined (ENABLE_MT)
+        mcx_atomic_store(&stream->blocks[i].busy, FALSE);
+        stream->blocks[i].next = NULL;
+#endif // ENABLE_MT
+    }
+    stream->current = 0;
+    stream->out = NULL;
+    stream->compressor = NULL;
+
+#if defined (ENABLE_MT)
+    mcx_atomic_store(&stream->failed, FALSE);
+#else
+    stream->failed = FALSE;
+#endif // ENABLE_MT
+
+    return stream;
+}
+
+OBJECT_CLASS(CompressedStream, Object);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //ENABLE_STORAGE
@@ -0,0 +1,126 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_STORAGE_COMPRESSED_STREAM_H
+#define MCX_STORAGE_COMPRESSED_STREAM_H
+
+#include "CentralParts.h"
+#include "storage/Backends.h"
+
+#include <stdio.h>
+
+#if defined (ENABLE_MT)
+#include "util/atomic.h"
+#include "util/mutex.h"
+#include "util/threads.h"
+#endif // ENABLE_MT
+
+#include <zlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A CompressedStream compresses everything written to it into an already
+ * opened result file. The data is collected in blocks; full blocks are
+ * deflated by the StorageCompressor thread while the next block is filled,
+ * so that compression does not slow down the thread that stores the results.
+ * Without compressor the blocks are deflated synchronously.
+ */
+
+// size of the blocks of uncompressed data
+#define COMPRESSED_BLOCK_SIZE (256 * 1024)
+
+typedef struct StorageCompressor StorageCompressor;
+typedef struct CompressedStream CompressedStream;
+
+typedef struct CompressedBlock {
+    char * data;
+    size_t size;  // bytes used in data
+    int flush;    // flush mode of deflate after data, Z_NO_FLUSH, Z_SYNC_FLUSH or Z_FINISH
+
+    CompressedStream * stream;
+
+#if defined (ENABLE_MT)
+    McxAtomic busy; // TRUE while the block is queued at or compressed by the compressor
+    struct CompressedBlock * next; // next block in the queue of the compressor
+#endif // ENABLE_MT
+} CompressedBlock;
+
+typedef McxStatus (* fCompressedStreamOpen)(CompressedStream * stream, FILE * fp, const char * name, CompressionType type, StorageCompressor * compressor);
+typedef McxStatus (* fCompressedStreamWrite)(CompressedStream * stream, const void * data, size_t size);
+typedef McxStatus (* fCompressedStreamFlush)(CompressedStream * stream);
+typedef McxStatus (* fCompressedStreamClose)(CompressedStream * stream);
+
+extern const struct ObjectClass _CompressedStream;
+
+struct CompressedStream {
+    Object _; // super class first
+
+    /* the stream writes to fp but does not close it, name is used for messages */
+    fCompressedStreamOpen Open;
+    fCompressedStreamWrite Write;
+    /* compresses all written data and flushes fp */
+    fCompressedStreamFlush Flush;
+    /* finishes the compressed stream, fp has to be closed by the caller afterwards */
+    fCompressedStreamClose Close;
+
+    FILE * fp;
+    const char * name;
+
+    CompressionType type;
+    z_stream zstream;
+    int zstreamInitialized;
+
+    CompressedBlock blocks[2];
+    size_t current; // block that is filled by Write
+    char * out;     // output buffer of deflate
+
+    StorageCompressor * compressor;
+
+#if defined (ENABLE_MT)
+    McxAtomic failed;
+#else
+    int failed;
+#endif // ENABLE_MT
+};
+
+#if defined (ENABLE_MT)
+typedef McxStatus (* fStorageCompressorStart)(StorageCompressor * compressor);
+typedef McxStatus (* fStorageCompressorStop)(StorageCompressor * compressor);
+
+extern const struct ObjectClass _StorageCompressor;
+
+/* background thread that compresses the blocks of all streams of a results storage in FIFO order */
+struct StorageCompressor {
+    Object _; // super class first
+
+    fStorageCompressorStart Start;
+    /* waits until all queued blocks are compressed */
+    fStorageCompressorStop Stop;
+
+    McxThread thread;
+    int running;
+
+    McxMutex queueLock;
+    CompressedBlock * first;
+    CompressedBlock * last;
+
+    McxAtomic signal; // incremented when blocks are queued
+    McxAtomic stop;
+};
+#endif // ENABLE_MT
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_STORAGE_COMPRESSED_STREAM_H */
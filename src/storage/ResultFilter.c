@@ -0,0 +1,449 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+#include "core/channels/Channel.h"
+#include "core/channels/ChannelInfo.h"
+#include "storage/ChannelStorage.h"
+#include "storage/ComponentStorage.h"
+#include "storage/ResultFilter.h"
+
+#include "reader/model/components/ResultFilterInput.h"
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+static int ResultFilterIsNumeric(ChannelType type) {
+    return CHANNEL_DOUBLE == type || CHANNEL_INTEGER == type || CHANNEL_BOOL == type;
+}
+
+// numeric value of a value reference, returns FALSE if there is none
+static int ResultFilterGetNumber(ChannelType type, const void * reference, double * value) {
+    if (!reference) {
+        return FALSE;
+    }
+
+    switch (type) {
+    case CHANNEL_DOUBLE:
+        * value = * (const double *) reference;
+        return TRUE;
+    case CHANNEL_INTEGER:
+    case CHANNEL_BOOL:
+        * value = (double) * (const int *) reference;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+// value reference of port i of row, or of the current value if row is NULL
+static const void * ResultFilterReference(ResultFilter * filter, ResultFilterRow * row, size_t i) {
+    ObjectContainer * channels = filter->chStore->channels;
+    Channel * channel = NULL;
+
+    if (row) {
+        return ChannelValueReference(&row->values[i]);
+    }
+
+    channel = (Channel *) channels->At(channels, i);
+    return channel->GetValueReference(channel);
+}
+
+static McxStatus ResultFilterSetupRow(ResultFilter * filter, ResultFilterRow * row) {
+    size_t i = 0;
+
+    row->values = (ChannelValue *) mcx_calloc(filter->numPorts, sizeof(ChannelValue));
+    if (!row->values) {
+        return RETURN_ERROR;
+    }
+    for (i = 0; i < filter->numPorts; i++) {
+        ChannelInfo * info = filter->chStore->GetChannelInfo(filter->chStore, i);
+        ChannelValueInit(&row->values[i], info->GetType(info));
+    }
+    row->valid = FALSE;
+
+    return RETURN_OK;
+}
+
+static void ResultFilterDestroyRow(ResultFilter * filter, ResultFilterRow * row) {
+    size_t i = 0;
+
+    if (!row->values) {
+        return;
+    }
+    for (i = 0; i < filter->numPorts; i++) {
+        ChannelValueDestructor(&row->values[i]);
+    }
+    mcx_free(row->values);
+    row->values = NULL;
+}
+
+// copies the current values of the ports into row
+static void ResultFilterCopyRow(ResultFilter * filter, ResultFilterRow * row, double time) {
+    size_t i = 0;
+
+    for (i = 1; i < filter->numPorts; i++) {
+        ChannelValueSetFromReference(&row->values[i], ResultFilterReference(filter, NULL, i));
+    }
+    row->time = time;
+    row->valid = TRUE;
+}
+
+// stores the min max rows before time in time order
+static McxStatus ResultFilterStorePending(ResultFilter * filter, double time) {
+    size_t numPending = 0;
+    size_t i = 0, j = 0;
+    double lastTime = 0.0;
+
+    for (i = 1; i < filter->numPorts; i++) {
+        ResultFilterPort * port = &filter->ports[i];
+
+        if (RESULT_FILTER_MIN_MAX != port->type) {
+            continue;
+        }
+        if (port->min.valid && port->min.time < time) {
+            filter->pending[numPending++] = &port->min;
+        }
+        if (port->max.valid && port->max.time < time) {
+            filter->pending[numPending++] = &port->max;
+        }
+    }
+
+    // insertion sort, there are only a few rows
+    for (i = 1; i < numPending; i++) {
+        ResultFilterRow * row = filter->pending[i];
+        for (j = i; j > 0 && filter->pending[j - 1]->time > row->time; j--) {
+            filter->pending[j] = filter->pending[j - 1];
+        }
+        filter->pending[j] = row;
+    }
+
+    for (i = 0; i < numPending; i++) {
+        ResultFilterRow * row = filter->pending[i];
+
+        // the extremes of several ports may be in the same row
+        if (i > 0 && row->time == lastTime) {
+            continue;
+        }
+        if (RETURN_OK != filter->emit(filter->compStore, filter->chType, row->time, row->values)) {
+            return RETURN_ERROR;
+        }
+        lastTime = row->time;
+    }
+
+    return RETURN_OK;
+}
+
+// stores row (the current values if NULL) and restarts all filters at it
+static McxStatus ResultFilterStoreRow(ResultFilter * filter, double time, ResultFilterRow * row) {
+    size_t i = 0;
+
+    if (RETURN_OK != ResultFilterStorePending(filter, time)) {
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != filter->emit(filter->compStore, filter->chType, time, row ? row->values : NULL)) {
+        return RETURN_ERROR;
+    }
+
+    for (i = 1; i < filter->numPorts; i++) {
+        ResultFilterPort * port = &filter->ports[i];
+        double value = 0.0;
+
+        if (ResultFilterGetNumber(port->channelType, ResultFilterReference(filter, row, i), &value)) {
+            port->stored = value;
+            port->storedTime = time;
+        }
+        port->upper = HUGE_VAL;
+        port->lower = -HUGE_VAL;
+
+        port->count = 0;
+        port->min.valid = FALSE;
+        port->max.valid = FALSE;
+    }
+
+    return RETURN_OK;
+}
+
+// narrows the door of port by value at time, returns FALSE if the value does not fit through the door
+static int ResultFilterDoorFits(ResultFilterPort * port, double time, double value, int narrow) {
+    double dt = time - port->storedTime;
+    double upper = 0.0, lower = 0.0;
+
+    if (dt <= 0.0) {
+        return fabs(value - port->stored) <= port->threshold;
+    }
+
+    upper = (value + port->threshold - port->stored) / dt;
+    lower = (value - port->threshold - port->stored) / dt;
+    if (upper > port->upper) {
+        upper = port->upper;
+    }
+    if (lower < port->lower) {
+        lower = port->lower;
+    }
+    if (!(lower <= upper)) {
+        return FALSE;
+    }
+
+    if (narrow) {
+        port->upper = upper;
+        port->lower = lower;
+    }
+
+    return TRUE;
+}
+
+/*
+ * A row is stored as soon as one port needs it, ports without filter need
+ * every row. Non-numeric ports covered by a filter for all ports cannot be
+ * filtered and need no row. Every stored row restarts all filters, so the
+ * deadband and the swinging door always refer to the last stored row and a
+ * minMax window starts after it.
+ */
+static McxStatus ResultFilterStore(ResultFilter * filter, double time) {
+    int storeCurrent = !filter->previous.valid; // the first row is always stored
+    int storePrevious = FALSE;
+    size_t i = 0;
+
+    for (i = 1; i < filter->numPorts && !storeCurrent; i++) {
+        ResultFilterPort * port = &filter->ports[i];
+        double value = 0.0;
+
+        if (port->followsRows) {
+            continue;
+        }
+        if (RESULT_FILTER_NONE == port->type) {
+            storeCurrent = TRUE;
+            break;
+        }
+        if (!ResultFilterGetNumber(port->channelType, ResultFilterReference(filter, NULL, i), &value)) {
+            continue;
+        }
+
+        switch (port->type) {
+        case RESULT_FILTER_DEADBAND:
+            // also stores changes from and to NaN
+            if (!(fabs(value - port->stored) <= port->threshold)) {
+                storeCurrent = TRUE;
+            }
+            break;
+        case RESULT_FILTER_SWINGING_DOOR:
+            if (!ResultFilterDoorFits(port, time, value, FALSE)) {
+                // the line to the previous row is within the threshold of all rows in between
+                if (filter->previousStored) {
+                    storeCurrent = TRUE;
+                } else {
+                    storePrevious = TRUE;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (storePrevious) {
+        if (RETURN_OK != ResultFilterStoreRow(filter, filter->previous.time, &filter->previous)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    for (i = 1; i < filter->numPorts && !storeCurrent; i++) {
+        ResultFilterPort * port = &filter->ports[i];
+        double value = 0.0;
+
+        if (!ResultFilterGetNumber(port->channelType, ResultFilterReference(filter, NULL, i), &value)) {
+            continue;
+        }
+
+        switch (port->type) {
+        case RESULT_FILTER_DEADBAND:
+            // storing the previous row moved the deadband
+            if (!(fabs(value - port->stored) <= port->threshold)) {
+                storeCurrent = TRUE;
+            }
+            break;
+        case RESULT_FILTER_SWINGING_DOOR:
+            if (!ResultFilterDoorFits(port, time, value, TRUE)) {
+                storeCurrent = TRUE;
+            }
+            break;
+        case RESULT_FILTER_MIN_MAX:
+            if (!port->min.valid || value < port->minValue) {
+                ResultFilterCopyRow(filter, &port->min, time);
+                port->minValue = value;
+            }
+            if (!port->max.valid || value > port->maxValue) {
+                ResultFilterCopyRow(filter, &port->max, time);
+                port->maxValue = value;
+            }
+            port->count++;
+            // the last row of the window
+            if (port->count >= port->window) {
+                storeCurrent = TRUE;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (storeCurrent) {
+        if (RETURN_OK != ResultFilterStoreRow(filter, time, NULL)) {
+            return RETURN_ERROR;
+        }
+    } else {
+        ResultFilterCopyRow(filter, &filter->previous, time);
+    }
+    filter->previous.time = time;
+    filter->previous.valid = TRUE;
+    filter->previousStored = storeCurrent;
+
+    return RETURN_OK;
+}
+
+static McxStatus ResultFilterFinish(ResultFilter * filter) {
+    if (filter->previous.valid && !filter->previousStored) {
+        if (RETURN_OK != ResultFilterStoreRow(filter, filter->previous.time, &filter->previous)) {
+            return RETURN_ERROR;
+        }
+        filter->previousStored = TRUE;
+    }
+
+    return RETURN_OK;
+}
+
+// the filter of port name, a filter for the port wins over one for all ports
+static ResultFilterInput * ResultFilterGetInput(ObjectContainer * filterInputs, const char * name) {
+    ResultFilterInput * result = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < filterInputs->Size(filterInputs); i++) {
+        ResultFilterInput * input = (ResultFilterInput *) filterInputs->At(filterInputs, i);
+
+        if (input->port && !strcmp(input->port, name)) {
+            return input;
+        }
+        if (!input->port && !result) {
+            result = input;
+        }
+    }
+
+    return result;
+}
+
+static McxStatus ResultFilterSetup(ResultFilter * filter, ComponentStorage * compStore, ChannelStoreType chType, ObjectContainer * filterInputs, fResultFilterEmit emit) {
+    ChannelStorage * chStore = compStore->channels[chType];
+    size_t i = 0;
+
+    filter->compStore = compStore;
+    filter->chType = chType;
+    filter->chStore = chStore;
+    filter->emit = emit;
+
+    filter->numPorts = chStore->GetChannelNum(chStore);
+    filter->ports = (ResultFilterPort *) mcx_calloc(filter->numPorts, sizeof(ResultFilterPort));
+    filter->pending = (ResultFilterRow **) mcx_calloc(2 * filter->numPorts, sizeof(ResultFilterRow *));
+    if (!filter->ports || !filter->pending) {
+        ComponentLog(compStore->comp, LOG_ERROR, "Results: Setup result filter: Memory allocation failed");
+        return RETURN_ERROR;
+    }
+
+    for (i = 1; i < filter->numPorts; i++) {
+        ResultFilterPort * port = &filter->ports[i];
+        ChannelInfo * info = chStore->GetChannelInfo(chStore, i);
+        ResultFilterInput * input = ResultFilterGetInput(filterInputs, info->GetName(info));
+
+        port->channelType = info->GetType(info);
+        port->type = RESULT_FILTER_NONE;
+        port->followsRows = FALSE;
+        port->upper = HUGE_VAL;
+        port->lower = -HUGE_VAL;
+
+        if (!input) {
+            continue;
+        }
+        if (!ResultFilterIsNumeric(port->channelType)) {
+            if (input->port) {
+                ComponentLog(compStore->comp, LOG_ERROR, "Results: Setup result filter: Port %s is not numeric", info->GetName(info));
+                return RETURN_ERROR;
+            }
+            // would otherwise need every row and defeat the filter for all ports
+            port->followsRows = TRUE;
+            continue;
+        }
+
+        port->type = input->type;
+        port->threshold = input->threshold.defined ? input->threshold.value : 0.0;
+        port->window = input->window.defined ? input->window.value : 1;
+
+        if (RESULT_FILTER_MIN_MAX == port->type) {
+            if (RETURN_OK != ResultFilterSetupRow(filter, &port->min) || RETURN_OK != ResultFilterSetupRow(filter, &port->max)) {
+                ComponentLog(compStore->comp, LOG_ERROR, "Results: Setup result filter: Memory allocation failed");
+                return RETURN_ERROR;
+            }
+        }
+    }
+
+    if (RETURN_OK != ResultFilterSetupRow(filter, &filter->previous)) {
+        ComponentLog(compStore->comp, LOG_ERROR, "Results: Setup result filter: Memory allocation failed");
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+static void ResultFilterDestructor(ResultFilter * filter) {
+    size_t i = 0;
+
+    if (filter->ports) {
+        for (i = 0; i < filter->numPorts; i++) {
+            ResultFilterDestroyRow(filter, &filter->ports[i].min);
+            ResultFilterDestroyRow(filter, &filter->ports[i].max);
+        }
+        mcx_free(filter->ports);
+    }
+    ResultFilterDestroyRow(filter, &filter->previous);
+    if (filter->pending) {
+        mcx_free(filter->pending);
+    }
+}
+
+static ResultFilter * ResultFilterCreate(ResultFilter * filter) {
+    filter->Setup = ResultFilterSetup;
+    filter->Store = ResultFilterStore;
+    filter->Finish = ResultFilterFinish;
+
+    filter->compStore = NULL;
+    filter->chType = CHANNEL_STORE_OUT;
+    filter->chStore = NULL;
+    filter->emit = NULL;
+
+    filter->numPorts = 0;
+    filter->ports = NULL;
+
+    filter->previous.time = 0.0;
+    filter->previous.values = NULL;
+    filter->previous.valid = FALSE;
+    filter->previousStored = FALSE;
+
+    filter->pending = NULL;
+
+    return filter;
+}
+
+OBJECT_CLASS(ResultFilter, Object);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
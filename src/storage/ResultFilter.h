@@ -0,0 +1,98 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_STORAGE_RESULT_FILTER_H
+#define MCX_STORAGE_RESULT_FILTER_H
+
+#include "CentralParts.h"
+#include "core/channels/ChannelValue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct ChannelStorage ChannelStorage;
+typedef struct ComponentStorage ComponentStorage;
+typedef struct ResultFilter ResultFilter;
+
+/* stores a row in the port storage chType of compStore, values is NULL for the current values of the ports */
+typedef McxStatus (* fResultFilterEmit)(ComponentStorage * compStore, ChannelStoreType chType, double time, ChannelValue * values);
+
+typedef McxStatus (* fResultFilterSetup)(ResultFilter * filter, ComponentStorage * compStore, ChannelStoreType chType, ObjectContainer * filterInputs, fResultFilterEmit emit);
+typedef McxStatus (* fResultFilterStore)(ResultFilter * filter, double time);
+typedef McxStatus (* fResultFilterFinish)(ResultFilter * filter);
+
+/* copy of a row of a port storage */
+typedef struct ResultFilterRow {
+    double time;
+    ChannelValue * values;
+    int valid;
+} ResultFilterRow;
+
+typedef struct ResultFilterPort {
+    ResultFilterType type;
+    ChannelType channelType;
+    int followsRows; // non-numeric port of a filter for all ports, stored with the rows the other ports need
+    double threshold;
+    size_t window;
+
+    // value of the last stored row
+    double stored;
+    double storedTime;
+
+    // swinging door: slopes of the door that starts at the last stored value
+    double upper;
+    double lower;
+
+    // min max: rows with the extreme values since the last stored row
+    size_t count;
+    ResultFilterRow min;
+    ResultFilterRow max;
+    double minValue;
+    double maxValue;
+} ResultFilterPort;
+
+extern const struct ObjectClass _ResultFilter;
+
+/**
+ * Decides which rows of a port storage are stored. Rows may be stored
+ * delayed: the swinging door stores the row before the one that does not
+ * fit through the door and minMax stores the rows with the extreme values
+ * when its window is complete. Rows are always emitted in time order.
+ */
+struct ResultFilter {
+    Object _; // super class first
+
+    /* matches the filter inputs (of ResultFilterInput) with the ports of the port storage */
+    fResultFilterSetup Setup;
+    /* called for every row that passed the time based thinning of the element */
+    fResultFilterStore Store;
+    /* stores the last row if it was not stored yet */
+    fResultFilterFinish Finish;
+
+    ComponentStorage * compStore;
+    ChannelStoreType chType;
+    ChannelStorage * chStore;
+    fResultFilterEmit emit;
+
+    size_t numPorts; // including the time column
+    ResultFilterPort * ports;
+
+    ResultFilterRow previous; // row of the last call of Store
+    int previousStored;
+
+    ResultFilterRow ** pending; // min max rows that are sorted before they are stored
+};
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_STORAGE_RESULT_FILTER_H */
@@ -15,11 +15,17 @@
 #include "storage/ComponentStorage.h"
 #include "core/Databus.h"
 #include "core/SubModel.h"
+#include "util/os.h"
+#include "util/paths.h"
 #include "util/string.h"
+#include "util/time.h"
 
 #include "reader/task/BackendInput.h"
 
 #include "storage/StorageBackendCsv.h"
+#include "storage/StorageBackendBinary.h"
+#include "storage/StorageBackendStream.h"
+#include "storage/CompressedStream.h"
 #include "util/compare.h"
 
 #ifdef __cplusplus
@@ -39,13 +45,21 @@ static StorageBackend * StorageBackendCreate(StorageBackend * backend) {
     backend->Setup = NULL;
     backend->Store = NULL;
     backend->Finished = NULL;
+    backend->Synchronized = NULL;
 
     backend->id = 0;
     backend->needsFullStorage = 0;
+    backend->immediate = FALSE;
     backend->storage = NULL;
 
     backend->active = TRUE;
 
+    backend->compression = COMPRESSION_NONE;
+    backend->compressor = NULL;
+
+    backend->mapped = FALSE;
+    backend->syncInterval = 1.0;
+
     return backend;
 }
 
@@ -54,7 +68,14 @@ OBJECT_CLASS(StorageBackend, Object);
 // ----------------------------------------------------------------------
 // Storage Backend
 
-static McxStatus StorageStoreBackends(ResultsStorage * storage, ChannelStoreType chType, size_t i, size_t start, size_t end) {
+// backends a store goes to
+typedef enum StorageBackendSelection {
+    STORE_ALL_BACKENDS,
+    STORE_IMMEDIATE_BACKENDS, // backends with immediate set
+    STORE_DEFERRED_BACKENDS,  // backends without immediate
+} StorageBackendSelection;
+
+static McxStatus StorageStoreSelectedBackends(ResultsStorage * storage, StorageBackendSelection selection, ChannelStoreType chType, size_t i, size_t start, size_t end) {
     McxStatus retVal = RETURN_OK;
     McxStatus tmp;
     size_t j = 0;
@@ -63,6 +84,10 @@ static McxStatus StorageStoreBackends(ResultsStorage * storage, ChannelStoreType
         for (k = start; k <= end; k++) {
             StorageBackend * backend = storage->backends[j];
             if (backend) {
+                if ((STORE_IMMEDIATE_BACKENDS == selection && !backend->immediate)
+                    || (STORE_DEFERRED_BACKENDS == selection && backend->immediate)) {
+                    continue;
+                }
                 if (storage->channelStoreEnabled[chType]
                     && backend->active) {
                     tmp = backend->Store(backend, chType, i, k);
@@ -77,10 +102,362 @@ static McxStatus StorageStoreBackends(ResultsStorage * storage, ChannelStoreType
     return retVal;
 }
 
+static McxStatus StorageStoreBackends(ResultsStorage * storage, ChannelStoreType chType, size_t i, size_t start, size_t end) {
+    return StorageStoreSelectedBackends(storage, STORE_ALL_BACKENDS, chType, i, start, end);
+}
+
+// stores the last row of a port storage to the immediate backends
+static McxStatus StorageStoreImmediateBackends(ResultsStorage * storage, ComponentStorage * compStore, ChannelStoreType chType, size_t row) {
+    if (RETURN_OK != StorageStoreSelectedBackends(storage, STORE_IMMEDIATE_BACKENDS, chType, compStore->idx, row, row)) {
+        ComponentLog(compStore->comp, LOG_ERROR, "Storing backends failed");
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+// ----------------------------------------------------------------------
+// Result Writer
+
+#if defined (ENABLE_MT)
+// writes all published rows of the ring buffers, returns the number of written rows
+static size_t StorageWriteRings(ResultsStorage * storage) {
+    size_t numWritten = 0;
+    size_t i = 0, chType = 0;
+
+    for (i = 0; i < storage->numComponents; i++) {
+        ComponentStorage * compStore = storage->componentStorage[i];
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            ChannelStorage * chStore = compStore->channels[chType];
+            uint32_t head = 0, tail = 0;
+
+            if (0 == chStore->ringSize) {
+                continue;
+            }
+
+            head = (uint32_t) mcx_atomic_load(&chStore->ringHead);
+            tail = (uint32_t) mcx_atomic_load(&chStore->ringTail);
+            while (tail != head) {
+                size_t row = tail & (chStore->ringSize - 1);
+
+                // the immediate backends got the row in StorageSetStoredAsync
+                if (RETURN_OK != StorageStoreSelectedBackends(storage, STORE_DEFERRED_BACKENDS, (ChannelStoreType) chType, i, row, row)) {
+                    mcx_atomic_store(&storage->writerFailed, TRUE);
+                }
+
+                tail++;
+                mcx_atomic_store(&chStore->ringTail, (int32_t) tail);
+                if (mcx_atomic_load(&chStore->ringWaiting)) {
+                    mcx_atomic_wake_all(&chStore->ringTail);
+                }
+                numWritten++;
+            }
+        }
+    }
+
+    return numWritten;
+}
+
+static McxThreadReturn StorageWriterThread(void * param) {
+    ResultsStorage * storage = (ResultsStorage *) param;
+
+    while (1) {
+        int32_t signal = mcx_atomic_load(&storage->writerSignal);
+        int stop = mcx_atomic_load(&storage->writerStop);
+
+        if (0 == StorageWriteRings(storage)) {
+            // rows published before the stop request have been written
+            if (stop) {
+                break;
+            }
+
+            mcx_atomic_store(&storage->writerSleeping, TRUE);
+            if (mcx_atomic_load(&storage->writerSignal) == signal) {
+                mcx_atomic_wait(&storage->writerSignal, signal);
+            }
+            mcx_atomic_store(&storage->writerSleeping, FALSE);
+        }
+    }
+
+    return 0;
+}
+
+static McxStatus StorageSetStoredAsync(ResultsStorage * storage, ComponentStorage * compStore, ChannelStoreType chType, double endTime) {
+    ChannelStorage * chStore = compStore->channels[chType];
+
+    if (mcx_atomic_load(&storage->writerFailed)) {
+        ComponentLog(compStore->comp, LOG_ERROR, "Storing backends failed");
+        return RETURN_ERROR;
+    }
+
+    if (chStore->ringRowPending) {
+        size_t row = (uint32_t) mcx_atomic_load(&chStore->ringHead) & (chStore->ringSize - 1);
+        if (RETURN_OK != StorageStoreImmediateBackends(storage, compStore, chType, row)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    if (chStore->PublishRow(chStore)) {
+        mcx_atomic_fetch_add(&storage->writerSignal, 1);
+        if (mcx_atomic_load(&storage->writerSleeping)) {
+            mcx_atomic_wake_all(&storage->writerSignal);
+        }
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus StorageStartWriter(ResultsStorage * storage) {
+    size_t i = 0, chType = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    for (i = 0; i < storage->numComponents; i++) {
+        ComponentStorage * compStore = storage->componentStorage[i];
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            ChannelStorage * chStore = compStore->channels[chType];
+
+            if (chStore->GetChannelNum(chStore) > 0) {
+                retVal = chStore->SetupRing(chStore, storage->writerBufferSize, storage->writerDropRows);
+                if (RETURN_OK != retVal) {
+                    ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not setup result buffer");
+                    return RETURN_ERROR;
+                }
+            }
+        }
+    }
+
+    if (mcx_thread_create(&storage->writerThread, (McxThreadStartRoutine) StorageWriterThread, storage)) {
+        mcx_log(LOG_ERROR, "Results: Could not create result writer thread");
+        return RETURN_ERROR;
+    }
+    storage->writerRunning = TRUE;
+    storage->SetStored = StorageSetStoredAsync;
+
+    mcx_log(LOG_INFO, "Results: Writing results in the background, buffering up to %zu rows per result file (%s if full)",
+        storage->writerBufferSize, storage->writerDropRows ? "drop" : "wait");
+
+    return RETURN_OK;
+}
+
+// writes all buffered rows and stops the result writer thread
+static McxStatus StorageStopWriter(ResultsStorage * storage) {
+    size_t i = 0, chType = 0;
+    long ret = 0;
+
+    if (!storage->writerRunning) {
+        return RETURN_OK;
+    }
+
+    mcx_atomic_store(&storage->writerStop, TRUE);
+    mcx_atomic_fetch_add(&storage->writerSignal, 1);
+    mcx_atomic_wake_all(&storage->writerSignal);
+    mcx_thread_join(storage->writerThread, &ret);
+    storage->writerRunning = FALSE;
+
+    for (i = 0; i < storage->numComponents; i++) {
+        ComponentStorage * compStore = storage->componentStorage[i];
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            ChannelStorage * chStore = compStore->channels[chType];
+
+            if (chStore->numDroppedRows > 0) {
+                ComponentLog(compStore->comp, LOG_WARNING, "Results: Dropped %zu rows of the %s results because the result writer could not keep up",
+                    chStore->numDroppedRows, ChannelStoreSuffix[chType]);
+            }
+        }
+    }
+
+    if (mcx_atomic_load(&storage->writerFailed)) {
+        mcx_log(LOG_ERROR, "Results: Result writer could not store all rows");
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+// ----------------------------------------------------------------------
+// Result Compressor
+
+// starts the compressor thread if any backend compresses its result files
+static McxStatus StorageStartCompressor(ResultsStorage * storage) {
+#if defined (ENABLE_STORAGE)
+    size_t i = 0;
+    int needsCompressor = FALSE;
+
+    for (i = 0; i < BACKEND_NUM; i++) {
+        if (storage->backends[i] && COMPRESSION_NONE != storage->backends[i]->compression) {
+            needsCompressor = TRUE;
+        }
+    }
+    if (!needsCompressor || storage->compressor) {
+        return RETURN_OK;
+    }
+
+    storage->compressor = (StorageCompressor *) object_create(StorageCompressor);
+    if (!storage->compressor) {
+        mcx_log(LOG_ERROR, "Results: Could not create result compressor");
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != storage->compressor->Start(storage->compressor)) {
+        object_destroy(storage->compressor);
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < BACKEND_NUM; i++) {
+        if (storage->backends[i] && COMPRESSION_NONE != storage->backends[i]->compression) {
+            storage->backends[i]->compressor = storage->compressor;
+        }
+    }
+#endif // ENABLE_STORAGE
+
+    return RETURN_OK;
+}
+
+// waits until all result files are compressed
+static McxStatus StorageStopCompressor(ResultsStorage * storage) {
+#if defined (ENABLE_STORAGE)
+    if (storage->compressor) {
+        return storage->compressor->Stop(storage->compressor);
+    }
+#endif // ENABLE_STORAGE
+
+    return RETURN_OK;
+}
+#endif // ENABLE_MT
+
+// ----------------------------------------------------------------------
+// Storage Files
+
+// creates a new directory in the temporary directory for the files of the port storages
+static McxStatus StorageCreateStorageDir(ResultsStorage * storage) {
+    char name[64];
+    const char * pathList[2] = {storage->storageTempDir, name};
+    long clock = mcx_time_get_clock();
+    int i = 0;
+
+    if (!mcx_os_path_exists(storage->storageTempDir)) {
+        if (RETURN_OK != mcx_os_mkdir_recursive(storage->storageTempDir)) {
+            mcx_log(LOG_ERROR, "Results: Could not create directory \"%s\"", storage->storageTempDir);
+            return RETURN_ERROR;
+        }
+    }
+
+    // the directory name is unique as mkdir fails for existing directories
+    for (i = 0; i < 1000; i++) {
+        snprintf(name, sizeof(name), "mcx_storage_%ld_%d", clock, i);
+        if (mcx_path_merge(pathList, 2, &storage->storageDir) || !storage->storageDir) {
+            mcx_log(LOG_ERROR, "Results: Could not create storage directory name");
+            return RETURN_ERROR;
+        }
+        if (0 == mcx_os_mkdir(storage->storageDir)) {
+            return RETURN_OK;
+        }
+        mcx_free(storage->storageDir);
+        storage->storageDir = NULL;
+    }
+
+    mcx_log(LOG_ERROR, "Results: Could not create storage directory in \"%s\"", storage->storageTempDir);
+    return RETURN_ERROR;
+}
+
+static McxStatus StorageSetupStorageFiles(ResultsStorage * storage) {
+    size_t i = 0, chType = 0;
+
+    if (RETURN_OK != StorageCreateStorageDir(storage)) {
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < storage->numComponents; i++) {
+        ComponentStorage * compStore = storage->componentStorage[i];
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            ChannelStorage * chStore = compStore->channels[chType];
+            char name[64];
+            const char * pathList[2] = {storage->storageDir, name};
+            char * fileName = NULL;
+            McxStatus retVal = RETURN_OK;
+
+            if (0 == chStore->GetChannelNum(chStore)) {
+                continue;
+            }
+
+            snprintf(name, sizeof(name), "%zu_%s.bin", i, ChannelStoreSuffix[chType]);
+            if (mcx_path_merge(pathList, 2, &fileName) || !fileName) {
+                mcx_log(LOG_ERROR, "Results: Could not create storage file name");
+                return RETURN_ERROR;
+            }
+            retVal = chStore->SetupSpill(chStore, fileName, storage->storageWindow);
+            mcx_free(fileName);
+            if (RETURN_OK != retVal) {
+                ComponentLog(compStore->comp, LOG_ERROR, "Results: Could not setup storage file");
+                return RETURN_ERROR;
+            }
+        }
+    }
+
+    mcx_log(LOG_INFO, "Results: Keeping up to %zu rows per result file in memory, storing older rows in %s",
+        storage->storageWindow, storage->storageDir);
+
+    return RETURN_OK;
+}
+
+static void StorageRemoveStorageFiles(ResultsStorage * storage) {
+    size_t i = 0, chType = 0;
+
+    if (!storage->storageDir) {
+        return;
+    }
+
+    for (i = 0; i < storage->numComponents; i++) {
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            ChannelStorage * chStore = storage->componentStorage[i]->channels[chType];
+            chStore->RemoveSpill(chStore);
+        }
+    }
+
+    if (RETURN_OK != mcx_os_remove_dir_tree(storage->storageDir)) {
+        mcx_log(LOG_WARNING, "Results: Could not remove storage directory \"%s\"", storage->storageDir);
+    }
+    mcx_free(storage->storageDir);
+    storage->storageDir = NULL;
+}
+
+static void StorageReportMemory(ResultsStorage * storage) {
+    size_t total = 0;
+    size_t i = 0;
+
+    for (i = 0; i < storage->numComponents; i++) {
+        ComponentStorage * compStore = storage->componentStorage[i];
+        size_t memory = 0;
+        size_t chType = 0;
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            memory += compStore->channels[chType]->memoryPeak;
+        }
+
+        if (memory > 0) {
+            mcx_log(LOG_INFO, "Results: Element %s: Peak storage memory: %.1f KiB",
+                compStore->comp->GetName(compStore->comp), memory / 1024.0);
+        }
+        total += memory;
+    }
+
+    if (total > 0) {
+        mcx_log(LOG_INFO, "Results: Peak storage memory: %.1f KiB", total / 1024.0);
+    }
+}
+
 static McxStatus StorageFinishBackends(ResultsStorage * storage) {
     McxStatus retVal = RETURN_OK;
     size_t i = 0;
 
+#if defined (ENABLE_MT)
+    retVal = StorageStopWriter(storage);
+#endif // ENABLE_MT
+
     for (i = 0; i < BACKEND_NUM; i++) {
         StorageBackend * backend = storage->backends[i];
         if (backend) {
@@ -92,6 +469,15 @@ static McxStatus StorageFinishBackends(ResultsStorage * storage) {
         }
     }
 
+#if defined (ENABLE_MT)
+    if (RETURN_OK != StorageStopCompressor(storage)) {
+        retVal = RETURN_ERROR;
+    }
+#endif // ENABLE_MT
+
+    StorageReportMemory(storage);
+    StorageRemoveStorageFiles(storage);
+
     return retVal;
 }
 
@@ -110,13 +496,35 @@ static McxStatus StorageFinished(ResultsStorage * storage) {
     return retVal;
 }
 
+// returns TRUE if compStore is registered at storage
+static int StorageIsRegistered(ResultsStorage * storage, ComponentStorage * compStore) {
+    return compStore
+        && compStore->idx < storage->numComponents
+        && storage->componentStorage[compStore->idx] == compStore;
+}
+
+// returns the registered storage of the i-th component of subModel or NULL
+static ComponentStorage * StorageGetSubModelStorage(ResultsStorage * storage, SubModel * subModel, size_t i) {
+    ObjectContainer * comps = subModel->components;
+    Component * comp = (Component *) comps->At(comps, i);
+    ComponentStorage * compStore = NULL;
+
+    if (!comp) {
+        return NULL;
+    }
+
+    compStore = comp->GetStorage(comp);
+    return StorageIsRegistered(storage, compStore) ? compStore : NULL;
+}
+
 static McxStatus StorageStoreModel(ResultsStorage * storage, SubModel * subModel, double time, StoreLevel level) {
+    ObjectContainer * comps = subModel->components;
     size_t i = 0;
 
     // Get values from Components
-    for (i = 0; i < storage->numComponents; i++) {
-        ComponentStorage * compStore = storage->componentStorage[i];
-        if (subModel->IsElement(subModel, (Component *)compStore->comp)) {
+    for (i = 0; i < comps->Size(comps); i++) {
+        ComponentStorage * compStore = StorageGetSubModelStorage(storage, subModel, i);
+        if (compStore) {
             size_t chType = 0;
             for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
                 compStore->StoreChannels(compStore, (ChannelStoreType) chType, time, level);
@@ -130,12 +538,13 @@ static McxStatus StorageStoreModel(ResultsStorage * storage, SubModel * subModel
 static McxStatus StorageStoreModelOut(ResultsStorage * storage, SubModel * subModel, double time, StoreLevel level) {
     size_t i = 0;
 
+    ObjectContainer * comps = subModel->components;
     McxStatus retVal = RETURN_OK;
 
     // Get values from Components
-    for (i = 0; i < storage->numComponents; i++) {
-        ComponentStorage * compStore = storage->componentStorage[i];
-        if (subModel->IsElement(subModel, compStore->comp)) {
+    for (i = 0; i < comps->Size(comps); i++) {
+        ComponentStorage * compStore = StorageGetSubModelStorage(storage, subModel, i);
+        if (compStore) {
             retVal = compStore->StoreChannels(compStore, CHANNEL_STORE_OUT, time, level);
             if (RETURN_OK != retVal) {
                 return RETURN_ERROR;
@@ -147,12 +556,13 @@ static McxStatus StorageStoreModelOut(ResultsStorage * storage, SubModel * subMo
 }
 
 static McxStatus StorageStoreModelLocal(ResultsStorage * storage, SubModel * subModel, double time, StoreLevel level) {
+    ObjectContainer * comps = subModel->components;
     size_t i = 0;
 
     // Get values from Components
-    for (i = 0; i < storage->numComponents; i++) {
-        ComponentStorage * compStore = storage->componentStorage[i];
-        if (subModel->IsElement(subModel, compStore->comp)) {
+    for (i = 0; i < comps->Size(comps); i++) {
+        ComponentStorage * compStore = StorageGetSubModelStorage(storage, subModel, i);
+        if (compStore) {
             compStore->StoreChannels(compStore, CHANNEL_STORE_LOCAL, time, level);
         }
     }
@@ -161,14 +571,15 @@ static McxStatus StorageStoreModelLocal(ResultsStorage * storage, SubModel * sub
 }
 
 static McxStatus StorageFinishModel(ResultsStorage * storage, SubModel * subModel) {
+    ObjectContainer * comps = subModel->components;
     size_t i = 0;
 
     mcx_log(LOG_DEBUG, "Results: Finish model");
 
     // Get values from Components
-    for (i = 0; i < storage->numComponents; i++) {
-        ComponentStorage * compStore = storage->componentStorage[i];
-        if (subModel->IsElement(subModel, compStore->comp)) {
+    for (i = 0; i < comps->Size(comps); i++) {
+        ComponentStorage * compStore = StorageGetSubModelStorage(storage, subModel, i);
+        if (compStore) {
             compStore->Finished(compStore);
         }
     }
@@ -187,6 +598,7 @@ static McxStatus StorageRegisterComponent(ResultsStorage * storage, ComponentSto
     }
 
     storage->componentStorage[storage->numComponents - 1] = compStore;
+    compStore->idx = storage->numComponents - 1;
 
     // is finished flags
     storage->isComponentFinished = (int *) mcx_realloc(storage->isComponentFinished,
@@ -243,11 +655,24 @@ static McxStatus StorageAddBackend(ResultsStorage * storage, BackendType type, i
         case BACKEND_CSV:
             storeBackend = (StorageBackend *)object_create(StorageBackendCsv);
             break;
+        case BACKEND_BINARY:
+            storeBackend = (StorageBackend *)object_create(StorageBackendBinary);
+            break;
+        case BACKEND_STREAM:
+#if defined (ENABLE_MT)
+            storeBackend = (StorageBackend *)object_create(StorageBackendStream);
+#else
+            mcx_log(LOG_ERROR, "The stream result storage backend needs multithreading support");
+#endif // ENABLE_MT
+            break;
         }
         if (NULL == storeBackend) {
             mcx_log(LOG_ERROR, "The %s result storage backend could not be created", GetBackendTypeString(type));
             return RETURN_ERROR;
         }
+        storeBackend->compression = storage->compression[type];
+        storeBackend->mapped = storage->mapped[type];
+        storeBackend->syncInterval = storage->syncInterval[type];
         retVal = storeBackend->Configure(storeBackend, storage, storage->resultPath, flushEveryStore, storage->storeAtRuntime[type]);
         if (RETURN_ERROR == retVal) {
             mcx_log(LOG_ERROR, "The %s result storage backend could not be configured", GetBackendTypeString(type));
@@ -261,22 +686,22 @@ static McxStatus StorageAddBackend(ResultsStorage * storage, BackendType type, i
 }
 
 static McxStatus StorageSetStoredFull(ResultsStorage * storage, ComponentStorage * compStore, ChannelStoreType chType, double endTime) {
-    // nothing to do
+    ChannelStorage * chStore = compStore->channels[chType];
+
+    // the other backends get all rows when the element is finished
+    if (chStore->numValues > 0) {
+        return StorageStoreImmediateBackends(storage, compStore, chType, chStore->numValues - 1);
+    }
+
     return RETURN_OK;
 }
 
-static McxStatus StorageSetStored(ResultsStorage * storage, ComponentStorage * compStore, ChannelStoreType chType, double endTime) {
-    size_t i = 0;
+static McxStatus StorageStoreRows(ResultsStorage * storage, StorageBackendSelection selection, ComponentStorage * compStore, ChannelStoreType chType, double endTime) {
+    size_t i = compStore->idx;
 
     McxStatus retVal = RETURN_OK;
 
-    // find index of compStore
-    for (i = 0; i < storage->numComponents; i++) {
-        if (storage->componentStorage[i] == compStore) {
-            break;
-        }
-    }
-    if (i == storage->numComponents) {
+    if (!StorageIsRegistered(storage, compStore)) {
         ComponentLog(compStore->comp, LOG_ERROR, "Could not find storage for component");
         return RETURN_ERROR;
     }
@@ -299,7 +724,7 @@ static McxStatus StorageSetStored(ResultsStorage * storage, ComponentStorage * c
         }
 #endif // MCX_DEBUG
 
-        retVal = storage->StoreBackends(storage, chType, i, start, end);
+        retVal = StorageStoreSelectedBackends(storage, selection, chType, i, start, end);
         if (RETURN_OK != retVal) {
             ComponentLog(compStore->comp, LOG_ERROR, "Storing backends failed");
             return RETURN_ERROR;
@@ -309,34 +734,34 @@ static McxStatus StorageSetStored(ResultsStorage * storage, ComponentStorage * c
     return RETURN_OK;
 }
 
+static McxStatus StorageSetStored(ResultsStorage * storage, ComponentStorage * compStore, ChannelStoreType chType, double endTime) {
+    return StorageStoreRows(storage, STORE_ALL_BACKENDS, compStore, chType, endTime);
+}
+
 static McxStatus StorageSetFinishedFull(ResultsStorage * storage, ComponentStorage * compStore) {
-    size_t i = 0;
+    size_t i = compStore->idx;
 
     McxStatus retVal = RETURN_OK;
 
-    for (i = 0; i < storage->numComponents; i++) {
-        if ((storage->componentStorage[i] == compStore)
-            && (!storage->isComponentFinished[i])) {
-            size_t chType = 0;
+    if (StorageIsRegistered(storage, compStore) && !storage->isComponentFinished[i]) {
+        size_t chType = 0;
 
-            /* flush stuff */
-            MCX_DEBUG_LOG("FINISH STORE (%d)", i);
+        /* flush stuff */
+        MCX_DEBUG_LOG("FINISH STORE (%d)", i);
 
-            for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
-                if (double_geq(compStore->channels[chType]->lastStored, 0)) { // if used at least once
-                    retVal = StorageSetStored(storage, compStore, (ChannelStoreType)chType, compStore->channels[chType]->lastStored);
-                    if (RETURN_OK != retVal) {
-                        return RETURN_ERROR;
-                    }
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            if (double_geq(compStore->channels[chType]->lastStored, 0)) { // if used at least once
+                // the immediate backends got the rows in StorageSetStoredFull
+                retVal = StorageStoreRows(storage, STORE_DEFERRED_BACKENDS, compStore, (ChannelStoreType)chType, compStore->channels[chType]->lastStored);
+                if (RETURN_OK != retVal) {
+                    return RETURN_ERROR;
                 }
             }
-
-            /* register as finished */
-            storage->isComponentFinished[i] = 1;
-            storage->numComponentsFinished += 1;
-
-            break;
         }
+
+        /* register as finished */
+        storage->isComponentFinished[i] = 1;
+        storage->numComponentsFinished += 1;
     }
 
     if (storage->numComponentsFinished == storage->numComponents) {
@@ -349,19 +774,14 @@ static McxStatus StorageSetFinishedFull(ResultsStorage * storage, ComponentStora
 }
 
 static McxStatus StorageSetFinished(ResultsStorage * storage, ComponentStorage * compStore) {
-    size_t compIdx = 0;
-
-    for (compIdx = 0; compIdx < storage->numComponents; compIdx++) {
-        if ((storage->componentStorage[compIdx] == compStore)
-            && (!storage->isComponentFinished[compIdx])) {
-            MCX_DEBUG_LOG("FINISH STORE (%d)", compIdx);
+    size_t compIdx = compStore->idx;
 
-            /* register as finished */
-            storage->isComponentFinished[compIdx] = 1;
-            storage->numComponentsFinished += 1;
+    if (StorageIsRegistered(storage, compStore) && !storage->isComponentFinished[compIdx]) {
+        MCX_DEBUG_LOG("FINISH STORE (%d)", compIdx);
 
-            break;
-        }
+        /* register as finished */
+        storage->isComponentFinished[compIdx] = 1;
+        storage->numComponentsFinished += 1;
     }
 
     if (storage->numComponentsFinished == storage->numComponents) {
@@ -373,6 +793,23 @@ static McxStatus StorageSetFinished(ResultsStorage * storage, ComponentStorage *
     return RETURN_OK;
 }
 
+static McxStatus StorageSynchronized(ResultsStorage * storage, double time) {
+    McxStatus retVal = RETURN_OK;
+    size_t i = 0;
+
+    for (i = 0; i < BACKEND_NUM; i++) {
+        StorageBackend * backend = storage->backends[i];
+        if (backend && backend->active && backend->Synchronized) {
+            if (RETURN_OK != backend->Synchronized(backend, time)) {
+                mcx_log(LOG_ERROR, "Results: Synchronize backends: Could not synchronize sucessfully");
+                retVal = RETURN_ERROR;
+            }
+        }
+    }
+
+    return retVal;
+}
+
 static StoreLevel ResultsStorageGetStoreLevel(ResultsStorage * storage) {
     return storage->level;
 }
@@ -414,20 +851,67 @@ static McxStatus StorageRead(ResultsStorage * storage, ResultsInput * resultsInp
     // read storage level
     storage->level = resultsInput->resultLevel.defined ? resultsInput->resultLevel.value : STORE_SYNCHRONIZATION;
 
+    storage->storageWindow = config->resultStorageWindow;
+    if (storage->storageWindow > 0) {
+        const char * tempDir = ConfigGetTempDir(config);
+        if (NULL == tempDir) {
+            tempDir = ConfigGetLocalTempDir(config);
+        }
+        storage->storageTempDir = mcx_string_copy(tempDir);
+        if (!storage->storageTempDir) {
+            mcx_log(LOG_ERROR, "Results: No temporary directory for the result storage");
+            return RETURN_ERROR;
+        }
+    }
+
+#if defined (ENABLE_MT)
+    storage->writerBufferSize = config->resultWriterBufferSize;
+    storage->writerDropRows = config->resultWriterDropRows;
+#endif // ENABLE_MT
+
     // read backends
     for (i = 0; i < backendsInput->backends->Size(backendsInput->backends); i++) {
         BackendInput * backendInput = (BackendInput *) backendsInput->backends->At(backendsInput->backends, i);
 
-        if (backendInput->type == BACKEND_CSV) {
-            retVal = storage->AddBackend(storage, BACKEND_CSV, config->flushEveryStore);
-            if (RETURN_OK != retVal) {
-                mcx_log(LOG_ERROR, "Could not add %s storage backend", GetBackendTypeString(BACKEND_CSV));
+        if (backendInput->type == BACKEND_CSV || backendInput->type == BACKEND_BINARY) {
+            // the settings are needed when the backend is configured
+            if (backendInput->storeAtRuntime.defined) {
+                storage->storeAtRuntime[backendInput->type] = backendInput->storeAtRuntime.value;
+            }
+            if (backendInput->compression.defined) {
+                storage->compression[backendInput->type] = (CompressionType) backendInput->compression.value;
+            }
+            if (backendInput->mapped.defined) {
+                storage->mapped[backendInput->type] = backendInput->mapped.value;
+            }
+            if (backendInput->syncInterval.defined) {
+                storage->syncInterval[backendInput->type] = backendInput->syncInterval.value;
+            }
+            if (storage->mapped[backendInput->type] && COMPRESSION_NONE != storage->compression[backendInput->type]) {
+                mcx_log(LOG_ERROR, "The result files of the %s storage backend cannot be both mapped and compressed",
+                        GetBackendTypeString(backendInput->type));
                 return RETURN_ERROR;
             }
 
-            if (backendInput->storeAtRuntime.defined) {
-                storage->storeAtRuntime[BACKEND_CSV] = backendInput->storeAtRuntime.value;
+            retVal = storage->AddBackend(storage, backendInput->type, config->flushEveryStore);
+            if (RETURN_OK != retVal) {
+                mcx_log(LOG_ERROR, "Could not add %s storage backend", GetBackendTypeString(backendInput->type));
+                return RETURN_ERROR;
             }
+        } else if (backendInput->type == BACKEND_STREAM) {
+            retVal = storage->AddBackend(storage, backendInput->type, config->flushEveryStore);
+            if (RETURN_OK != retVal) {
+                mcx_log(LOG_ERROR, "Could not add %s storage backend", GetBackendTypeString(backendInput->type));
+                return RETURN_ERROR;
+            }
+#if defined (ENABLE_MT)
+            if (storage->backends[BACKEND_STREAM]) {
+                retVal = StorageBackendStreamRead(storage->backends[BACKEND_STREAM], backendInput);
+                if (RETURN_OK != retVal) {
+                    return RETURN_ERROR;
+                }
+            }
+#endif // ENABLE_MT
         }
     }
     return RETURN_OK;
@@ -447,6 +931,13 @@ static McxStatus StorageSetupBackends(ResultsStorage * storage) {
     size_t i = 0;
     int numBackends = 0;
 
+#if defined (ENABLE_MT)
+    // the backends open their result files in Setup
+    if (RETURN_OK != StorageStartCompressor(storage)) {
+        return RETURN_ERROR;
+    }
+#endif // ENABLE_MT
+
     storage->needsFullStorage = 0;
     for (i = 0; i < BACKEND_NUM; i++) {
         StorageBackend * backend = storage->backends[i];
@@ -466,8 +957,22 @@ static McxStatus StorageSetupBackends(ResultsStorage * storage) {
     if (storage->needsFullStorage) {
         storage->SetStored = StorageSetStoredFull;
         storage->SetFinished = StorageSetFinishedFull;
+
+        if (storage->storageWindow > 0 && numBackends > 0) {
+            if (RETURN_OK != StorageSetupStorageFiles(storage)) {
+                return RETURN_ERROR;
+            }
+        }
     }
 
+#if defined (ENABLE_MT)
+    if (!storage->needsFullStorage && storage->writerBufferSize > 0 && numBackends > 0) {
+        if (RETURN_OK != StorageStartWriter(storage)) {
+            return RETURN_ERROR;
+        }
+    }
+#endif // ENABLE_MT
+
     // if no backends are registered, then skip storing results
     if (0 == numBackends) {
         size_t compIdx = 0;
@@ -488,12 +993,23 @@ McxStatus ResultsStorageSetStoreFlag(ResultsStorage * storage, int active) {
 static void ResultsStorageDestructor(ResultsStorage * storage) {
     size_t i = 0;
 
+#if defined (ENABLE_MT)
+    StorageStopWriter(storage);
+#endif // ENABLE_MT
+
     for (i = 0; i < BACKEND_NUM; i++) {
         if (storage->backends[i]) {
             object_destroy(storage->backends[i]);
         }
     }
 
+#if defined (ENABLE_MT) && defined (ENABLE_STORAGE)
+    // after the backends, their streams may still use the compressor
+    if (storage->compressor) {
+        object_destroy(storage->compressor);
+    }
+#endif // ENABLE_MT
+
     if (storage->componentStorage) {
         /* individual component storages are destroyed in components */
         mcx_free(storage->componentStorage);
@@ -510,6 +1026,15 @@ static void ResultsStorageDestructor(ResultsStorage * storage) {
     if (storage->resultPath) {
         mcx_free(storage->resultPath);
     }
+
+    if (storage->storageDir) {
+        // only left if the backends were not finished
+        mcx_os_remove_dir_tree(storage->storageDir);
+        mcx_free(storage->storageDir);
+    }
+    if (storage->storageTempDir) {
+        mcx_free(storage->storageTempDir);
+    }
 }
 
 static ResultsStorage * ResultsStorageCreate(ResultsStorage * storage) {
@@ -534,6 +1059,7 @@ static ResultsStorage * ResultsStorageCreate(ResultsStorage * storage) {
 
     storage->SetFinished = StorageSetFinished;
     storage->FinishBackends = StorageFinishBackends;
+    storage->Synchronized = StorageSynchronized;
 
     storage->GetStoreLevel = ResultsStorageGetStoreLevel;
     storage->SetStoreLevel = ResultsStorageSetStoreLevel;
@@ -549,9 +1075,17 @@ static ResultsStorage * ResultsStorageCreate(ResultsStorage * storage) {
     for (i = 0; i < BACKEND_NUM; i++) {
         storage->backends[i] = NULL;
         storage->storeAtRuntime[i] = TRUE;
+        storage->compression[i] = COMPRESSION_NONE;
+        storage->mapped[i] = FALSE;
+        storage->syncInterval[i] = 1.0;
     }
 
     storage->resultPath = NULL;
+
+    storage->storageWindow = 0;
+    storage->storageTempDir = NULL;
+    storage->storageDir = NULL;
+
     storage->needsFullStorage = 0;
 
     storage->numComponentsFinished = 0;
@@ -563,6 +1097,18 @@ static ResultsStorage * ResultsStorageCreate(ResultsStorage * storage) {
 
     storage->active = TRUE;
 
+#if defined (ENABLE_MT)
+    storage->writerBufferSize = 0;
+    storage->writerDropRows = FALSE;
+    storage->writerRunning = FALSE;
+    mcx_atomic_store(&storage->writerSignal, 0);
+    mcx_atomic_store(&storage->writerSleeping, FALSE);
+    mcx_atomic_store(&storage->writerStop, FALSE);
+    mcx_atomic_store(&storage->writerFailed, FALSE);
+
+    storage->compressor = NULL;
+#endif // ENABLE_MT
+
     /* enable all stores by default */
     for (i = 0; i < CHANNEL_STORE_NUM; i++) {
         storage->channelStoreEnabled[i] = 1;
@@ -20,6 +20,11 @@
 
 #include "reader/task/ResultsInput.h"
 
+#if defined (ENABLE_MT)
+#include "util/atomic.h"
+#include "util/threads.h"
+#endif // ENABLE_MT
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -36,6 +41,7 @@ typedef McxStatus (* fStorageBackendConfigure)(StorageBackend * backend, Results
 typedef McxStatus (* fStorageBackendSetup)(StorageBackend * backend);
 typedef McxStatus (* fStorageBackendStore)(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row);
 typedef McxStatus (* fStorageBackendFinished)(StorageBackend * backend);
+typedef McxStatus (* fStorageBackendSynchronized)(StorageBackend * backend, double time);
 
 extern const struct ObjectClass _StorageBackend;
 
@@ -47,12 +53,23 @@ struct StorageBackend {
     fStorageBackendStore     Store;
     fStorageBackendFinished  Finished;
 
+    // called after all rows up to the end of a synchronization step are stored, may be NULL
+    fStorageBackendSynchronized Synchronized;
+
     int id;
 
     int needsFullStorage;
 
+    // rows are stored by the element that stores them, also with full storage or the result writer
+    int immediate;
+
     int active;
 
+    CompressionType compression; // set before Configure
+    int mapped;                  // write the result files through mapped windows, set before Configure
+    double syncInterval;         // seconds between syncs of mapped result files
+    struct StorageCompressor * compressor; // compresses the result files in the background, may be NULL
+
     struct ResultsStorage * storage;
 };
 
@@ -72,6 +89,7 @@ typedef McxStatus (* fResultsStorageSetStored)(ResultsStorage * storage, Compone
 typedef McxStatus (* fResultsStorageSetFinished)(ResultsStorage * storage, ComponentStorage * compStore);
 typedef McxStatus (* fResultsStorageStoreBackends)(ResultsStorage * storage, ChannelStoreType chType, size_t i, size_t start, size_t end);
 typedef McxStatus (* fResultsStorageFinishBackends)(ResultsStorage * storage);
+typedef McxStatus (* fResultsStorageSynchronized)(ResultsStorage * storage, double time);
 typedef StoreLevel (* fResultsStorageGetStoreLevel)(ResultsStorage * storage);
 typedef void (* fResultsStorageSetStoreLevel)(ResultsStorage * storage, StoreLevel level);
 
@@ -104,6 +122,9 @@ struct ResultsStorage {
     fResultsStorageSetFinished     SetFinished;
     fResultsStorageFinishBackends  FinishBackends;
 
+    // marks the end of a synchronization step at time, all elements are stored up to time
+    fResultsStorageSynchronized    Synchronized;
+
     fResultsStorageGetStoreLevel GetStoreLevel;
     fResultsStorageSetStoreLevel SetStoreLevel;
 
@@ -123,6 +144,9 @@ struct ResultsStorage {
     StorageBackend * backends[BACKEND_NUM];
 
     int storeAtRuntime[BACKEND_NUM];
+    CompressionType compression[BACKEND_NUM];
+    int mapped[BACKEND_NUM];
+    double syncInterval[BACKEND_NUM];
 
     char *resultPath;
     int needsFullStorage;
@@ -134,6 +158,26 @@ struct ResultsStorage {
     int channelStoreEnabled[CHANNEL_STORE_NUM];
 
     double startTime;
+
+    // full storage keeps at most storageWindow rows per port storage in memory, 0 if unlimited
+    size_t storageWindow;
+    char * storageTempDir; // base directory of storageDir
+    char * storageDir;     // directory of the files with the rows that do not fit into memory
+
+#if defined (ENABLE_MT)
+    // result writer thread, the rows are buffered in ring buffers of the port storages
+    size_t writerBufferSize;     // rows per port storage, 0 to store synchronously
+    int writerDropRows;          // drop rows instead of waiting if a ring buffer is full
+    int writerRunning;
+    McxThread writerThread;
+    McxAtomic writerSignal;      // incremented when rows are published
+    McxAtomic writerSleeping;
+    McxAtomic writerStop;
+    McxAtomic writerFailed;
+
+    // compresses the result files of all backends with compression, NULL if none
+    struct StorageCompressor * compressor;
+#endif // ENABLE_MT
 };
 
 McxStatus ResultsStorageSetStoreFlag(ResultsStorage * storage, int active);
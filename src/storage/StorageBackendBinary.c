@@ -0,0 +1,860 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_STORAGE)
+
+#include "core/channels/ChannelInfo.h"
+#include "storage/StorageBackendBinary.h"
+#include "storage/ComponentStorage.h"
+#include "storage/ChannelStorage.h"
+#include "storage/CompressedStream.h"
+#include "storage/PPD.h"
+
+#include "util/paths.h"
+#include "util/string.h"
+#include "util/os.h"
+#include "util/mapped_file.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define TOOL_NAME "OpenMCx"
+#define TOOL_VERSION ""
+
+#define PPD_FILE_NAME "binary_results.ppd"
+
+// number of rows that are buffered before they are written as one chunk
+#define CHUNK_ROWS 4096
+
+typedef struct BinaryColumn {
+    char * data;
+    size_t size;
+    size_t capacity;
+} BinaryColumn;
+
+typedef struct BinaryFile {
+    char * name;
+    FILE * fp;
+    CompressedStream * stream; // NULL if the file is not compressed
+    McxMappedFile * mapped;    // NULL if the file is written through fp
+
+    size_t numColumns;
+    ChannelType * types;
+    BinaryColumn * columns;
+
+    size_t numRows; // rows in the columns that are not written yet
+} BinaryFile;
+
+typedef struct BinaryComponent {
+    BinaryFile files[CHANNEL_STORE_NUM];
+} BinaryComponent;
+
+typedef struct StorageBackendBinary {
+    StorageBackend _;
+
+    size_t numComponents;
+    BinaryComponent * comps;
+
+    char * path;
+
+    int flushEveryStore;
+} StorageBackendBinary;
+
+static McxStatus Store(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row);
+static McxStatus Finished(StorageBackend * backend);
+static McxStatus StoreFull(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row);
+static McxStatus FinishedFull(StorageBackend * backend);
+
+// ----------------------------------------------------------------------
+// Columns
+
+static int IsLittleEndian(void) {
+    const uint16_t one = 1;
+
+    return * (const char *) &one;
+}
+
+static McxStatus ColumnReserve(BinaryColumn * column, size_t size) {
+    if (column->size + size > column->capacity) {
+        size_t capacity = column->capacity ? column->capacity : 64;
+        char * data = NULL;
+
+        while (capacity < column->size + size) {
+            capacity *= 2;
+        }
+        data = (char *) mcx_realloc(column->data, capacity);
+        if (!data) {
+            return RETURN_ERROR;
+        }
+        column->data = data;
+        column->capacity = capacity;
+    }
+
+    return RETURN_OK;
+}
+
+// appends the number of size bytes in little-endian byte order
+static McxStatus ColumnAppendNumber(BinaryColumn * column, const void * value, size_t size) {
+    size_t i = 0;
+
+    if (RETURN_OK != ColumnReserve(column, size)) {
+        return RETURN_ERROR;
+    }
+
+    if (IsLittleEndian()) {
+        memcpy(column->data + column->size, value, size);
+    } else {
+        for (i = 0; i < size; i++) {
+            column->data[column->size + i] = ((const char *) value)[size - 1 - i];
+        }
+    }
+    column->size += size;
+
+    return RETURN_OK;
+}
+
+static McxStatus ColumnAppendUInt32(BinaryColumn * column, uint32_t value) {
+    return ColumnAppendNumber(column, &value, sizeof(value));
+}
+
+// appends the length of bytes followed by the bytes
+static McxStatus ColumnAppendBytes(BinaryColumn * column, const char * bytes, size_t len) {
+    if (len > UINT32_MAX) {
+        mcx_log(LOG_ERROR, "Results: Value of %zu bytes is too long for the binary result format", len);
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != ColumnAppendUInt32(column, (uint32_t) len)) {
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != ColumnReserve(column, len)) {
+        return RETURN_ERROR;
+    }
+    if (len > 0) {
+        memcpy(column->data + column->size, bytes, len);
+    }
+    column->size += len;
+
+    return RETURN_OK;
+}
+
+static void ColumnDestructor(BinaryColumn * column) {
+    if (column->data) {
+        mcx_free(column->data);
+    }
+    column->data = NULL;
+    column->size = 0;
+    column->capacity = 0;
+}
+
+// ----------------------------------------------------------------------
+// Files
+
+static int BinaryFileIsOpen(BinaryFile * binaryFile) {
+    return binaryFile->fp || binaryFile->mapped;
+}
+
+static McxStatus WriteBinaryFile(BinaryFile * binaryFile, const void * data, size_t size) {
+    if (binaryFile->stream) {
+        return binaryFile->stream->Write(binaryFile->stream, data, size);
+    }
+
+    if (binaryFile->mapped) {
+        if (mcx_mapped_file_write(binaryFile->mapped, data, size)) {
+            mcx_log(LOG_ERROR, "Results: Could not write results to mapped file \"%s\"", binaryFile->name);
+            return RETURN_ERROR;
+        }
+        return RETURN_OK;
+    }
+
+    if (size > 0 && 1 != fwrite(data, size, 1, binaryFile->fp)) {
+        int errsv = errno;
+        if (ENOSPC == errsv) {
+            mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\": No space left on device", binaryFile->name);
+        } else {
+            mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\"", binaryFile->name);
+        }
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus FlushBinaryFile(BinaryFile * binaryFile) {
+    if (binaryFile->stream) {
+        return binaryFile->stream->Flush(binaryFile->stream);
+    }
+
+    if (fflush(binaryFile->fp)) {
+        int errsv = errno;
+        if (ENOSPC == errsv) {
+            mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\": No space left on device", binaryFile->name);
+        } else {
+            mcx_log(LOG_ERROR, "Results: Could not write results to file \"%s\"", binaryFile->name);
+        }
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+static ChannelType BinaryFileType(ChannelType type) {
+    if (CHANNEL_BINARY_REFERENCE == type) {
+        return CHANNEL_BINARY;
+    }
+
+    return type;
+}
+
+static McxStatus WriteHeader(BinaryFile * binaryFile, ChannelStorage * chStore) {
+    BinaryColumn header = { NULL, 0, 0 };
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    retVal = ColumnReserve(&header, 8);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+    memcpy(header.data, "MCXBRES", 8);
+    header.size = 8;
+
+    retVal = ColumnAppendUInt32(&header, BINARY_RESULTS_VERSION);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+    retVal = ColumnAppendUInt32(&header, (uint32_t) binaryFile->numColumns);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < binaryFile->numColumns; i++) {
+        ChannelInfo * info = chStore->GetChannelInfo(chStore, i);
+        const char * name = info->GetName(info);
+        const char * unit = info->GetUnit(info);
+
+        retVal = ColumnAppendUInt32(&header, (uint32_t) binaryFile->types[i]);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+        retVal = ColumnAppendBytes(&header, name, name ? strlen(name) : 0);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+        retVal = ColumnAppendBytes(&header, unit, unit ? strlen(unit) : 0);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+    }
+
+    retVal = WriteBinaryFile(binaryFile, header.data, header.size);
+
+cleanup:
+    ColumnDestructor(&header);
+
+    return retVal;
+}
+
+static McxStatus WriteChunk(BinaryFile * binaryFile) {
+    BinaryColumn header = { NULL, 0, 0 };
+    uint64_t size = 0;
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (0 == binaryFile->numRows) {
+        return RETURN_OK;
+    }
+
+    for (i = 0; i < binaryFile->numColumns; i++) {
+        size += binaryFile->columns[i].size;
+    }
+
+    retVal = ColumnReserve(&header, 4);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+    memcpy(header.data, "CHNK", 4);
+    header.size = 4;
+
+    retVal = ColumnAppendUInt32(&header, (uint32_t) binaryFile->numRows);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+    retVal = ColumnAppendNumber(&header, &size, sizeof(size));
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+
+    retVal = WriteBinaryFile(binaryFile, header.data, header.size);
+    if (RETURN_OK != retVal) {
+        goto cleanup;
+    }
+    for (i = 0; i < binaryFile->numColumns; i++) {
+        BinaryColumn * column = &binaryFile->columns[i];
+
+        retVal = WriteBinaryFile(binaryFile, column->data, column->size);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+        column->size = 0;
+    }
+    binaryFile->numRows = 0;
+
+cleanup:
+    ColumnDestructor(&header);
+
+    return retVal;
+}
+
+static McxStatus AppendRow(BinaryFile * binaryFile, ChannelStorage * chStore, size_t row) {
+    size_t i = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    for (i = 0; i < binaryFile->numColumns; i++) {
+        ChannelValue val = chStore->GetValueAt(chStore, row, i);
+        BinaryColumn * column = &binaryFile->columns[i];
+
+        switch (binaryFile->types[i]) {
+        case CHANNEL_DOUBLE:
+            retVal = ColumnAppendNumber(column, &val.value.d, sizeof(double));
+            break;
+        case CHANNEL_INTEGER:
+        case CHANNEL_BOOL:
+        {
+            int32_t value = (int32_t) val.value.i;
+            retVal = ColumnAppendNumber(column, &value, sizeof(value));
+            break;
+        }
+        case CHANNEL_STRING:
+            retVal = ColumnAppendBytes(column, val.value.s, val.value.s ? strlen(val.value.s) : 0);
+            break;
+        case CHANNEL_BINARY:
+            retVal = ColumnAppendBytes(column, val.value.b.data, val.value.b.data ? val.value.b.len : 0);
+            break;
+        default:
+            mcx_log(LOG_ERROR, "Results: Port type %s is not supported by the binary result format", ChannelTypeToString(binaryFile->types[i]));
+            return RETURN_ERROR;
+        }
+        if (RETURN_OK != retVal) {
+            mcx_log(LOG_ERROR, "Results: Could not buffer result row for \"%s\"", binaryFile->name);
+            return RETURN_ERROR;
+        }
+    }
+    binaryFile->numRows++;
+
+    return RETURN_OK;
+}
+
+static McxStatus StoreRow(StorageBackendBinary * binaryBackend, BinaryFile * binaryFile, ChannelStorage * chStore, size_t row) {
+    McxStatus retVal = RETURN_OK;
+
+    retVal = AppendRow(binaryFile, chStore, row);
+    if (RETURN_OK != retVal) {
+        return RETURN_ERROR;
+    }
+
+    if (binaryFile->numRows >= CHUNK_ROWS || binaryBackend->flushEveryStore) {
+        retVal = WriteChunk(binaryFile);
+        if (RETURN_OK != retVal) {
+            return RETURN_ERROR;
+        }
+    }
+
+    if (binaryFile->mapped) {
+        // the written chunks are visible to readers right away, syncing only makes them durable
+        if (mcx_mapped_file_sync_every(binaryFile->mapped, ((StorageBackend *) binaryBackend)->syncInterval)) {
+            mcx_log(LOG_ERROR, "Results: Could not sync result file \"%s\"", binaryFile->name);
+            return RETURN_ERROR;
+        }
+    } else if (binaryBackend->flushEveryStore) {
+        return FlushBinaryFile(binaryFile);
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus CloseBinaryFiles(StorageBackendBinary * backend, size_t comp) {
+    size_t i = 0;
+    McxStatus retVal = RETURN_OK;
+
+    if (comp >= backend->numComponents) {
+        mcx_log(LOG_ERROR, "Results: Could not close result file: No result file for element %d", comp);
+        return RETURN_ERROR;
+    }
+    for (i = 0; i < CHANNEL_STORE_NUM; i++) {
+        BinaryFile * binaryFile = &(backend->comps[comp].files[i]);
+        if (BinaryFileIsOpen(binaryFile)) {
+            if (RETURN_OK != WriteChunk(binaryFile)) {
+                retVal = RETURN_ERROR;
+            }
+            if (binaryFile->stream) {
+                if (RETURN_OK != binaryFile->stream->Close(binaryFile->stream)) {
+                    mcx_log(LOG_ERROR, "Results: Could not finish compressed result file \"%s\"", binaryFile->name);
+                    retVal = RETURN_ERROR;
+                }
+                object_destroy(binaryFile->stream);
+            }
+            mcx_log(LOG_DEBUG, "Results: Closing result file \"%s\"!", binaryFile->name);
+            if (binaryFile->mapped) {
+                if (mcx_mapped_file_close(binaryFile->mapped)) {
+                    mcx_log(LOG_ERROR, "Results: Could not close result file \"%s\"", binaryFile->name);
+                    retVal = RETURN_ERROR;
+                }
+                mcx_free(binaryFile->mapped);
+                binaryFile->mapped = NULL;
+            } else if (mcx_os_fclose(binaryFile->fp)) {
+                int errsv = errno;
+                if (ENOSPC == errsv) {
+                    mcx_log(LOG_ERROR, "Results: Could not close result file \"%s\": No space left on device", binaryFile->name);
+                } else {
+                    mcx_log(LOG_ERROR, "Results: Could not close result file \"%s\"", binaryFile->name);
+                }
+                retVal = RETURN_ERROR;
+            }
+        }
+        binaryFile->fp = NULL;
+    }
+
+    return retVal;
+}
+
+// ----------------------------------------------------------------------
+// Backend
+
+static char * LocalPath(const char * filename) {
+    char * path = (char *) mcx_calloc(strlen(filename) + 3, sizeof(char));
+    if (!path) { return NULL; }
+
+    strcpy(path, "./");
+    strcat(path, filename);
+
+    return path;
+}
+
+static McxStatus WritePPDFile(StorageBackendBinary * binaryBackend) {
+    StorageBackend * backend = (StorageBackend *) binaryBackend;
+    ResultsStorage * storage = backend->storage;
+    char * filename = NULL;
+    size_t compIdx = 0;
+
+    PpdRootFolder * root = NULL;
+
+    McxStatus retVal = RETURN_OK;
+
+    filename = (char *) mcx_calloc(strlen(binaryBackend->path) + strlen(PPD_FILE_NAME) + 1 + 1, sizeof(char));
+    if (!filename) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for filename of result file \"%s/%s\" failed", binaryBackend->path, PPD_FILE_NAME);
+        return RETURN_ERROR;
+    }
+    sprintf(filename, "%s/%s", binaryBackend->path, PPD_FILE_NAME);
+
+    root = PpdRootFolderMake(
+        TOOL_NAME " Simulation Results",
+        TOOL_NAME " Simulation Results",
+        TOOL_NAME ,
+        TOOL_VERSION);
+
+    for (compIdx = 0; compIdx < binaryBackend->numComponents; compIdx++) {
+        ComponentStorage * compStore = storage->componentStorage[compIdx];
+        Component * comp = (Component *) compStore->comp;
+        BinaryComponent * binaryComponent = &(binaryBackend->comps[compIdx]);
+
+        char * paths[CHANNEL_STORE_NUM] = { NULL };
+        size_t i = 0;
+
+        PpdFolder * folder = (PpdFolder *) root;
+        PpdFolder * compFolder = NULL;
+
+        for (i = 0; i < CHANNEL_STORE_NUM; i++) {
+            const char * name = binaryComponent->files[i].name;
+
+            if (name) {
+                paths[i] = LocalPath(name);
+                if (!paths[i]) {
+                    mcx_log(LOG_ERROR, "Results: Could not setup directory file");
+                    retVal = RETURN_ERROR;
+                }
+            }
+        }
+
+        if (RETURN_OK == retVal) {
+            compFolder = folder->InsertComponent(
+                folder,
+                "MCXBInfo",
+                comp->GetName(comp),
+                paths[CHANNEL_STORE_OUT],
+                paths[CHANNEL_STORE_IN],
+                paths[CHANNEL_STORE_LOCAL],
+                paths[CHANNEL_STORE_RTFACTOR]);
+            if (!compFolder) {
+                mcx_log(LOG_ERROR, "Results: Could not add directory file");
+                retVal = RETURN_ERROR;
+            }
+        }
+
+        for (i = 0; i < CHANNEL_STORE_NUM; i++) {
+            if (paths[i]) {
+                mcx_free(paths[i]);
+            }
+        }
+
+        if (RETURN_OK != retVal) {
+            break;
+        }
+    }
+
+    if (RETURN_OK == retVal) {
+        retVal = root->Print(root, filename);
+    }
+
+    mcx_free(filename);
+    object_destroy(root);
+
+    return retVal;
+}
+
+static McxStatus SetupBinaryFile(StorageBackendBinary * binaryBackend, BinaryFile * binaryFile, ChannelStorage * chStore, const char * localName, const char * suffix) {
+    StorageBackend * backend = (StorageBackend *) binaryBackend;
+    const char * compressionSuffix = GetCompressionFileSuffix(backend->compression);
+    size_t nameLen = strlen(localName) + strlen(suffix) + strlen(compressionSuffix) + 7;
+    size_t chIdx = 0;
+    char * buffer = NULL;
+
+    binaryFile->numColumns = chStore->GetChannelNum(chStore);
+    binaryFile->types = (ChannelType *) mcx_calloc(binaryFile->numColumns, sizeof(ChannelType));
+    binaryFile->columns = (BinaryColumn *) mcx_calloc(binaryFile->numColumns, sizeof(BinaryColumn));
+    binaryFile->name = (char *) mcx_calloc(nameLen, sizeof(char));
+    if ((binaryFile->numColumns > 0 && (!binaryFile->types || !binaryFile->columns)) || !binaryFile->name) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for result file of \"%s\" failed", localName);
+        return RETURN_ERROR;
+    }
+    snprintf(binaryFile->name, nameLen, "%s_%s.mcxb%s", localName, suffix, compressionSuffix);
+
+    for (chIdx = 0; chIdx < binaryFile->numColumns; chIdx++) {
+        ChannelInfo * info = chStore->GetChannelInfo(chStore, chIdx);
+        binaryFile->types[chIdx] = BinaryFileType(info->GetType(info));
+    }
+
+    buffer = (char *) mcx_calloc(strlen(binaryBackend->path) + strlen(binaryFile->name) + 1 + 1, sizeof(char));
+    if (!buffer) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for result file name \"%s/%s\" failed", binaryBackend->path, binaryFile->name);
+        return RETURN_ERROR;
+    }
+    sprintf(buffer, "%s/%s", binaryBackend->path, binaryFile->name);
+
+    if (backend->mapped) {
+        binaryFile->mapped = (McxMappedFile *) mcx_calloc(1, sizeof(McxMappedFile));
+        if (!binaryFile->mapped) {
+            mcx_log(LOG_ERROR, "Results: Memory allocation for mapped result file \"%s\" failed", buffer);
+            mcx_free(buffer);
+            return RETURN_ERROR;
+        }
+        if (mcx_mapped_file_open(binaryFile->mapped, buffer)) {
+            mcx_log(LOG_ERROR, "Results: Could not open result file \"%s\" for writing", buffer);
+            mcx_free(binaryFile->mapped);
+            binaryFile->mapped = NULL;
+            mcx_free(buffer);
+            return RETURN_ERROR;
+        }
+        mcx_free(buffer);
+
+        return WriteHeader(binaryFile, chStore);
+    }
+
+    binaryFile->fp = mcx_os_fopen(buffer, "wb");
+    if (!binaryFile->fp) {
+        mcx_log(LOG_ERROR, "Results: Could not open result file \"%s\" for writing", buffer);
+        mcx_free(buffer);
+        return RETURN_ERROR;
+    }
+    mcx_free(buffer);
+
+    if (COMPRESSION_NONE != backend->compression) {
+        binaryFile->stream = (CompressedStream *) object_create(CompressedStream);
+        if (!binaryFile->stream) {
+            mcx_log(LOG_ERROR, "Results: Could not create compressed stream for \"%s\"", binaryFile->name);
+            return RETURN_ERROR;
+        }
+        if (RETURN_OK != binaryFile->stream->Open(binaryFile->stream, binaryFile->fp, binaryFile->name, backend->compression, backend->compressor)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    return WriteHeader(binaryFile, chStore);
+}
+
+static McxStatus SetupComponentFiles(StorageBackendBinary * binaryBackend) {
+    StorageBackend * backend = (StorageBackend *) binaryBackend;
+    ResultsStorage * storage = backend->storage;
+    size_t compIdx = 0;
+
+    if (binaryBackend->numComponents > 0) {
+        mcx_log(LOG_ERROR, "Results: Re-setting up backend");
+        return RETURN_ERROR;
+    }
+
+    binaryBackend->comps = (BinaryComponent *) mcx_calloc(storage->numComponents, sizeof(BinaryComponent));
+    if (storage->numComponents > 0 && !binaryBackend->comps) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for result files failed");
+        return RETURN_ERROR;
+    }
+    binaryBackend->numComponents = storage->numComponents;
+
+    for (compIdx = 0; compIdx < binaryBackend->numComponents; compIdx++) {
+        ComponentStorage * compStore = storage->componentStorage[compIdx];
+        Component * comp = (Component *) compStore->comp;
+        BinaryComponent * binaryComponent = &(binaryBackend->comps[compIdx]);
+        size_t j = 0;
+
+        char * localName = mcx_string_encode_filename(comp->GetName(comp));
+
+        size_t numberOfPorts[CHANNEL_STORE_NUM] = { 0 };  //avoid empty result files
+        numberOfPorts[CHANNEL_STORE_IN] = comp->GetNumWriteInChannels(comp);
+        numberOfPorts[CHANNEL_STORE_OUT] = comp->GetNumWriteOutChannels(comp);
+        numberOfPorts[CHANNEL_STORE_LOCAL] = comp->GetNumWriteLocalChannels(comp);
+        numberOfPorts[CHANNEL_STORE_RTFACTOR] = comp->GetNumWriteRTFactorChannels(comp);
+
+        if (!localName) {
+            mcx_log(LOG_ERROR, "Results: Could not encode file name of element %s", comp->GetName(comp));
+            return RETURN_ERROR;
+        }
+
+        for (j = 0; j < CHANNEL_STORE_NUM; j++) {
+            /* do not create a file if channel store is not enabled */
+            if (!compStore->storage->channelStoreEnabled[j]) {
+                continue;
+            }
+
+            /* do not create a file if no channel (beside the time) is present */
+            if (numberOfPorts[j] < 1) {
+                continue;
+            }
+
+            if (RETURN_OK != SetupBinaryFile(binaryBackend, &binaryComponent->files[j], compStore->channels[j], localName, ChannelStoreSuffix[j])) {
+                mcx_free(localName);
+                return RETURN_ERROR;
+            }
+        }
+        mcx_free(localName);
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus Configure(StorageBackend * backend, ResultsStorage * storage, const char * path, int flushEveryStore, int storeAtRuntime) {
+    StorageBackendBinary * binaryBackend = (StorageBackendBinary *) backend;
+
+    binaryBackend->flushEveryStore = flushEveryStore;
+    if (FALSE == storeAtRuntime) {
+        backend->needsFullStorage = 1;
+        backend->Store = StoreFull;
+        backend->Finished = FinishedFull;
+    } else {
+        backend->needsFullStorage = 0;
+        backend->Store = Store;
+        backend->Finished = Finished;
+    }
+
+    backend->storage = storage;
+
+    binaryBackend->path = mcx_string_copy(path);
+    if (!binaryBackend->path) {
+        mcx_log(LOG_ERROR, "Results: Configure: No path given");
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus Setup(StorageBackend * backend) {
+    StorageBackendBinary * binaryBackend = (StorageBackendBinary *) backend;
+    char * buffer = NULL;
+    struct stat sb;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (!binaryBackend->path) {
+        mcx_log(LOG_ERROR, "Results: No path given");
+        return RETURN_ERROR;
+    }
+
+    // make directory
+    if (0 != stat(binaryBackend->path, &sb)) {
+        buffer = mcx_string_copy(binaryBackend->path);
+        if (!buffer) {
+            return RETURN_ERROR;
+        }
+        mcx_path_to_platform(buffer);
+        retVal = mcx_os_mkdir_recursive(buffer);
+        if (RETURN_ERROR == retVal) {
+            mcx_log(LOG_ERROR, "Results: Could not make results directory \"%s\"", buffer);
+            mcx_free(buffer);
+            return RETURN_ERROR;
+        }
+        mcx_free(buffer);
+    }
+
+    retVal = SetupComponentFiles(binaryBackend);
+    if (RETURN_ERROR == retVal) {
+        return RETURN_ERROR;
+    }
+
+    return WritePPDFile(binaryBackend);
+}
+
+static McxStatus Store(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row) {
+    StorageBackendBinary * binaryBackend = (StorageBackendBinary *) backend;
+    ResultsStorage * storage = backend->storage;
+    ComponentStorage * compStore = storage->componentStorage[comp];
+    BinaryFile * binaryFile = NULL;
+
+    if (comp >= binaryBackend->numComponents) {
+        mcx_log(LOG_ERROR, "Results: No result file for element %d", comp);
+        return RETURN_ERROR;
+    }
+    binaryFile = &(binaryBackend->comps[comp].files[chType]);
+    if (!BinaryFileIsOpen(binaryFile)) {
+        // no ports to store
+        return RETURN_OK;
+    }
+
+    return StoreRow(binaryBackend, binaryFile, compStore->channels[chType], row);
+}
+
+static McxStatus Finished(StorageBackend * backend) {
+    StorageBackendBinary * binaryBackend = (StorageBackendBinary *) backend;
+    size_t i = 0;
+
+    McxStatus finishedStatus = RETURN_OK;
+
+    for (i = 0; i < binaryBackend->numComponents; i++) {
+        if (RETURN_ERROR == CloseBinaryFiles(binaryBackend, i)) {
+            finishedStatus = RETURN_ERROR;
+        }
+    }
+
+    return finishedStatus;
+}
+
+static McxStatus StoreFull(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row) {
+    UNUSED(backend);
+    UNUSED(chType);
+    UNUSED(comp);
+    UNUSED(row);
+
+    return RETURN_OK;
+}
+
+static McxStatus FinishedFull(StorageBackend * backend) {
+    StorageBackendBinary * binaryBackend = (StorageBackendBinary *) backend;
+    ResultsStorage * storage = backend->storage;
+    size_t compIdx = 0, row = 0, chType = 0;
+
+    McxStatus finishedStatus = RETURN_OK;
+
+    for (compIdx = 0; compIdx < binaryBackend->numComponents; compIdx++) {
+        ComponentStorage * compStore = storage->componentStorage[compIdx];
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            BinaryFile * binaryFile = &(binaryBackend->comps[compIdx].files[chType]);
+            ChannelStorage * chStore = compStore->channels[chType];
+
+            if (storage->channelStoreEnabled[chType] && BinaryFileIsOpen(binaryFile)) {
+                for (row = 0; row < chStore->Length(chStore); row++) {
+                    if (RETURN_OK != StoreRow(binaryBackend, binaryFile, chStore, row)) {
+                        mcx_log(LOG_ERROR, "Results: Could not write result row for %s", binaryFile->name);
+                        finishedStatus = RETURN_ERROR;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (RETURN_ERROR == CloseBinaryFiles(binaryBackend, compIdx)) {
+            finishedStatus = RETURN_ERROR;
+        }
+    }
+
+    return finishedStatus;
+}
+
+static void StorageBackendBinaryDestructor(StorageBackendBinary * binaryBackend) {
+    if (NULL != binaryBackend->comps) {
+        size_t compIdx = 0, chType = 0, i = 0;
+        for (compIdx = 0; compIdx < binaryBackend->numComponents; compIdx++) {
+            for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+                BinaryFile * binaryFile = &(binaryBackend->comps[compIdx].files[chType]);
+
+                if (binaryFile->stream) {
+                    object_destroy(binaryFile->stream);
+                }
+                if (binaryFile->mapped) {
+                    mcx_mapped_file_close(binaryFile->mapped);
+                    mcx_free(binaryFile->mapped);
+                }
+                if (binaryFile->fp) {
+                    mcx_os_fclose(binaryFile->fp);
+                }
+                if (binaryFile->columns) {
+                    for (i = 0; i < binaryFile->numColumns; i++) {
+                        ColumnDestructor(&binaryFile->columns[i]);
+                    }
+                    mcx_free(binaryFile->columns);
+                }
+                if (binaryFile->types) {
+                    mcx_free(binaryFile->types);
+                }
+                if (binaryFile->name) {
+                    mcx_free(binaryFile->name);
+                }
+            }
+        }
+        mcx_free(binaryBackend->comps);
+    }
+
+    if (NULL != binaryBackend->path) {
+        mcx_free(binaryBackend->path);
+        binaryBackend->path = NULL;
+    }
+}
+
+static StorageBackendBinary * StorageBackendBinaryCreate(StorageBackendBinary * binaryBackend) {
+    StorageBackend * backend = (StorageBackend *) binaryBackend;
+
+    binaryBackend->path = NULL;
+    binaryBackend->comps = NULL;
+    binaryBackend->numComponents = 0;
+    binaryBackend->flushEveryStore = FALSE;
+
+    backend->Configure = Configure;
+    backend->Setup = Setup;
+
+    backend->needsFullStorage = FALSE;
+
+    backend->Store = NULL;     // will be set in configure
+    backend->Finished = NULL;  // will be set in configure
+
+    return binaryBackend;
+}
+
+OBJECT_CLASS(StorageBackendBinary, StorageBackend);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif //ENABLE_STORAGE
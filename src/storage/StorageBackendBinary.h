@@ -0,0 +1,58 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_STORAGE_STORAGEBACKENDBINARY_H
+#define MCX_STORAGE_STORAGEBACKENDBINARY_H
+
+#include "storage/ResultsStorage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The binary backend writes one file <element>_<store>.mcxb per result file
+ * of the csv backend and indexes them in binary_results.ppd. The files can be
+ * converted to the csv format with the mcxb2csv tool. If the backend
+ * compresses its results, the files are gzip streams <element>_<store>.mcxb.gz
+ * of the same content. Mapped result files are preallocated and end in zero
+ * bytes until the backend has finished.
+ *
+ * All numbers are little-endian. A file consists of a header followed by
+ * chunks of rows that are stored column by column:
+ *
+ *   header:
+ *     char[8]   magic "MCXBRES\0"
+ *     uint32    format version (1)
+ *     uint32    number of channels
+ *     per channel:
+ *       uint32  type (1 double, 2 integer, 3 bool, 4 string, 5 binary)
+ *       uint32  length of the name, followed by the name without termination
+ *       uint32  length of the unit, followed by the unit without termination
+ *
+ *   chunk:
+ *     char[4]   magic "CHNK"
+ *     uint32    number of rows n
+ *     uint64    number of bytes of the columns that follow
+ *     per channel a column of n values:
+ *       double         float64
+ *       integer, bool  int32
+ *       string, binary per value: uint32 length, followed by the bytes
+ */
+
+#define BINARY_RESULTS_VERSION 1
+
+extern const struct ObjectClass _StorageBackendBinary;
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_STORAGE_STORAGEBACKENDBINARY_H */
@@ -216,7 +216,8 @@ static McxStatus SetupComponentFilesCsv(StorageBackend * backend) {
             ChannelStorage * chStore = compStore->channels[j];
             size_t chNum = chStore->GetChannelNum(chStore);
             size_t chIdx = 0;
-            const size_t nameLen = strlen(localName) + strlen(ChannelStoreSuffix[j]) + 6;
+            const char * compressionSuffix = GetCompressionFileSuffix(backend->compression);
+            const size_t nameLen = strlen(localName) + strlen(ChannelStoreSuffix[j]) + strlen(compressionSuffix) + 6;
 
             /* do not create a file if channel store is not enabled */
             if (!compStore->storage->channelStoreEnabled[j]) {
@@ -229,7 +230,7 @@ static McxStatus SetupComponentFilesCsv(StorageBackend * backend) {
             }
 
             textFile->name = (char *) mcx_calloc(nameLen, sizeof(char));
-            snprintf(textFile->name, nameLen, "%s_%s.csv", localName, ChannelStoreSuffix[j]);
+            snprintf(textFile->name, nameLen, "%s_%s.csv%s", localName, ChannelStoreSuffix[j], compressionSuffix);
 
             buffer = (char *) mcx_calloc(strlen(textBackend->path) + strlen(textFile->name) + 1 + 1, sizeof(char));
             if (!buffer) {
@@ -238,16 +239,14 @@ static McxStatus SetupComponentFilesCsv(StorageBackend * backend) {
                 return RETURN_ERROR;
             }
             sprintf(buffer, "%s/%s", textBackend->path, textFile->name);
-            textFile->fp = mcx_os_fopen(buffer, "w");
-            if (!textFile->fp) {
-                mcx_log(LOG_ERROR, "Results: Could not open result file \"%s\" for writing", buffer);
+            if (RETURN_OK != TextFileOpen(textBackend, textFile, buffer)) {
                 mcx_free(buffer);
                 mcx_free(localName);
                 return RETURN_ERROR;
             }
             mcx_free(buffer);
 
-            mcx_os_fprintf(textFile->fp, "sep=%s\n", textBackend->separator);
+            TextFilePrintf(textFile, "sep=%s\n", textBackend->separator);
 
             for (chIdx = 0; chIdx < chNum; chIdx++) {
                 ChannelInfo * info = chStore->GetChannelInfo(chStore, chIdx);
@@ -259,14 +258,14 @@ static McxStatus SetupComponentFilesCsv(StorageBackend * backend) {
                     sep = "";
                 }
                 if(quotedChannelName){
-                    mcx_os_fprintf(textFile->fp, "%s\"%s\"", sep, quotedChannelName);
+                    TextFilePrintf(textFile, "%s\"%s\"", sep, quotedChannelName);
                     mcx_free(quotedChannelName);
                 } else {
-                    mcx_os_fprintf(textFile->fp, "%s", sep);
+                    TextFilePrintf(textFile, "%s", sep);
                 }
 
             }
-            mcx_os_fprintf(textFile->fp, "\n");
+            TextFilePrintf(textFile, "\n");
 
             for (chIdx = 0; chIdx < chNum; chIdx++) {
                 ChannelInfo * info = chStore->GetChannelInfo(chStore, chIdx);
@@ -275,9 +274,9 @@ static McxStatus SetupComponentFilesCsv(StorageBackend * backend) {
                 if (chIdx == 0) {
                     sep = "";
                 }
-                mcx_os_fprintf(textFile->fp, "%s%s", sep, channelUnit);
+                TextFilePrintf(textFile, "%s%s", sep, channelUnit);
             }
-            mcx_os_fprintf(textFile->fp, "\n");
+            TextFilePrintf(textFile, "\n");
         }
         mcx_free(localName);
     }
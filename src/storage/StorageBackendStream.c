@@ -0,0 +1,748 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_STORAGE) && defined (ENABLE_MT)
+
+#include "core/channels/ChannelInfo.h"
+#include "storage/StorageBackendStream.h"
+#include "storage/ComponentStorage.h"
+#include "storage/ChannelStorage.h"
+
+#include "reader/task/StreamChannelInput.h"
+
+#include "util/atomic.h"
+#include "util/mutex.h"
+#include "util/socket.h"
+#include "util/string.h"
+#include "util/threads.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// how long the sender waits for a subscriber before it checks for the end of the simulation
+#define STREAM_ACCEPT_TIMEOUT_MS 100
+// a subscriber that does not read for this long is disconnected
+#define STREAM_SEND_TIMEOUT_MS 5000
+
+#define STREAM_DEFAULT_QUEUE_SIZE 64
+
+// offsets of the fields of a frame
+#define FRAME_SIZE_OFFSET 4
+#define FRAME_SEQUENCE_OFFSET 8
+#define FRAME_DROPPED_OFFSET 16
+#define FRAME_TIME_OFFSET 24
+#define FRAME_ROWS_OFFSET 32
+#define FRAME_HEADER_SIZE 36
+
+typedef struct StreamBuffer {
+    char * data;
+    size_t size;
+    size_t capacity;
+} StreamBuffer;
+
+// the selected ports of a port storage
+typedef struct StreamTable {
+    uint32_t index;
+    size_t numColumns;
+    size_t * columns; // columns of the port storage
+} StreamTable;
+
+typedef struct StorageBackendStream {
+    StorageBackend _;
+
+    int tcpPort;
+    size_t queueSize;
+
+    size_t numSelected;
+    char ** selectedElements;
+    char ** selectedPorts; // NULL selects all ports of the element
+
+    size_t numComponents;
+    StreamTable * tables; // per element and port storage
+    StreamBuffer header;
+
+    // frame that is filled by Store, components may be stored concurrently
+    McxMutex frameLock;
+    StreamBuffer frame;
+    double frameTime; // latest time of the rows in the frame
+    uint32_t frameRows;
+    uint64_t sequence;
+
+    // ring of complete frames that are sent by the sender thread
+    McxMutex queueLock;
+    StreamBuffer * queue;
+    size_t queueFirst;
+    size_t queueCount;
+    uint64_t numDropped;
+    StreamBuffer sending; // frame that is sent by the sender thread
+
+    McxSocket listener;
+    McxThread thread;
+    int running;
+    int socketStarted;
+
+    McxAtomic signal; // incremented when frames are queued
+    McxAtomic stop;
+    McxAtomic connected;
+} StorageBackendStream;
+
+// ----------------------------------------------------------------------
+// Buffers
+
+static int IsLittleEndian(void) {
+    const uint16_t one = 1;
+
+    return * (const char *) &one;
+}
+
+static McxStatus BufferReserve(StreamBuffer * buffer, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        char * data = NULL;
+
+        while (capacity < buffer->size + size) {
+            capacity *= 2;
+        }
+        data = (char *) mcx_realloc(buffer->data, capacity);
+        if (!data) {
+            return RETURN_ERROR;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    return RETURN_OK;
+}
+
+// writes the number of size bytes in little-endian byte order to dest
+static void PutNumber(char * dest, const void * value, size_t size) {
+    size_t i = 0;
+
+    if (IsLittleEndian()) {
+        memcpy(dest, value, size);
+    } else {
+        for (i = 0; i < size; i++) {
+            dest[i] = ((const char *) value)[size - 1 - i];
+        }
+    }
+}
+
+static McxStatus BufferAppendNumber(StreamBuffer * buffer, const void * value, size_t size) {
+    if (RETURN_OK != BufferReserve(buffer, size)) {
+        return RETURN_ERROR;
+    }
+    PutNumber(buffer->data + buffer->size, value, size);
+    buffer->size += size;
+
+    return RETURN_OK;
+}
+
+static McxStatus BufferAppendUInt32(StreamBuffer * buffer, uint32_t value) {
+    return BufferAppendNumber(buffer, &value, sizeof(value));
+}
+
+// appends the length of str followed by str
+static McxStatus BufferAppendString(StreamBuffer * buffer, const char * str) {
+    size_t len = str ? strlen(str) : 0;
+
+    if (RETURN_OK != BufferAppendUInt32(buffer, (uint32_t) len)) {
+        return RETURN_ERROR;
+    }
+    if (RETURN_OK != BufferReserve(buffer, len)) {
+        return RETURN_ERROR;
+    }
+    if (len > 0) {
+        memcpy(buffer->data + buffer->size, str, len);
+    }
+    buffer->size += len;
+
+    return RETURN_OK;
+}
+
+static void BufferDestructor(StreamBuffer * buffer) {
+    if (buffer->data) {
+        mcx_free(buffer->data);
+    }
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+static void BufferSwap(StreamBuffer * a, StreamBuffer * b) {
+    StreamBuffer tmp = * a;
+    * a = * b;
+    * b = tmp;
+}
+
+// ----------------------------------------------------------------------
+// Sender
+
+// removes all queued frames
+static void StreamClearQueue(StorageBackendStream * stream) {
+    mcx_mutex_lock(&stream->queueLock);
+    stream->queueFirst = 0;
+    stream->queueCount = 0;
+    mcx_mutex_unlock(&stream->queueLock);
+}
+
+// moves the oldest queued frame to sending, returns FALSE if there is none
+static int StreamPopFrame(StorageBackendStream * stream) {
+    int popped = FALSE;
+
+    mcx_mutex_lock(&stream->queueLock);
+    if (stream->queueCount > 0) {
+        BufferSwap(&stream->queue[stream->queueFirst], &stream->sending);
+        stream->queueFirst = (stream->queueFirst + 1) % stream->queueSize;
+        stream->queueCount--;
+        PutNumber(stream->sending.data + FRAME_DROPPED_OFFSET, &stream->numDropped, sizeof(stream->numDropped));
+        popped = TRUE;
+    }
+    mcx_mutex_unlock(&stream->queueLock);
+
+    return popped;
+}
+
+static McxThreadReturn StreamSenderThread(void * param) {
+    StorageBackendStream * stream = (StorageBackendStream *) param;
+    McxSocket client = INVALID_SOCKET;
+
+    while (1) {
+        int32_t signal = mcx_atomic_load(&stream->signal);
+        int stop = mcx_atomic_load(&stream->stop);
+
+        if (INVALID_SOCKET == client) {
+            if (stop) {
+                break;
+            }
+
+            client = mcx_socket_accept(stream->listener, STREAM_ACCEPT_TIMEOUT_MS);
+            if (INVALID_SOCKET == client) {
+                continue;
+            }
+
+            mcx_socket_set_send_timeout(client, STREAM_SEND_TIMEOUT_MS);
+            mcx_socket_set_nodelay(client, TRUE);
+            if (mcx_socket_send_all(client, stream->header.data, stream->header.size)) {
+                mcx_socket_close(client);
+                client = INVALID_SOCKET;
+                continue;
+            }
+
+            mcx_log(LOG_INFO, "Results: Stream subscriber connected");
+            mcx_atomic_store(&stream->connected, TRUE);
+            continue;
+        }
+
+        if (StreamPopFrame(stream)) {
+            if (mcx_socket_send_all(client, stream->sending.data, stream->sending.size)) {
+                mcx_log(LOG_INFO, "Results: Stream subscriber disconnected");
+                mcx_atomic_store(&stream->connected, FALSE);
+                StreamClearQueue(stream);
+                mcx_socket_close(client);
+                client = INVALID_SOCKET;
+            }
+            continue;
+        }
+
+        // frames queued before the stop request have been sent
+        if (stop) {
+            break;
+        }
+        mcx_atomic_wait(&stream->signal, signal);
+    }
+
+    if (INVALID_SOCKET != client) {
+        mcx_atomic_store(&stream->connected, FALSE);
+        mcx_socket_close(client);
+    }
+
+    return 0;
+}
+
+// queues the current frame for time, dropping the oldest queued frame if the queue is full
+static void StreamPublishFrame(StorageBackendStream * stream, double time) {
+    uint32_t size = 0;
+    size_t slot = 0;
+
+    if (0 == stream->frameRows) {
+        return;
+    }
+
+    if (!mcx_atomic_load(&stream->connected)) {
+        stream->frame.size = 0;
+        stream->frameRows = 0;
+        return;
+    }
+
+    size = (uint32_t) (stream->frame.size - FRAME_SEQUENCE_OFFSET);
+    PutNumber(stream->frame.data + FRAME_SIZE_OFFSET, &size, sizeof(size));
+    PutNumber(stream->frame.data + FRAME_SEQUENCE_OFFSET, &stream->sequence, sizeof(stream->sequence));
+    PutNumber(stream->frame.data + FRAME_TIME_OFFSET, &time, sizeof(time));
+    PutNumber(stream->frame.data + FRAME_ROWS_OFFSET, &stream->frameRows, sizeof(stream->frameRows));
+    stream->sequence++;
+
+    mcx_mutex_lock(&stream->queueLock);
+    if (stream->queueCount == stream->queueSize) {
+        stream->queueFirst = (stream->queueFirst + 1) % stream->queueSize;
+        stream->queueCount--;
+        stream->numDropped++;
+    }
+    // the frame takes over the buffer of the slot, which is free or dropped
+    slot = (stream->queueFirst + stream->queueCount) % stream->queueSize;
+    BufferSwap(&stream->queue[slot], &stream->frame);
+    stream->queueCount++;
+    mcx_mutex_unlock(&stream->queueLock);
+
+    stream->frame.size = 0;
+    stream->frameRows = 0;
+
+    mcx_atomic_fetch_add(&stream->signal, 1);
+    mcx_atomic_wake_all(&stream->signal);
+}
+
+// ----------------------------------------------------------------------
+// Tables
+
+static int IsSelected(StorageBackendStream * stream, const char * element, const char * port) {
+    size_t i = 0;
+
+    if (0 == stream->numSelected) {
+        return TRUE;
+    }
+
+    for (i = 0; i < stream->numSelected; i++) {
+        if (!strcmp(stream->selectedElements[i], element)
+            && (!stream->selectedPorts[i] || !strcmp(stream->selectedPorts[i], port))) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static int IsNumeric(ChannelType type) {
+    return CHANNEL_DOUBLE == type || CHANNEL_INTEGER == type || CHANNEL_BOOL == type;
+}
+
+static McxStatus SetupTables(StorageBackendStream * stream) {
+    StorageBackend * backend = (StorageBackend *) stream;
+    ResultsStorage * storage = backend->storage;
+    uint32_t numTables = 0;
+    size_t compIdx = 0, chType = 0, col = 0;
+
+    stream->tables = (StreamTable *) mcx_calloc(storage->numComponents * CHANNEL_STORE_NUM, sizeof(StreamTable));
+    if (storage->numComponents > 0 && !stream->tables) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for stream tables failed");
+        return RETURN_ERROR;
+    }
+    stream->numComponents = storage->numComponents;
+
+    for (compIdx = 0; compIdx < stream->numComponents; compIdx++) {
+        ComponentStorage * compStore = storage->componentStorage[compIdx];
+        Component * comp = (Component *) compStore->comp;
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            StreamTable * table = &stream->tables[compIdx * CHANNEL_STORE_NUM + chType];
+            ChannelStorage * chStore = compStore->channels[chType];
+            size_t numChannels = chStore->GetChannelNum(chStore);
+
+            if (!storage->channelStoreEnabled[chType] || numChannels < 2) {
+                continue;
+            }
+
+            table->columns = (size_t *) mcx_calloc(numChannels, sizeof(size_t));
+            if (!table->columns) {
+                mcx_log(LOG_ERROR, "Results: Memory allocation for stream tables failed");
+                return RETURN_ERROR;
+            }
+
+            // column 0 is the time
+            for (col = 1; col < numChannels; col++) {
+                ChannelInfo * info = chStore->GetChannelInfo(chStore, col);
+
+                if (IsNumeric(info->GetType(info)) && IsSelected(stream, comp->GetName(comp), info->GetName(info))) {
+                    table->columns[table->numColumns++] = col;
+                }
+            }
+
+            if (table->numColumns > 0) {
+                table->index = numTables++;
+            }
+        }
+    }
+
+    if (0 == numTables) {
+        mcx_log(LOG_WARNING, "Results: The stream backend does not publish any port");
+    }
+
+    // header
+    if (RETURN_OK != BufferReserve(&stream->header, 8)) {
+        return RETURN_ERROR;
+    }
+    memcpy(stream->header.data, "MCXSTRM", 8);
+    stream->header.size = 8;
+
+    if (RETURN_OK != BufferAppendUInt32(&stream->header, STREAM_RESULTS_VERSION)
+        || RETURN_OK != BufferAppendUInt32(&stream->header, numTables)) {
+        return RETURN_ERROR;
+    }
+
+    for (compIdx = 0; compIdx < stream->numComponents; compIdx++) {
+        ComponentStorage * compStore = storage->componentStorage[compIdx];
+        Component * comp = (Component *) compStore->comp;
+
+        for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
+            StreamTable * table = &stream->tables[compIdx * CHANNEL_STORE_NUM + chType];
+            ChannelStorage * chStore = compStore->channels[chType];
+
+            if (0 == table->numColumns) {
+                continue;
+            }
+
+            if (RETURN_OK != BufferAppendString(&stream->header, comp->GetName(comp))
+                || RETURN_OK != BufferAppendUInt32(&stream->header, (uint32_t) chType)
+                || RETURN_OK != BufferAppendUInt32(&stream->header, (uint32_t) table->numColumns)) {
+                return RETURN_ERROR;
+            }
+            for (col = 0; col < table->numColumns; col++) {
+                ChannelInfo * info = chStore->GetChannelInfo(chStore, table->columns[col]);
+                if (RETURN_OK != BufferAppendString(&stream->header, info->GetName(info))) {
+                    return RETURN_ERROR;
+                }
+            }
+        }
+    }
+
+    return RETURN_OK;
+}
+
+// ----------------------------------------------------------------------
+// Backend
+
+McxStatus StorageBackendStreamRead(StorageBackend * backend, BackendInput * input) {
+    StorageBackendStream * stream = (StorageBackendStream *) backend;
+    ObjectContainer * channels = input->channels;
+    size_t i = 0;
+
+    if (input->tcpPort.defined) {
+        if (input->tcpPort.value < 0 || input->tcpPort.value > 65535) {
+            mcx_log(LOG_ERROR, "Results: Invalid TCP port %d of the stream backend", input->tcpPort.value);
+            return RETURN_ERROR;
+        }
+        stream->tcpPort = input->tcpPort.value;
+    }
+    if (input->queueSize.defined) {
+        stream->queueSize = input->queueSize.value;
+    }
+
+    stream->numSelected = channels->Size(channels);
+    if (0 == stream->numSelected) {
+        return RETURN_OK;
+    }
+
+    stream->selectedElements = (char **) mcx_calloc(stream->numSelected, sizeof(char *));
+    stream->selectedPorts = (char **) mcx_calloc(stream->numSelected, sizeof(char *));
+    if (!stream->selectedElements || !stream->selectedPorts) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for the ports of the stream backend failed");
+        return RETURN_ERROR;
+    }
+
+    for (i = 0; i < stream->numSelected; i++) {
+        StreamChannelInput * channel = (StreamChannelInput *) channels->At(channels, i);
+
+        stream->selectedElements[i] = mcx_string_copy(channel->element);
+        stream->selectedPorts[i] = mcx_string_copy(channel->port);
+        if (!stream->selectedElements[i] || (channel->port && !stream->selectedPorts[i])) {
+            mcx_log(LOG_ERROR, "Results: Memory allocation for the ports of the stream backend failed");
+            return RETURN_ERROR;
+        }
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus Store(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row) {
+    StorageBackendStream * stream = (StorageBackendStream *) backend;
+    ComponentStorage * compStore = backend->storage->componentStorage[comp];
+    ChannelStorage * chStore = compStore->channels[chType];
+    StreamTable * table = NULL;
+    ChannelValue timeValue;
+    double time = 0.0;
+    size_t col = 0;
+
+    McxStatus retVal = RETURN_OK;
+
+    if (comp >= stream->numComponents) {
+        mcx_log(LOG_ERROR, "Results: No stream table for element %d", comp);
+        return RETURN_ERROR;
+    }
+    table = &stream->tables[comp * CHANNEL_STORE_NUM + chType];
+
+    // nobody is listening
+    if (0 == table->numColumns || !mcx_atomic_load(&stream->connected)) {
+        return RETURN_OK;
+    }
+
+    timeValue = chStore->GetValueAt(chStore, row, 0);
+    time = timeValue.value.d;
+
+    mcx_mutex_lock(&stream->frameLock);
+
+    // the frame collects the rows of one synchronization step, it is published in Synchronized
+    if (0 == stream->frameRows) {
+        retVal = BufferReserve(&stream->frame, FRAME_HEADER_SIZE);
+        if (RETURN_OK != retVal) {
+            goto cleanup;
+        }
+        memcpy(stream->frame.data, "FRME", 4);
+        stream->frame.size = FRAME_HEADER_SIZE;
+        stream->frameTime = time;
+    } else if (time > stream->frameTime) {
+        stream->frameTime = time;
+    }
+
+    retVal = BufferAppendUInt32(&stream->frame, table->index);
+    if (RETURN_OK == retVal) {
+        retVal = BufferAppendNumber(&stream->frame, &time, sizeof(time));
+    }
+    for (col = 0; RETURN_OK == retVal && col < table->numColumns; col++) {
+        ChannelValue val = chStore->GetValueAt(chStore, row, table->columns[col]);
+        double value = CHANNEL_DOUBLE == ChannelValueType(&val) ? val.value.d : (double) val.value.i;
+
+        retVal = BufferAppendNumber(&stream->frame, &value, sizeof(value));
+    }
+    if (RETURN_OK != retVal) {
+        // drop the incomplete frame
+        stream->frame.size = 0;
+        stream->frameRows = 0;
+        goto cleanup;
+    }
+    stream->frameRows++;
+
+cleanup:
+    mcx_mutex_unlock(&stream->frameLock);
+
+    if (RETURN_OK != retVal) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for stream frame failed");
+    }
+
+    return retVal;
+}
+
+static McxStatus Synchronized(StorageBackend * backend, double time) {
+    StorageBackendStream * stream = (StorageBackendStream *) backend;
+
+    mcx_mutex_lock(&stream->frameLock);
+    StreamPublishFrame(stream, time);
+    mcx_mutex_unlock(&stream->frameLock);
+
+    return RETURN_OK;
+}
+
+static McxStatus Finished(StorageBackend * backend) {
+    StorageBackendStream * stream = (StorageBackendStream *) backend;
+    long ret = 0;
+
+    // rows stored after the last synchronization step
+    mcx_mutex_lock(&stream->frameLock);
+    StreamPublishFrame(stream, stream->frameTime);
+    mcx_mutex_unlock(&stream->frameLock);
+
+    if (stream->running) {
+        mcx_atomic_store(&stream->stop, TRUE);
+        mcx_atomic_fetch_add(&stream->signal, 1);
+        mcx_atomic_wake_all(&stream->signal);
+        mcx_thread_join(stream->thread, &ret);
+        stream->running = FALSE;
+    }
+
+    if (INVALID_SOCKET != stream->listener) {
+        mcx_socket_close(stream->listener);
+        stream->listener = INVALID_SOCKET;
+    }
+
+    if (stream->numDropped > 0) {
+        mcx_log(LOG_WARNING, "Results: Dropped %llu frames of the result stream because the subscriber could not keep up",
+            (unsigned long long) stream->numDropped);
+    }
+
+    return RETURN_OK;
+}
+
+static McxStatus Configure(StorageBackend * backend, ResultsStorage * storage, const char * path, int flushEveryStore, int storeAtRuntime) {
+    UNUSED(path);
+    UNUSED(flushEveryStore);
+
+    if (FALSE == storeAtRuntime) {
+        mcx_log(LOG_WARNING, "Results: The stream backend always publishes the results at runtime");
+    }
+
+    backend->needsFullStorage = 0;
+    backend->Store = Store;
+    backend->Finished = Finished;
+    backend->Synchronized = Synchronized;
+
+    backend->storage = storage;
+
+    return RETURN_OK;
+}
+
+static McxStatus Setup(StorageBackend * backend) {
+    StorageBackendStream * stream = (StorageBackendStream *) backend;
+
+    if (stream->tables) {
+        mcx_log(LOG_ERROR, "Results: Re-setting up backend");
+        return RETURN_ERROR;
+    }
+
+    if (RETURN_OK != SetupTables(stream)) {
+        return RETURN_ERROR;
+    }
+
+    stream->queue = (StreamBuffer *) mcx_calloc(stream->queueSize, sizeof(StreamBuffer));
+    if (!stream->queue) {
+        mcx_log(LOG_ERROR, "Results: Memory allocation for stream queue failed");
+        return RETURN_ERROR;
+    }
+
+    if (mcx_socket_startup()) {
+        mcx_log(LOG_ERROR, "Results: Could not initialize sockets for the result stream");
+        return RETURN_ERROR;
+    }
+    stream->socketStarted = TRUE;
+
+    stream->listener = mcx_socket_listen_local(stream->tcpPort);
+    if (INVALID_SOCKET == stream->listener) {
+        mcx_log(LOG_ERROR, "Results: Could not listen on port %d for result stream subscribers", stream->tcpPort);
+        return RETURN_ERROR;
+    }
+
+    if (mcx_thread_create(&stream->thread, (McxThreadStartRoutine) StreamSenderThread, stream)) {
+        mcx_log(LOG_ERROR, "Results: Could not create result stream thread");
+        return RETURN_ERROR;
+    }
+    stream->running = TRUE;
+
+    mcx_log(LOG_INFO, "Results: Streaming results on 127.0.0.1:%d", mcx_socket_get_port(stream->listener));
+
+    return RETURN_OK;
+}
+
+static void StorageBackendStreamDestructor(StorageBackendStream * stream) {
+    size_t i = 0;
+
+    if (stream->running) {
+        Finished((StorageBackend *) stream);
+    }
+    if (INVALID_SOCKET != stream->listener) {
+        mcx_socket_close(stream->listener);
+    }
+    if (stream->socketStarted) {
+        mcx_socket_cleanup();
+    }
+
+    if (stream->tables) {
+        for (i = 0; i < stream->numComponents * CHANNEL_STORE_NUM; i++) {
+            if (stream->tables[i].columns) {
+                mcx_free(stream->tables[i].columns);
+            }
+        }
+        mcx_free(stream->tables);
+    }
+
+    if (stream->queue) {
+        for (i = 0; i < stream->queueSize; i++) {
+            BufferDestructor(&stream->queue[i]);
+        }
+        mcx_free(stream->queue);
+    }
+    BufferDestructor(&stream->header);
+    BufferDestructor(&stream->frame);
+    BufferDestructor(&stream->sending);
+
+    for (i = 0; i < stream->numSelected; i++) {
+        if (stream->selectedElements && stream->selectedElements[i]) {
+            mcx_free(stream->selectedElements[i]);
+        }
+        if (stream->selectedPorts && stream->selectedPorts[i]) {
+            mcx_free(stream->selectedPorts[i]);
+        }
+    }
+    if (stream->selectedElements) {
+        mcx_free(stream->selectedElements);
+    }
+    if (stream->selectedPorts) {
+        mcx_free(stream->selectedPorts);
+    }
+
+    mcx_mutex_destroy(&stream->frameLock);
+    mcx_mutex_destroy(&stream->queueLock);
+}
+
+static StorageBackendStream * StorageBackendStreamCreate(StorageBackendStream * stream) {
+    StorageBackend * backend = (StorageBackend *) stream;
+
+    backend->Configure = Configure;
+    backend->Setup = Setup;
+    backend->Store = NULL;     // will be set in configure
+    backend->Finished = NULL;  // will be set in configure
+
+    backend->needsFullStorage = FALSE;
+
+    // the rows are published while the simulation runs, independent of the other backends
+    backend->immediate = TRUE;
+
+    stream->tcpPort = 0;
+    stream->queueSize = STREAM_DEFAULT_QUEUE_SIZE;
+
+    stream->numSelected = 0;
+    stream->selectedElements = NULL;
+    stream->selectedPorts = NULL;
+
+    stream->numComponents = 0;
+    stream->tables = NULL;
+    memset(&stream->header, 0, sizeof(StreamBuffer));
+
+    mcx_mutex_create(&stream->frameLock);
+    memset(&stream->frame, 0, sizeof(StreamBuffer));
+    stream->frameTime = 0.0;
+    stream->frameRows = 0;
+    stream->sequence = 0;
+
+    mcx_mutex_create(&stream->queueLock);
+    stream->queue = NULL;
+    stream->queueFirst = 0;
+    stream->queueCount = 0;
+    stream->numDropped = 0;
+    memset(&stream->sending, 0, sizeof(StreamBuffer));
+
+    stream->listener = INVALID_SOCKET;
+    stream->running = FALSE;
+    stream->socketStarted = FALSE;
+
+    mcx_atomic_store(&stream->signal, 0);
+    mcx_atomic_store(&stream->stop, FALSE);
+    mcx_atomic_store(&stream->connected, FALSE);
+
+    return stream;
+}
+
+OBJECT_CLASS(StorageBackendStream, StorageBackend);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // ENABLE_STORAGE && ENABLE_MT
@@ -0,0 +1,69 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_STORAGE_STORAGEBACKENDSTREAM_H
+#define MCX_STORAGE_STORAGEBACKENDSTREAM_H
+
+#include "storage/ResultsStorage.h"
+#include "reader/task/BackendInput.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The stream backend publishes the selected numeric ports while the
+ * simulation runs to one subscriber at a time that connects to a TCP port
+ * of the loopback interface. All rows that are stored in one synchronization
+ * step are sent as one frame. The rows reach the backend when the elements
+ * store them, also if other backends use full storage or the result writer
+ * thread. Frames are queued for a sender thread; if the
+ * subscriber does not keep up, the oldest queued frames are dropped, so the
+ * simulation is never blocked by the subscriber.
+ *
+ * All numbers are little-endian. The subscriber first receives a header,
+ * followed by frames:
+ *
+ *   header:
+ *     char[8]   magic "MCXSTRM\0"
+ *     uint32    format version (2)
+ *     uint32    number of tables
+ *     per table (the selected ports of one result file of an element):
+ *       uint32  length of the element name, followed by the name without termination
+ *       uint32  port storage (0 in, 1 out, 2 local, 3 RTFactor)
+ *       uint32  number of ports
+ *       per port:
+ *         uint32 length of the name, followed by the name without termination
+ *
+ *   frame:
+ *     char[4]   magic "FRME"
+ *     uint32    number of bytes of the frame that follow
+ *     uint64    sequence number, gaps are dropped frames
+ *     uint64    number of frames dropped so far
+ *     float64   end time of the synchronization step
+ *     uint32    number of rows
+ *     per row:
+ *       uint32  index of the table
+ *       float64 time of the row
+ *       float64 value per port of the table
+ */
+
+#define STREAM_RESULTS_VERSION 2
+
+extern const struct ObjectClass _StorageBackendStream;
+
+/* takes the port, queue size and port selection of the stream backend from input */
+McxStatus StorageBackendStreamRead(StorageBackend * backend, BackendInput * input);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif /* MCX_STORAGE_STORAGEBACKENDSTREAM_H */
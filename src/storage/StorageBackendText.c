@@ -16,8 +16,10 @@
 
 #include "util/paths.h"
 #include "util/os.h"
+#include "util/format.h"
 
 #include <locale.h>     /* struct lconv, setlocale, localeconv */
+#include <stdarg.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,7 +32,105 @@ static McxStatus Finished(StorageBackend * backend);
 static McxStatus StoreFull(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row);
 static McxStatus FinishedFull(StorageBackend * backend);
 
+McxStatus TextFileOpen(StorageBackendText * textBackend, TextFile * textFile, const char * path) {
+    StorageBackend * backend = (StorageBackend *) textBackend;
+
+    if (backend->mapped) {
+        textFile->mapped = (McxMappedFile *) mcx_calloc(1, sizeof(McxMappedFile));
+        if (!textFile->mapped) {
+            mcx_log(LOG_ERROR, "Results: Memory allocation for mapped result file \"%s\" failed", path);
+            return RETURN_ERROR;
+        }
+        if (mcx_mapped_file_open(textFile->mapped, path)) {
+            mcx_log(LOG_ERROR, "Results: Could not open result file \"%s\" for writing", path);
+            mcx_free(textFile->mapped);
+            textFile->mapped = NULL;
+            return RETURN_ERROR;
+        }
+        return RETURN_OK;
+    }
+
+    textFile->fp = mcx_os_fopen(path, COMPRESSION_NONE == backend->compression ? "w" : "wb");
+    if (!textFile->fp) {
+        mcx_log(LOG_ERROR, "Results: Could not open result file \"%s\" for writing", path);
+        return RETURN_ERROR;
+    }
+
+    if (COMPRESSION_NONE != backend->compression) {
+        textFile->stream = (CompressedStream *) object_create(CompressedStream);
+        if (!textFile->stream) {
+            mcx_log(LOG_ERROR, "Results: Could not create compressed stream for \"%s\"", path);
+            return RETURN_ERROR;
+        }
+        if (RETURN_OK != textFile->stream->Open(textFile->stream, textFile->fp, textFile->name, backend->compression, backend->compressor)) {
+            return RETURN_ERROR;
+        }
+    }
+
+    return RETURN_OK;
+}
+
+McxStatus TextFileWrite(TextFile * textFile, const char * data, size_t size) {
+    if (textFile->stream) {
+        return textFile->stream->Write(textFile->stream, data, size);
+    }
+
+    if (textFile->mapped) {
+        if (mcx_mapped_file_write(textFile->mapped, data, size)) {
+            mcx_log(LOG_ERROR, "Results: Could not write results to mapped file \"%s\"", textFile->name);
+            return RETURN_ERROR;
+        }
+        return RETURN_OK;
+    }
+
+    if (size > 0 && 1 != fwrite(data, size, 1, textFile->fp)) {
+        mcx_log(LOG_ERROR, "Results: fwrite failed!");
+        return RETURN_ERROR;
+    }
+
+    return RETURN_OK;
+}
+
+McxStatus TextFilePrintf(TextFile * textFile, const char * format, ...) {
+    char buffer[SIZE];
+    char * str = buffer;
+    va_list args;
+    int len = 0;
+    McxStatus retVal = RETURN_OK;
+
+    va_start(args, format);
+    len = vsnprintf(buffer, SIZE, format, args);
+    va_end(args);
+
+    if (len < 0) {
+        mcx_log(LOG_ERROR, "Results: Could not format output of \"%s\"", textFile->name);
+        return RETURN_ERROR;
+    }
+    if (len >= SIZE) {
+        str = (char *) mcx_malloc((size_t) len + 1);
+        if (!str) {
+            mcx_log(LOG_ERROR, "Results: Memory allocation for output of \"%s\" failed", textFile->name);
+            return RETURN_ERROR;
+        }
+        va_start(args, format);
+        vsnprintf(str, (size_t) len + 1, format, args);
+        va_end(args);
+    }
+
+    retVal = TextFileWrite(textFile, str, (size_t) len);
+
+    if (str != buffer) {
+        mcx_free(str);
+    }
+
+    return retVal;
+}
+
 static McxStatus FlushTextFile(TextFile * textFile) {
+    if (textFile->stream) {
+        return textFile->stream->Flush(textFile->stream);
+    }
+
     if (fflush(textFile->fp)) {
         int errsv = errno;
         mcx_log(LOG_DEBUG, "Results: Flushing result file \"%s\"!", textFile->name);
@@ -54,6 +154,22 @@ static McxStatus CloseTextFiles(StorageBackendText * backend, size_t comp) {
     }
     for (i = 0; i < CHANNEL_STORE_NUM; i++) {
         TextFile * textFile = &(backend->comps[comp].files[i]);
+        if (textFile && textFile->stream) {
+            if (RETURN_OK != textFile->stream->Close(textFile->stream)) {
+                mcx_log(LOG_ERROR, "Results: Could not finish compressed result file \"%s\"", textFile->name);
+                retVal = RETURN_ERROR;
+            }
+            object_destroy(textFile->stream);
+        }
+        if (textFile && textFile->mapped) {
+            mcx_log(LOG_DEBUG, "Results: Closing result file \"%s\"!", textFile->name);
+            if (mcx_mapped_file_close(textFile->mapped)) {
+                mcx_log(LOG_ERROR, "Results: Could not close result file \"%s\"", textFile->name);
+                retVal = RETURN_ERROR;
+            }
+            mcx_free(textFile->mapped);
+            textFile->mapped = NULL;
+        }
         if (textFile && textFile->fp) {
             mcx_log(LOG_DEBUG, "Results: Closing result file \"%s\"!", textFile->name);
             if (mcx_os_fclose(textFile->fp)) {
@@ -68,7 +184,7 @@ static McxStatus CloseTextFiles(StorageBackendText * backend, size_t comp) {
         }
         textFile->fp = NULL;
     }
-    return RETURN_OK;
+    return retVal;
 }
 
 static McxStatus Configure(StorageBackend * backend, ResultsStorage * storage, const char * path, int flushEveryStore, int storeAtRuntime) {
@@ -157,106 +273,139 @@ static McxStatus Setup(StorageBackend * backend) {
     return textBackend->WritePPDFile(backend);
 }
 
-static char * QuoteString(const char * _str) {
-    char * str = (char *)_str;
-    char * newStr = NULL;
-
-    size_t i = 0;
+static McxStatus ReserveRowBuffer(TextFile * textFile, size_t pos, size_t needed) {
+    size_t capacity = textFile->rowCapacity;
+    char * buffer = NULL;
 
-    if (!str) {
-        return NULL;
+    if (pos + needed <= capacity) {
+        return RETURN_OK;
     }
 
-    newStr = (char *) mcx_calloc(strlen(str) * 2 + 1, sizeof(char));
-
-    if (!newStr) {
-        return NULL;
+    if (capacity < 256) {
+        capacity = 256;
+    }
+    while (capacity < pos + needed) {
+        capacity *= 2;
     }
 
-    /* copy _str quoting '"':
-     *
-     * From https://tools.ietf.org/html/rfc4180#section-2
-     *
-     *    7.  If double-quotes are used to enclose fields, then a double-quote
-     *        appearing inside a field must be escaped by preceding it with
-     *        another double quote.  For example:
-     *
-     *    "aaa","b""bb","ccc"
-     */
-    while (*str) {
-        if (*str == '\"') {
-            newStr[i++] = '\"';
-            newStr[i++] = '\"';
-        } else {
-            newStr[i++] = *str;
-        }
-        str++;
+    buffer = (char *) mcx_realloc(textFile->rowBuffer, capacity);
+    if (!buffer) {
+        mcx_log(LOG_ERROR, "Results: Could not allocate row buffer for \"%s\"", textFile->name);
+        return RETURN_ERROR;
     }
+    textFile->rowBuffer = buffer;
+    textFile->rowCapacity = capacity;
+
+    return RETURN_OK;
+}
 
-    return newStr;
+static int IsSpecialChar(unsigned char c) {
+    // don't allow control characters
+    return (c < ' ' || c > '~');
 }
 
-static McxStatus WriteRow(FILE * file, ChannelStorage * chStore, size_t row, const char * separator) {
+/* The whole row is formatted into the row buffer of the file and written
+ * with a single fwrite. Strings and binaries are formatted as by
+ * ChannelValueToString and quoted. */
+static McxStatus WriteRow(TextFile * textFile, ChannelStorage * chStore, size_t row, const char * separator) {
+    static const char hexDigits[] = "0123456789abcdef";
     size_t channel = 0;
     const size_t numChannels = chStore->GetChannelNum(chStore);
-    char staticBuffer[32];
-    int storedLen = 0;
+    const size_t sepLen = strlen(separator);
+    const unsigned precision = 13;
+    size_t pos = 0;
+    char * buffer = NULL;
 
-    if (!file) {
+    if (!textFile->fp && !textFile->mapped) {
         mcx_log(LOG_ERROR, "Results: null-file pointer!");
         return RETURN_ERROR;
     }
 
     for (channel = 0; channel < numChannels; channel++) {
-        McxStatus retVal = RETURN_OK;
         ChannelValue val = chStore->GetValueAt(chStore, row, channel);
-        const char * sep = separator;
-        if (channel == 0) { // leave out separator at the beginning
-            sep = "";
+        size_t needed = sepLen + MCX_FORMAT_BUFFER_SIZE;
+        size_t i = 0;
+
+        switch (ChannelValueType(&val)) {
+        case CHANNEL_STRING:
+            needed += val.value.s ? 2 * strlen(val.value.s) : 0;
+            break;
+        case CHANNEL_BINARY:
+        case CHANNEL_BINARY_REFERENCE:
+            needed += val.value.b.data ? 4 * val.value.b.len : 0;
+            break;
+        default:
+            break;
+        }
+
+        if (RETURN_OK != ReserveRowBuffer(textFile, pos, needed)) {
+            return RETURN_ERROR;
         }
+        buffer = textFile->rowBuffer;
+
+        if (channel > 0) { // leave out separator at the beginning
+            memcpy(buffer + pos, separator, sepLen);
+            pos += sepLen;
+        }
+
         switch (ChannelValueType(&val)) {
         case CHANNEL_DOUBLE:
+            pos += mcx_format_double_exp(val.value.d, precision, buffer + pos, MCX_FORMAT_BUFFER_SIZE);
+            break;
         case CHANNEL_INTEGER:
+            pos += mcx_format_int(val.value.i, buffer + pos, MCX_FORMAT_BUFFER_SIZE);
+            break;
         case CHANNEL_BOOL:
-            /* fixed length values */
-
-            retVal = ChannelValueToStringBuffer(&val, staticBuffer, 32);
-            if (RETURN_OK == retVal) {
-                mcx_os_fprintf(file, "%s%s", sep, staticBuffer);
-            } else {
-                mcx_os_fprintf(file, "%s\"\"", sep);
+            buffer[pos++] = (val.value.i != 0) ? '1' : '0';
+            break;
+        case CHANNEL_STRING: {
+            const char * str = val.value.s;
+
+            if (str) {
+                /* quote '"' as in https://tools.ietf.org/html/rfc4180#section-2
+                 * and replace non printable characters */
+                buffer[pos++] = '\"';
+                for (; *str; str++) {
+                    if (*str == '\"') {
+                        buffer[pos++] = '\"';
+                        buffer[pos++] = '\"';
+                    } else if (IsSpecialChar((unsigned char) *str)) {
+                        buffer[pos++] = '_';
+                    } else {
+                        buffer[pos++] = *str;
+                    }
+                }
+                buffer[pos++] = '\"';
             }
             break;
+        }
         case CHANNEL_BINARY:
         case CHANNEL_BINARY_REFERENCE:
-        case CHANNEL_STRING: {
-            /* variable length values */
-
-            char * str = ChannelValueToString(&val);
-            char * quotedStr = QuoteString(str);
-
-            if (quotedStr) {
-                mcx_os_fprintf(file, "%s\"%s\"", sep, quotedStr);
-                mcx_free(quotedStr);
-                mcx_free(str);
-            } else {
-                mcx_os_fprintf(file, "%s", sep);
+            buffer[pos++] = '\"';
+            if (val.value.b.data) {
+                for (i = 0; i < val.value.b.len; i++) {
+                    unsigned char c = (unsigned char) val.value.b.data[i];
+                    buffer[pos++] = '\\';
+                    buffer[pos++] = 'x';
+                    buffer[pos++] = hexDigits[c >> 4];
+                    buffer[pos++] = hexDigits[c & 0xf];
+                }
             }
+            buffer[pos++] = '\"';
             break;
-        }
         default:
-            mcx_os_fprintf(file, "%s\"\"", sep);
+            buffer[pos++] = '\"';
+            buffer[pos++] = '\"';
             break;
         }
     }
-    storedLen = mcx_os_fprintf(file, "\n");
 
-    if (storedLen <= 0) {
-        mcx_log(LOG_ERROR, "Results: fprintf failed!");
+    if (RETURN_OK != ReserveRowBuffer(textFile, pos, 1)) {
         return RETURN_ERROR;
     }
+    textFile->rowBuffer[pos++] = '\n';
 
-    return RETURN_OK;
+    return TextFileWrite(textFile, textFile->rowBuffer, pos);
 }
 
 
@@ -274,12 +423,18 @@ static McxStatus Store(StorageBackend * backend, ChannelStoreType chType, size_t
     textFile = &(textBackend->comps[comp].files[chType]);
 
     MCX_DEBUG_LOG("STORE WRITE (%d) chtype %d row %d", comp, chType, row);
-    retVal = WriteRow(textFile->fp, compStore->channels[chType], row, textBackend->separator);
+    retVal = WriteRow(textFile, compStore->channels[chType], row, textBackend->separator);
     if (RETURN_OK != retVal) {
         mcx_log(LOG_ERROR, "Results: Could not write result row for \"%s\"", textFile->name);
         return RETURN_ERROR;
     }
-    if (textBackend->flushEveryStore) {
+    if (textFile->mapped) {
+        // the rows are visible to readers right away, syncing only makes them durable
+        if (mcx_mapped_file_sync_every(textFile->mapped, backend->syncInterval)) {
+            mcx_log(LOG_ERROR, "Results: Could not sync result file \"%s\"", textFile->name);
+            return RETURN_ERROR;
+        }
+    } else if (textBackend->flushEveryStore) {
         if (RETURN_ERROR == FlushTextFile(textFile)) {
             return RETURN_ERROR;
         }
@@ -336,7 +491,7 @@ static McxStatus FinishedFull(StorageBackend * backend) {
 
             if (storage->channelStoreEnabled[chType] && textFile) {
                 for (chIdx = 0; chIdx < chStore->Length(chStore); chIdx++) {
-                    McxStatus retVal = WriteRow(textFile->fp, chStore, chIdx, textBackend->separator);
+                    McxStatus retVal = WriteRow(textFile, chStore, chIdx, textBackend->separator);
                     if (RETURN_OK != retVal) {
                         mcx_log(LOG_ERROR, "Results: Could not write result row for %s", textFile->name);
                         finishedStatus = RETURN_ERROR;
@@ -368,9 +523,22 @@ static void StorageBackendTextDestructor(StorageBackendText * textBackend) {
         size_t compIdx = 0, chType = 0;
         for (compIdx = 0; compIdx < textBackend->numComponents; compIdx++) {
             for (chType = 0; chType < CHANNEL_STORE_NUM; chType++) {
-                char * name = textBackend->comps[compIdx].files[chType].name;
-                if (name) {
-                    mcx_free(name);
+                TextFile * textFile = &(textBackend->comps[compIdx].files[chType]);
+                if (textFile->name) {
+                    mcx_free(textFile->name);
+                }
+                if (textFile->rowBuffer) {
+                    mcx_free(textFile->rowBuffer);
+                }
+                if (textFile->stream) {
+                    object_destroy(textFile->stream);
+                }
+                if (textFile->mapped) {
+                    mcx_mapped_file_close(textFile->mapped);
+                    mcx_free(textFile->mapped);
+                }
+                if (textFile->fp) {
+                    mcx_os_fclose(textFile->fp);
                 }
             }
         }
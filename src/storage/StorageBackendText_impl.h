@@ -16,6 +16,9 @@
 #include "storage/ChannelStorage.h"
 
 #include "storage/StorageBackendText.h"
+#include "storage/CompressedStream.h"
+
+#include "util/mapped_file.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -29,6 +32,12 @@ extern "C" {
 typedef struct TextFile {
     char * name;
     FILE * fp;
+    CompressedStream * stream; // NULL if the file is not compressed
+    McxMappedFile * mapped;    // NULL if the file is written through fp
+
+    // buffer of WriteRow, kept per file as components may be stored concurrently
+    char * rowBuffer;
+    size_t rowCapacity;
 } TextFile;
 
 typedef struct TextComponent {
@@ -52,6 +61,11 @@ typedef struct StorageBackendText {
 
 } StorageBackendText;
 
+/* opens textFile at path, all data is compressed or written through a mapped window if the backend is set up so */
+McxStatus TextFileOpen(StorageBackendText * textBackend, TextFile * textFile, const char * path);
+McxStatus TextFileWrite(TextFile * textFile, const char * data, size_t size);
+McxStatus TextFilePrintf(TextFile * textFile, const char * format, ...);
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,63 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_UTIL_ATOMIC_H
+#define MCX_UTIL_ATOMIC_H
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+
+#if defined(OS_WINDOWS)
+#define _WINSOCKAPI_    // stops windows.h including winsock.h
+#include <windows.h>
+
+//atomic
+typedef volatile LONG McxAtomic;
+
+#elif defined(OS_LINUX)
+
+//atomic (32 bit so that it can be used as a futex word)
+typedef volatile int32_t McxAtomic;
+
+#endif // OS_WINDOWS
+
+/* all operations are sequentially consistent */
+int32_t mcx_atomic_load(McxAtomic * atomic);
+void mcx_atomic_store(McxAtomic * atomic, int32_t value);
+
+/* returns the value before the addition */
+int32_t mcx_atomic_fetch_add(McxAtomic * atomic, int32_t value);
+
+/**
+ * Blocks the calling thread as long as the value of atomic equals expected.
+ * May return spuriously, so callers have to re-check the value in a loop.
+ */
+void mcx_atomic_wait(McxAtomic * atomic, int32_t expected);
+
+/* wakes all threads blocked in mcx_atomic_wait on atomic */
+void mcx_atomic_wake_all(McxAtomic * atomic);
+
+/* hint to the processor that the calling thread is busy-waiting */
+void mcx_cpu_relax(void);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // ENABLE_MT
+
+#endif // MCX_UTIL_ATOMIC_H
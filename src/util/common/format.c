@@ -0,0 +1,298 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "util/format.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* The double formatter scales |value| by a power of ten into the range
+ * [10^precision, 10^(precision+1)) using double-double arithmetic
+ * (Dekker), so that the integral part holds exactly the digits to print.
+ * The result is accurate to far more than the remaining fraction needs
+ * for rounding; values where the rounding decision is close to a tie,
+ * non-finite values and values close to the limits of the double range
+ * are delegated to snprintf. */
+
+#define FORMAT_MAX_PRECISION 14
+#define FORMAT_MAX_EXP10     290
+#define FORMAT_TIE_EPS       1e-6
+
+typedef struct {
+    double hi;
+    double lo;
+} DoubleDouble;
+
+/* exactly representable powers of ten */
+static const double pow10Exact[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+};
+
+/* 10^(22 j) as double-double */
+static const DoubleDouble pow10Big[] = {
+    { 1.0, 0.0 },
+    { 1e+22, 0.0 },
+    { 1e+44, -8.821361405306423e+27 },
+    { 1e+66, 5.467766613175255e+49 },
+    { 1e+88, 4.0583275543649637e+71 },
+    { 1e+110, -2.3569367514170256e+93 },
+    { 1e+132, 9.170432597638724e+114 },
+    { 1e+154, -3.6947545688058227e+137 },
+    { 1e+176, -7.44898050207432e+158 },
+    { 1e+198, -1.75355415660194e+181 },
+    { 1e+220, 3.562757926310489e+202 },
+    { 1e+242, -5.0961029563700274e+225 },
+    { 1e+264, -4.414051890289529e+247 },
+    { 1e+286, -3.2988611034086966e+269 },
+};
+
+/* 10^(-22 j) as double-double */
+static const DoubleDouble pow10Small[] = {
+    { 1.0, 0.0 },
+    { 1e-22, -4.859677432657087e-39 },
+    { 1e-44, 4.700987842202463e-61 },
+    { 1e-66, 2.415206322322255e-83 },
+    { 1e-88, 6.6104605356325366e-105 },
+    { 1e-110, -5.1221963480540186e-127 },
+    { 1e-132, 1.40567366405444e-149 },
+    { 1e-154, 2.7091301680308315e-171 },
+    { 1e-176, 4.085789420184388e-194 },
+    { 1e-198, 8.751979007754662e-215 },
+    { 1e-220, 7.606440013180328e-238 },
+    { 1e-242, 3.0632120172299876e-259 },
+    { 1e-264, -1.2213672486375396e-281 },
+    { 1e-286, -5.044436842451221e-303 },
+};
+
+#define POW10_EXACT_NUM (sizeof(pow10Exact) / sizeof(pow10Exact[0]))
+
+static void Split(double a, double * hi, double * lo) {
+    double t = 134217729.0 * a; // 2^27 + 1
+    *hi = t - (t - a);
+    *lo = a - *hi;
+}
+
+static DoubleDouble TwoProd(double a, double b) {
+    DoubleDouble r;
+    double ah, al, bh, bl;
+
+    Split(a, &ah, &al);
+    Split(b, &bh, &bl);
+
+    r.hi = a * b;
+    r.lo = ((ah * bh - r.hi) + ah * bl + al * bh) + al * bl;
+
+    return r;
+}
+
+static DoubleDouble Normalize(double hi, double lo) {
+    DoubleDouble r;
+
+    r.hi = hi + lo;
+    r.lo = lo - (r.hi - hi);
+
+    return r;
+}
+
+static DoubleDouble Mul(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble p = TwoProd(a.hi, b.hi);
+
+    return Normalize(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+static DoubleDouble Div(double a, double b) {
+    double q = a / b;
+    DoubleDouble p = TwoProd(q, b);
+
+    return Normalize(q, ((a - p.hi) - p.lo) / b);
+}
+
+/* returns |value| * 10^k for -300 < k < 310 */
+static DoubleDouble Scale(double value, int k) {
+    if (k >= 0) {
+        DoubleDouble p = TwoProd(value, pow10Exact[k % POW10_EXACT_NUM]);
+        return Mul(p, pow10Big[k / POW10_EXACT_NUM]);
+    } else {
+        DoubleDouble q = Div(value, pow10Exact[(-k) % POW10_EXACT_NUM]);
+        return Mul(q, pow10Small[(-k) / POW10_EXACT_NUM]);
+    }
+}
+
+static size_t FormatDoubleFallback(double value, unsigned precision, char * buffer, size_t len) {
+    int n = snprintf(buffer, len, "%*.*E", precision, precision, value);
+
+    if (n < 0 || (size_t) n >= len) {
+        return 0;
+    }
+
+    return (size_t) n;
+}
+
+size_t mcx_format_double_exp(double value, unsigned precision, char * buffer, size_t len) {
+    double absValue = fabs(value);
+    double lower = 0.0;
+    double upper = 0.0;
+    double digits = 0.0;
+    double frac = 0.0;
+    DoubleDouble scaled;
+    int exp10 = 0;
+    int expAbs = 0;
+    int tries = 0;
+    size_t pos = 0;
+    size_t i = 0;
+    char tmp[8];
+    size_t tmpLen = 0;
+
+    if (precision > FORMAT_MAX_PRECISION || !isfinite(value)) {
+        return FormatDoubleFallback(value, precision, buffer, len);
+    }
+
+    /* sign, digit, dot, precision digits, 'E', exponent sign, 3 digits, termination */
+    if (len < precision + 9) {
+        return 0;
+    }
+
+    if (absValue == 0.0) {
+        if (signbit(value)) {
+            buffer[pos++] = '-';
+        }
+        buffer[pos++] = '0';
+        if (precision > 0) {
+            buffer[pos++] = '.';
+            for (i = 0; i < precision; i++) {
+                buffer[pos++] = '0';
+            }
+        }
+        buffer[pos++] = 'E';
+        buffer[pos++] = '+';
+        buffer[pos++] = '0';
+        buffer[pos++] = '0';
+        buffer[pos] = '\0';
+        return pos;
+    }
+
+    if (absValue < 1e-290 || absValue > 1e290) {
+        return FormatDoubleFallback(value, precision, buffer, len);
+    }
+
+    lower = pow10Exact[precision];
+    upper = pow10Exact[precision + 1];
+
+    exp10 = (int) floor(log10(absValue));
+    scaled = Scale(absValue, (int) precision - exp10);
+    // log10 may be off by one close to powers of ten
+    while (tries < 2 && (scaled.hi < lower || scaled.hi >= upper)) {
+        exp10 += scaled.hi < lower ? -1 : 1;
+        scaled = Scale(absValue, (int) precision - exp10);
+        tries++;
+    }
+    if (scaled.hi < lower || scaled.hi >= upper) {
+        return FormatDoubleFallback(value, precision, buffer, len);
+    }
+
+    digits = floor(scaled.hi);
+    frac = (scaled.hi - digits) + scaled.lo;
+    if (frac < 0.0) {
+        digits -= 1.0;
+        frac += 1.0;
+    } else if (frac >= 1.0) {
+        digits += 1.0;
+        frac -= 1.0;
+    }
+
+    if (fabs(frac - 0.5) < FORMAT_TIE_EPS) {
+        // too close to call, let the exact implementation decide
+        return FormatDoubleFallback(value, precision, buffer, len);
+    }
+    if (frac > 0.5) {
+        digits += 1.0;
+    }
+    if (digits >= upper) {
+        digits = lower;
+        exp10++;
+    } else if (digits < lower) {
+        return FormatDoubleFallback(value, precision, buffer, len);
+    }
+
+    if (signbit(value)) {
+        buffer[pos++] = '-';
+    }
+
+    {
+        // digits < 10^15 fits into 64 bits exactly
+        unsigned long long mantissa = (unsigned long long) digits;
+        char * start = buffer + pos;
+
+        for (i = precision + 1; i > 1; i--) {
+            start[i] = (char) ('0' + mantissa % 10);
+            mantissa /= 10;
+        }
+        start[0] = (char) ('0' + mantissa);
+        if (precision > 0) {
+            start[1] = '.';
+            pos += precision + 2;
+        } else {
+            pos += 1;
+        }
+    }
+
+    buffer[pos++] = 'E';
+    buffer[pos++] = exp10 < 0 ? '-' : '+';
+    expAbs = exp10 < 0 ? -exp10 : exp10;
+    do {
+        tmp[tmpLen++] = (char) ('0' + expAbs % 10);
+        expAbs /= 10;
+    } while (expAbs > 0);
+    if (tmpLen < 2) {
+        tmp[tmpLen++] = '0';
+    }
+    while (tmpLen > 0) {
+        buffer[pos++] = tmp[--tmpLen];
+    }
+    buffer[pos] = '\0';
+
+    return pos;
+}
+
+size_t mcx_format_int(int value, char * buffer, size_t len) {
+    // compute in unsigned to handle INT_MIN
+    unsigned int absValue = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+    char tmp[16];
+    size_t tmpLen = 0;
+    size_t pos = 0;
+
+    do {
+        tmp[tmpLen++] = (char) ('0' + absValue % 10);
+        absValue /= 10;
+    } while (absValue > 0);
+
+    if (len < tmpLen + (value < 0 ? 1 : 0) + 1) {
+        return 0;
+    }
+
+    if (value < 0) {
+        buffer[pos++] = '-';
+    }
+    while (tmpLen > 0) {
+        buffer[pos++] = tmp[--tmpLen];
+    }
+    buffer[pos] = '\0';
+
+    return pos;
+}
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
@@ -0,0 +1,66 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "util/mapped_file.h"
+
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+int mcx_mapped_file_write(McxMappedFile * file, const void * data, size_t size) {
+    const char * bytes = (const char *) data;
+
+    while (size > 0) {
+        size_t chunk = 0;
+        int64_t end = 0;
+
+        if (!file->window || MCX_MAPPED_FILE_WINDOW_SIZE == file->windowPos) {
+            int64_t offset = file->window ? file->windowOffset + MCX_MAPPED_FILE_WINDOW_SIZE : 0;
+            if (mcx_mapped_file_map(file, offset)) {
+                return -1;
+            }
+        }
+
+        chunk = MCX_MAPPED_FILE_WINDOW_SIZE - file->windowPos;
+        if (chunk > size) {
+            chunk = size;
+        }
+        end = file->windowOffset + (int64_t) (file->windowPos + chunk);
+        if (end > file->size && mcx_mapped_file_extend(file, end)) {
+            return -1;
+        }
+        memcpy(file->window + file->windowPos, bytes, chunk);
+
+        file->windowPos += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+
+    return 0;
+}
+
+int mcx_mapped_file_sync_every(McxMappedFile * file, double interval) {
+    McxTime now, diff;
+
+    mcx_time_get(&now);
+    mcx_time_diff(&file->lastSync, &now, &diff);
+    if (mcx_time_to_seconds(&diff) < interval) {
+        return 0;
+    }
+    file->lastSync = now;
+
+    return mcx_mapped_file_sync(file);
+}
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
@@ -31,6 +31,73 @@ int mcx_run_with_timeout(McxThreadStartRoutine fn, McxThreadParameter arg, long
     return 0;
 }
 
+// upper bound for processor indices in processor lists
+#define MCX_CPU_LIST_MAX 65536
+
+int mcx_cpu_list_parse(const char * list, size_t ** cpus, size_t * numCpus) {
+    const char * pos = list;
+    size_t * result = NULL;
+    size_t num = 0;
+
+    while (*pos) {
+        char * end = NULL;
+        unsigned long first = 0;
+        unsigned long last = 0;
+        unsigned long cpu = 0;
+
+        while (' ' == *pos || ',' == *pos) {
+            pos++;
+        }
+        if (!*pos) {
+            break;
+        }
+
+        first = strtoul(pos, &end, 10);
+        if (end == pos) {
+            goto error;
+        }
+        last = first;
+        pos = end;
+
+        if ('-' == *pos) {
+            pos++;
+            last = strtoul(pos, &end, 10);
+            if (end == pos || last < first) {
+                goto error;
+            }
+            pos = end;
+        }
+
+        if ((*pos && ',' != *pos && ' ' != *pos) || last >= MCX_CPU_LIST_MAX) {
+            goto error;
+        }
+
+        result = (size_t *) mcx_realloc(result, (num + last - first + 1) * sizeof(size_t));
+        if (!result) {
+            goto error;
+        }
+        for (cpu = first; cpu <= last; cpu++) {
+            result[num++] = (size_t) cpu;
+        }
+    }
+
+    if (0 == num) {
+        goto error;
+    }
+
+    *cpus = result;
+    *numCpus = num;
+
+    return 0;
+
+error:
+    if (result) {
+        mcx_free(result);
+    }
+
+    return 1;
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,32 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_UTIL_FILE_H
+#define MCX_UTIL_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Sets the position of file to the absolute offset. Unlike fseek this
+ * supports files larger than 2 GiB on all platforms. Returns 0 on success.
+ */
+int mcx_file_seek(FILE * file, int64_t offset);
+
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // MCX_UTIL_FILE_H
@@ -0,0 +1,46 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_UTIL_FORMAT_H
+#define MCX_UTIL_FORMAT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Size of a buffer that is large enough for every output of
+ * mcx_format_double_exp and mcx_format_int (including termination)
+ */
+#define MCX_FORMAT_BUFFER_SIZE 32
+
+/**
+ * Writes value in the same format as snprintf(buffer, len, "%*.*E",
+ * precision, precision, value) independent of the current locale and
+ * without allocating memory. Returns the number of characters written
+ * (without termination) or 0 if len is too small.
+ */
+size_t mcx_format_double_exp(double value, unsigned precision, char * buffer, size_t len);
+
+/**
+ * Writes value in the same format as snprintf(buffer, len, "%d", value).
+ * Returns the number of characters written (without termination) or 0
+ * if len is too small.
+ */
+size_t mcx_format_int(int value, char * buffer, size_t len);
+
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // MCX_UTIL_FORMAT_H
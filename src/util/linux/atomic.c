@@ -0,0 +1,61 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#include "util/atomic.h"
+
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+int32_t mcx_atomic_load(McxAtomic * atomic) {
+    return __atomic_load_n(atomic, __ATOMIC_SEQ_CST);
+}
+
+void mcx_atomic_store(McxAtomic * atomic, int32_t value) {
+    __atomic_store_n(atomic, value, __ATOMIC_SEQ_CST);
+}
+
+int32_t mcx_atomic_fetch_add(McxAtomic * atomic, int32_t value) {
+    return __atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+}
+
+void mcx_atomic_wait(McxAtomic * atomic, int32_t expected) {
+    // returns immediately with EAGAIN if the value already changed
+    syscall(SYS_futex, (int32_t *) atomic, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+void mcx_atomic_wake_all(McxAtomic * atomic) {
+    syscall(SYS_futex, (int32_t *) atomic, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+void mcx_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // ENABLE_MT
@@ -0,0 +1,187 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+
+#include "util/mapped_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+int mcx_mapped_file_open(McxMappedFile * file, const char * path) {
+    file->window = NULL;
+    file->windowOffset = 0;
+    file->windowPos = 0;
+    file->syncedPos = 0;
+    file->allocated = 0;
+    file->size = 0;
+    mcx_time_get(&file->lastSync);
+
+    file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (file->fd < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int mcx_mapped_file_allocate(McxMappedFile * file, int64_t size) {
+    int64_t newSize = file->allocated;
+
+    while (newSize < size) {
+        newSize += MCX_MAPPED_FILE_EXTENT_SIZE;
+    }
+
+    // reserve the blocks without changing the size, the file system may not
+    // support it, mcx_mapped_file_extend allocates the blocks then
+    if (fallocate(file->fd, FALLOC_FL_KEEP_SIZE, (off_t) file->allocated, (off_t) (newSize - file->allocated))) {
+        if (EOPNOTSUPP != errno && ENOSYS != errno) {
+            return -1;
+        }
+    }
+    file->allocated = newSize;
+
+    return 0;
+}
+
+static int mcx_mapped_file_unmap(McxMappedFile * file) {
+    int ret = 0;
+
+    if (!file->window) {
+        return 0;
+    }
+
+    // the unsynced data of the window must not wait for the next sync of another window
+    if (mcx_mapped_file_sync(file)) {
+        ret = -1;
+    }
+    if (munmap(file->window, MCX_MAPPED_FILE_WINDOW_SIZE)) {
+        ret = -1;
+    }
+    file->window = NULL;
+
+    return ret;
+}
+
+int mcx_mapped_file_map(McxMappedFile * file, int64_t offset) {
+    void * window = NULL;
+
+    if (mcx_mapped_file_unmap(file)) {
+        return -1;
+    }
+
+    if (offset + MCX_MAPPED_FILE_WINDOW_SIZE > file->allocated) {
+        if (mcx_mapped_file_allocate(file, offset + MCX_MAPPED_FILE_WINDOW_SIZE)) {
+            return -1;
+        }
+    }
+
+    window = mmap(NULL, MCX_MAPPED_FILE_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, (off_t) offset);
+    if (MAP_FAILED == window) {
+        return -1;
+    }
+
+    file->window = (char *) window;
+    file->windowOffset = offset;
+    file->windowPos = 0;
+    file->syncedPos = 0;
+
+    return 0;
+}
+
+int mcx_mapped_file_extend(McxMappedFile * file, int64_t size) {
+    int64_t end = file->windowOffset + MCX_MAPPED_FILE_WINDOW_SIZE;
+    int err = 0;
+
+    if (size <= file->size) {
+        return 0;
+    }
+
+    // the rest of the window at once, so that this happens at most once per window and sync
+    if (end < size) {
+        end = size;
+    }
+
+    // pages beyond the end of the file cannot be written through the mapping,
+    // allocating them makes a full disk an error here instead of a SIGBUS later
+    err = posix_fallocate(file->fd, (off_t) file->size, (off_t) (end - file->size));
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    file->size = end;
+
+    return 0;
+}
+
+int mcx_mapped_file_sync(McxMappedFile * file) {
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    int64_t written = file->windowOffset + (int64_t) file->windowPos;
+    size_t start = 0;
+
+    if (!file->window || file->syncedPos == file->windowPos) {
+        return 0;
+    }
+
+    // msync needs a page aligned address
+    start = file->syncedPos - file->syncedPos % pageSize;
+    if (msync(file->window + start, file->windowPos - start, MS_SYNC)) {
+        return -1;
+    }
+    file->syncedPos = file->windowPos;
+
+    // drop the unwritten rest of the window, the next write extends the file again
+    if (file->size > written) {
+        if (ftruncate(file->fd, (off_t) written)) {
+            return -1;
+        }
+        file->size = written;
+        // the truncation also frees the reserved blocks
+        file->allocated = written;
+    }
+
+    return 0;
+}
+
+int mcx_mapped_file_close(McxMappedFile * file) {
+    int64_t size = file->windowOffset + (int64_t) file->windowPos;
+    int ret = 0;
+
+    if (file->fd < 0) {
+        return 0;
+    }
+
+    if (mcx_mapped_file_unmap(file)) {
+        ret = -1;
+    }
+    // drop the preallocated but unused part
+    if (ftruncate(file->fd, (off_t) size)) {
+        ret = -1;
+    }
+    if (close(file->fd)) {
+        ret = -1;
+    }
+    file->fd = -1;
+
+    return ret;
+}
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
@@ -15,9 +15,12 @@
 #include "util/socket.h"
 
 #include <sys/types.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <errno.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +42,92 @@ int mcx_socket_set_nodelay(McxSocket sockfd, int noDelay) {
     return setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
 }
 
+int mcx_socket_set_send_timeout(McxSocket sockfd, int msTimeout) {
+    struct timeval tv;
+    tv.tv_sec = msTimeout / 1000;
+    tv.tv_usec = (msTimeout % 1000) * 1000;
+
+    return setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const char*)&tv, sizeof tv);
+}
+
+int mcx_socket_startup(void) {
+    return 0;
+}
+
+void mcx_socket_cleanup(void) {
+}
+
+McxSocket mcx_socket_listen_local(int port) {
+    struct sockaddr_in addr;
+    int reuse = 1;
+    McxSocket sockfd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (INVALID_SOCKET == sockfd) {
+        return INVALID_SOCKET;
+    }
+
+    // allows restarting a simulation while connections of the last run are in TIME_WAIT
+    setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short) port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(sockfd, (struct sockaddr *) &addr, sizeof(addr)) || listen(sockfd, 1)) {
+        mcx_socket_close(sockfd);
+        return INVALID_SOCKET;
+    }
+
+    return sockfd;
+}
+
+int mcx_socket_get_port(McxSocket sockfd) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+
+    if (getsockname(sockfd, (struct sockaddr *) &addr, &len)) {
+        return -1;
+    }
+
+    return ntohs(addr.sin_port);
+}
+
+McxSocket mcx_socket_accept(McxSocket listener, int msTimeout) {
+    struct timeval tv;
+    fd_set fds;
+
+    tv.tv_sec = msTimeout / 1000;
+    tv.tv_usec = (msTimeout % 1000) * 1000;
+
+    FD_ZERO(&fds);
+    FD_SET(listener, &fds);
+    if (select(listener + 1, &fds, NULL, NULL, &tv) <= 0) {
+        return INVALID_SOCKET;
+    }
+
+    return accept(listener, NULL, NULL);
+}
+
+int mcx_socket_send_all(McxSocket sockfd, const void * data, size_t size) {
+    const char * bytes = (const char *) data;
+
+    while (size > 0) {
+        // a closed connection must not raise SIGPIPE
+        ssize_t sent = send(sockfd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+        bytes += sent;
+        size -= (size_t) sent;
+    }
+
+    return 0;
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
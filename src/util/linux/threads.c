@@ -15,7 +15,10 @@
 #include "util/time.h"
 #include "util/threads.h"
 #include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
 #include <time.h>
+#include <unistd.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,6 +78,41 @@ int mcx_thread_join_with_timeout(McxThread handle, long * ret, int secs) {
     return status;
 }
 
+size_t mcx_thread_get_num_cpus(void) {
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return num > 0 ? (size_t) num : 1;
+}
+
+int mcx_thread_set_affinity(size_t cpu) {
+    cpu_set_t set;
+
+    if (cpu >= CPU_SETSIZE) {
+        return 1;
+    }
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    // 0: calling thread
+    return sched_setaffinity(0, sizeof(set), &set) ? 1 : 0;
+}
+
+int mcx_cpu_get_numa_node(size_t cpu) {
+    char path[64];
+    int node = 0;
+
+    // the sysfs cpu directory contains a nodeN link for its NUMA node
+    for (node = 0; node < 1024; node++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/node%d", cpu, node);
+        if (0 == access(path, F_OK)) {
+            return node;
+        }
+    }
+
+    return -1;
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,102 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#ifndef MCX_UTIL_MAPPED_FILE_H
+#define MCX_UTIL_MAPPED_FILE_H
+
+#include "util/time.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// size of the part of the file that is mapped at once
+#define MCX_MAPPED_FILE_WINDOW_SIZE (16 * 1024 * 1024)
+// the file is preallocated in steps of this size
+#define MCX_MAPPED_FILE_EXTENT_SIZE (64 * 1024 * 1024)
+
+/**
+ * A file that is written sequentially through a mapped window instead of
+ * a FILE stream. The file is preallocated in large extents while it grows
+ * and truncated to the written size when it is closed. Written data is
+ * visible to other processes immediately, mcx_mapped_file_sync makes it
+ * durable.
+ *
+ * On Linux the extents are reserved without changing the file size. The
+ * size is extended to the end of the window when data is written beyond
+ * it and truncated to the written data by mcx_mapped_file_sync, so readers
+ * see unwritten bytes only until the next sync.
+ */
+typedef struct McxMappedFile {
+#if defined(OS_WINDOWS)
+    HANDLE file;
+    HANDLE mapping;
+#elif defined(OS_LINUX)
+    int fd;
+#endif
+
+    char * window;        // mapped part of the file, NULL if none
+    int64_t windowOffset; // offset of window in the file
+    size_t windowPos;     // bytes written to window
+    size_t syncedPos;     // bytes of window that were synced
+
+    int64_t allocated;    // preallocated size of the file
+    int64_t size;         // size of the file as seen by readers, at least the written data
+
+    McxTime lastSync;
+} McxMappedFile;
+
+/**
+ * Creates (or truncates) the file at path for writing. Returns 0 on success.
+ */
+int mcx_mapped_file_open(McxMappedFile * file, const char * path);
+
+/**
+ * Appends size bytes of data to file. Returns 0 on success.
+ */
+int mcx_mapped_file_write(McxMappedFile * file, const void * data, size_t size);
+
+/**
+ * Writes the data that was written since the last sync to the disk. Returns 0 on success.
+ */
+int mcx_mapped_file_sync(McxMappedFile * file);
+
+/**
+ * Syncs file if at least interval seconds passed since it was opened or
+ * last synced by this function. Returns 0 on success.
+ */
+int mcx_mapped_file_sync_every(McxMappedFile * file, double interval);
+
+/**
+ * Unmaps and closes file and truncates it to the written size. Returns 0 on success.
+ */
+int mcx_mapped_file_close(McxMappedFile * file);
+
+/**
+ * Maps the window at offset, preallocating the file if needed. Used by
+ * mcx_mapped_file_write, implemented per platform. Returns 0 on success.
+ */
+int mcx_mapped_file_map(McxMappedFile * file, int64_t offset);
+
+/**
+ * Makes the file at least size bytes long before data is written up to
+ * size. Used by mcx_mapped_file_write if size exceeds the size of the
+ * file, implemented per platform. Returns 0 on success.
+ */
+int mcx_mapped_file_extend(McxMappedFile * file, int64_t size);
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // MCX_UTIL_MAPPED_FILE_H
@@ -27,6 +27,7 @@
   #include <netinet/tcp.h>
 
   #define SOCKET_ERROR (-1)
+  #define INVALID_SOCKET (-1)
 
   #define mcx_socket_close(s) close(s)
 
@@ -37,6 +38,20 @@
 #if defined (ENABLE_MT)
   int mcx_socket_set_timeout(McxSocket sockfd, int msTimeout);
   int mcx_socket_set_nodelay(McxSocket sockfd, int noDelay);
+  int mcx_socket_set_send_timeout(McxSocket sockfd, int msTimeout);
+
+  /* initializes the socket library (WSAStartup on Windows), returns 0 on success */
+  int mcx_socket_startup(void);
+  void mcx_socket_cleanup(void);
+
+  /* listens on port of the loopback interface, port 0 selects a free port. Returns INVALID_SOCKET on error */
+  McxSocket mcx_socket_listen_local(int port);
+  /* returns the local port of sockfd or -1 on error */
+  int mcx_socket_get_port(McxSocket sockfd);
+  /* accepts a connection within msTimeout, returns INVALID_SOCKET on timeout or error */
+  McxSocket mcx_socket_accept(McxSocket listener, int msTimeout);
+  /* sends all size bytes of data, returns 0 on success */
+  int mcx_socket_send_all(McxSocket sockfd, const void * data, size_t size);
 #endif // defined (ENABLE_MT)
 
 #endif // MCX_UTIL_SOCKET_H
\ No newline at end of file
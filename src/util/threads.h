@@ -51,6 +51,21 @@ int mcx_thread_join_with_timeout(McxThread handle, long * ret, int secs);
 
 int mcx_run_with_timeout(McxThreadStartRoutine fn, McxThreadParameter arg, long * retVal, int timeoutSec);
 
+/* number of processors available to the process (at least 1) */
+size_t mcx_thread_get_num_cpus(void);
+
+/* pins the calling thread to the given processor, returns 0 on success */
+int mcx_thread_set_affinity(size_t cpu);
+
+/* NUMA node of the given processor, -1 if unknown */
+int mcx_cpu_get_numa_node(size_t cpu);
+
+/*
+ * Parses a processor list like "0-3,8,10-11" into a newly allocated array
+ * of processor indices, returns 0 on success.
+ */
+int mcx_cpu_list_parse(const char * list, size_t ** cpus, size_t * numCpus);
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,55 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "CentralParts.h"
+
+#if defined (ENABLE_MT)
+
+#include "util/atomic.h"
+
+#define _WINSOCKAPI_    // stops windows.h including winsock.h
+#include <windows.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+int32_t mcx_atomic_load(McxAtomic * atomic) {
+    return InterlockedCompareExchange(atomic, 0, 0);
+}
+
+void mcx_atomic_store(McxAtomic * atomic, int32_t value) {
+    InterlockedExchange(atomic, value);
+}
+
+int32_t mcx_atomic_fetch_add(McxAtomic * atomic, int32_t value) {
+    return InterlockedExchangeAdd(atomic, value);
+}
+
+void mcx_atomic_wait(McxAtomic * atomic, int32_t expected) {
+    LONG compare = expected;
+    WaitOnAddress(atomic, &compare, sizeof(LONG), INFINITE);
+}
+
+void mcx_atomic_wake_all(McxAtomic * atomic) {
+    WakeByAddressAll((PVOID) atomic);
+}
+
+void mcx_cpu_relax(void) {
+    YieldProcessor();
+}
+
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
+
+#endif // ENABLE_MT
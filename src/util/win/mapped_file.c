@@ -0,0 +1,177 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+#include "util/mapped_file.h"
+#include "util/string.h"
+#include "common/memory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+int mcx_mapped_file_open(McxMappedFile * file, const char * path) {
+    wchar_t * wPath = mcx_string_to_widechar(path);
+
+    file->mapping = NULL;
+    file->window = NULL;
+    file->windowOffset = 0;
+    file->windowPos = 0;
+    file->syncedPos = 0;
+    file->allocated = 0;
+    file->size = 0;
+    mcx_time_get(&file->lastSync);
+
+    if (!wPath) {
+        file->file = INVALID_HANDLE_VALUE;
+        return -1;
+    }
+
+    file->file = CreateFileW(wPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                             CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    mcx_free(wPath);
+
+    if (INVALID_HANDLE_VALUE == file->file) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int mcx_mapped_file_unmap(McxMappedFile * file) {
+    int ret = 0;
+
+    if (file->window) {
+        // start the write back of the whole window
+        if (!FlushViewOfFile(file->window, 0)) {
+            ret = -1;
+        }
+        if (!UnmapViewOfFile(file->window)) {
+            ret = -1;
+        }
+        file->window = NULL;
+    }
+
+    return ret;
+}
+
+static int mcx_mapped_file_allocate(McxMappedFile * file, int64_t size) {
+    int64_t newSize = file->allocated;
+    LARGE_INTEGER end;
+
+    while (newSize < size) {
+        newSize += MCX_MAPPED_FILE_EXTENT_SIZE;
+    }
+
+    // the mapping has the size of the file when it was created
+    if (file->mapping) {
+        CloseHandle(file->mapping);
+        file->mapping = NULL;
+    }
+
+    end.QuadPart = newSize;
+    if (!SetFilePointerEx(file->file, end, NULL, FILE_BEGIN) || !SetEndOfFile(file->file)) {
+        return -1;
+    }
+    file->allocated = newSize;
+
+    file->mapping = CreateFileMappingW(file->file, NULL, PAGE_READWRITE, 0, 0, NULL);
+    if (!file->mapping) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int mcx_mapped_file_map(McxMappedFile * file, int64_t offset) {
+    void * window = NULL;
+
+    if (mcx_mapped_file_unmap(file)) {
+        return -1;
+    }
+
+    if (offset + MCX_MAPPED_FILE_WINDOW_SIZE > file->allocated) {
+        if (mcx_mapped_file_allocate(file, offset + MCX_MAPPED_FILE_WINDOW_SIZE)) {
+            return -1;
+        }
+    }
+
+    // the offset is a multiple of the allocation granularity as the window size is
+    window = MapViewOfFile(file->mapping, FILE_MAP_WRITE, (DWORD) (offset >> 32), (DWORD) (offset & 0xFFFFFFFF),
+                           MCX_MAPPED_FILE_WINDOW_SIZE);
+    if (!window) {
+        return -1;
+    }
+
+    file->window = (char *) window;
+    file->windowOffset = offset;
+    file->windowPos = 0;
+    file->syncedPos = 0;
+
+    return 0;
+}
+
+int mcx_mapped_file_extend(McxMappedFile * file, int64_t size) {
+    // the mapping needs a file of the allocated size, the data beyond size reads as zeros
+    if (size > file->size) {
+        file->size = size;
+    }
+
+    return 0;
+}
+
+int mcx_mapped_file_sync(McxMappedFile * file) {
+    if (!file->window || file->syncedPos == file->windowPos) {
+        return 0;
+    }
+
+    if (!FlushViewOfFile(file->window + file->syncedPos, file->windowPos - file->syncedPos)) {
+        return -1;
+    }
+    if (!FlushFileBuffers(file->file)) {
+        return -1;
+    }
+    file->syncedPos = file->windowPos;
+
+    return 0;
+}
+
+int mcx_mapped_file_close(McxMappedFile * file) {
+    int64_t size = file->windowOffset + (int64_t) file->windowPos;
+    LARGE_INTEGER end;
+    int ret = 0;
+
+    if (INVALID_HANDLE_VALUE == file->file) {
+        return 0;
+    }
+
+    if (mcx_mapped_file_unmap(file)) {
+        ret = -1;
+    }
+    if (file->mapping) {
+        CloseHandle(file->mapping);
+        file->mapping = NULL;
+    }
+
+    // drop the preallocated but unused part
+    end.QuadPart = size;
+    if (!SetFilePointerEx(file->file, end, NULL, FILE_BEGIN) || !SetEndOfFile(file->file)) {
+        ret = -1;
+    }
+    if (!CloseHandle(file->file)) {
+        ret = -1;
+    }
+    file->file = INVALID_HANDLE_VALUE;
+
+    return ret;
+}
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
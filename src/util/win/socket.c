@@ -15,6 +15,7 @@
 #include "util/socket.h"
 
 #include <winsock2.h>
+#include <limits.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,83 @@ int mcx_socket_set_nodelay(McxSocket sockfd, int noDelay) {
     return setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &_noDelay, sizeof(_noDelay));
 }
 
+int mcx_socket_set_send_timeout(McxSocket sockfd, int msTimeout) {
+    return setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const char*)&msTimeout, sizeof msTimeout);
+}
+
+int mcx_socket_startup(void) {
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData);
+}
+
+void mcx_socket_cleanup(void) {
+    WSACleanup();
+}
+
+McxSocket mcx_socket_listen_local(int port) {
+    struct sockaddr_in addr;
+    McxSocket sockfd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    if (INVALID_SOCKET == sockfd) {
+        return INVALID_SOCKET;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short) port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(sockfd, (struct sockaddr *) &addr, sizeof(addr)) || listen(sockfd, 1)) {
+        mcx_socket_close(sockfd);
+        return INVALID_SOCKET;
+    }
+
+    return sockfd;
+}
+
+int mcx_socket_get_port(McxSocket sockfd) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+
+    if (getsockname(sockfd, (struct sockaddr *) &addr, &len)) {
+        return -1;
+    }
+
+    return ntohs(addr.sin_port);
+}
+
+McxSocket mcx_socket_accept(McxSocket listener, int msTimeout) {
+    struct timeval tv;
+    fd_set fds;
+
+    tv.tv_sec = msTimeout / 1000;
+    tv.tv_usec = (msTimeout % 1000) * 1000;
+
+    FD_ZERO(&fds);
+    FD_SET(listener, &fds);
+    if (select(0, &fds, NULL, NULL, &tv) <= 0) {
+        return INVALID_SOCKET;
+    }
+
+    return accept(listener, NULL, NULL);
+}
+
+int mcx_socket_send_all(McxSocket sockfd, const void * data, size_t size) {
+    const char * bytes = (const char *) data;
+
+    while (size > 0) {
+        int chunk = size > INT_MAX ? INT_MAX : (int) size;
+        int sent = send(sockfd, bytes, chunk, 0);
+        if (SOCKET_ERROR == sent) {
+            return -1;
+        }
+        bytes += sent;
+        size -= (size_t) sent;
+    }
+
+    return 0;
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -86,6 +86,32 @@ error:
     return 1;
 }
 
+size_t mcx_thread_get_num_cpus(void) {
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors > 0 ? (size_t) info.dwNumberOfProcessors : 1;
+}
+
+int mcx_thread_set_affinity(size_t cpu) {
+    if (cpu >= sizeof(DWORD_PTR) * 8) {
+        return 1;
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << cpu) ? 0 : 1;
+}
+
+int mcx_cpu_get_numa_node(size_t cpu) {
+    UCHAR node = 0;
+
+    if (cpu > 0xFF || !GetNumaProcessorNode((UCHAR) cpu, &node) || 0xFF == node) {
+        return -1;
+    }
+
+    return (int) node;
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,220 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+/*
+ * Compares the csv row formatting of the text result backend with the
+ * previous per-cell path on a row of random doubles.
+ *
+ * Usage: bench_format [numColumns [numRows]]
+ *
+ * The previous path formats every cell with sprintf("%*.*E") and writes it
+ * with its own fprintf. The current path formats the whole row with
+ * mcx_format_double_exp into one buffer and writes it with a single fwrite.
+ * Both write into a temporary file. The rows are compared before timing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "util/format.h"
+#include "util/time.h"
+
+#define SEPARATOR ","
+#define PRECISION 13
+
+static uint64_t NextRandom(uint64_t * state) {
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// random doubles with random signs and decimal exponents from -30 to 30
+static void FillValues(double * values, size_t num) {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t i = 0;
+
+    for (i = 0; i < num; i++) {
+        double mantissa = (double) (NextRandom(&state) >> 11) / 9007199254740992.0;
+        int exponent = (int) (NextRandom(&state) % 61) - 30;
+        double value = mantissa;
+
+        while (exponent > 0) {
+            value *= 10.0;
+            exponent--;
+        }
+        while (exponent < 0) {
+            value /= 10.0;
+            exponent++;
+        }
+        values[i] = (NextRandom(&state) & 1) ? -value : value;
+    }
+}
+
+static size_t FormatRowPrevious(const double * values, size_t num, char * row) {
+    size_t pos = 0;
+    size_t i = 0;
+
+    for (i = 0; i < num; i++) {
+        if (i > 0) {
+            pos += sprintf(row + pos, "%s", SEPARATOR);
+        }
+        pos += sprintf(row + pos, "%*.*E", PRECISION, PRECISION, values[i]);
+    }
+    row[pos++] = '\n';
+
+    return pos;
+}
+
+static size_t FormatRow(const double * values, size_t num, char * row) {
+    size_t pos = 0;
+    size_t i = 0;
+
+    for (i = 0; i < num; i++) {
+        if (i > 0) {
+            row[pos++] = SEPARATOR[0];
+        }
+        pos += mcx_format_double_exp(values[i], PRECISION, row + pos, MCX_FORMAT_BUFFER_SIZE);
+    }
+    row[pos++] = '\n';
+
+    return pos;
+}
+
+static int WriteRowsPrevious(FILE * fp, const double * values, size_t numColumns, size_t numRows) {
+    char buffer[MCX_FORMAT_BUFFER_SIZE];
+    size_t row = 0;
+    size_t i = 0;
+
+    for (row = 0; row < numRows; row++) {
+        for (i = 0; i < numColumns; i++) {
+            sprintf(buffer, "%*.*E", PRECISION, PRECISION, values[i]);
+            if (fprintf(fp, "%s%s", i > 0 ? SEPARATOR : "", buffer) < 0) {
+                return 0;
+            }
+        }
+        if (fprintf(fp, "\n") <= 0) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int WriteRows(FILE * fp, const double * values, size_t numColumns, size_t numRows, char * row) {
+    size_t r = 0;
+
+    for (r = 0; r < numRows; r++) {
+        size_t len = FormatRow(values, numColumns, row);
+
+        if (1 != fwrite(row, len, 1, fp)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static double Seconds(McxTime * start) {
+    McxTime end, diff;
+
+    mcx_time_get(&end);
+    mcx_time_diff(start, &end, &diff);
+
+    return mcx_time_to_seconds(&diff);
+}
+
+int main(int argc, char * argv[]) {
+    size_t numColumns = 10000;
+    size_t numRows = 100;
+
+    double * values = NULL;
+    char * row = NULL;
+    char * rowPrevious = NULL;
+    size_t len = 0, lenPrevious = 0;
+
+    FILE * fp = NULL;
+    McxTime start;
+    double previous = 0.0, current = 0.0;
+    int ok = 0;
+
+    if (argc > 1) {
+        numColumns = (size_t) strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        numRows = (size_t) strtoul(argv[2], NULL, 10);
+    }
+    if (0 == numColumns || 0 == numRows) {
+        fprintf(stderr, "Usage: %s [numColumns [numRows]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    values = (double *) malloc(numColumns * sizeof(double));
+    // each cell has a separator or the newline
+    row = (char *) malloc(numColumns * (MCX_FORMAT_BUFFER_SIZE + 1));
+    rowPrevious = (char *) malloc(numColumns * (MCX_FORMAT_BUFFER_SIZE + 1));
+    fp = tmpfile();
+    if (!values || !row || !rowPrevious || !fp) {
+        fprintf(stderr, "Could not allocate %zu columns\n", numColumns);
+        goto cleanup;
+    }
+
+    FillValues(values, numColumns);
+
+    len = FormatRow(values, numColumns, row);
+    lenPrevious = FormatRowPrevious(values, numColumns, rowPrevious);
+    if (len != lenPrevious || memcmp(row, rowPrevious, len)) {
+        fprintf(stderr, "Formatted rows differ\n");
+        goto cleanup;
+    }
+
+    mcx_time_get(&start);
+    if (!WriteRowsPrevious(fp, values, numColumns, numRows)) {
+        fprintf(stderr, "Writing rows failed\n");
+        goto cleanup;
+    }
+    fflush(fp);
+    previous = Seconds(&start);
+
+    rewind(fp);
+
+    mcx_time_get(&start);
+    if (!WriteRows(fp, values, numColumns, numRows, row)) {
+        fprintf(stderr, "Writing rows failed\n");
+        goto cleanup;
+    }
+    fflush(fp);
+    current = Seconds(&start);
+
+    printf("%zu rows of %zu columns (%zu bytes per row)\n", numRows, numColumns, len);
+    printf("sprintf and fprintf per cell: %10.6f s, %8.1f ns per cell\n",
+           previous, previous * 1e9 / ((double) numRows * numColumns));
+    printf("row buffer and fwrite:        %10.6f s, %8.1f ns per cell\n",
+           current, current * 1e9 / ((double) numRows * numColumns));
+    if (current > 0.0) {
+        printf("speedup: %.2fx\n", previous / current);
+    }
+
+    ok = 1;
+
+cleanup:
+    if (fp) {
+        fclose(fp);
+    }
+    free(rowPrevious);
+    free(row);
+    free(values);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
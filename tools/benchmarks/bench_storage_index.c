@@ -0,0 +1,222 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+/*
+ * Measures ResultsStorage::SetStored for a synthetic model of N elements.
+ *
+ * Usage: bench_storage_index [numSteps [N ...]]
+ *
+ * Every element has a port storage with one row. Each step stores the
+ * outports of all elements into a backend that only counts the rows, so
+ * the time per store is the cost of finding the element's storage and
+ * dispatching to the backend. For comparison, the time of the linear
+ * search that was used before the storages had an index is also given.
+ */
+
+#include "CentralParts.h"
+#include "storage/ResultsStorage.h"
+#include "storage/ComponentStorage.h"
+#include "storage/ChannelStorage.h"
+#include "util/time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// backend that counts the stored rows of each element
+typedef struct StorageBackendCount {
+    StorageBackend _; // super class first
+
+    size_t * numRows;
+} StorageBackendCount;
+
+static McxStatus CountStore(StorageBackend * backend, ChannelStoreType chType, size_t comp, size_t row) {
+    StorageBackendCount * countBackend = (StorageBackendCount *) backend;
+
+    countBackend->numRows[comp]++;
+
+    return RETURN_OK;
+}
+
+static void StorageBackendCountDestructor(StorageBackendCount * countBackend) {
+}
+
+static StorageBackendCount * StorageBackendCountCreate(StorageBackendCount * countBackend) {
+    StorageBackend * backend = (StorageBackend *) countBackend;
+
+    backend->Store = CountStore;
+    backend->active = TRUE;
+
+    countBackend->numRows = NULL;
+
+    return countBackend;
+}
+
+OBJECT_CLASS(StorageBackendCount, StorageBackend);
+
+static double Seconds(McxTime * start) {
+    McxTime end, diff;
+
+    mcx_time_get(&end);
+    mcx_time_diff(start, &end, &diff);
+
+    return mcx_time_to_seconds(&diff);
+}
+
+// index of compStore in the storage as it was searched before
+static size_t SearchComponent(ResultsStorage * storage, ComponentStorage * compStore) {
+    size_t i = 0;
+
+    for (i = 0; i < storage->numComponents; i++) {
+        if (storage->componentStorage[i] == compStore) {
+            return i;
+        }
+    }
+
+    return (size_t) -1;
+}
+
+static int Run(size_t numComponents, size_t numSteps) {
+    ResultsStorage * storage = NULL;
+    StorageBackendCount * backend = NULL;
+    ComponentStorage ** compStores = NULL;
+
+    McxTime start;
+    double stored = 0.0, searched = 0.0;
+    size_t found = 0;
+    size_t step = 0;
+    size_t i = 0;
+    int ok = 0;
+
+    storage = (ResultsStorage *) object_create(ResultsStorage);
+    backend = (StorageBackendCount *) object_create(StorageBackendCount);
+    compStores = (ComponentStorage **) mcx_calloc(numComponents, sizeof(ComponentStorage *));
+    if (!storage || !backend || !compStores) {
+        goto cleanup;
+    }
+
+    backend->numRows = (size_t *) mcx_calloc(numComponents, sizeof(size_t));
+    if (!backend->numRows) {
+        goto cleanup;
+    }
+    storage->backends[BACKEND_CSV] = (StorageBackend *) backend;
+    backend = NULL; // owned by storage
+    storage->SetChannelStoreEnabled(storage, CHANNEL_STORE_OUT, TRUE);
+
+    for (i = 0; i < numComponents; i++) {
+        compStores[i] = (ComponentStorage *) object_create(ComponentStorage);
+        if (!compStores[i]) {
+            goto cleanup;
+        }
+        if (RETURN_OK != storage->RegisterComponent(storage, compStores[i])) {
+            goto cleanup;
+        }
+        compStores[i]->storage = storage;
+        // one row that is stored again in every step
+        compStores[i]->channels[CHANNEL_STORE_OUT]->numValues = 1;
+    }
+
+    mcx_time_get(&start);
+    for (step = 0; step < numSteps; step++) {
+        for (i = 0; i < numComponents; i++) {
+            if (RETURN_OK != storage->SetStored(storage, compStores[i], CHANNEL_STORE_OUT, (double) step)) {
+                goto cleanup;
+            }
+        }
+    }
+    stored = Seconds(&start);
+
+    mcx_time_get(&start);
+    for (step = 0; step < numSteps; step++) {
+        for (i = 0; i < numComponents; i++) {
+            found += SearchComponent(storage, compStores[i]) == i;
+        }
+    }
+    searched = Seconds(&start);
+
+    for (i = 0; i < numComponents; i++) {
+        StorageBackendCount * count = (StorageBackendCount *) storage->backends[BACKEND_CSV];
+        if (count->numRows[i] != numSteps) {
+            fprintf(stderr, "Element %zu has %zu instead of %zu rows\n", i, count->numRows[i], numSteps);
+            goto cleanup;
+        }
+    }
+    if (found != numSteps * numComponents) {
+        fprintf(stderr, "Linear search did not find all elements\n");
+        goto cleanup;
+    }
+
+    printf("%8zu elements: SetStored %8.1f ns per store, linear search %10.1f ns per store\n",
+           numComponents,
+           stored * 1e9 / ((double) numSteps * numComponents),
+           searched * 1e9 / ((double) numSteps * numComponents));
+
+    ok = 1;
+
+cleanup:
+    if (!ok) {
+        fprintf(stderr, "Benchmark with %zu elements failed\n", numComponents);
+    }
+    if (compStores) {
+        for (i = 0; i < numComponents; i++) {
+            if (compStores[i]) {
+                compStores[i]->channels[CHANNEL_STORE_OUT]->numValues = 0;
+                object_destroy(compStores[i]);
+            }
+        }
+        mcx_free(compStores);
+    }
+    if (storage && storage->backends[BACKEND_CSV]) {
+        mcx_free(((StorageBackendCount *) storage->backends[BACKEND_CSV])->numRows);
+    }
+    if (backend) {
+        object_destroy(backend);
+    }
+    if (storage) {
+        object_destroy(storage);
+    }
+
+    return ok;
+}
+
+int main(int argc, char * argv[]) {
+    size_t defaultSizes[] = { 10, 100, 1000, 10000 };
+    size_t numSteps = 100;
+    int i = 0;
+    int ok = 1;
+
+    if (argc > 1) {
+        numSteps = (size_t) strtoul(argv[1], NULL, 10);
+        if (0 == numSteps) {
+            fprintf(stderr, "Usage: %s [numSteps [N ...]]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%zu steps\n", numSteps);
+    if (argc > 2) {
+        for (i = 2; i < argc; i++) {
+            ok = Run((size_t) strtoul(argv[i], NULL, 10), numSteps) && ok;
+        }
+    } else {
+        for (i = 0; i < (int) (sizeof(defaultSizes) / sizeof(defaultSizes[0])); i++) {
+            ok = Run(defaultSizes[i], numSteps) && ok;
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif /* __cplusplus */
@@ -0,0 +1,239 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+/*
+ * Measures the ordering of model nodes on synthetic sparse dependency
+ * graphs the way SubModel orders them: the graph of the edges from each
+ * node to the nodes that depend on it is built with tarjan_graph_create,
+ * transposed with tarjan_graph_transpose and ordered with tarjan_graph.
+ *
+ * Usage: bench_tarjan [numSuccessors [N ...]]
+ *
+ * Every node has numSuccessors (4 by default) dependent nodes close to it.
+ * Most edges point forward; one in 16 points backward and closes a loop.
+ * For small graphs the dense tarjan on the dependency matrix is timed as
+ * well, and both orderings are compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "tarjan.h"
+#include "util/time.h"
+
+// largest graph that is also ordered with the dense adjacency matrix
+#define DENSE_MAX_NODES 4096
+
+// nodes that an edge spans at most
+#define EDGE_SPAN 64
+
+static uint64_t NextRandom(uint64_t * state) {
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+static void GenerateEdges(size_t n, size_t numSuccessors, size_t * sources, size_t * targets) {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t v = 0, k = 0, e = 0;
+
+    for (v = 0; v < n; v++) {
+        for (k = 0; k < numSuccessors; k++) {
+            uint64_t r = NextRandom(&state);
+            size_t span = 1 + (size_t) ((r >> 8) % EDGE_SPAN);
+
+            sources[e] = v;
+            if (0 == (r & 15)) {
+                targets[e] = v >= span ? v - span : 0;
+            } else {
+                targets[e] = v + span < n ? v + span : n - 1;
+            }
+            e++;
+        }
+    }
+}
+
+static double Seconds(McxTime * start) {
+    McxTime end, diff;
+
+    mcx_time_get(&end);
+    mcx_time_diff(start, &end, &diff);
+
+    return mcx_time_to_seconds(&diff);
+}
+
+static int SameOrder(const OrderedNodes * a, const OrderedNodes * b) {
+    size_t i = 0;
+
+    if (a->size != b->size) {
+        return 0;
+    }
+    for (i = 0; i < a->size; i++) {
+        const NodeGroup * ga = a->groups[i];
+        const NodeGroup * gb = b->groups[i];
+
+        if (ga->isLoop != gb->isLoop || ga->nodes.size != gb->nodes.size
+            || memcmp(ga->nodes.values, gb->nodes.values, ga->nodes.size * sizeof(size_t))) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int Run(size_t n, size_t numSuccessors) {
+    size_t numEdges = n * numSuccessors;
+    size_t * sources = NULL;
+    size_t * targets = NULL;
+    int * A = NULL;
+
+    TarjanGraph * graph = NULL;
+    TarjanGraph * dependencies = NULL;
+    OrderedNodes * ordered = NULL;
+    OrderedNodes * orderedDense = NULL;
+
+    McxTime start;
+    double create = 0.0, transpose = 0.0, order = 0.0, dense = 0.0;
+    size_t numLoops = 0, largest = 0;
+    size_t i = 0;
+    int ok = 0;
+
+    sources = (size_t *) malloc(numEdges * sizeof(size_t));
+    targets = (size_t *) malloc(numEdges * sizeof(size_t));
+    if (!sources || !targets) {
+        goto cleanup;
+    }
+    GenerateEdges(n, numSuccessors, sources, targets);
+
+    mcx_time_get(&start);
+    graph = tarjan_graph_create(n, sources, targets, numEdges);
+    create = Seconds(&start);
+    if (!graph) {
+        goto cleanup;
+    }
+
+    mcx_time_get(&start);
+    dependencies = tarjan_graph_transpose(graph);
+    transpose = Seconds(&start);
+    if (!dependencies) {
+        goto cleanup;
+    }
+
+    mcx_time_get(&start);
+    ordered = tarjan_graph(dependencies);
+    order = Seconds(&start);
+    if (!ordered) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < ordered->size; i++) {
+        const NodeGroup * group = ordered->groups[i];
+
+        if (group->isLoop) {
+            numLoops++;
+        }
+        if (group->nodes.size > largest) {
+            largest = group->nodes.size;
+        }
+    }
+
+    printf("%8zu nodes %9zu edges: %8zu groups, %6zu loops, largest %6zu nodes, "
+           "create %9.6f s, transpose %9.6f s, tarjan_graph %9.6f s",
+           n, numEdges, ordered->size, numLoops, largest, create, transpose, order);
+
+    if (n <= DENSE_MAX_NODES) {
+        A = (int *) calloc(n * n, sizeof(int));
+        if (!A) {
+            printf("\n");
+            goto cleanup;
+        }
+        // row of a node: the nodes it depends on
+        for (i = 0; i < numEdges; i++) {
+            A[targets[i] * n + sources[i]] = 1;
+        }
+
+        mcx_time_get(&start);
+        orderedDense = tarjan(A, n);
+        dense = Seconds(&start);
+        if (!orderedDense) {
+            printf("\n");
+            goto cleanup;
+        }
+        printf(", dense tarjan %9.6f s", dense);
+
+        if (!SameOrder(ordered, orderedDense)) {
+            printf("\n");
+            fprintf(stderr, "Orderings of the sparse and the dense graph differ\n");
+            goto cleanup;
+        }
+    }
+    printf("\n");
+
+    ok = 1;
+
+cleanup:
+    if (!ok) {
+        fprintf(stderr, "Benchmark with %zu nodes failed\n", n);
+    }
+    if (orderedDense) {
+        tarjan_ordered_nodes_cleanup(orderedDense);
+    }
+    if (ordered) {
+        tarjan_ordered_nodes_cleanup(ordered);
+    }
+    if (dependencies) {
+        tarjan_graph_cleanup(dependencies);
+    }
+    if (graph) {
+        tarjan_graph_cleanup(graph);
+    }
+    free(A);
+    free(targets);
+    free(sources);
+
+    return ok;
+}
+
+int main(int argc, char * argv[]) {
+    size_t defaultSizes[] = { 1000, 4000, 10000, 100000 };
+    size_t numSuccessors = 4;
+    int i = 0;
+    int ok = 1;
+
+    if (argc > 1) {
+        numSuccessors = (size_t) strtoul(argv[1], NULL, 10);
+        if (0 == numSuccessors) {
+            fprintf(stderr, "Usage: %s [numSuccessors [N ...]]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (tarjan_init_mem(malloc, free, realloc)) {
+        fprintf(stderr, "Could not initialize tarjan\n");
+        return EXIT_FAILURE;
+    }
+
+    if (argc > 2) {
+        for (i = 2; i < argc; i++) {
+            ok = Run((size_t) strtoul(argv[i], NULL, 10), numSuccessors) && ok;
+        }
+    } else {
+        for (i = 0; i < (int) (sizeof(defaultSizes) / sizeof(defaultSizes[0])); i++) {
+            ok = Run(defaultSizes[i], numSuccessors) && ok;
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
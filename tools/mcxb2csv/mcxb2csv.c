@@ -0,0 +1,388 @@
+/********************************************************************************
+ * Copyright (c) 2020 AVL List GmbH and others
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache Software License 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * SPDX-License-Identifier: Apache-2.0
+ ********************************************************************************/
+
+/*
+ * Converts result files of the binary storage backend (*.mcxb) into the csv
+ * files that the csv backend writes. The format is described in
+ * src/storage/StorageBackendBinary.h.
+ *
+ * Usage: mcxb2csv file.mcxb [file.mcxb ...]
+ *
+ * Each file.mcxb is converted into file.csv in the same directory. Compressed
+ * result files (file.mcxb.gz) are read transparently.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include <zlib.h>
+
+#define BINARY_RESULTS_VERSION 1
+
+#define SEPARATOR ","
+#define PRECISION 13
+
+enum {
+    TYPE_DOUBLE = 1,
+    TYPE_INTEGER = 2,
+    TYPE_BOOL = 3,
+    TYPE_STRING = 4,
+    TYPE_BINARY = 5,
+};
+
+typedef struct Column {
+    uint32_t type;
+    char * name;
+    char * unit;
+    const unsigned char * cursor; // next value of the current chunk
+} Column;
+
+static uint32_t DecodeUInt32(const unsigned char * bytes) {
+    return (uint32_t) bytes[0]
+        | ((uint32_t) bytes[1] << 8)
+        | ((uint32_t) bytes[2] << 16)
+        | ((uint32_t) bytes[3] << 24);
+}
+
+static uint64_t DecodeUInt64(const unsigned char * bytes) {
+    return (uint64_t) DecodeUInt32(bytes) | ((uint64_t) DecodeUInt32(bytes + 4) << 32);
+}
+
+static double DecodeDouble(const unsigned char * bytes) {
+    uint64_t bits = DecodeUInt64(bytes);
+    double value = 0.0;
+
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+/* reads up to size bytes, returns the number of bytes read */
+static size_t ReadBytes(gzFile in, void * data, size_t size) {
+    char * bytes = (char *) data;
+    size_t read = 0;
+
+    while (read < size) {
+        size_t len = size - read;
+        int ret = 0;
+
+        if (len > INT_MAX) {
+            len = INT_MAX;
+        }
+        ret = gzread(in, bytes + read, (unsigned) len);
+        if (ret <= 0) {
+            break;
+        }
+        read += (size_t) ret;
+    }
+
+    return read;
+}
+
+static int ReadUInt32(gzFile in, uint32_t * value) {
+    unsigned char bytes[4];
+
+    if (sizeof(bytes) != ReadBytes(in, bytes, sizeof(bytes))) {
+        return 0;
+    }
+    * value = DecodeUInt32(bytes);
+
+    return 1;
+}
+
+static char * ReadString(gzFile in) {
+    uint32_t len = 0;
+    char * str = NULL;
+
+    if (!ReadUInt32(in, &len)) {
+        return NULL;
+    }
+    str = (char *) calloc((size_t) len + 1, 1);
+    if (!str) {
+        return NULL;
+    }
+    if (len > 0 && len != ReadBytes(in, str, len)) {
+        free(str);
+        return NULL;
+    }
+
+    return str;
+}
+
+/* same quoting as the csv backend, see https://tools.ietf.org/html/rfc4180#section-2 */
+static void WriteQuoted(FILE * out, const char * str, size_t len, int sanitize) {
+    size_t i = 0;
+
+    fputc('"', out);
+    for (i = 0; i < len; i++) {
+        unsigned char c = (unsigned char) str[i];
+
+        if (sanitize && (c < ' ' || c > '~')) {
+            c = '_';
+        }
+        if (c == '"') {
+            fputc('"', out);
+        }
+        fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+static size_t ColumnValueSize(const Column * column, const unsigned char * cursor) {
+    switch (column->type) {
+    case TYPE_DOUBLE:
+        return 8;
+    case TYPE_INTEGER:
+    case TYPE_BOOL:
+        return 4;
+    default:
+        return 4 + DecodeUInt32(cursor);
+    }
+}
+
+/* sets the cursors of all columns to the beginning of the columns in chunk */
+static int SetupCursors(Column * columns, uint32_t numColumns, uint32_t numRows, const unsigned char * chunk, size_t size) {
+    const unsigned char * cursor = chunk;
+    const unsigned char * end = chunk + size;
+    uint32_t i = 0, row = 0;
+
+    for (i = 0; i < numColumns; i++) {
+        columns[i].cursor = cursor;
+        for (row = 0; row < numRows; row++) {
+            if ((size_t) (end - cursor) < 4) {
+                return 0;
+            }
+            cursor += ColumnValueSize(&columns[i], cursor);
+            if (cursor > end) {
+                return 0;
+            }
+        }
+    }
+
+    return cursor == end;
+}
+
+static void WriteValue(FILE * out, Column * column) {
+    const unsigned char * cursor = column->cursor;
+
+    switch (column->type) {
+    case TYPE_DOUBLE:
+        fprintf(out, "%*.*E", PRECISION, PRECISION, DecodeDouble(cursor));
+        break;
+    case TYPE_INTEGER:
+        fprintf(out, "%d", (int32_t) DecodeUInt32(cursor));
+        break;
+    case TYPE_BOOL:
+        fprintf(out, "%1d", DecodeUInt32(cursor) != 0 ? 1 : 0);
+        break;
+    case TYPE_STRING:
+    {
+        uint32_t len = DecodeUInt32(cursor);
+        // an empty string is written as ""
+        WriteQuoted(out, (const char *) cursor + 4, len, 1);
+        break;
+    }
+    case TYPE_BINARY:
+    {
+        uint32_t len = DecodeUInt32(cursor);
+        uint32_t i = 0;
+
+        fputc('"', out);
+        for (i = 0; i < len; i++) {
+            fprintf(out, "\\x%02x", cursor[4 + i]);
+        }
+        fputc('"', out);
+        break;
+    }
+    default:
+        fprintf(out, "\"\"");
+        break;
+    }
+
+    column->cursor += ColumnValueSize(column, cursor);
+}
+
+static int Convert(const char * inName, const char * outName) {
+    gzFile in = NULL;
+    FILE * out = NULL;
+    Column * columns = NULL;
+    unsigned char * chunk = NULL;
+    size_t chunkCapacity = 0;
+    char magic[8];
+    uint32_t version = 0, numColumns = 0, i = 0;
+    int ok = 0;
+
+    in = gzopen(inName, "rb");
+    if (!in) {
+        fprintf(stderr, "Could not open \"%s\" for reading\n", inName);
+        return 0;
+    }
+
+    if (sizeof(magic) != ReadBytes(in, magic, sizeof(magic)) || memcmp(magic, "MCXBRES", sizeof(magic))) {
+        fprintf(stderr, "\"%s\" is not a binary result file\n", inName);
+        goto cleanup;
+    }
+    if (!ReadUInt32(in, &version) || version != BINARY_RESULTS_VERSION) {
+        fprintf(stderr, "\"%s\": Unsupported format version %u\n", inName, version);
+        goto cleanup;
+    }
+    if (!ReadUInt32(in, &numColumns)) {
+        goto corrupt;
+    }
+
+    columns = (Column *) calloc(numColumns ? numColumns : 1, sizeof(Column));
+    if (!columns) {
+        goto nomem;
+    }
+    for (i = 0; i < numColumns; i++) {
+        if (!ReadUInt32(in, &columns[i].type)) {
+            goto corrupt;
+        }
+        columns[i].name = ReadString(in);
+        columns[i].unit = columns[i].name ? ReadString(in) : NULL;
+        if (!columns[i].unit) {
+            goto corrupt;
+        }
+    }
+
+    out = fopen(outName, "w");
+    if (!out) {
+        fprintf(stderr, "Could not open \"%s\" for writing\n", outName);
+        goto cleanup;
+    }
+
+    fprintf(out, "sep=%s\n", SEPARATOR);
+    for (i = 0; i < numColumns; i++) {
+        fprintf(out, "%s", i == 0 ? "" : SEPARATOR);
+        WriteQuoted(out, columns[i].name, strlen(columns[i].name), 0);
+    }
+    fprintf(out, "\n");
+    for (i = 0; i < numColumns; i++) {
+        fprintf(out, "%s%s", i == 0 ? "" : SEPARATOR, columns[i].unit);
+    }
+    fprintf(out, "\n");
+
+    for (;;) {
+        unsigned char header[16];
+        uint32_t numRows = 0, row = 0;
+        uint64_t size = 0;
+        size_t read = ReadBytes(in, header, sizeof(header));
+
+        if (0 == read && gzeof(in)) {
+            break;
+        }
+        if (read != sizeof(header) || memcmp(header, "CHNK", 4)) {
+            goto corrupt;
+        }
+        numRows = DecodeUInt32(header + 4);
+        size = DecodeUInt64(header + 8);
+        if (size > (uint64_t) SIZE_MAX) {
+            goto corrupt;
+        }
+
+        if (size > chunkCapacity) {
+            free(chunk);
+            chunk = (unsigned char *) malloc((size_t) size);
+            if (!chunk) {
+                goto nomem;
+            }
+            chunkCapacity = (size_t) size;
+        }
+        if (size > 0 && (size_t) size != ReadBytes(in, chunk, (size_t) size)) {
+            goto corrupt;
+        }
+        if (!SetupCursors(columns, numColumns, numRows, chunk, (size_t) size)) {
+            goto corrupt;
+        }
+
+        for (row = 0; row < numRows; row++) {
+            for (i = 0; i < numColumns; i++) {
+                fprintf(out, "%s", i == 0 ? "" : SEPARATOR);
+                WriteValue(out, &columns[i]);
+            }
+            fprintf(out, "\n");
+        }
+    }
+
+    if (fclose(out)) {
+        out = NULL;
+        fprintf(stderr, "Could not write \"%s\"\n", outName);
+        goto cleanup;
+    }
+    out = NULL;
+    ok = 1;
+    goto cleanup;
+
+corrupt:
+    fprintf(stderr, "\"%s\" is corrupt or truncated\n", inName);
+    goto cleanup;
+
+nomem:
+    fprintf(stderr, "Out of memory while converting \"%s\"\n", inName);
+
+cleanup:
+    if (columns) {
+        for (i = 0; i < numColumns; i++) {
+            free(columns[i].name);
+            free(columns[i].unit);
+        }
+        free(columns);
+    }
+    free(chunk);
+    if (out) {
+        fclose(out);
+    }
+    gzclose(in);
+
+    return ok;
+}
+
+int main(int argc, char * argv[]) {
+    int i = 0;
+    int ok = 1;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s file.mcxb [file.mcxb ...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 1; i < argc; i++) {
+        const char * inName = argv[i];
+        size_t baseLen = strlen(inName);
+        char * outName = NULL;
+
+        if (baseLen > 3 && !strcmp(inName + baseLen - 3, ".gz")) {
+            baseLen -= 3;
+        }
+        if (baseLen > 5 && !strncmp(inName + baseLen - 5, ".mcxb", 5)) {
+            baseLen -= 5;
+        }
+        outName = (char *) malloc(baseLen + strlen(".csv") + 1);
+
+        if (!outName) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+        memcpy(outName, inName, baseLen);
+        strcpy(outName + baseLen, ".csv");
+
+        if (!Convert(inName, outName)) {
+            ok = 0;
+        } else {
+            printf("%s -> %s\n", inName, outName);
+        }
+        free(outName);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}